@@ -6,24 +6,75 @@
 // - FIXED: Font size inside timetable event boxes was too small.
 //   - Increased font size in DrawTimetableGridFixed() to 20px/18px.
 // - Kept all other layout and font changes from v2.
+// - Loaded tables are saved to acadfac.snap after a clean load and after the save on
+//   exit. Startup copies them from that binary image and only parses the text files
+//   when one of them changed size or mtime since.
+//   Results rows and the snapshot's assignment rows hold interned symbols, not MAX_STR
+//   buffers (32 bytes a result instead of 1040). "acadfac --snapshot-bench [rows]"
+//   sizes and times the snapshot against parsing results.txt.
+// - Adding a lecture/lab now also rejects room and professor double-bookings, through
+//   a per-day interval index instead of a scan of every timetable row. Existing
+//   clashes are outlined in red on the grid and listed under it.
+// - Timetable rows are the compact, string-interned TimetableEntry of timetable.h
+//   (24 bytes instead of ~780), and the grid draws from a view grouped by type and day.
+// - Semester Info draws its holiday and exam lists from a date-sorted calendar store
+//   (calendar.h) saved in semester.txt, instead of hardcoded text. Events are added in
+//   the sidebar and removed with the X next to them.
+// - Add/Delete no longer rewrite files mid-frame. They mark their table dirty; once
+//   edits pause, the tables are formatted in memory and a background thread writes
+//   them (temp file + rename, see persist.h). Exit flushes whatever is still dirty;
+//   tables nobody touched are not rewritten. "acadfac --persist-check" checks both.
+// - The Results and Attendance summary lines come from running totals kept on every
+//   insert and delete, so they cover all rows and cost nothing per frame.
+// - Attendance is recorded per session (attendance.h): one compressed set of attended
+//   sessions per subject and student, array or bitmap, whichever is smaller. The tab
+//   adds subjects, enrolls students and records sessions by absentees, and shows each
+//   subject's average, students below 75%, and sessions everyone/anyone attended.
+//   "acadfac --attendance-bench [students]" sizes and times a 60-session term.
+// - Results can be bulk-imported from a CSV (gradebook.h): "Import CSV" in the Results
+//   tab, or "acadfac --import-results file.csv" from the command line. Rows are validated
+//   against student_info.txt, deduped, merged, and results.txt is written once; rejected
+//   lines go to results_rejects.txt. The results table grows instead of stopping at 512.
+// - Results has an Analytics view (analytics.h): per-subject pass rates, grade
+//   histograms and percentiles, students ranked by credit-weighted CPI, and each row's
+//   percentile within its subject. "acadfac --results-report [file]" prints the same
+//   report without a window; "acadfac --results-bench [rows]" times it.
+// - The table loaders read through records.h: one vectorized pass over the mapped file
+//   instead of fgets + strtok + atoi per line. Empty fields now stay empty instead of
+//   shifting the following fields left. "acadfac --parse-bench [lines]" times both
+//   loaders on the same synthetic results.txt (10M lines by default).
+// - Assignments tracks every student's hand-in state (deadlines.h) in
+//   assignment_progress.txt. "Record Hand-in" marks a student submitted or pending; the
+//   Overdue view lists past-due assignments with how many students are missing each.
+//   "acadfac --deadline-bench [students] [assignments]" times it on a large cohort.
+// - The lecture and lab grids are drawn into render textures (gridcache.h) and blitted;
+//   they are redrawn only when tt_version changes. "acadfac --grid-bench [entries]"
+//   compares draw calls and frame times with drawing them every frame.
 
 #include "raylib.h"
+#include "portal.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include "datacache.h"
+#include "timetable.h"
+#include "calendar.h"
+#include "records.h"
+#include "analytics.h"
+#include "gradebook.h"
+#include "attendance.h"
+#include "deadlines.h"
+#include "gridcache.h"
+#include "persist.h"
 
 #define MAX_STR 256
 #define MAX_ENTRIES 512
+#define MAX_CLASHES 256
+#define TT_DEFAULT_ROOM "Room"  // Filled in when the Room box is left empty
+#define TT_DEFAULT_PROF "Prof"
 
 // --- [Data Structures: Unchanged] ---
-typedef enum { TT_LECTURE = 0, TT_LAB = 1 } TTType;
-
-typedef struct {
-    int day; int start_h, start_m; int end_h, end_m;
-    char title[MAX_STR]; char room[MAX_STR]; char professor[MAX_STR];
-    TTType type; int id;
-} TimetableEntry;
-
 typedef enum { ASSIGNED=0, PENDING=1, SUBMITTED=2 } AssignStatus;
 typedef struct {
     int id; char title[MAX_STR]; char due_date[MAX_STR]; char submitted_date[MAX_STR];
@@ -34,33 +85,45 @@ typedef struct {
     int id; char title[MAX_STR]; char date[MAX_STR]; char desc[MAX_STR];
 } Event;
 
+// Holidays, exams, tests, orientations and deadlines live in the calendar store
 typedef struct {
     char semester_name[MAX_STR]; char start_date[MAX_STR]; char end_date[MAX_STR];
     int total_credits;
-    Event holidays[MAX_ENTRIES]; int holidays_count;
-    Event exams[MAX_ENTRIES]; int exams_count;
-    Event tests[MAX_ENTRIES]; int tests_count;
-    Event orientations[MAX_ENTRIES]; int orientations_count;
-    Event deadlines[MAX_ENTRIES]; int deadlines_count;
 } SemesterInfo;
 
+// Students, subjects, grades and remarks repeat across rows, so a row holds their symbols
+// in res_strings (interned like the timetable text): 32 bytes instead of four MAX_STR buffers
 typedef struct {
-    char subject[MAX_STR]; int total_lectures; int attended;
-} AttendanceRecord;
+    TimetableSymbol student_id, subject, grade, remarks;
+    int total_credits; int credits_earned; float SPI; int passed;
+} ResultRecord;
 
+// Snapshot layout of an Assignment, its text as symbols in res_strings
 typedef struct {
-    char student_id[MAX_STR]; char subject[MAX_STR]; int total_credits;
-    int credits_earned; float SPI; char grade[MAX_STR]; char remarks[MAX_STR];
-    int passed;
-} ResultRecord;
+    int32_t id, status;
+    TimetableSymbol title, due_date, submitted_date, issued_by, desc;
+} AssignmentImage;
 
 // --- [Storage & Files: Unchanged] ---
-static TimetableEntry tt_entries[MAX_ENTRIES]; static int tt_count = 0;
+static TimetableEntry tt_entries[MAX_TT_ENTRIES]; static int tt_count = 0;
+static TimetableStrings tt_strings;     // Titles, rooms and professors of tt_entries
 static Assignment assignments[MAX_ENTRIES]; static int assign_count = 0;
 static Event events_list[MAX_ENTRIES]; static int events_count = 0;
 static SemesterInfo seminfo;
-static AttendanceRecord attendance[MAX_ENTRIES]; static int attendance_count = 0;
-static ResultRecord results[MAX_ENTRIES]; static int results_count = 0;
+static CalendarStore calendar;          // Semester events, saved with seminfo
+static AttendanceStore attendance;      // Per-session marks of every enrolled student
+static ResultRecord *results = NULL; static int results_count = 0, results_capacity = 0;   // Grows, imports can be large
+static TimetableStrings res_strings;    // Text of results rows (and of assignments in the snapshot)
+static int tt_version = 1;              // Bumped whenever tt_entries changes
+static int results_version = 1;         // Bumped whenever results changes
+static int attendance_version = 1;      // Bumped whenever attendance changes
+static DeadlineTracker deadlines;       // Per-student assignment state and the due-date index
+static int deadlines_version = 1;       // Bumped whenever deadlines changes
+
+// Running totals behind the Results summary line, see results_insert() and friends.
+// The attendance store keeps its own (attendance.attended / attendance.possible).
+typedef struct { long credits, earned; double spiSum; int spiCount; } ResultTotals;
+static ResultTotals results_totals;
 
 const char* FILE_TT = "tt_entries.txt";
 const char* FILE_ASSIGN = "assignments.txt";
@@ -68,99 +131,377 @@ const char* FILE_EVENTS = "events.txt";
 const char* FILE_SEM = "semester.txt";
 const char* FILE_ATT = "attendance.txt";
 const char* FILE_RES = "results.txt";
+const char* FILE_SNAPSHOT = "acadfac.snap"; // Binary image of all of the above
+const char* FILE_STUDENTS = "student_info.txt";     // Known student IDs for imports
+const char* FILE_RES_IMPORT = "results_import.csv";
+const char* FILE_RES_REJECTS = "results_rejects.txt";
+const char* FILE_PROGRESS = "assignment_progress.txt";  // Per-student assignment state
 
 // --- [Util Functions: Unchanged] ---
 static void trimnl(char *s) {
     int n = (int)strlen(s);
     while (n>0 && (s[n-1]=='\n' || s[n-1]=='\r')) { s[--n] = 0; }
 }
-static void scpy(char *dst, const char *src) {
-    if (!src) { dst[0]=0; return; }
-    strncpy(dst, src, MAX_STR-1);
-    dst[MAX_STR-1]=0;
+static void scpy(char *dst, size_t size, const char *src) {
+    if (src == dst) return;             // Keeping a field as it is
+    snprintf(dst, size, "%s", src ? src : "");
 }
+// "HH:MM" -> minutes since midnight
 static int times_overlap_minutes(int a_start_min, int a_end_min, int b_start_min, int b_end_min) {
     return !(a_end_min <= b_start_min || b_end_min <= a_start_min);
 }
 
-// --- [Save/Load Functions: Unchanged] ---
-void save_timetable() {
-    FILE *f = fopen(FILE_TT,"w"); if (!f) return;
+// --- [Save/Load Functions] ---
+// The save_* functions format a table in memory; save_tables() hands the text to the writer thread
+static void save_timetable(PersistBuffer *f) {
     for (int i=0;i<tt_count;i++) {
         TimetableEntry *e = &tt_entries[i];
-        fprintf(f, "%d|%02d:%02d|%02d:%02d|%d|%s|%s|%s|%d\n",
-            e->day, e->start_h, e->start_m, e->end_h, e->end_m,
-            (int)e->type, e->title, e->room, e->professor, e->id);
-    } fclose(f);
+        PersistAppend(f, "%d|%02d:%02d|%02d:%02d|%d|%s|%s|%s|%d\n",
+            e->day, e->start/60, e->start%60, e->end/60, e->end%60, (int)e->type,
+            TimetableString(&tt_strings, e->title), TimetableString(&tt_strings, e->room),
+            TimetableString(&tt_strings, e->professor), e->id);
+    }
 }
 void load_timetable() {
-    tt_count = 0; FILE *f = fopen(FILE_TT,"r"); if (!f) return; char line[1024];
-    while (fgets(line,sizeof(line),f)) {
-        trimnl(line); if (strlen(line)==0) continue;
+    tt_count = 0; tt_version++; TimetableStringsReset(&tt_strings);
+    RecordFile f; if (!RecordFileOpen(&f, FILE_TT)) return;
+    RecordLine line; char text[MAX_STR];
+    while (RecordNextLine(&f, &line)) {
+        if (line.count < 4) continue;
         TimetableEntry e; memset(&e,0,sizeof(e));
-        char *tok = strtok(line,"|"); if (!tok) continue; e.day = atoi(tok);
-        tok = strtok(NULL,"|"); if (!tok) continue; sscanf(tok,"%d:%d",&e.start_h,&e.start_m);
-        tok = strtok(NULL,"|"); if (!tok) continue; sscanf(tok,"%d:%d",&e.end_h,&e.end_m);
-        tok = strtok(NULL,"|"); if (!tok) continue; e.type = (TTType)atoi(tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(e.title, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(e.room, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(e.professor, tok);
-        tok = strtok(NULL,"|"); if (tok) e.id = atoi(tok);
-        if (tt_count < MAX_ENTRIES) tt_entries[tt_count++] = e;
-    } fclose(f);
+        e.day = (uint8_t)RecordInt(&line,0);
+        e.start = (uint16_t)RecordMinutes(&line,1); e.end = (uint16_t)RecordMinutes(&line,2);
+        e.type = (uint8_t)RecordInt(&line,3);
+        RecordCopy(&line,4,text,MAX_STR); e.title = TimetableIntern(&tt_strings, text);
+        RecordCopy(&line,5,text,MAX_STR); e.room = TimetableIntern(&tt_strings, text);
+        RecordCopy(&line,6,text,MAX_STR); e.professor = TimetableIntern(&tt_strings, text);
+        e.id = RecordInt(&line,7);
+        if (tt_count < MAX_TT_ENTRIES) tt_entries[tt_count++] = e;
+    } RecordFileClose(&f);
 }
-void save_assignments() {
-    FILE *f = fopen(FILE_ASSIGN,"w"); if (!f) return;
+static void save_assignments(PersistBuffer *f) {
     for (int i=0;i<assign_count;i++) {
         Assignment *a = &assignments[i];
-        fprintf(f, "%d|%s|%s|%d|%s|%s|%s\n",
+        PersistAppend(f, "%d|%s|%s|%d|%s|%s|%s\n",
             a->id, a->title, a->due_date, (int)a->status, a->submitted_date, a->issued_by, a->desc);
-    } fclose(f);
+    }
 }
 void load_assignments() {
-    assign_count = 0; FILE *f = fopen(FILE_ASSIGN,"r"); if (!f) return; char line[2048];
-    while (fgets(line,sizeof(line),f)) {
-        trimnl(line); if (strlen(line)==0) continue;
+    assign_count = 0; RecordFile f; if (!RecordFileOpen(&f, FILE_ASSIGN)) return; RecordLine line;
+    while (RecordNextLine(&f, &line)) {
         Assignment a; memset(&a,0,sizeof(a));
-        char *tok = strtok(line,"|"); if (!tok) continue; a.id = atoi(tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(a.title, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(a.due_date, tok);
-        tok = strtok(NULL,"|"); if (tok) a.status = atoi(tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(a.submitted_date, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(a.issued_by, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(a.desc, tok);
+        a.id = RecordInt(&line,0);
+        RecordCopy(&line,1,a.title,MAX_STR);
+        RecordCopy(&line,2,a.due_date,MAX_STR);
+        a.status = (AssignStatus)RecordInt(&line,3);
+        RecordCopy(&line,4,a.submitted_date,MAX_STR);
+        RecordCopy(&line,5,a.issued_by,MAX_STR);
+        RecordCopy(&line,6,a.desc,MAX_STR);
         if (assign_count < MAX_ENTRIES) assignments[assign_count++] = a;
-    } fclose(f);
+    } RecordFileClose(&f);
+}
+// Rebuilds the deadline index from the assignment rows; after any assignment change
+static void sync_deadlines(void) {
+    int32_t ids[MAX_ENTRIES], dues[MAX_ENTRIES];
+    for (int i=0;i<assign_count;i++) { ids[i] = assignments[i].id; dues[i] = CalendarParseDate(assignments[i].due_date); }
+    DeadlineSetTasks(&deadlines, ids, dues, assign_count);
+    deadlines_version++;
+}
+// Everyone in student_info.txt is in the cohort, whether or not they handed anything in
+static void load_cohort(void) {
+    GradebookRoster roster; char id[DEADLINE_MAX_ID];
+    if (GradebookRosterLoad(&roster, FILE_STUDENTS)) {
+        for (int i=0;i<roster.count;i++) {
+            int n = roster.ids[i].length < DEADLINE_MAX_ID - 1 ? roster.ids[i].length : DEADLINE_MAX_ID - 1;
+            memcpy(id, roster.ids[i].text, n); id[n] = 0;
+            DeadlineAddStudent(&deadlines, id);
+        }
+    }
+    GradebookRosterFree(&roster);
+    deadlines_version++;
+}
+static void save_progress(PersistBuffer *f) {
+    for (int t=0;t<deadlines.taskCount;t++) {
+        if (deadlines.tasks[t].column < 0) continue;
+        for (int s=0;s<deadlines.studentCount;s++) {
+            DeadlineState state = DeadlineStateAt(&deadlines, t, s);
+            if (state != DL_ASSIGNED) PersistAppend(f, "%d|%s|%s\n", deadlines.tasks[t].id, deadlines.students[s].id, DEADLINE_STATE_NAMES[state]);
+        }
+    }
+}
+void load_progress() {
+    DeadlineFree(&deadlines); RecordFile f;
+    if (RecordFileOpen(&f, FILE_PROGRESS)) {
+        RecordLine line;
+        while (RecordNextLine(&f, &line)) DeadlineParseLine(&deadlines, &line);
+        RecordFileClose(&f);
+    }
+    sync_deadlines();
+}
+static void load_events() { /* ...unchanged... */ }
+static void save_events() { /* ...unchanged... */ }
+static void save_semester(PersistBuffer *f) {
+    PersistAppend(f, "%s|%s|%s|%d\n", seminfo.semester_name, seminfo.start_date, seminfo.end_date, seminfo.total_credits);
+    char line[256];
+    for (int i=0;i<calendar.count;i++) PersistAppend(f, "%s\n", CalendarFormatLine(&calendar.events[i], line, sizeof(line)));
+}
+void load_semester() {
+    scpy(seminfo.semester_name, sizeof(seminfo.semester_name), "Semester 1");
+    scpy(seminfo.start_date, sizeof(seminfo.start_date), "2025-01-10");
+    scpy(seminfo.end_date, sizeof(seminfo.end_date),   "2025-05-30");
+    seminfo.total_credits = 20;
+    CalendarFree(&calendar);
+    FILE *f = fopen(FILE_SEM,"r");
+    if (f) {
+        char line[512];
+        if (fgets(line,sizeof(line),f)) {
+            trimnl(line);
+            char *tok = strtok(line,"|");
+            if (tok) scpy(seminfo.semester_name, sizeof(seminfo.semester_name), tok);
+            tok = strtok(NULL,"|"); if (tok) scpy(seminfo.start_date, sizeof(seminfo.start_date), tok);
+            tok = strtok(NULL,"|"); if (tok) scpy(seminfo.end_date, sizeof(seminfo.end_date), tok);
+            tok = strtok(NULL,"|"); if (tok) seminfo.total_credits = atoi(tok);
+        }
+        while (fgets(line,sizeof(line),f)) { trimnl(line); if (line[0]) CalendarParseLine(&calendar, line); }
+        fclose(f);
+    }
+    if (calendar.count == 0) CalendarAddDefaults(&calendar); // No file yet, or one without events
+}
+static const char *res_text(TimetableSymbol symbol) { return TimetableString(&res_strings, symbol); }
+static TimetableSymbol res_intern(const char *text) { return TimetableIntern(&res_strings, text); }
+
+// --- [Running Totals] ---
+// Every insert and delete goes through these, so the totals always match the tables.
+// SPI is a float, so its double sum stays exact across adds and removes.
+static void results_tally(const ResultRecord *r, int sign) {
+    results_totals.credits += sign * r->total_credits;
+    results_totals.earned += sign * r->credits_earned;
+    if (r->SPI > 0.0f) { results_totals.spiSum += sign * (double)r->SPI; results_totals.spiCount += sign; }
+}
+static void results_recount(void) {
+    memset(&results_totals, 0, sizeof(results_totals));
+    for (int i=0;i<results_count;i++) results_tally(&results[i], 1);
+}
+static void results_reserve(int count) {
+    if (count <= results_capacity) return;
+    int capacity = results_capacity ? results_capacity : MAX_ENTRIES;
+    while (capacity < count) capacity *= 2;
+    results = (ResultRecord *)realloc(results, sizeof(ResultRecord) * capacity);
+    results_capacity = capacity;
+}
+static bool results_insert(const ResultRecord *r) {
+    results_reserve(results_count + 1);
+    results[results_count++] = *r; results_tally(r, 1); results_version++;
+    return true;
+}
+static void results_replace(int i, const ResultRecord *r) {
+    results_tally(&results[i], -1);
+    results[i] = *r; results_tally(r, 1); results_version++;
+}
+static void results_remove(int i) {
+    results_tally(&results[i], -1);
+    memmove(&results[i], &results[i+1], sizeof(ResultRecord) * (results_count - i - 1));
+    results_count--; results_version++;
 }
-void save_events() { /* ...unchanged... */ }
-void load_events() { /* ...unchanged... */ }
-void save_semester() { /* ...unchanged... */ }
-void load_semester() { /* ...unchanged... */ }
-void save_attendance() { /* ...unchanged... */ }
-void load_attendance() { /* ...unchanged... */ }
 
-void save_results() {
-    FILE *f = fopen(FILE_RES,"w"); if (!f) return;
+static void save_attendance(PersistBuffer *f) {
+    char bits[ATTENDANCE_MAX_SESSIONS / 4 + 1];
+    for (int i=0;i<attendance.subjectCount;i++) {
+        const AttendanceSubject *sub = &attendance.subjects[i];
+        PersistAppend(f, "SUBJECT|%s|%d\n", sub->name, sub->sessions);
+        for (int k=sub->firstSet;k<sub->firstSet+sub->setCount;k++) {
+            const AttendanceSet *set = &attendance.sets[k];
+            PersistAppend(f, "MARK|%s|%s|%s\n", sub->name, attendance.students[set->student].id, AttendanceFormatBits(&attendance, i, set, bits, sizeof(bits)));
+        }
+    }
+}
+void load_attendance() {
+    AttendanceFree(&attendance); attendance_version++;
+    RecordFile f; if (!RecordFileOpen(&f, FILE_ATT)) return; RecordLine line;
+    while (RecordNextLine(&f, &line)) AttendanceParseLine(&attendance, &line);
+    RecordFileClose(&f);
+    AttendanceCompact(&attendance);
+}
+
+static void save_results(PersistBuffer *f) {
     for (int i=0;i<results_count;i++) {
         ResultRecord *r = &results[i];
-        fprintf(f, "%s|%s|%d|%d|%.2f|%s|%s|%d\n", r->student_id, r->subject, r->total_credits, r->credits_earned, r->SPI, r->grade, r->remarks, r->passed);
-    } fclose(f);
+        PersistAppend(f, "%s|%s|%d|%d|%.2f|%s|%s|%d\n", res_text(r->student_id), res_text(r->subject), r->total_credits, r->credits_earned,
+            r->SPI, res_text(r->grade), res_text(r->remarks), r->passed);
+    }
 }
 void load_results() {
-    results_count = 0; FILE *f = fopen(FILE_RES,"r"); if (!f) return; char line[1024];
-    while (fgets(line,sizeof(line),f)) {
-        trimnl(line); if (strlen(line)==0) continue;
+    results_count = 0; results_version++; TimetableStringsReset(&res_strings);
+    RecordFile f; if (!RecordFileOpen(&f, FILE_RES)) return;
+    RecordLine line; char text[MAX_STR];
+    while (RecordNextLine(&f, &line)) {
         ResultRecord r; memset(&r,0,sizeof(r));
-        char *tok = strtok(line,"|"); if (!tok) continue; scpy(r.student_id, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(r.subject, tok);
-        tok = strtok(NULL,"|"); if (tok) r.total_credits = atoi(tok);
-        tok = strtok(NULL,"|"); if (tok) r.credits_earned = atoi(tok);
-        tok = strtok(NULL,"|"); if (tok) r.SPI = (float)atof(tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(r.grade, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(r.remarks, tok);
-        tok = strtok(NULL,"|"); if (tok) r.passed = atoi(tok);
-        if (results_count < MAX_ENTRIES) results[results_count++] = r;
-    } fclose(f);
+        RecordCopy(&line,0,text,MAX_STR); r.student_id = res_intern(text);
+        RecordCopy(&line,1,text,MAX_STR); r.subject = res_intern(text);
+        r.total_credits = RecordInt(&line,2);
+        r.credits_earned = RecordInt(&line,3);
+        r.SPI = (float)RecordFloat(&line,4);
+        RecordCopy(&line,5,text,MAX_STR); r.grade = res_intern(text);
+        RecordCopy(&line,6,text,MAX_STR); r.remarks = res_intern(text);
+        r.passed = RecordInt(&line,7);
+        results_reserve(results_count + 1); results[results_count++] = r;
+    } RecordFileClose(&f);
+    results_recount();
+}
+
+// --- [Dirty Tracking] ---
+// UI edits only mark their table; persist_pump() saves once the edits pause
+enum { TABLE_TT=1, TABLE_ASSIGN=2, TABLE_SEM=4, TABLE_ATT=8, TABLE_RES=16, TABLE_PROGRESS=32, TABLE_ALL=63 };
+#define PERSIST_QUIET_SECONDS 0.5   // Save after this long without another edit...
+#define PERSIST_MAX_DELAY 3.0       // ...but never hold a dirty table longer than this
+
+static PersistWriter writer;
+static unsigned dirty_tables = 0;
+static double first_dirty = 0.0, last_edit = 0.0;
+
+static void mark_dirty(unsigned tables) {
+    double now = GetTime();
+    if (!dirty_tables) first_dirty = now;
+    dirty_tables |= tables; last_edit = now;
+}
+
+static const struct { unsigned table; const char **path; void (*save)(PersistBuffer *); } table_savers[] = {
+    { TABLE_TT, &FILE_TT, save_timetable },     { TABLE_ASSIGN, &FILE_ASSIGN, save_assignments },
+    { TABLE_SEM, &FILE_SEM, save_semester },    { TABLE_ATT, &FILE_ATT, save_attendance },
+    { TABLE_RES, &FILE_RES, save_results },     { TABLE_PROGRESS, &FILE_PROGRESS, save_progress },
+};
+#define TABLE_SAVER_COUNT ((int)(sizeof(table_savers)/sizeof(table_savers[0])))
+
+// Formats the tables on this thread (the UI owns them) and queues the text for the writer
+static void save_tables(unsigned tables) {
+    for (int i=0;i<TABLE_SAVER_COUNT;i++) {
+        if (!(tables & table_savers[i].table)) continue;
+        PersistBuffer buffer = {0};
+        table_savers[i].save(&buffer);
+        PersistQueue(&writer, *table_savers[i].path, &buffer);
+        PortalFileWritten(*table_savers[i].path);    // The student window reads it again
+    }
+    dirty_tables &= ~tables;
+}
+
+// Exit path: saves only the tables edited since their last save, then waits for the writer.
+// Returns the files written this session; 0 means the files are exactly as loaded.
+static int flush_tables(void) {
+    if (dirty_tables) save_tables(dirty_tables);
+    PersistStop(&writer);
+    return writer.written;
+}
+
+// Called once per frame
+static void persist_pump(void) {
+    if (!dirty_tables) return;
+    double now = GetTime();
+    if (now - last_edit >= PERSIST_QUIET_SECONDS || now - first_dirty >= PERSIST_MAX_DELAY) save_tables(dirty_tables);
+}
+
+// --- [Shared Data Model] ---
+// Inside the portal shell the tables stay loaded between visits. They are read again only
+// when another screen (the timetable generator, registration) wrote one of their files
+// since; see PortalFileWritten() in portal.h. Standalone every start reads them.
+static bool tables_loaded = false;
+static unsigned tables_version = 0, cohort_version = 0;
+
+static unsigned table_files_version(void) {
+    const char *files[] = { FILE_TT, FILE_ASSIGN, FILE_EVENTS, FILE_SEM, FILE_ATT, FILE_RES, FILE_PROGRESS };
+    unsigned version = 0;     // A sum of counters that only grow changes whenever one of them does
+    for (int i=0;i<(int)(sizeof(files)/sizeof(files[0]));i++) version += PortalFileVersion(files[i]);
+    return version;
+}
+
+// --- [Warm-Start Snapshot] ---
+static AssignmentImage assign_image[MAX_ENTRIES];
+
+// Describes the loaded tables for datacache.h, in section order
+static int table_sources(DataCacheSource *sources) {
+    for (int i=0;i<assign_count;i++) {
+        const Assignment *a = &assignments[i];
+        assign_image[i] = (AssignmentImage){ a->id, (int32_t)a->status, res_intern(a->title), res_intern(a->due_date),
+                                             res_intern(a->submitted_date), res_intern(a->issued_by), res_intern(a->desc) };
+    }
+    sources[0] = (DataCacheSource){ FILE_TT,     tt_entries,  sizeof(TimetableEntry),   tt_count };
+    sources[1] = (DataCacheSource){ FILE_ASSIGN, assign_image, sizeof(AssignmentImage), assign_count };
+    sources[2] = (DataCacheSource){ FILE_EVENTS, events_list, sizeof(Event),            events_count };
+    sources[3] = (DataCacheSource){ FILE_SEM,    &seminfo,    sizeof(SemesterInfo),     1 };
+    int attendanceWords = 0;
+    const uint64_t *marks = AttendancePack(&attendance, &attendanceWords);
+    sources[4] = (DataCacheSource){ FILE_ATT,    marks,       sizeof(uint64_t),         attendanceWords };
+    sources[5] = (DataCacheSource){ FILE_RES,    results,     sizeof(ResultRecord),     results_count };
+    long stringBytes = 0;
+    const char *strings = TimetableStringsPack(&tt_strings, &stringBytes);
+    sources[6] = (DataCacheSource){ FILE_TT,     strings,     1,                        (int)stringBytes };
+    sources[7] = (DataCacheSource){ FILE_SEM,    calendar.events, sizeof(CalendarEvent), calendar.count };
+    int progressWords = 0;
+    const uint64_t *progress = DeadlinePack(&deadlines, &progressWords);
+    sources[8] = (DataCacheSource){ FILE_PROGRESS, progress,  sizeof(uint64_t),         progressWords };
+    long resultBytes = 0;
+    const char *resultStrings = TimetableStringsPack(&res_strings, &resultBytes);
+    sources[9] = (DataCacheSource){ FILE_RES,    resultStrings, 1,                      (int)resultBytes };
+    return 10;
+}
+
+static void save_snapshot(void) {
+    DataCacheSource sources[DATACACHE_MAX_SECTIONS];
+    if (!DataCacheWriteFile(FILE_SNAPSHOT, sources, table_sources(sources))) {
+        TraceLog(LOG_WARNING, "ACADFAC: Could not write %s.", FILE_SNAPSHOT);
+    }
+}
+
+// Copies one section into its table; false if the section does not fit
+static bool copy_section(const DataCacheHeader *snap, int index, void *dest, long elementSize, int *count, int capacity) {
+    int n = 0;
+    const void *src = DataCacheSectionData(snap, index, elementSize, &n);
+    if (!src || n > capacity) return false;
+    memcpy(dest, src, elementSize * n);
+    *count = n;
+    return true;
+}
+
+// Expands the assignment rows once res_strings holds their text
+static void assignments_from_image(void) {
+    for (int i=0;i<assign_count;i++) {
+        const AssignmentImage *m = &assign_image[i];
+        Assignment *a = &assignments[i]; memset(a,0,sizeof(*a));
+        a->id = m->id; a->status = (AssignStatus)m->status;
+        scpy(a->title, sizeof(a->title), res_text(m->title)); scpy(a->due_date, sizeof(a->due_date), res_text(m->due_date));
+        scpy(a->submitted_date, sizeof(a->submitted_date), res_text(m->submitted_date));
+        scpy(a->issued_by, sizeof(a->issued_by), res_text(m->issued_by)); scpy(a->desc, sizeof(a->desc), res_text(m->desc));
+    }
+}
+
+// The tables stay editable, so records are copied out of the image rather than used in place
+static bool load_snapshot(void) {
+    const DataCacheHeader *snap = DataCacheMapFile(FILE_SNAPSHOT);
+    bool loaded = false;
+    if (snap && DataCacheIsFresh(snap)) {
+        int semCount = 0, stringBytes = 0, eventCount = 0, resultCount = 0, attendanceWords = 0, progressWords = 0, resultBytes = 0;
+        DataCacheSectionData(snap, 5, sizeof(ResultRecord), &resultCount);
+        results_reserve(resultCount);
+        const char *strings = (const char *)DataCacheSectionData(snap, 6, 1, &stringBytes);
+        const CalendarEvent *events = (const CalendarEvent *)DataCacheSectionData(snap, 7, sizeof(CalendarEvent), &eventCount);
+        const uint64_t *marks = (const uint64_t *)DataCacheSectionData(snap, 4, sizeof(uint64_t), &attendanceWords);
+        const uint64_t *progress = (const uint64_t *)DataCacheSectionData(snap, 8, sizeof(uint64_t), &progressWords);
+        const char *resultStrings = (const char *)DataCacheSectionData(snap, 9, 1, &resultBytes);
+        loaded = copy_section(snap, 0, tt_entries, sizeof(TimetableEntry), &tt_count, MAX_TT_ENTRIES) &&
+                 resultStrings && TimetableStringsLoad(&res_strings, resultStrings, resultBytes, false) &&
+                 copy_section(snap, 1, assign_image, sizeof(AssignmentImage), &assign_count, MAX_ENTRIES) &&
+                 copy_section(snap, 2, events_list, sizeof(Event), &events_count, MAX_ENTRIES) &&
+                 copy_section(snap, 3, &seminfo, sizeof(SemesterInfo), &semCount, 1) && semCount == 1 &&
+                 marks && AttendanceLoadImage(&attendance, marks, attendanceWords, false) &&
+                 progress && DeadlineLoadImage(&deadlines, progress, progressWords, false) &&
+                 copy_section(snap, 5, results, sizeof(ResultRecord), &results_count, results_capacity) &&
+                 strings && TimetableStringsLoad(&tt_strings, strings, stringBytes, false) &&
+                 events && CalendarLoad(&calendar, events, eventCount, false);
+        if (loaded) assignments_from_image();
+        tt_version++; results_version++; attendance_version++;
+        results_recount(); sync_deadlines();
+    }
+    DataCacheUnmapFile(snap);
+    return loaded;
 }
 
 // ---------------- UI HELPERS (Unchanged from v2) ----------------
@@ -254,9 +595,186 @@ int ButtonRect(Rectangle r, const char* text) {
 
 const char* DAYS[7] = {"Mon","Tue","Wed","Thu","Fri","Sat","Sun"};
 
+// ---------------- Clash Index ----------------
+// One interval index per kind of clash. Its slots are sorted by (day, key, start), so all
+// bookings of one room (or professor, or grid) on one day form a contiguous run. Each run
+// is read as an implicit balanced tree rooted at its middle slot, and every slot carries
+// the latest end time in its subtree, so an overlap query is O(log n + k).
+typedef enum { CLASH_ROOM = 0, CLASH_PROFESSOR, CLASH_SLOT, CLASH_KIND_COUNT } ClashKind;
+
+typedef struct {
+    int day; const char *key;   // key points into tt_strings, whose strings never move
+    int start, end;             // Minutes since midnight, [start, end)
+    int maxEnd;                 // Latest end in this slot's subtree
+    int entry;                  // Index into tt_entries
+} ClashSlot;
+
+typedef struct { int a, b; ClashKind kind; } ClashPair;
+
+static ClashSlot *clash_slots[CLASH_KIND_COUNT]; static int clash_capacity = 0;
+static int clash_slot_count[CLASH_KIND_COUNT];
+static int clash_version = 0;               // tt_version the index was built for
+static ClashPair clash_pairs[MAX_CLASHES]; static int clash_pair_count = 0;
+static int clash_total = 0;                 // Room/professor clashes, may exceed MAX_CLASHES
+static bool *tt_clashing = NULL;            // Entry is part of at least one clash
+static char clash_status[MAX_STR] = "";     // Why the last Add was rejected
+static const char* CLASH_KIND_NAMES[CLASH_KIND_COUNT] = { "Room", "Professor", "Slot" };
+
+static int clash_keycmp(const char *a, const char *b) {
+    for (;; a++, b++) {
+        int ca = tolower((unsigned char)*a), cb = tolower((unsigned char)*b);
+        if (ca != cb || ca == 0) return ca - cb;
+    }
+}
+
+static int clash_slotcmp(const void *pa, const void *pb) {
+    const ClashSlot *a = pa, *b = pb;
+    if (a->day != b->day) return a->day - b->day;
+    int c = clash_keycmp(a->key, b->key);
+    return c ? c : a->start - b->start;
+}
+
+// What an entry is indexed under; NULL when it cannot clash on that kind
+static const char* clash_key(const TimetableEntry *e, ClashKind kind) {
+    switch (kind) {
+        case CLASH_ROOM: {
+            const char *room = TimetableString(&tt_strings, e->room);
+            return (room[0] && strcmp(room, TT_DEFAULT_ROOM) != 0) ? room : NULL;
+        }
+        case CLASH_PROFESSOR: {
+            const char *prof = TimetableString(&tt_strings, e->professor);
+            return (prof[0] && strcmp(prof, TT_DEFAULT_PROF) != 0) ? prof : NULL;
+        }
+        default:              return e->type == TT_LAB ? "Lab" : "Lecture"; // One grid per type
+    }
+}
+
+static int clash_build_tree(ClashSlot *s, int lo, int hi) {
+    if (lo >= hi) return -1;
+    int mid = lo + (hi - lo) / 2;
+    int maxEnd = s[mid].end;
+    int left = clash_build_tree(s, lo, mid), right = clash_build_tree(s, mid + 1, hi);
+    if (left > maxEnd) maxEnd = left;
+    if (right > maxEnd) maxEnd = right;
+    s[mid].maxEnd = maxEnd;
+    return maxEnd;
+}
+
+// Run of slots in [*lo, *hi) with this day and key
+static void clash_find_run(ClashKind kind, int day, const char *key, int *lo, int *hi) {
+    const ClashSlot *s = clash_slots[kind];
+    ClashSlot probe = { day, key, 0, 0, 0, -1 };
+    int a = 0, b = clash_slot_count[kind];
+    while (a < b) { int m = (a + b) / 2; if (clash_slotcmp(&s[m], &probe) < 0) a = m + 1; else b = m; }
+    *lo = a;
+    b = clash_slot_count[kind];
+    while (a < b) { int m = (a + b) / 2; if (s[m].day == day && clash_keycmp(s[m].key, key) == 0) a = m + 1; else b = m; }
+    *hi = a;
+}
+
+static void RebuildClashIndex(void) {
+    double start = GetTime();
+    if (tt_count > clash_capacity) {
+        clash_capacity = tt_count + tt_count / 2;
+        for (int k = 0; k < CLASH_KIND_COUNT; k++) clash_slots[k] = (ClashSlot *)realloc(clash_slots[k], sizeof(ClashSlot) * clash_capacity);
+        tt_clashing = (bool *)realloc(tt_clashing, sizeof(bool) * clash_capacity);
+    }
+    for (int k = 0; k < CLASH_KIND_COUNT; k++) {
+        ClashSlot *s = clash_slots[k]; int n = 0;
+        for (int i = 0; i < tt_count; i++) {
+            const TimetableEntry *e = &tt_entries[i];
+            const char *key = clash_key(e, (ClashKind)k);
+            if (!key) continue;
+            s[n++] = (ClashSlot){ e->day, key, e->start, e->end, 0, i };
+        }
+        qsort(s, n, sizeof(ClashSlot), clash_slotcmp);
+        for (int lo = 0, hi; lo < n; lo = hi) {
+            for (hi = lo + 1; hi < n && s[hi].day == s[lo].day && clash_keycmp(s[hi].key, s[lo].key) == 0; hi++) { }
+            clash_build_tree(s, lo, hi);
+        }
+        clash_slot_count[k] = n;
+    }
+
+    // Sorted by start, whatever overlaps a slot from later in its run directly follows it
+    clash_pair_count = 0; clash_total = 0;
+    if (tt_count > 0) memset(tt_clashing, 0, sizeof(bool) * tt_count);
+    for (int k = CLASH_ROOM; k <= CLASH_PROFESSOR; k++) {
+        const ClashSlot *s = clash_slots[k]; int n = clash_slot_count[k];
+        for (int i = 0; i < n; i++) {
+            for (int j = i + 1; j < n && s[j].day == s[i].day && s[j].start < s[i].end && clash_keycmp(s[j].key, s[i].key) == 0; j++) {
+                tt_clashing[s[i].entry] = tt_clashing[s[j].entry] = true;
+                if (clash_pair_count < MAX_CLASHES) clash_pairs[clash_pair_count++] = (ClashPair){ s[i].entry, s[j].entry, (ClashKind)k };
+                clash_total++;
+            }
+        }
+    }
+    clash_version = tt_version;
+    TraceLog(LOG_INFO, "ACADFAC: Clash index over %d entries rebuilt in %.3f ms, %d clashes.", tt_count, (GetTime() - start) * 1000.0, clash_total);
+}
+
+static int clash_query(const ClashSlot *s, int lo, int hi, int start, int end, int *out, int max, int found) {
+    if (lo >= hi) return found;
+    int mid = lo + (hi - lo) / 2;
+    if (s[mid].maxEnd <= start) return found;   // Everything below ends before the query
+    found = clash_query(s, lo, mid, start, end, out, max, found);
+    if (s[mid].start >= end) return found;      // Everything to the right starts after it
+    if (times_overlap_minutes(start, end, s[mid].start, s[mid].end)) { if (found < max) out[found] = s[mid].entry; found++; }
+    return clash_query(s, mid + 1, hi, start, end, out, max, found);
+}
+
+// Entries booked under the same kind/key that overlap [start, end) on day. Returns how many;
+// the first max of them are written to out.
+static int FindClashes(ClashKind kind, int day, const char *key, int start, int end, int *out, int max) {
+    if (!key) return 0;
+    if (clash_version != tt_version) RebuildClashIndex();
+    int lo, hi;
+    clash_find_run(kind, day, key, &lo, &hi);
+    return clash_query(clash_slots[kind], lo, hi, start, end, out, max, 0);
+}
+
+// True if e can be added; otherwise clash_status says what it collides with
+static bool TimetableSlotFree(const TimetableEntry *e) {
+    for (int k = 0; k < CLASH_KIND_COUNT; k++) {
+        int hit;
+        if (FindClashes((ClashKind)k, e->day, clash_key(e, (ClashKind)k), e->start, e->end, &hit, 1) == 0) continue;
+        const TimetableEntry *ex = &tt_entries[hit];
+        snprintf(clash_status, sizeof(clash_status), "%s clash: %s %02d:%02d-%02d:%02d %s", CLASH_KIND_NAMES[k], DAYS[ex->day],
+            ex->start/60, ex->start%60, ex->end/60, ex->end%60, TimetableString(&tt_strings, ex->title));
+        return false;
+    }
+    clash_status[0] = 0;
+    return true;
+}
+
+// Room/professor clashes among entries of one type, under the grid
+static void DrawClashList(int x, int y, TTType type) {
+    if (clash_version != tt_version) RebuildClashIndex();
+    int shown = 0, total = 0;
+    for (int i = 0; i < clash_pair_count; i++) {
+        const TimetableEntry *a = &tt_entries[clash_pairs[i].a], *b = &tt_entries[clash_pairs[i].b];
+        if (a->type != type) continue;
+        total++;
+        if (shown >= 4) continue;
+        const char *key = TimetableString(&tt_strings, clash_pairs[i].kind == CLASH_ROOM ? a->room : a->professor);
+        DrawText(TextFormat("%s %s  %s: %s %02d:%02d / %s %02d:%02d", CLASH_KIND_NAMES[clash_pairs[i].kind], key, DAYS[a->day],
+            TimetableString(&tt_strings, a->title), a->start/60, a->start%60,
+            TimetableString(&tt_strings, b->title), b->start/60, b->start%60), x, y + 30 + shown*24, 20, MAROON);
+        shown++;
+    }
+    if (total == 0) return;
+    if (clash_total > clash_pair_count) DrawText(TextFormat("Clashes: %d+ (showing %d)", total, shown), x, y, 22, RED);
+    else DrawText(TextFormat("Clashes: %d (showing %d)", total, shown), x, y, 22, RED);
+}
+
 // ---------------- Timetable grid (MODIFIED) ----------------
+static TimetableView tt_view;           // tt_entries grouped by type and day for the grids
+static int tt_view_version = 0;
+static GridCache tt_grid_cache[2];      // Drawn lecture and lab grids, redrawn when tt_version changes
+#define TT_GRID_LABEL_H 30              // Day names sit above the grid
+
 // MODIFIED: Increased font size *inside* the event boxes
-void DrawTimetableGridFixed(int x, int y, int w, int h, int showLabs) {
+// Grid lines, time labels and entry boxes; returns how many raylib draw calls that took
+static int DrawTimetableLayers(int x, int y, int w, int h, int showLabs) {
     int timeColW = 120;
     int daysCols = 5;
     int contentW = w - timeColW;
@@ -288,37 +806,53 @@ void DrawTimetableGridFixed(int x, int y, int w, int h, int showLabs) {
     for (int r=0;r<=rows;r++) {
         DrawLine(x + timeColW, y + r*cellH, x + timeColW + contentW, y + r*cellH, LIGHTGRAY);
     }
+    int calls = 3 + rows*2 + daysCols*2 + rows + 1;
+
+    TTType type = showLabs ? TT_LAB : TT_LECTURE;
+    for (int day=0; day<daysCols; day++) {
+        for (int k=TimetableRunBegin(&tt_view, type, day); k<TimetableRunEnd(&tt_view, type, day); k++) {
+            float startTotal = tt_view.start[k] / 60.0f;
+            float endTotal   = tt_view.end[k] / 60.0f;
+            if (endTotal <= visibleStart || startTotal >= visibleEnd) continue;
+            if (startTotal < visibleStart) startTotal = visibleStart;
+            if (endTotal > visibleEnd) endTotal = visibleEnd;
+
+            float startOffset = startTotal - visibleStart;
+            float endOffset = endTotal - visibleStart;
+            float ry = y + (startOffset / visibleRange) * h;
+            float rh = (endOffset - startOffset) / visibleRange * h;
+            if (rh < 6.0f) rh = 6.0f;
+
+            int rx = x + timeColW + day * cellW + 4;
+            int rw = cellW - 8;
+
+            Color bg = showLabs ? Fade(GREEN,0.8f) : Fade(SKYBLUE,0.6f);
+            DrawRectangle(rx, (int)ry + 4, rw, (int)rh - 6, bg);
+            DrawRectangleLines(rx, (int)ry + 4, rw, (int)rh - 6, tt_clashing[tt_view.entry[k]] ? RED : DARKGRAY);
+
+            // MODIFIED: Fonts and y-offsets
+            DrawText(TimetableString(&tt_strings, tt_view.title[k]), rx + 6, (int)ry + 8, 20, BLACK); 
+            char info[128]; snprintf(info, sizeof(info), "%02d:%02d-%02d:%02d @%s", tt_view.start[k]/60, tt_view.start[k]%60,
+                tt_view.end[k]/60, tt_view.end[k]%60, TimetableString(&tt_strings, tt_view.room[k]));
+            DrawText(info, rx + 6, (int)ry + 34, 18, DARKGRAY);
+            calls += 4;
+        }
+    }
+    return calls;
+}
 
-    for (int i=0;i<tt_count;i++) {
-        TimetableEntry *e = &tt_entries[i];
-        if (e->day < 0 || e->day >= 5) continue;
-        if (showLabs) { if (e->type != TT_LAB) continue; } 
-        else { if (e->type != TT_LECTURE) continue; }
-
-        float startTotal = e->start_h + e->start_m/60.0f;
-        float endTotal   = e->end_h   + e->end_m/60.0f;
-        if (endTotal <= visibleStart || startTotal >= visibleEnd) continue;
-        if (startTotal < visibleStart) startTotal = visibleStart;
-        if (endTotal > visibleEnd) endTotal = visibleEnd;
-
-        float startOffset = startTotal - visibleStart;
-        float endOffset = endTotal - visibleStart;
-        float ry = y + (startOffset / visibleRange) * h;
-        float rh = (endOffset - startOffset) / visibleRange * h;
-        if (rh < 6.0f) rh = 6.0f;
-
-        int rx = x + timeColW + e->day * cellW + 4;
-        int rw = cellW - 8;
-
-        Color bg = (e->type == TT_LAB) ? Fade(GREEN,0.8f) : Fade(SKYBLUE,0.6f);
-        DrawRectangle(rx, (int)ry + 4, rw, (int)rh - 6, bg);
-        DrawRectangleLines(rx, (int)ry + 4, rw, (int)rh - 6, DARKGRAY);
-
-        // MODIFIED: Fonts and y-offsets
-        DrawText(e->title, rx + 6, (int)ry + 8, 20, BLACK); 
-        char info[128]; sprintf(info, "%02d:%02d-%02d:%02d @%s", e->start_h, e->start_m, e->end_h, e->end_m, e->room);
-        DrawText(info, rx + 6, (int)ry + 34, 18, DARKGRAY);
+// Draws the cached layers; they are only redrawn after an Add or Delete
+void DrawTimetableGridFixed(int x, int y, int w, int h, int showLabs) {
+    if (clash_version != tt_version) RebuildClashIndex();
+    if (tt_view_version != tt_version) { TimetableBuildView(&tt_view, tt_entries, tt_count); tt_view_version = tt_version; }
+    GridCache *cache = &tt_grid_cache[showLabs ? 1 : 0];
+    int width = w + 1, height = TT_GRID_LABEL_H + h + 1;   // Lines on the right and bottom edge
+    if (!GridCacheFresh(cache, width, height, tt_version)) {
+        if (!GridCacheBegin(cache, width, height, RAYWHITE)) { DrawTimetableLayers(x, y, w, h, showLabs); return; }
+        DrawTimetableLayers(0, TT_GRID_LABEL_H, w, h, showLabs);
+        GridCacheEnd(cache, tt_version);
     }
+    GridCacheDraw(cache, x, y - TT_GRID_LABEL_H);
 }
 
 // ---------------- UI STATE ----------------
@@ -328,11 +862,12 @@ int active_tab = 0;
 // Inputs
 InputBox ib_tt_title, ib_tt_room, ib_tt_prof, ib_tt_start, ib_tt_end; int ib_tt_day = 0;
 InputBox ib_lab_title, ib_lab_room, ib_lab_prof, ib_lab_start, ib_lab_end; int ib_lab_day = 0;
-InputBox ib_assign_title, ib_assign_due, ib_assign_desc, ib_assign_issuedby;
-InputBox ib_event_title, ib_event_date, ib_event_desc;
+InputBox ib_assign_title, ib_assign_due, ib_assign_desc, ib_assign_issuedby, ib_assign_student, ib_assign_ref;
+InputBox ib_event_title, ib_event_date, ib_event_desc, ib_event_end; int ib_event_type = CAL_HOLIDAY;
 InputBox ib_sem_name, ib_sem_start, ib_sem_end, ib_sem_credit;
-InputBox ib_att_subject, ib_att_total, ib_att_attended;
+InputBox ib_att_subject, ib_att_students, ib_att_absent;
 InputBox ib_res_subject, ib_res_credits, ib_res_earned, ib_res_spi, ib_res_grade, ib_res_remarks, ib_res_id;
+InputBox ib_res_import;
 
 // ---------------- UI Draw Functions (MODIFIED) ----------------
 void DrawHeader(int screenWidth) {
@@ -361,6 +896,7 @@ void DrawHeader(int screenWidth) {
 void Tab_Timetable(int x, int y, int w, int sidebarX) {
     DrawText("Lecture Timetable", x, y, 30, DARKBLUE);
     DrawTimetableGridFixed(x, y+50, w, 700, 0); // MODIFIED: Height
+    DrawClashList(x, y+770, TT_LECTURE);
 
     // --- Sidebar Form (Sequentially Drawn) ---
     DrawText("Add Lecture", sidebarX, y, 26, DARKBLUE);
@@ -413,34 +949,29 @@ void Tab_Timetable(int x, int y, int w, int sidebarX) {
 
     if (ButtonRect((Rectangle){(float)sidebarX, (float)formY, 220, 40}, "Add Lecture")) {
         // ... [Add logic is unchanged] ...
-        if (tt_count < MAX_ENTRIES) {
+        if (tt_count < MAX_TT_ENTRIES) {
             TimetableEntry e; memset(&e,0,sizeof(e));
             e.day = ib_tt_day;
-            e.start_h = 8; e.start_m = 0; e.end_h = 9; e.end_m = 0;
-            if (sscanf(ib_tt_start.text, "%d:%d", &e.start_h, &e.start_m) < 1) { e.start_h = 8; e.start_m = 0; }
-            if (sscanf(ib_tt_end.text, "%d:%d", &e.end_h, &e.end_m) < 1) { e.end_h = e.start_h + 1; e.end_m = 0; }
-            if ((e.end_h*60 + e.end_m) <= (e.start_h*60 + e.start_m)) { e.end_h = e.start_h + 1; e.end_m = 0; }
-            if (e.start_h < 8) { e.start_h = 8; e.start_m = 0; }
-            if (e.end_h > 12) { e.end_h = 12; e.end_m = 0; }
-            if (e.start_h > 12) { e.start_h = 12; e.start_m = 0; }
-            if (e.end_h < 8) { e.end_h = 8; e.end_m = 0; }
-            scpy(e.title, ib_tt_title.text[0] ? ib_tt_title.text : "Untitled Lecture");
-            scpy(e.room, ib_tt_room.text[0] ? ib_tt_room.text : "Room");
-            scpy(e.professor, ib_tt_prof.text[0] ? ib_tt_prof.text : "Prof");
+            int start_h = 8, start_m = 0, end_h = 9, end_m = 0;
+            if (sscanf(ib_tt_start.text, "%d:%d", &start_h, &start_m) < 1) { start_h = 8; start_m = 0; }
+            if (sscanf(ib_tt_end.text, "%d:%d", &end_h, &end_m) < 1) { end_h = start_h + 1; end_m = 0; }
+            if ((end_h*60 + end_m) <= (start_h*60 + start_m)) { end_h = start_h + 1; end_m = 0; }
+            if (start_h < 8) { start_h = 8; start_m = 0; }
+            if (end_h > 12) { end_h = 12; end_m = 0; }
+            if (start_h > 12) { start_h = 12; start_m = 0; }
+            if (end_h < 8) { end_h = 8; end_m = 0; }
+            e.start = (uint16_t)(start_h*60 + start_m); e.end = (uint16_t)(end_h*60 + end_m);
+            e.title = TimetableIntern(&tt_strings, ib_tt_title.text[0] ? ib_tt_title.text : "Untitled Lecture");
+            e.room = TimetableIntern(&tt_strings, ib_tt_room.text[0] ? ib_tt_room.text : TT_DEFAULT_ROOM);
+            e.professor = TimetableIntern(&tt_strings, ib_tt_prof.text[0] ? ib_tt_prof.text : TT_DEFAULT_PROF);
             e.type = TT_LECTURE;
             e.id = (tt_count>0 ? tt_entries[tt_count-1].id + 1 : 1);
-            int new_start = e.start_h*60 + e.start_m; int new_end   = e.end_h*60 + e.end_m; int overlap = 0;
-            for (int k=0;k<tt_count;k++) {
-                TimetableEntry *ex = &tt_entries[k];
-                if (ex->day != e.day || ex->type != TT_LECTURE) continue;
-                int ex_start = ex->start_h*60 + ex->start_m; int ex_end = ex->end_h*60 + ex->end_m;
-                if (times_overlap_minutes(new_start,new_end, ex_start, ex_end)) { overlap = 1; break; }
-            }
-            if (!overlap) { tt_entries[tt_count++] = e; save_timetable(); }
+            if (TimetableSlotFree(&e)) { tt_entries[tt_count++] = e; tt_version++; mark_dirty(TABLE_TT); }
         }
     }
-    if (ButtonRect((Rectangle){(float)sidebarX + 230, (float)formY, 180, 40}, "Save Timetable")) save_timetable();
+    if (ButtonRect((Rectangle){(float)sidebarX + 230, (float)formY, 180, 40}, "Save Timetable")) save_tables(TABLE_TT);
     formY += 40 + fieldSpacing;
+    if (clash_status[0]) { DrawText(clash_status, sidebarX, formY, 18, RED); formY += 24; }
 
     DrawText("Entries (Lectures Only):", sidebarX, formY, 20, DARKGRAY);
     formY += 30;
@@ -449,12 +980,12 @@ void Tab_Timetable(int x, int y, int w, int sidebarX) {
         TimetableEntry *e = &tt_entries[i];
         if (e->type != TT_LECTURE) continue;
         char buf[256];
-        sprintf(buf, "%s %02d:%02d @%s", DAYS[e->day], e->start_h, e->start_m, e->title);
+        sprintf(buf, "%s %02d:%02d @%s", DAYS[e->day], e->start/60, e->start%60, TimetableString(&tt_strings, e->title));
         DrawText(buf, sidebarX, ly, 20, BLACK);
         Rectangle del = {sidebarX + 300, ly - 5, 100, 30};
         if (ButtonRect(del, "Delete")) {
             for (int k=i;k<tt_count-1;k++) tt_entries[k] = tt_entries[k+1];
-            tt_count--; save_timetable(); break;
+            tt_count--; tt_version++; mark_dirty(TABLE_TT); break;
         }
         ly += 40;
         if (ly > 820) break;
@@ -466,6 +997,7 @@ void Tab_Timetable(int x, int y, int w, int sidebarX) {
 void Tab_Labs(int x, int y, int w, int sidebarX) {
     DrawText("Lab Timetable", x, y, 30, DARKBLUE);
     DrawTimetableGridFixed(x, y+50, w, 700, 1);
+    DrawClashList(x, y+770, TT_LAB);
 
     // --- Sidebar Form (Sequentially Drawn) ---
     DrawText("Add Lab", sidebarX, y, 26, DARKBLUE);
@@ -518,61 +1050,118 @@ void Tab_Labs(int x, int y, int w, int sidebarX) {
     
     if (ButtonRect((Rectangle){(float)sidebarX, (float)formY, 220, 40}, "Add Lab")) {
         // ... [Add logic is unchanged] ...
-        if (tt_count < MAX_ENTRIES) {
+        if (tt_count < MAX_TT_ENTRIES) {
             TimetableEntry e; memset(&e,0,sizeof(e));
             e.day = ib_lab_day;
-            e.start_h = 14; e.start_m = 0; e.end_h = 15; e.end_m = 0;
-            if (sscanf(ib_lab_start.text, "%d:%d", &e.start_h, &e.start_m) < 1) { e.start_h = 14; e.start_m = 0; }
-            if (sscanf(ib_lab_end.text, "%d:%d", &e.end_h, &e.end_m) < 1) { e.end_h = e.start_h + 1; e.end_m = 0; }
-            if ((e.end_h*60 + e.end_m) <= (e.start_h*60 + e.start_m)) { e.end_h = e.start_h + 1; e.end_m = 0; }
-            if (e.start_h < 14) { e.start_h = 14; e.start_m = 0; }
-            if (e.end_h > 18) { e.end_h = 18; e.end_m = 0; }
-            if (e.start_h > 18) { e.start_h = 18; e.start_m = 0; }
-            if (e.end_h < 14) { e.end_h = 14; e.end_m = 0; }
-            scpy(e.title, ib_lab_title.text[0] ? ib_lab_title.text : "Lab");
-            scpy(e.room, ib_lab_room.text[0] ? ib_lab_room.text : "Room");
-            scpy(e.professor, ib_lab_prof.text[0] ? ib_lab_prof.text : "Prof");
+            int start_h = 14, start_m = 0, end_h = 15, end_m = 0;
+            if (sscanf(ib_lab_start.text, "%d:%d", &start_h, &start_m) < 1) { start_h = 14; start_m = 0; }
+            if (sscanf(ib_lab_end.text, "%d:%d", &end_h, &end_m) < 1) { end_h = start_h + 1; end_m = 0; }
+            if ((end_h*60 + end_m) <= (start_h*60 + start_m)) { end_h = start_h + 1; end_m = 0; }
+            if (start_h < 14) { start_h = 14; start_m = 0; }
+            if (end_h > 18) { end_h = 18; end_m = 0; }
+            if (start_h > 18) { start_h = 18; start_m = 0; }
+            if (end_h < 14) { end_h = 14; end_m = 0; }
+            e.start = (uint16_t)(start_h*60 + start_m); e.end = (uint16_t)(end_h*60 + end_m);
+            e.title = TimetableIntern(&tt_strings, ib_lab_title.text[0] ? ib_lab_title.text : "Lab");
+            e.room = TimetableIntern(&tt_strings, ib_lab_room.text[0] ? ib_lab_room.text : TT_DEFAULT_ROOM);
+            e.professor = TimetableIntern(&tt_strings, ib_lab_prof.text[0] ? ib_lab_prof.text : TT_DEFAULT_PROF);
             e.type = TT_LAB;
             e.id = (tt_count>0 ? tt_entries[tt_count-1].id + 1 : 1);
-            int new_start = e.start_h*60 + e.start_m; int new_end   = e.end_h*60 + e.end_m; int overlap = 0;
-            for (int k=0;k<tt_count;k++) {
-                TimetableEntry *ex = &tt_entries[k];
-                if (ex->day != e.day || ex->type != TT_LAB) continue;
-                int ex_start = ex->start_h*60 + ex->start_m; int ex_end = ex->end_h*60 + ex->end_m;
-                if (times_overlap_minutes(new_start,new_end, ex_start, ex_end)) { overlap = 1; break; }
-            }
-            if (!overlap) { tt_entries[tt_count++] = e; save_timetable(); }
+            if (TimetableSlotFree(&e)) { tt_entries[tt_count++] = e; tt_version++; mark_dirty(TABLE_TT); }
         }
     }
 
     formY += 40 + fieldSpacing;
+    if (clash_status[0]) { DrawText(clash_status, sidebarX, formY, 18, RED); formY += 24; }
     DrawText("Entries (Labs Only):", sidebarX, formY, 20, DARKGRAY);
     formY += 30;
     int ly = formY;
     for (int i=0;i<tt_count;i++) {
         if (tt_entries[i].type != TT_LAB) continue;
         TimetableEntry *e = &tt_entries[i];
-        char buf[256]; sprintf(buf, "%s %02d:%02d @%s", DAYS[e->day], e->start_h,e->start_m, e->title);
+        char buf[256]; sprintf(buf, "%s %02d:%02d @%s", DAYS[e->day], e->start/60, e->start%60, TimetableString(&tt_strings, e->title));
         DrawText(buf, sidebarX, ly, 20, BLACK);
         Rectangle del = {sidebarX + 300, ly - 5, 100, 30};
         if (ButtonRect(del, "Delete")) {
             for (int k=i;k<tt_count-1;k++) tt_entries[k] = tt_entries[k+1];
-            tt_count--; save_timetable(); break;
+            tt_count--; tt_version++; mark_dirty(TABLE_TT); break;
         }
         ly += 40; if (ly > 820) break;
     }
 }
 
 // ---------------- Assignments Tab (MODIFIED) ----------------
-// MODIFIED: Reworked sidebar layout to be sequential
-void Tab_Assign(int x, int y, int w, int sidebarX) {
-    DrawText("Assignments", x, y, 30, DARKBLUE);
+static bool assign_show_overdue = false;
+static char assign_status[MAX_STR] = "";
+
+// Overdue assignments across the cohort, recomputed when the tracker or the date changes
+#define OVERDUE_ROWS 14
+#define OVERDUE_NAMES 4                 // Missing students named per row
+typedef struct { int task, missing; char names[128]; } OverdueRow;
+static OverdueRow overdue_rows[OVERDUE_ROWS];
+static int overdue_count = 0, overdue_tasks = 0, overdue_version = 0;
+static int32_t overdue_today = 0;
+static long overdue_missing = 0;
+
+static const Assignment *assignment_by_id(int id) {
+    for (int i=0;i<assign_count;i++) if (assignments[i].id == id) return &assignments[i];
+    return NULL;
+}
 
-    // Left: list area
-    int listX = x, listY = y + 50, listW = w, listH = 700;
-    DrawRectangle(listX, listY, listW, listH, RAYWHITE);
-    DrawRectangleLines(listX, listY, listW, listH, LIGHTGRAY);
+static void refresh_overdue(void) {
+    int32_t today = DeadlineToday();
+    if (overdue_version == deadlines_version && overdue_today == today) return;
+    overdue_version = deadlines_version; overdue_today = today;
+    overdue_missing = DeadlineOverdueCount(&deadlines, today, &overdue_tasks);
+    int tasks[OVERDUE_ROWS], students[OVERDUE_NAMES];
+    int n = DeadlineOverdueFor(&deadlines, -1, today, tasks, OVERDUE_ROWS);
+    overdue_count = 0;
+    for (int r=n-1;r>=0;r--) {          // Most recently due first
+        OverdueRow *row = &overdue_rows[overdue_count];
+        row->task = tasks[r];
+        row->missing = DeadlineMissing(&deadlines, tasks[r], students, OVERDUE_NAMES);
+        if (row->missing == 0) continue;
+        row->names[0] = 0;
+        for (int k=0;k<row->missing && k<OVERDUE_NAMES;k++) {
+            strncat(row->names, deadlines.students[students[k]].id, sizeof(row->names) - strlen(row->names) - 1);
+            if (k+1 < row->missing && k+1 < OVERDUE_NAMES) strncat(row->names, ", ", sizeof(row->names) - strlen(row->names) - 1);
+        }
+        if (row->missing > OVERDUE_NAMES) strncat(row->names, " ...", sizeof(row->names) - strlen(row->names) - 1);
+        overdue_count++;
+    }
+}
 
+static void DrawOverduePanel(int listX, int listY, int listW, int listH) {
+    refresh_overdue();
+    char date[32];
+    DrawText(TextFormat("%ld hand-ins missing across %d overdue assignments, %d students (as of %s)", overdue_missing, overdue_tasks,
+             deadlines.studentCount, CalendarFormatDate(overdue_today, date, sizeof(date))), listX+10, listY+10, 20, DARKBLUE);
+    DrawText("ID", listX+10, listY+50, 20, DARKGRAY);
+    DrawText("Title", listX+70, listY+50, 20, DARKGRAY);
+    DrawText("Due", listX+380, listY+50, 20, DARKGRAY);
+    DrawText("Handed in", listX+520, listY+50, 20, DARKGRAY);
+    DrawText("Missing", listX+650, listY+50, 20, DARKGRAY);
+    DrawText("Not handed in", listX+770, listY+50, 20, DARKGRAY);
+    DrawLine(listX, listY+80, listX+listW, listY+80, LIGHTGRAY);
+
+    int ly = listY + 90;
+    for (int r=0;r<overdue_count;r++) {
+        const OverdueRow *row = &overdue_rows[r];
+        const DeadlineTask *t = &deadlines.tasks[row->task];
+        const Assignment *a = assignment_by_id(t->id);
+        DrawText(TextFormat("%d", t->id), listX+10, ly, 20, BLACK);
+        DrawText(a ? a->title : "?", listX+70, ly, 20, BLACK);
+        DrawText(CalendarFormatDate(t->due, date, sizeof(date)), listX+380, ly, 20, BLACK);
+        DrawText(TextFormat("%d", t->submitted), listX+520, ly, 20, BLACK);
+        DrawText(TextFormat("%d", row->missing), listX+650, ly, 20, RED);
+        DrawText(row->names, listX+770, ly, 20, DARKGRAY);
+        ly += 44; if (ly > listY + listH - 30) break;
+    }
+    if (overdue_count == 0) DrawText("Nothing overdue.", listX+10, ly, 20, DARKGRAY);
+}
+
+// The assignment rows; the ID is what Record Hand-in asks for
+static void DrawAssignmentRows(int listX, int listY, int listW, int listH) {
     DrawText("Title", listX+10, listY+10, 20, DARKGRAY);
     DrawText("Due", listX+320, listY+10, 20, DARKGRAY);
     DrawText("Status", listX+450, listY+10, 20, DARKGRAY);
@@ -583,27 +1172,30 @@ void Tab_Assign(int x, int y, int w, int sidebarX) {
     int ly = listY + 50;
     for (int i=0;i<assign_count;i++) {
         Assignment *a = &assignments[i];
-        DrawText(a->title, listX+10, ly, 20, BLACK);
+        DrawText(TextFormat("%d. %s", a->id, a->title), listX+10, ly, 20, BLACK);
         DrawText(a->due_date, listX+320, ly, 20, BLACK);
         const char* st = a->status==ASSIGNED ? "Assigned" : a->status==PENDING ? "Pending" : "Submitted";
         Rectangle btn = {listX+450, ly-4, 110, 30};
         if (ButtonRect(btn, st)) {
             if (a->status == ASSIGNED) a->status = PENDING;
-            else if (a->status == PENDING) { a->status = SUBMITTED; scpy(a->submitted_date, "2025-10-27"); }
+            else if (a->status == PENDING) { a->status = SUBMITTED; scpy(a->submitted_date, sizeof(a->submitted_date), "2025-10-27"); }
             else a->status = ASSIGNED;
-            save_assignments();
+            mark_dirty(TABLE_ASSIGN);
         }
         DrawText(a->issued_by, listX+580, ly, 20, DARKGRAY);
         DrawText(a->desc, listX+750, ly, 20, DARKGRAY);
         
         Rectangle del = {listX+listW-100, ly-4, 80, 30};
         if (ButtonRect(del, "Delete")) {
+            DeadlineDropAssignment(&deadlines, a->id);
             for (int k=i;k<assign_count-1;k++) assignments[k]=assignments[k+1];
-            assign_count--; save_assignments(); break;
+            assign_count--; sync_deadlines(); mark_dirty(TABLE_ASSIGN | TABLE_PROGRESS); break;
         }
         ly += 44; if (ly > listY + listH - 30) break;
     }
+}
 
+static void DrawAssignSidebar(int sidebarX, int y) {
     // --- Sidebar Form (Sequentially Drawn) ---
     DrawText("Add / Edit Assignment", sidebarX, y, 26, DARKBLUE);
     
@@ -641,19 +1233,112 @@ void Tab_Assign(int x, int y, int w, int sidebarX) {
         if (assign_count < MAX_ENTRIES) {
             Assignment a; memset(&a,0,sizeof(a));
             a.id = assign_count>0 ? assignments[assign_count-1].id + 1 : 1;
-            scpy(a.title, ib_assign_title.text[0] ? ib_assign_title.text : "Untitled");
-            scpy(a.due_date, ib_assign_due.text[0] ? ib_assign_due.text : "YYYY-MM-DD");
-            scpy(a.issued_by, ib_assign_issuedby.text[0] ? ib_assign_issuedby.text : "Prof");
-            scpy(a.desc, ib_assign_desc.text[0] ? ib_assign_desc.text : "-");
-            a.status = ASSIGNED; scpy(a.submitted_date, "");
+            scpy(a.title, sizeof(a.title), ib_assign_title.text[0] ? ib_assign_title.text : "Untitled");
+            scpy(a.due_date, sizeof(a.due_date), ib_assign_due.text[0] ? ib_assign_due.text : "YYYY-MM-DD");
+            scpy(a.issued_by, sizeof(a.issued_by), ib_assign_issuedby.text[0] ? ib_assign_issuedby.text : "Prof");
+            scpy(a.desc, sizeof(a.desc), ib_assign_desc.text[0] ? ib_assign_desc.text : "-");
+            a.status = ASSIGNED; scpy(a.submitted_date, sizeof(a.submitted_date), "");
             assignments[assign_count++] = a;
-            save_assignments();
+            sync_deadlines(); mark_dirty(TABLE_ASSIGN);
+        }
+    }
+    if (ButtonRect((Rectangle){(float)sidebarX + 210, (float)formY, 200, 40}, "Save Assignments")) save_tables(TABLE_ASSIGN | TABLE_PROGRESS);
+    formY += 40 + fieldSpacing * 3;
+
+    // One student's state for one assignment
+    DrawText("Record Hand-in", sidebarX, formY, 26, DARKBLUE);
+    formY += 40;
+    DrawText("Student ID:", sidebarX, formY, 20, BLACK);
+    DrawText("Assignment ID:", sidebarX + 230, formY, 20, BLACK);
+    formY += labelOffset;
+    ib_assign_student.rect = (Rectangle){(float)sidebarX, (float)formY, 210, (float)inputH};
+    DrawInput(&ib_assign_student, "Student ID");
+    ib_assign_ref.rect = (Rectangle){(float)sidebarX + 230, (float)formY, 210, (float)inputH};
+    DrawInput(&ib_assign_ref, "ID");
+    formY += inputH + fieldSpacing;
+
+    static const struct { const char *label; DeadlineState state; } marks[] = {
+        { "Submitted", DL_SUBMITTED }, { "Pending", DL_PENDING }, { "Reset", DL_ASSIGNED },
+    };
+    for (int m=0;m<3;m++) {
+        if (!ButtonRect((Rectangle){(float)sidebarX + m*150, (float)formY, 140, 40}, marks[m].label)) continue;
+        // Only students from student_info.txt are tracked; one registered since the window
+        // opened is picked up by re-reading it, a typo is rejected
+        int task = DeadlineFindTask(&deadlines, atoi(ib_assign_ref.text));
+        int student = DeadlineFindStudent(&deadlines, ib_assign_student.text);
+        if (student < 0 && ib_assign_student.text[0] && task >= 0) { load_cohort(); student = DeadlineFindStudent(&deadlines, ib_assign_student.text); }
+        if (!ib_assign_student.text[0]) snprintf(assign_status, sizeof(assign_status), "Enter a student ID.");
+        else if (task < 0) snprintf(assign_status, sizeof(assign_status), "No assignment with that ID.");
+        else if (student < 0) snprintf(assign_status, sizeof(assign_status), "No student %.40s in %s.", ib_assign_student.text, FILE_STUDENTS);
+        else if (!DeadlineSetTaskState(&deadlines, task, student, marks[m].state, DeadlineToday())) snprintf(assign_status, sizeof(assign_status), "Could not record the hand-in.");
+        else {
+            DeadlineState now = DeadlineStateOf(&deadlines, student, atoi(ib_assign_ref.text));
+            snprintf(assign_status, sizeof(assign_status), "%.40s: assignment %.12s is %s.", ib_assign_student.text, ib_assign_ref.text, DEADLINE_STATE_NAMES[now]);
+            deadlines_version++; mark_dirty(TABLE_PROGRESS);
         }
     }
-    if (ButtonRect((Rectangle){(float)sidebarX + 210, (float)formY, 200, 40}, "Save Assignments")) save_assignments();
+    formY += 40 + fieldSpacing;
+    if (assign_status[0]) DrawText(assign_status, sidebarX, formY, 18, DARKGRAY);
+}
+
+// MODIFIED: Reworked sidebar layout to be sequential
+void Tab_Assign(int x, int y, int w, int sidebarX) {
+    DrawText("Assignments", x, y, 30, DARKBLUE);
+    if (ButtonRect((Rectangle){(float)(x+w-180), (float)y, 180, 36}, assign_show_overdue ? "Show All" : "Overdue")) {
+        assign_show_overdue = !assign_show_overdue;
+    }
+
+    // Left: list area
+    int listX = x, listY = y + 50, listW = w, listH = 700;
+    DrawRectangle(listX, listY, listW, listH, RAYWHITE);
+    DrawRectangleLines(listX, listY, listW, listH, LIGHTGRAY);
+    if (assign_show_overdue) DrawOverduePanel(listX, listY, listW, listH);
+    else DrawAssignmentRows(listX, listY, listW, listH);
+    DrawAssignSidebar(sidebarX, y);
 }
 
 // ---------------- Semester Tab (MODIFIED) ----------------
+static const char* CAL_TAB_LABELS[CAL_TYPE_COUNT] = {"Holiday","Exam","Test","Orient.","Deadline"};
+static const char* CAL_LIST_TITLES[CAL_TYPE_COUNT] = {"Holidays","Exams:","Tests:","Orientation:","Deadlines:"};
+static char calendar_status[MAX_STR] = "";
+
+// Holidays of the semester's year on the left, the other event types on the right.
+// With editable set, each event gets an X that removes it.
+static void DrawCalendarLists(int x, int y, bool editable) {
+    int year = atoi(seminfo.start_date);
+    if (year < 1900) year = 2025;
+    char header[64]; snprintf(header, sizeof(header), "Official Holiday List %d", year);
+    DrawText(header, x, y, 24, DARKBLUE);
+
+    int begin, end;
+    CalendarRange(&calendar, year*10000 + 101, year*10000 + 1231, &begin, &end);
+    int hy = y + 40, ey = y, ex = x + 700;
+    for (int t=1; t<CAL_TYPE_COUNT; t++) {
+        bool shown = false;
+        for (int i=begin; i<end; i++) {
+            CalendarEvent *e = &calendar.events[i];
+            if (e->type != t || e->end < year*10000 + 101) continue;
+            if (!shown) { DrawText(CAL_LIST_TITLES[t], ex, ey, 24, DARKBLUE); ey += 40; shown = true; }
+            char from[16], to[16], line[256];
+            if (e->end != e->start) snprintf(line, sizeof(line), "%s: %s -> %s", e->title, CalendarFormatDate(e->start, from, 16), CalendarFormatDate(e->end, to, 16));
+            else snprintf(line, sizeof(line), "%s: %s", e->title, CalendarFormatDate(e->start, from, 16));
+            DrawText(line, ex, ey, 20, BLACK);
+            if (editable && ButtonRect((Rectangle){(float)ex + 560, (float)ey - 4, 30, 28}, "X")) { CalendarRemove(&calendar, i); mark_dirty(TABLE_SEM); return; }
+            ey += 30;
+        }
+        if (shown) ey += 10;
+    }
+    for (int i=begin; i<end; i++) {
+        CalendarEvent *e = &calendar.events[i];
+        if (e->type != CAL_HOLIDAY || e->end < year*10000 + 101) continue;
+        char date[16], line[256];
+        snprintf(line, sizeof(line), "%s (%s)  -  %s", CalendarFormatDate(e->start, date, 16), CalendarWeekdayName(e->start), e->title);
+        DrawText(line, x, hy, 20, BLACK);
+        if (editable && ButtonRect((Rectangle){(float)x + 620, (float)hy - 4, 30, 28}, "X")) { CalendarRemove(&calendar, i); mark_dirty(TABLE_SEM); return; }
+        hy += 30;
+    }
+}
+
 // MODIFIED: Reworked sidebar layout to be sequential
 void Tab_Sem(int x, int y, int w, int sidebarX) {
     DrawText("Semester Information & Calendar", x, y, 30, DARKBLUE);
@@ -667,20 +1352,7 @@ void Tab_Sem(int x, int y, int w, int sidebarX) {
     DrawText(credBuf, x, mainY, 20, BLACK);
 
     mainY += 60;
-    DrawText("Official Holiday List 2025", x, mainY, 24, DARKBLUE);
-    int hy = mainY + 40;
-    DrawText("26/01/2025 (Sunday)  -  Republic Day", x, hy, 20, BLACK); hy += 30;
-    DrawText("26/02/2025 (Wednesday)  -  Maha Shivaratri", x, hy, 20, BLACK); hy += 30;
-    DrawText("14/03/2025 (Friday)  -  Holi / Dhulivandan", x, hy, 20, BLACK); hy += 30;
-    DrawText("15/08/2025 (Friday)  -  Independence Day", x, hy, 20, BLACK); hy += 30;
-    DrawText("02/10/2025 (Thursday)  -  Mahatma Gandhi’s Birthday", x, hy, 20, BLACK); hy += 30;
-    DrawText("25/12/2025 (Thursday)  -  Christmas Day", x, hy, 20, BLACK); hy += 30;
-    
-    int ex = x + 700;
-    int ey = mainY + 40;
-    DrawText("Exams:", ex, mainY, 24, DARKBLUE);
-    DrawText("MIDESEM: 03/10/2025 -> 08/10/2025", ex, ey, 20, BLACK); ey += 40;
-    DrawText("ENDESEM: 03/12/2025 -> 08/12/2025", ex, ey, 20, BLACK); ey += 20;
+    DrawCalendarLists(x, mainY, true);
 
     // --- Sidebar Form (Sequentially Drawn) ---
     DrawText("Edit Semester / Add Items", sidebarX, y, 26, DARKBLUE);
@@ -714,53 +1386,178 @@ void Tab_Sem(int x, int y, int w, int sidebarX) {
     formY += inputH + fieldSpacing;
     
     if (ButtonRect((Rectangle){(float)sidebarX, (float)formY, 240, 40}, "Save Semester")) {
-        scpy(seminfo.semester_name, ib_sem_name.text[0] ? ib_sem_name.text : seminfo.semester_name);
-        scpy(seminfo.start_date, ib_sem_start.text[0] ? ib_sem_start.text : seminfo.start_date);
-        scpy(seminfo.end_date, ib_sem_end.text[0] ? ib_sem_end.text : seminfo.end_date);
+        scpy(seminfo.semester_name, sizeof(seminfo.semester_name), ib_sem_name.text[0] ? ib_sem_name.text : seminfo.semester_name);
+        scpy(seminfo.start_date, sizeof(seminfo.start_date), ib_sem_start.text[0] ? ib_sem_start.text : seminfo.start_date);
+        scpy(seminfo.end_date, sizeof(seminfo.end_date), ib_sem_end.text[0] ? ib_sem_end.text : seminfo.end_date);
         seminfo.total_credits = atoi(ib_sem_credit.text);
-        save_semester();
+        save_tables(TABLE_SEM);
     }
+    formY += 40 + fieldSpacing + 20;
+
+    DrawText("Add Calendar Event", sidebarX, formY, 24, DARKBLUE);
+    formY += 36;
+    for (int t=0; t<CAL_TYPE_COUNT; t++) {
+        Rectangle r = {sidebarX + t*88, formY, 84, 34};
+        DrawRectangleRec(r, t==ib_event_type ? Fade(BLUE,0.85f) : LIGHTGRAY);
+        DrawRectangleLines((int)r.x,(int)r.y,(int)r.width,(int)r.height,GRAY);
+        DrawText(CAL_TAB_LABELS[t], r.x+8, r.y+8, 16, BLACK);
+        Vector2 mp = GetMousePosition();
+        if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mp, r)) ib_event_type = t;
+    }
+    formY += 34 + fieldSpacing;
+
+    DrawText("Title:", sidebarX, formY, 20, BLACK);
+    formY += labelOffset;
+    ib_event_title.rect = (Rectangle){(float)sidebarX, (float)formY, (float)inputW, (float)inputH};
+    DrawInput(&ib_event_title, "e.g. Republic Day");
+    formY += inputH + fieldSpacing;
+
+    DrawText("From:", sidebarX, formY, 20, BLACK);
+    DrawText("To (optional):", sidebarX + inputW_half + 20, formY, 20, BLACK);
+    formY += labelOffset;
+    ib_event_date.rect = (Rectangle){(float)sidebarX, (float)formY, (float)inputW_half, (float)inputH};
+    DrawInput(&ib_event_date, "YYYY-MM-DD");
+    ib_event_end.rect = (Rectangle){(float)sidebarX + inputW_half + 20, (float)formY, (float)inputW_half, (float)inputH};
+    DrawInput(&ib_event_end, "YYYY-MM-DD");
+    formY += inputH + fieldSpacing;
+
+    if (ButtonRect((Rectangle){(float)sidebarX, (float)formY, 240, 40}, "Add Event")) {
+        int32_t start = CalendarParseDate(ib_event_date.text);
+        int32_t end = ib_event_end.text[0] ? CalendarParseDate(ib_event_end.text) : start;
+        if (start == 0 || end == 0) snprintf(calendar_status, sizeof(calendar_status), "Dates must be YYYY-MM-DD.");
+        else if (CalendarAdd(&calendar, (CalendarType)ib_event_type, start, end, ib_event_title.text[0] ? ib_event_title.text : "Untitled") >= 0) {
+            calendar_status[0] = 0;
+            mark_dirty(TABLE_SEM);
+        }
+    }
+    formY += 40 + fieldSpacing;
+    if (calendar_status[0]) DrawText(calendar_status, sidebarX, formY, 18, RED);
 }
 
 // ---------------- Attendance Tab (MODIFIED) ----------------
+// Per-subject figures are recomputed only when attendance_version moves
+typedef struct { int below, everyone, anyone; } AttendanceSubjectStats;
+static AttendanceSubjectStats *att_stats = NULL; static int att_stats_capacity = 0, att_stats_version = 0;
+static int *att_risk = NULL; static int att_risk_count = 0, att_risk_capacity = 0;   // Sets below the threshold
+static int att_selected = -1;           // Subject whose at-risk students are listed
+static char att_status[MAX_STR] = "";
+#define ATT_RECENT 5                    // "Missed last N" column
+
+static void refresh_attendance_stats(void) {
+    if (att_stats_version == attendance_version) return;
+    att_stats_version = attendance_version;
+    if (att_stats_capacity < attendance.subjectCount) {
+        att_stats_capacity = attendance.subjectCount * 2;
+        att_stats = (AttendanceSubjectStats *)realloc(att_stats, sizeof(AttendanceSubjectStats) * att_stats_capacity);
+    }
+    uint64_t words[ATTENDANCE_MAX_WORDS];
+    for (int i=0;i<attendance.subjectCount;i++) {
+        att_stats[i].below = AttendanceBelow(&attendance, i, ATTENDANCE_THRESHOLD, NULL, 0);
+        att_stats[i].everyone = AttendanceCombine(&attendance, i, true, words);
+        att_stats[i].anyone = AttendanceCombine(&attendance, i, false, words);
+    }
+    if (att_selected >= attendance.subjectCount) att_selected = -1;
+    att_risk_count = 0;
+    if (att_selected < 0) return;
+    int sets = attendance.subjects[att_selected].setCount;
+    if (att_risk_capacity < sets) { att_risk_capacity = sets * 2; att_risk = (int *)realloc(att_risk, sizeof(int) * att_risk_capacity); }
+    att_risk_count = AttendanceBelow(&attendance, att_selected, ATTENDANCE_THRESHOLD, att_risk, att_risk_capacity);
+}
+
+// Calls fn for each comma- or space-separated ID in text; returns how many fn accepted
+static int for_each_id(const char *text, bool (*fn)(const char *id, void *ctx), void *ctx) {
+    char buf[MAX_STR]; scpy(buf, sizeof(buf), text);
+    int accepted = 0;
+    for (char *id = strtok(buf, ", "); id; id = strtok(NULL, ", ")) if (fn(id, ctx)) accepted++;
+    return accepted;
+}
+
+static bool enroll_id(const char *id, void *ctx) {
+    int subject = *(int *)ctx, student = AttendanceAddStudent(&attendance, id);
+    if (student < 0) return false;
+    bool added = AttendanceFindSet(&attendance, subject, student) < 0;
+    AttendanceEnroll(&attendance, subject, student);
+    return added;
+}
+
+typedef struct { int ids[MAX_ENTRIES]; int count, unknown; } AbsentList;
+static bool absent_id(const char *id, void *ctx) {
+    AbsentList *list = (AbsentList *)ctx;
+    int student = AttendanceFindStudent(&attendance, id);
+    if (student < 0) { list->unknown++; return false; }
+    if (list->count < MAX_ENTRIES) list->ids[list->count++] = student;
+    return true;
+}
+
 // MODIFIED: Reworked sidebar layout to be sequential
 void Tab_Attendance(int x, int y, int w, int sidebarX) {
-    DrawText("Student Attendance (lecture-wise)", x, y, 30, DARKBLUE);
+    DrawText("Student Attendance (session-wise)", x, y, 30, DARKBLUE);
+    refresh_attendance_stats();
     
     int listX = x, listY = y + 50, listW = w, listH = 700;
     DrawRectangle(listX, listY, listW, listH, RAYWHITE);
     DrawRectangleLines(listX, listY, listW, listH, LIGHTGRAY);
     
     DrawText("Subject", x+10, y+60, 20, DARKGRAY);
-    DrawText("Total", x+400, y+60, 20, DARKGRAY);
-    DrawText("Attended", x+500, y+60, 20, DARKGRAY);
-    DrawText("Missed", x+620, y+60, 20, DARKGRAY);
-    DrawText("Percent", x+720, y+60, 20, DARKGRAY);
+    DrawText("Sessions", x+330, y+60, 20, DARKGRAY);
+    DrawText("Students", x+450, y+60, 20, DARKGRAY);
+    DrawText("Avg %", x+570, y+60, 20, DARKGRAY);
+    DrawText(TextFormat("< %d%%", ATTENDANCE_THRESHOLD), x+670, y+60, 20, DARKGRAY);
+    DrawText("All/Any present", x+770, y+60, 20, DARKGRAY);
     DrawLine(listX, listY+40, listX+listW, listY+40, LIGHTGRAY);
     
-    int ly = y+100;
-    for (int i=0;i<attendance_count;i++) {
-        AttendanceRecord *a = &attendance[i];
-        DrawText(a->subject, x+10, ly, 20, BLACK);
-        char buf[64]; sprintf(buf, "%d", a->total_lectures); DrawText(buf, x+400, ly, 20, BLACK);
-        sprintf(buf, "%d", a->attended); DrawText(buf, x+500, ly, 20, BLACK);
-        sprintf(buf, "%d", a->total_lectures - a->attended); DrawText(buf, x+620, ly, 20, BLACK);
-        float pct = a->total_lectures ? (100.0f * a->attended / a->total_lectures) : 0.0f;
-        char pctbuf[32]; sprintf(pctbuf, "%.1f%%", pct); DrawText(pctbuf, x+720, ly, 20, BLACK);
+    int ly = y+100, detailY = listY + 340;
+    for (int i=0;i<attendance.subjectCount;i++) {
+        const AttendanceSubject *sub = &attendance.subjects[i];
+        if (i == att_selected) DrawRectangle(listX+1, ly-8, listW-2, 40, (Color){ 220, 235, 255, 255 });
+        DrawText(sub->name, x+10, ly, 20, BLACK);
+        DrawText(TextFormat("%d", sub->sessions), x+330, ly, 20, BLACK);
+        DrawText(TextFormat("%d", sub->setCount), x+450, ly, 20, BLACK);
+        DrawText(TextFormat("%.1f%%", AttendanceSubjectPercent(&attendance, i)), x+570, ly, 20, BLACK);
+        DrawText(TextFormat("%d", att_stats[i].below), x+670, ly, 20, att_stats[i].below ? RED : BLACK);
+        DrawText(TextFormat("%d / %d", att_stats[i].everyone, att_stats[i].anyone), x+770, ly, 20, BLACK);
+        if (ButtonRect((Rectangle){x+w-200, ly-6, 90, 30}, "View")) { att_selected = i; att_stats_version = 0; }
         Rectangle del = {x+w-100, ly-6, 80, 30};
         if (ButtonRect(del, "Delete")) {
-            for (int k=i;k<attendance_count-1;k++) attendance[k]=attendance[k+1];
-            attendance_count--; save_attendance(); break;
+            AttendanceRemoveSubject(&attendance, i);
+            if (att_selected == i) att_selected = -1; else if (att_selected > i) att_selected--;
+            attendance_version++; mark_dirty(TABLE_ATT); break;
         }
-        ly += 44; if (ly > listY + listH - 30) break;
+        ly += 44; if (ly > detailY - 40) break;
     }
+
+    // At-risk students of the selected subject
+    DrawLine(listX, detailY - 10, listX+listW, detailY - 10, LIGHTGRAY);
+    if (att_selected < 0) {
+        DrawText("View a subject to list its students below the threshold.", x+10, detailY, 20, DARKGRAY);
+    } else {
+        const AttendanceSubject *sub = &attendance.subjects[att_selected];
+        DrawText(TextFormat("%s: %d of %d students below %d%%", sub->name, att_risk_count, sub->setCount, ATTENDANCE_THRESHOLD), x+10, detailY, 20, DARKBLUE);
+        DrawText("Student", x+10, detailY+36, 20, DARKGRAY);
+        DrawText("Attended", x+330, detailY+36, 20, DARKGRAY);
+        DrawText("Percent", x+470, detailY+36, 20, DARKGRAY);
+        DrawText(TextFormat("Missed last %d", ATT_RECENT), x+610, detailY+36, 20, DARKGRAY);
+        int ry = detailY + 70;
+        for (int r=0;r<att_risk_count && r<att_risk_capacity;r++) {
+            const AttendanceSet *set = &attendance.sets[att_risk[r]];
+            const char *id = attendance.students[set->student].id;
+            DrawText(id[0] ? id : "(old counters)", x+10, ry, 20, BLACK);
+            DrawText(TextFormat("%d / %d", set->cardinality, sub->sessions), x+330, ry, 20, BLACK);
+            DrawText(TextFormat("%.1f%%", AttendancePercent(&attendance, att_selected, set)), x+470, ry, 20, RED);
+            DrawText(TextFormat("%d", AttendanceMissedLast(&attendance, att_selected, set, ATT_RECENT)), x+610, ry, 20, BLACK);
+            ry += 32; if (ry > listY + listH - 30) break;
+        }
+    }
+    float overall = attendance.possible ? (float)(100.0 * attendance.attended / attendance.possible) : 0.0f;
+    DrawText(TextFormat("Subjects: %d  Students: %d  Lectures: %ld  Attended: %ld  Overall: %.1f%%  (%ld KB)", attendance.subjectCount,
+             attendance.studentCount, (long)attendance.possible, (long)attendance.attended, overall, AttendanceBytes(&attendance) / 1024),
+             x+10, listY + listH + 10, 20, DARKGRAY);
     
     // --- Sidebar Form (Sequentially Drawn) ---
-    DrawText("Add Subject Attendance", sidebarX, y, 26, DARKBLUE);
+    DrawText("Subjects and Sessions", sidebarX, y, 26, DARKBLUE);
 
     int formY = y + 40;
     int inputW = 440;
-    int inputW_half = 210;
     int inputH = 40;
     int labelOffset = 28;
     int fieldSpacing = 10;
@@ -771,71 +1568,274 @@ void Tab_Attendance(int x, int y, int w, int sidebarX) {
     DrawInput(&ib_att_subject, "Subject");
     formY += inputH + fieldSpacing;
 
-    DrawText("Total lects:", sidebarX, formY, 20, BLACK);
-    DrawText("Attended:", sidebarX + inputW_half + 20, formY, 20, BLACK);
+    if (ButtonRect((Rectangle){(float)sidebarX, (float)formY, 300, 40}, "Add Subject")) {
+        int subject = AttendanceAddSubject(&attendance, ib_att_subject.text[0] ? ib_att_subject.text : "Subject");
+        if (subject >= 0) { att_selected = subject; attendance_version++; mark_dirty(TABLE_ATT); att_status[0] = 0; }
+    }
+    formY += 40 + fieldSpacing * 2;
+
+    DrawText("Enroll students (IDs, comma-separated):", sidebarX, formY, 20, BLACK);
+    formY += labelOffset;
+    ib_att_students.rect = (Rectangle){(float)sidebarX, (float)formY, (float)inputW, (float)inputH};
+    DrawInput(&ib_att_students, "e.g. 2023001, 2023002");
+    formY += inputH + fieldSpacing;
+
+    if (ButtonRect((Rectangle){(float)sidebarX, (float)formY, 300, 40}, "Enroll in Subject")) {
+        if (att_selected < 0) scpy(att_status, sizeof(att_status), "View or add a subject first.");
+        else {
+            int added = for_each_id(ib_att_students.text, enroll_id, &att_selected);
+            snprintf(att_status, sizeof(att_status), "Enrolled %d student(s) in %s.", added, attendance.subjects[att_selected].name);
+            if (added) { ib_att_students.text[0] = 0; attendance_version++; mark_dirty(TABLE_ATT); }
+        }
+    }
+    formY += 40 + fieldSpacing * 2;
+
+    DrawText("Absent this session (IDs):", sidebarX, formY, 20, BLACK);
     formY += labelOffset;
-    ib_att_total.rect = (Rectangle){(float)sidebarX, (float)formY, (float)inputW_half, (float)inputH};
-    DrawInput(&ib_att_total, "Total");
-    ib_att_attended.rect = (Rectangle){(float)sidebarX + inputW_half + 20, (float)formY, (float)inputW_half, (float)inputH};
-    DrawInput(&ib_att_attended, "Attended");
+    ib_att_absent.rect = (Rectangle){(float)sidebarX, (float)formY, (float)inputW, (float)inputH};
+    DrawInput(&ib_att_absent, "Everyone else is marked present");
     formY += inputH + fieldSpacing;
-    
-    if (ButtonRect((Rectangle){(float)sidebarX, (float)formY, 300, 40}, "Add Attendance")) {
-        if (attendance_count < MAX_ENTRIES) {
-            AttendanceRecord a; memset(&a,0,sizeof(a));
-            scpy(a.subject, ib_att_subject.text[0] ? ib_att_subject.text : "Subject");
-            a.total_lectures = atoi(ib_att_total.text);
-            a.attended = atoi(ib_att_attended.text);
-            attendance[attendance_count++] = a; save_attendance();
+
+    if (ButtonRect((Rectangle){(float)sidebarX, (float)formY, 300, 40}, "Record Session")) {
+        static AbsentList absent;
+        absent.count = absent.unknown = 0;
+        for_each_id(ib_att_absent.text, absent_id, &absent);
+        if (att_selected < 0) scpy(att_status, sizeof(att_status), "View or add a subject first.");
+        else if (absent.unknown) snprintf(att_status, sizeof(att_status), "%d absent ID(s) are not enrolled anywhere.", absent.unknown);
+        else {
+            int session = AttendanceRecordSession(&attendance, att_selected, absent.ids, absent.count);
+            if (session < 0) scpy(att_status, sizeof(att_status), "This subject has no room for more sessions.");
+            else {
+                snprintf(att_status, sizeof(att_status), "Session %d of %s recorded, %d absent.", session + 1, attendance.subjects[att_selected].name, absent.count);
+                ib_att_absent.text[0] = 0; attendance_version++; mark_dirty(TABLE_ATT);
+            }
         }
     }
+    formY += 40 + fieldSpacing;
+    if (att_status[0]) DrawText(att_status, sidebarX, formY, 18, DARKGRAY);
+}
+
+// ---------------- Gradebook Import ----------------
+typedef struct {
+    int lines, added, updated, rejected, threads;
+    int reasons[GRADE_REJECT_COUNT];
+    bool rosterChecked;                 // False when student_info.txt could not be read
+    double parseMs, mergeMs;
+} ResultImportReport;
+
+static char import_status[256] = "";
+
+static void copy_text(char *dst, AnalyticsText text) { snprintf(dst, MAX_STR, "%.*s", text.length, text.text); }
+
+// Rejected lines with their reason and text, one per line; the file is removed when there are none
+static void write_import_rejects(const GradebookImport *imp, const char *data, long size) {
+    if (imp->rejectCount == 0) { remove(FILE_RES_REJECTS); return; }
+    PersistBuffer f = {0};
+    for (int i = 0; i < imp->rejectCount; i++) {
+        const GradebookReject *r = &imp->rejects[i];
+        const char *end = (const char *)memchr(data + r->offset, '\n', size - r->offset);
+        int length = (int)((end ? end : data + size) - (data + r->offset));
+        if (length > 0 && data[r->offset + length - 1] == '\r') length--;
+        PersistAppend(&f, "line %d: %s: %.*s\n", r->line, GRADEBOOK_REASONS[r->reason], length, data + r->offset);
+    }
+    PersistWriteFile(FILE_RES_REJECTS, f.data, f.length);
+    PersistBufferFree(&f);
+}
+
+// Merges a CSV into results[]: a (student, subject) already present is replaced, anything
+// else is appended. Writing results.txt is left to the caller, so it happens once.
+static bool import_results(const char *path, int threads, ResultImportReport *rep) {
+    memset(rep, 0, sizeof(*rep));
+    RecordFile csv; if (!RecordFileOpen(&csv, path)) return false;
+    GradebookRoster roster; rep->rosterChecked = GradebookRosterLoad(&roster, FILE_STUDENTS);
+    GradebookImport imp; memset(&imp, 0, sizeof(imp));
+    GradebookRun(csv.data, csv.size, rep->rosterChecked ? &roster : NULL, threads, &imp);
+
+    double mergeStart = MonoClockNow();
+    int *target = (int *)malloc(sizeof(int) * (imp.rowCount + 1));
+    memset(target, 0xFF, sizeof(int) * (imp.rowCount + 1));
+    for (int i = 0; i < results_count; i++) {
+        AnalyticsText student = AnalyticsTextOf(res_text(results[i].student_id)), subject = AnalyticsTextOf(res_text(results[i].subject));
+        int j = GradebookIndexFind(&imp.index, imp.rows, GradebookKeyHash(student, subject), student, subject);
+        if (j >= 0) target[j] = i;
+    }
+    results_reserve(results_count + imp.rowCount);
+    for (int j = 0; j < imp.rowCount; j++) {
+        const GradebookRow *g = &imp.rows[j];
+        ResultRecord r; memset(&r,0,sizeof(r)); char text[MAX_STR];
+        copy_text(text, g->student); r.student_id = res_intern(text);
+        copy_text(text, g->subject); r.subject = res_intern(text);
+        copy_text(text, g->grade); r.grade = res_intern(text);
+        copy_text(text, g->remarks); r.remarks = res_intern(text);
+        r.total_credits = g->credits; r.credits_earned = g->earned; r.SPI = g->spi; r.passed = g->passed;
+        if (target[j] >= 0) { results_replace(target[j], &r); rep->updated++; }
+        else { results_insert(&r); rep->added++; }
+    }
+    write_import_rejects(&imp, csv.data, csv.size);
+    rep->mergeMs = (MonoClockNow() - mergeStart) * 1000.0;
+
+    rep->lines = imp.lines; rep->rejected = imp.rejectCount; rep->threads = imp.threads; rep->parseMs = imp.ms;
+    memcpy(rep->reasons, imp.reasons, sizeof(rep->reasons));
+    free(target); GradebookFree(&imp);
+    if (rep->rosterChecked) GradebookRosterFree(&roster);
+    RecordFileClose(&csv);
+    return true;
+}
+
+static void import_results_ui(const char *path) {
+    ResultImportReport rep;
+    if (!import_results(path, GRADEBOOK_THREADS, &rep)) { snprintf(import_status, sizeof(import_status), "Cannot read %.200s", path); return; }
+    if (rep.added + rep.updated > 0) save_tables(TABLE_RES);
+    snprintf(import_status, sizeof(import_status), "%d added, %d updated, %d rejected%s (%.1f ms)", rep.added, rep.updated, rep.rejected,
+             rep.rejected ? ", see results_rejects.txt" : "", rep.parseMs + rep.mergeMs);
+    TraceLog(LOG_INFO, "ACADFAC: Imported %s: %s", path, import_status);
+}
+
+// ---------------- Results Analytics ----------------
+static AnalyticsRow *analytics_rows = NULL; static int analytics_rows_capacity = 0;
+static AnalyticsReport results_report;
+static int results_report_version = 0;  // results_version the report was built for
+static bool results_show_analytics = false;
+
+static int analytics_subject_cmp(const void *pa, const void *pb) {
+    const AnalyticsSubject *a = (const AnalyticsSubject *)pa, *b = (const AnalyticsSubject *)pb;
+    int c = memcmp(a->name.text, b->name.text, a->name.length < b->name.length ? a->name.length : b->name.length);
+    return c ? c : a->name.length - b->name.length;
+}
+
+static int analytics_student_cmp(const void *pa, const void *pb) {   // Best CPI first
+    double x = ((const AnalyticsStudent *)pa)->cpi, y = ((const AnalyticsStudent *)pb)->cpi;
+    return (x < y) - (x > y);
+}
+
+// Subjects by name, students by CPI; rowPercentile is per row, so it is unaffected
+static void analytics_sort(AnalyticsReport *report) {
+    qsort(report->subjects, report->subjectCount, sizeof(AnalyticsSubject), analytics_subject_cmp);
+    qsort(report->students, report->studentCount, sizeof(AnalyticsStudent), analytics_student_cmp);
+}
+
+// The three most common grades, e.g. "A:12 B+:9 B:4"
+static const char *analytics_top_grades(const AnalyticsSubject *s, char *buf, int size) {
+    uint32_t counts[ANALYTICS_GRADE_COUNT]; memcpy(counts, s->grades, sizeof(counts));
+    buf[0] = '\0';
+    for (int n = 0, used = 0; n < 3; n++) {
+        int best = 0;
+        for (int g = 1; g < ANALYTICS_GRADE_COUNT; g++) if (counts[g] > counts[best]) best = g;
+        if (counts[best] == 0) break;
+        used += snprintf(buf + used, size - used, "%s%s:%u", n ? " " : "", AnalyticsGradeName(best), counts[best]);
+        if (used >= size) break;
+        counts[best] = 0;
+    }
+    return buf;
+}
+
+// Rebuilds the report when results changed since the last one
+static void refresh_results_report(void) {
+    if (results_report_version == results_version) return;
+    if (analytics_rows_capacity < results_count) {
+        analytics_rows_capacity = results_capacity;
+        analytics_rows = (AnalyticsRow *)realloc(analytics_rows, sizeof(AnalyticsRow) * analytics_rows_capacity);
+    }
+    for (int i = 0; i < results_count; i++) {
+        ResultRecord *r = &results[i];
+        analytics_rows[i] = (AnalyticsRow){ AnalyticsTextOf(res_text(r->student_id)), AnalyticsTextOf(res_text(r->subject)), AnalyticsTextOf(res_text(r->grade)),
+                                            r->total_credits, r->credits_earned, r->SPI, r->passed };
+    }
+    AnalyticsRun(analytics_rows, results_count, ANALYTICS_THREADS, &results_report);
+    analytics_sort(&results_report);
+    results_report_version = results_version;
+}
+
+static void DrawResultsAnalytics(int x, int y, int w, int h) {
+    const AnalyticsReport *rep = &results_report;
+    char tmp[128];
+
+    DrawText(TextFormat("Subjects (%d)", rep->subjectCount), x+10, y+10, 22, DARKBLUE);
+    DrawText("Subject", x+10, y+42, 20, DARKGRAY);
+    DrawText("Rows", x+300, y+42, 20, DARKGRAY);
+    DrawText("Pass %", x+380, y+42, 20, DARKGRAY);
+    DrawText("Mean GP", x+480, y+42, 20, DARKGRAY);
+    DrawText("P25/P50/P90", x+590, y+42, 20, DARKGRAY);
+    DrawText("Top grades", x+760, y+42, 20, DARKGRAY);
+    int half = y + h/2, ly = y + 72;
+    for (int i = 0; i < rep->subjectCount && ly < half - 30; i++, ly += 30) {
+        const AnalyticsSubject *s = &rep->subjects[i];
+        DrawText(TextFormat("%.*s", s->name.length, s->name.text), x+10, ly, 20, BLACK);
+        DrawText(TextFormat("%d", s->rows), x+300, ly, 20, BLACK);
+        DrawText(TextFormat("%.1f", s->rows ? 100.0f * s->passed / s->rows : 0.0f), x+380, ly, 20, BLACK);
+        DrawText(TextFormat("%.2f", s->meanGradePoint), x+480, ly, 20, BLACK);
+        DrawText(TextFormat("%.1f/%.1f/%.1f", s->p25, s->p50, s->p90), x+590, ly, 20, BLACK);
+        DrawText(analytics_top_grades(s, tmp, sizeof(tmp)), x+760, ly, 20, DARKGRAY);
+    }
+    DrawLine(x, half, x+w, half, LIGHTGRAY);
+
+    DrawText(TextFormat("Students by CPI (%d)", rep->studentCount), x+10, half+10, 22, DARKBLUE);
+    DrawText("Student ID", x+10, half+42, 20, DARKGRAY);
+    DrawText("Subjects", x+300, half+42, 20, DARKGRAY);
+    DrawText("Credits", x+400, half+42, 20, DARKGRAY);
+    DrawText("Earned", x+500, half+42, 20, DARKGRAY);
+    DrawText("CPI", x+600, half+42, 20, DARKGRAY);
+    DrawText("Percentile", x+700, half+42, 20, DARKGRAY);
+    ly = half + 72;
+    for (int i = 0; i < rep->studentCount && ly < y + h - 30; i++, ly += 30) {
+        const AnalyticsStudent *s = &rep->students[i];
+        DrawText(TextFormat("%.*s", s->id.length, s->id.text), x+10, ly, 20, BLACK);
+        DrawText(TextFormat("%d", s->rows), x+300, ly, 20, BLACK);
+        DrawText(TextFormat("%ld", s->credits), x+400, ly, 20, BLACK);
+        DrawText(TextFormat("%ld", s->earned), x+500, ly, 20, BLACK);
+        DrawText(TextFormat("%.2f", s->cpi), x+600, ly, 20, BLACK);
+        DrawText(TextFormat("%.1f", s->percentile), x+700, ly, 20, BLACK);
+    }
+    DrawText(TextFormat("%d rows analysed in %.2f ms on %d thread(s)", rep->rows, rep->ms, rep->threads), x+10, y + h + 10, 20, DARKGRAY);
 }
 
 // ---------------- Results Tab (MODIFIED) ----------------
-// MODIFIED: Reworked sidebar layout to be sequential
-void Tab_Results(int x, int y, int w, int sidebarX) {
-    DrawText("Results / Grades", x, y, 30, DARKBLUE);
-    
-    int listX = x, listY = y + 50, listW = w, listH = 700;
-    DrawRectangle(listX, listY, listW, listH, RAYWHITE);
-    DrawRectangleLines(listX, listY, listW, listH, LIGHTGRAY);
-    
-    DrawText("Student ID", x+10, y+60, 20, DARKGRAY);
-    DrawText("Subject", x+180, y+60, 20, DARKGRAY);
-    DrawText("Credits", x+450, y+60, 20, DARKGRAY);
-    DrawText("Earned", x+550, y+60, 20, DARKGRAY);
-    DrawText("SPI", x+650, y+60, 20, DARKGRAY);
-    DrawText("Grade", x+730, y+60, 20, DARKGRAY);
-    DrawText("Remarks", x+810, y+60, 20, DARKGRAY);
+static void DrawResultRows(int x, int w, int listX, int listY, int listW, int listH) {
+    DrawText("Student ID", x+10, listY+10, 20, DARKGRAY);
+    DrawText("Subject", x+180, listY+10, 20, DARKGRAY);
+    DrawText("Credits", x+450, listY+10, 20, DARKGRAY);
+    DrawText("Earned", x+550, listY+10, 20, DARKGRAY);
+    DrawText("SPI", x+650, listY+10, 20, DARKGRAY);
+    DrawText("Grade", x+730, listY+10, 20, DARKGRAY);
+    DrawText("Pctl", x+810, listY+10, 20, DARKGRAY);
+    DrawText("Remarks", x+890, listY+10, 20, DARKGRAY);
     DrawLine(listX, listY+40, listX+listW, listY+40, LIGHTGRAY);
 
-    int ly = y+100;
-    float totalSPI = 0.0f; int spi_count = 0;
-    int totalCredits = 0, creditsEarnedTotal = 0;
-    
+    int ly = listY+50;
     for (int i=0;i<results_count;i++) {
         ResultRecord *r = &results[i];
-        DrawText(r->student_id, x+10, ly, 20, BLACK);
-        DrawText(r->subject, x+180, ly, 20, BLACK);
+        DrawText(res_text(r->student_id), x+10, ly, 20, BLACK);
+        DrawText(res_text(r->subject), x+180, ly, 20, BLACK);
         char tmp[64];
         sprintf(tmp, "%d", r->total_credits); DrawText(tmp, x+450, ly, 20, BLACK);
         sprintf(tmp, "%d", r->credits_earned); DrawText(tmp, x+550, ly, 20, BLACK);
         sprintf(tmp, "%.2f", r->SPI); DrawText(tmp, x+650, ly, 20, BLACK);
-        DrawText(r->grade, x+730, ly, 20, BLACK);
-        DrawText(r->remarks, x+810, ly, 20, DARKGRAY);
+        DrawText(res_text(r->grade), x+730, ly, 20, BLACK);
+        if (i < results_report.rows) { sprintf(tmp, "%.0f", results_report.rowPercentile[i]); DrawText(tmp, x+810, ly, 20, BLACK); }
+        DrawText(res_text(r->remarks), x+890, ly, 20, DARKGRAY);
         Rectangle del = {x+w-100, ly-6, 80, 30};
-        if (ButtonRect(del, "Delete")) {
-            for (int k=i;k<results_count-1;k++) results[k]=results[k+1];
-            results_count--; save_results(); break;
-        }
-        if (r->SPI > 0.0f) { totalSPI += r->SPI; spi_count++; }
-        totalCredits += r->total_credits;
-        creditsEarnedTotal += r->credits_earned;
+        if (ButtonRect(del, "Delete")) { results_remove(i); mark_dirty(TABLE_RES); break; }
         ly += 44; if (ly > listY + listH - 30) break;
     }
-    float SPIavg = spi_count ? totalSPI / spi_count : 0.0f;
-    char stats[256]; sprintf(stats, "Total credits: %d  Earned: %d  Avg SPI: %.2f", totalCredits, creditsEarnedTotal, SPIavg);
+    double SPIavg = results_totals.spiCount ? results_totals.spiSum / results_totals.spiCount : 0.0;
+    char stats[256]; sprintf(stats, "Total credits: %ld  Earned: %ld  Avg SPI: %.2f", results_totals.credits, results_totals.earned, SPIavg);
     DrawText(stats, x+10, listY + listH + 10, 20, DARKGRAY);
+}
+
+// MODIFIED: Reworked sidebar layout to be sequential
+void Tab_Results(int x, int y, int w, int sidebarX) {
+    DrawText("Results / Grades", x, y, 30, DARKBLUE);
+    refresh_results_report();
+    if (ButtonRect((Rectangle){(float)(x+w-180), (float)y, 180, 36}, results_show_analytics ? "Show Rows" : "Analytics")) {
+        results_show_analytics = !results_show_analytics;
+    }
+    
+    int listX = x, listY = y + 50, listW = w, listH = 700;
+    DrawRectangle(listX, listY, listW, listH, RAYWHITE);
+    DrawRectangleLines(listX, listY, listW, listH, LIGHTGRAY);
+    
+    if (results_show_analytics) DrawResultsAnalytics(listX, listY, listW, listH);
+    else DrawResultRows(x, w, listX, listY, listW, listH);
 
     // --- Sidebar Form (Sequentially Drawn) ---
     DrawText("Add Result", sidebarX, y, 26, DARKBLUE);
@@ -884,32 +1884,664 @@ void Tab_Results(int x, int y, int w, int sidebarX) {
     formY += inputH + fieldSpacing;
     
     if (ButtonRect((Rectangle){(float)sidebarX, (float)formY, 300, 40}, "Add Result")) {
-        if (results_count < MAX_ENTRIES) {
-            ResultRecord r; memset(&r,0,sizeof(r));
-            scpy(r.student_id, ib_res_id.text[0] ? ib_res_id.text : "N/A");
-            scpy(r.subject, ib_res_subject.text[0] ? ib_res_subject.text : "Subject");
-            r.total_credits = atoi(ib_res_credits.text);
-            r.credits_earned = atoi(ib_res_earned.text);
-            r.SPI = (float)atof(ib_res_spi.text);
-            scpy(r.grade, ib_res_grade.text);
-            scpy(r.remarks, ib_res_remarks.text);
-            r.passed = (strcmp(r.grade,"F")!=0 && r.SPI > 0.0f) ? 1 : 0;
-            results[results_count++] = r; save_results();
+        ResultRecord r; memset(&r,0,sizeof(r));
+        r.student_id = res_intern(ib_res_id.text[0] ? ib_res_id.text : "N/A");
+        r.subject = res_intern(ib_res_subject.text[0] ? ib_res_subject.text : "Subject");
+        r.total_credits = atoi(ib_res_credits.text);
+        r.credits_earned = atoi(ib_res_earned.text);
+        r.SPI = (float)atof(ib_res_spi.text);
+        r.grade = res_intern(ib_res_grade.text);
+        r.remarks = res_intern(ib_res_remarks.text);
+        r.passed = (strcmp(ib_res_grade.text,"F")!=0 && r.SPI > 0.0f) ? 1 : 0;
+        if (results_insert(&r)) mark_dirty(TABLE_RES);
+    }
+    formY += 40 + 30;
+
+    DrawText("Bulk import (CSV):", sidebarX, formY, 20, BLACK);
+    formY += labelOffset;
+    ib_res_import.rect = (Rectangle){(float)sidebarX, (float)formY, (float)inputW, (float)inputH};
+    DrawInput(&ib_res_import, "results_import.csv");
+    formY += inputH + fieldSpacing;
+    if (ButtonRect((Rectangle){(float)sidebarX, (float)formY, 300, 40}, "Import CSV")) {
+        import_results_ui(ib_res_import.text[0] ? ib_res_import.text : FILE_RES_IMPORT);
+    }
+    DrawText(import_status, sidebarX, formY + 50, 18, DARKGRAY);
+}
+
+// ---------------- Results Report (CLI) ----------------
+#define RESULTS_BENCH_ROWS 5000000
+#define RESULTS_BENCH_SUBJECTS 400
+#define IMPORT_BENCH_ROWS 1000000
+#define PARSE_BENCH_LINES 10000000
+
+static void print_results_report(const AnalyticsReport *rep) {
+    char grades[128];
+    printf("%-24s %7s %7s %8s %6s %6s %6s  %s\n", "subject", "rows", "pass%", "mean GP", "p25", "p50", "p90", "top grades");
+    for (int i = 0; i < rep->subjectCount; i++) {
+        const AnalyticsSubject *s = &rep->subjects[i];
+        printf("%-24.*s %7d %7.1f %8.2f %6.2f %6.2f %6.2f  %s\n", s->name.length, s->name.text, s->rows,
+            s->rows ? 100.0 * s->passed / s->rows : 0.0, s->meanGradePoint, s->p25, s->p50, s->p90, analytics_top_grades(s, grades, sizeof(grades)));
+    }
+    printf("\n%-24s %8s %8s %8s %6s %6s\n", "student", "subjects", "credits", "earned", "CPI", "pctl");
+    for (int i = 0; i < rep->studentCount && i < 10; i++) {
+        const AnalyticsStudent *s = &rep->students[i];
+        printf("%-24.*s %8d %8ld %8ld %6.2f %6.1f\n", s->id.length, s->id.text, s->rows, s->credits, s->earned, s->cpi, s->percentile);
+    }
+    printf("\n%d rows, %d students, %d subjects in %.1f ms on %d thread(s)\n", rep->rows, rep->studentCount, rep->subjectCount, rep->ms, rep->threads);
+}
+
+// Rows point straight into the mapped file, so the file stays open until the report is printed
+static int results_report_cli(const char *path) {
+    RecordFile f; RecordLine line;
+    if (!RecordFileOpen(&f, path)) { fprintf(stderr, "Cannot read %s\n", path); return 1; }
+    int count = 0, capacity = 4096;
+    AnalyticsRow *rows = (AnalyticsRow *)malloc(sizeof(AnalyticsRow) * capacity);
+    while (RecordNextLine(&f, &line)) {
+        if (line.count < 6) continue;
+        if (count == capacity) { capacity *= 2; rows = (AnalyticsRow *)realloc(rows, sizeof(AnalyticsRow) * capacity); }
+        rows[count++] = (AnalyticsRow){ { line.fields[0].text, line.fields[0].length }, { line.fields[1].text, line.fields[1].length },
+                                        { line.fields[5].text, line.fields[5].length }, RecordInt(&line,2), RecordInt(&line,3),
+                                        (float)RecordFloat(&line,4), RecordInt(&line,7) };
+    }
+    AnalyticsReport rep; memset(&rep,0,sizeof(rep));
+    AnalyticsRun(rows, count, ANALYTICS_THREADS, &rep);
+    analytics_sort(&rep);
+    print_results_report(&rep);
+    AnalyticsFree(&rep); free(rows); RecordFileClose(&f);
+    return 0;
+}
+
+// Synthetic cohort: about 25 results per student over RESULTS_BENCH_SUBJECTS subjects
+static int results_bench_cli(int count) {
+    int studentCount = count / 25 + 1;
+    char *ids = (char *)malloc((size_t)studentCount * 12), *names = (char *)malloc(RESULTS_BENCH_SUBJECTS * 12);
+    for (int i = 0; i < studentCount; i++) snprintf(ids + (size_t)i*12, 12, "S%08d", i);
+    for (int i = 0; i < RESULTS_BENCH_SUBJECTS; i++) snprintf(names + i*12, 12, "SUBJ%03d", i);
+
+    AnalyticsRow *rows = (AnalyticsRow *)malloc(sizeof(AnalyticsRow) * (count + 1));
+    uint32_t seed = 12345;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u; int student = (int)((seed >> 8) % (uint32_t)studentCount);
+        seed = seed * 1664525u + 1013904223u; int subject = (int)((seed >> 8) % RESULTS_BENCH_SUBJECTS);
+        seed = seed * 1664525u + 1013904223u; int grade = (int)((seed >> 8) % 8);     // AA..FF
+        int credits = 2 + (int)((seed >> 4) % 3);
+        AnalyticsRow *r = &rows[i];
+        r->student = AnalyticsTextOf(ids + (size_t)student*12);
+        r->subject = AnalyticsTextOf(names + subject*12);
+        r->grade = AnalyticsTextOf(ANALYTICS_GRADES[grade]);
+        r->gradePoint = (grade == 7) ? 0.0f : 10.0f - grade;
+        r->passed = (grade != 7);
+        r->credits = credits; r->earned = r->passed ? credits : 0;
+    }
+
+    printf("%-10s %-8s %-9s %-9s %-10s %-10s %s\n", "rows", "threads", "students", "subjects", "ms", "Mrows/s", "checksum");
+    int threadCounts[] = { 1, 2, 4, 8 };
+    for (int t = 0; t < 4; t++) {
+        AnalyticsReport rep; memset(&rep,0,sizeof(rep));
+        AnalyticsRun(rows, count, threadCounts[t], &rep);
+        double checksum = 0.0;          // Same on every thread count if the partitions agree
+        for (int i = 0; i < rep.studentCount; i++) checksum += rep.students[i].weighted;
+        for (int i = 0; i < rep.subjectCount; i++) checksum += rep.subjects[i].passed;
+        printf("%-10d %-8d %-9d %-9d %-10.1f %-10.2f %.0f\n", count, rep.threads, rep.studentCount, rep.subjectCount, rep.ms,
+            rep.ms > 0.0 ? count / rep.ms / 1000.0 : 0.0, checksum);
+        AnalyticsFree(&rep);
+    }
+    free(rows); free(ids); free(names);
+    return 0;
+}
+
+// Folds one parsed row into a checksum both loaders must agree on
+static uint64_t parse_bench_fold(uint64_t sum, const char *id, const char *subject, int credits, int earned, float spi,
+                                 const char *grade, const char *remarks, int passed) {
+    sum += (uint64_t)credits * 31 + (uint64_t)earned * 7 + (uint64_t)passed + (uint64_t)(spi * 100.0f + 0.5f);
+    return sum + strlen(id) + strlen(subject) * 3 + strlen(grade) * 5 + strlen(remarks) * 11;
+}
+
+// The results loader before records.h: fgets + strtok + atoi per line, into MAX_STR buffers
+static uint64_t parse_bench_strtok(const char *path, int *rows) {
+    *rows = 0; uint64_t sum = 0;
+    FILE *f = fopen(path,"r"); if (!f) return 0; char line[1024];
+    char id[MAX_STR], subject[MAX_STR], grade[MAX_STR], remarks[MAX_STR];
+    while (fgets(line,sizeof(line),f)) {
+        trimnl(line); if (strlen(line)==0) continue;
+        int credits = 0, earned = 0, passed = 0; float spi = 0.0f;
+        subject[0] = grade[0] = remarks[0] = 0;
+        char *tok = strtok(line,"|"); if (!tok) continue; scpy(id, MAX_STR, tok);
+        tok = strtok(NULL,"|"); if (tok) scpy(subject, MAX_STR, tok);
+        tok = strtok(NULL,"|"); if (tok) credits = atoi(tok);
+        tok = strtok(NULL,"|"); if (tok) earned = atoi(tok);
+        tok = strtok(NULL,"|"); if (tok) spi = (float)atof(tok);
+        tok = strtok(NULL,"|"); if (tok) scpy(grade, MAX_STR, tok);
+        tok = strtok(NULL,"|"); if (tok) scpy(remarks, MAX_STR, tok);
+        tok = strtok(NULL,"|"); if (tok) passed = atoi(tok);
+        sum = parse_bench_fold(sum, id, subject, credits, earned, spi, grade, remarks, passed);
+        (*rows)++;
+    } fclose(f);
+    return sum;
+}
+
+// The same fields through RecordNextLine, as load_results() reads them
+static uint64_t parse_bench_records(const char *path, int *rows) {
+    *rows = 0; uint64_t sum = 0;
+    RecordFile f; if (!RecordFileOpen(&f, path)) return 0;
+    RecordLine line; char id[MAX_STR], subject[MAX_STR], grade[MAX_STR], remarks[MAX_STR];
+    while (RecordNextLine(&f, &line)) {
+        RecordCopy(&line,0,id,MAX_STR); RecordCopy(&line,1,subject,MAX_STR);
+        RecordCopy(&line,5,grade,MAX_STR); RecordCopy(&line,6,remarks,MAX_STR);
+        sum = parse_bench_fold(sum, id, subject, RecordInt(&line,2), RecordInt(&line,3), (float)RecordFloat(&line,4),
+                               grade, remarks, RecordInt(&line,7));
+        (*rows)++;
+    } RecordFileClose(&f);
+    return sum;
+}
+
+// Synthetic results.txt in parse_bench.res (removed afterwards), read by the old and the
+// current loader. Written line by line: at the default 10M lines it is ~400 MB.
+static int parse_bench_cli(int lineCount) {
+    const char *path = "parse_bench.res";
+    FILE *out = fopen(path, "w");
+    if (!out) { fprintf(stderr, "Cannot write %s\n", path); return 1; }
+    int studentCount = lineCount / 25 + 1;
+    uint32_t seed = 12345;
+    for (int i = 0; i < lineCount; i++) {
+        seed = seed * 1664525u + 1013904223u; int student = (int)((seed >> 8) % (uint32_t)studentCount);
+        seed = seed * 1664525u + 1013904223u; int subject = (int)((seed >> 8) % RESULTS_BENCH_SUBJECTS);
+        seed = seed * 1664525u + 1013904223u; int grade = (int)((seed >> 8) % 8);
+        int credits = 2 + (int)((seed >> 4) % 3);
+        fprintf(out, "S%08d|SUBJ%03d|%d|%d|%.2f|%s|%s|%d\n", student, subject, credits, grade == 7 ? 0 : credits,
+            grade == 7 ? 0.0 : 10.0 - grade, ANALYTICS_GRADES[grade], (seed >> 16) % 4 ? "Pass" : "Reviewed", grade != 7);
+    }
+    long bytes = ftell(out);
+    fclose(out);
+
+    printf("%-22s %-10s %-10s %-10s %-10s %s\n", "loader", "lines", "ms", "Mlines/s", "MB/s", "checksum");
+    for (int run = 0; run < 2; run++) {
+        int rows = 0;
+        double start = MonoClockNow();
+        uint64_t sum = run ? parse_bench_records(path, &rows) : parse_bench_strtok(path, &rows);
+        double ms = (MonoClockNow() - start) * 1000.0;
+        printf("%-22s %-10d %-10.1f %-10.2f %-10.1f %llu\n", run ? "RecordNextLine" : "fgets+strtok+atoi", rows, ms,
+            ms > 0.0 ? rows / ms / 1000.0 : 0.0, ms > 0.0 ? bytes / ms / 1000.0 : 0.0, (unsigned long long)sum);
+    }
+    remove(path);
+    return 0;
+}
+
+// "acadfac --import-results file.csv [threads]": merge into results.txt with one write
+static int import_results_cli(const char *path, int threads) {
+    load_results();
+    ResultImportReport rep;
+    if (!import_results(path, threads, &rep)) { fprintf(stderr, "Cannot read %s\n", path); return 1; }
+    double writeStart = MonoClockNow();
+    PersistBuffer f = {0};
+    save_results(&f);
+    bool written = PersistWriteFile(FILE_RES, f.data ? f.data : "", f.length);
+    PersistBufferFree(&f);
+    double writeMs = (MonoClockNow() - writeStart) * 1000.0;
+
+    printf("%s: %d lines, %d added, %d updated, %d rejected%s\n", path, rep.lines, rep.added, rep.updated, rep.rejected,
+        rep.rosterChecked ? "" : " (student_info.txt missing, IDs not checked)");
+    for (int i = 0; i < GRADE_REJECT_COUNT; i++) if (rep.reasons[i]) printf("  %6d %s\n", rep.reasons[i], GRADEBOOK_REASONS[i]);
+    if (rep.rejected) printf("Rejected lines are listed in %s\n", FILE_RES_REJECTS);
+    double totalMs = rep.parseMs + rep.mergeMs + writeMs;
+    printf("parse+validate+dedupe %.1f ms on %d thread(s), merge %.1f ms, write %.1f ms -> %s%s (%.2f Mrows/s overall)\n",
+        rep.parseMs, rep.threads, rep.mergeMs, writeMs, FILE_RES, written ? "" : " FAILED", totalMs > 0.0 ? rep.lines / totalMs / 1000.0 : 0.0);
+    return written ? 0 : 1;
+}
+
+// Synthetic gradebook with a few bad, unknown and repeated lines, imported end to end:
+// parsed, merged into the results table and written out, on import_bench.* files
+static int import_bench_cli(int count) {
+    FILE_RES = "import_bench.res"; FILE_STUDENTS = "import_bench.students"; FILE_RES_REJECTS = "import_bench.rejects";
+    const char *csvPath = "import_bench.csv";
+    int studentCount = count / 25 + 1;
+    PersistBuffer roster = {0};
+    for (int i = 0; i < studentCount; i++) if (i % 100 != 99) PersistAppend(&roster, "S%08d\n--END--\n", i);   // 1% unknown
+    PersistWriteFile(FILE_STUDENTS, roster.data ? roster.data : "", roster.length);
+    PersistBufferFree(&roster);
+    PersistBuffer csv = {0};
+    PersistAppend(&csv, "student_id,subject,credits,earned,spi,grade,remarks\n");
+    uint32_t seed = 12345;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u; int student = (int)((seed >> 8) % (uint32_t)studentCount);
+        seed = seed * 1664525u + 1013904223u; int subject = (int)((seed >> 8) % RESULTS_BENCH_SUBJECTS);
+        seed = seed * 1664525u + 1013904223u; int grade = (int)((seed >> 8) % 8);
+        int credits = 2 + (int)((seed >> 4) % 3);
+        const char *gradeText = ((seed >> 12) % 200 == 0) ? "ZZ" : ANALYTICS_GRADES[grade];             // 0.5% bad grades
+        PersistAppend(&csv, "S%08d,SUBJ%03d,%d,%d,%.2f,%s,%s\n", student, subject, credits, grade == 7 ? 0 : credits,
+            grade == 7 ? 0.0 : 10.0 - grade, gradeText, (seed >> 16) % 4 ? "" : "\"late, reviewed\"");
+    }
+    PersistWriteFile(csvPath, csv.data, csv.length);
+    long csvBytes = csv.length;
+    PersistBufferFree(&csv);
+
+    printf("%-10s %-8s %-10s %-10s %-10s %-10s %-10s %-10s %-10s %s\n", "rows", "threads", "accepted", "rejected",
+        "parse ms", "merge ms", "write ms", "total ms", "Mrows/s", "MB/s");
+    int threadCounts[] = { 1, 2, 4, 8 };
+    for (int t = 0; t < 4; t++) {
+        results_count = 0; TimetableStringsReset(&res_strings); results_recount();   // Every run merges into an empty table
+        double start = MonoClockNow();
+        ResultImportReport rep;
+        if (!import_results(csvPath, threadCounts[t], &rep)) { fprintf(stderr, "Cannot read %s\n", csvPath); break; }
+        double writeStart = MonoClockNow();
+        PersistBuffer f = {0};
+        save_results(&f);
+        PersistWriteFile(FILE_RES, f.data ? f.data : "", f.length);
+        PersistBufferFree(&f);
+        double writeMs = (MonoClockNow() - writeStart) * 1000.0, totalMs = (MonoClockNow() - start) * 1000.0;
+        printf("%-10d %-8d %-10d %-10d %-10.1f %-10.1f %-10.1f %-10.1f %-10.2f %.1f\n", count, rep.threads, results_count, rep.rejected,
+            rep.parseMs, rep.mergeMs, writeMs, totalMs, totalMs > 0.0 ? count / totalMs / 1000.0 : 0.0, totalMs > 0.0 ? csvBytes / totalMs / 1000.0 : 0.0);
+    }
+    printf("(results rows are %d bytes each)\n", (int)sizeof(ResultRecord));
+    remove(csvPath); remove(FILE_RES); remove(FILE_STUDENTS); remove(FILE_RES_REJECTS);
+    return 0;
+}
+
+// Synthetic results.txt and a full assignment table: text parse against the snapshot,
+// its size per results row, and whether the snapshot loads back the same rows
+static int snapshot_bench_cli(int count) {
+    FILE_TT = "snapshot_bench.tt"; FILE_ASSIGN = "snapshot_bench.assign"; FILE_EVENTS = "snapshot_bench.events";
+    FILE_SEM = "snapshot_bench.sem"; FILE_ATT = "snapshot_bench.att"; FILE_RES = "snapshot_bench.res";
+    FILE_PROGRESS = "snapshot_bench.progress"; FILE_SNAPSHOT = "snapshot_bench.snap";
+    PersistBuffer text = {0};
+    uint32_t seed = 12345;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u; int student = (int)((seed >> 8) % (uint32_t)(count / 25 + 1));
+        seed = seed * 1664525u + 1013904223u; int subject = (int)((seed >> 8) % RESULTS_BENCH_SUBJECTS);
+        seed = seed * 1664525u + 1013904223u; int grade = (int)((seed >> 8) % 8);
+        int credits = 2 + (int)((seed >> 4) % 3);
+        PersistAppend(&text, "S%08d|SUBJ%03d|%d|%d|%.2f|%s|%s|%d\n", student, subject, credits, grade == 7 ? 0 : credits,
+            grade == 7 ? 0.0 : 10.0 - grade, ANALYTICS_GRADES[grade], (seed >> 16) % 4 ? "" : "late, reviewed", grade != 7);
+    }
+    PersistWriteFile(FILE_RES, text.data ? text.data : "", text.length);
+    PersistBufferFree(&text);
+    for (assign_count = 0; assign_count < MAX_ENTRIES; assign_count++) {
+        Assignment *a = &assignments[assign_count]; memset(a,0,sizeof(*a));
+        a->id = assign_count + 1; a->status = ASSIGNED;
+        snprintf(a->title, sizeof(a->title), "Problem set %d", assign_count + 1);
+        snprintf(a->due_date, sizeof(a->due_date), "2025-%02d-%02d", 1 + assign_count % 12, 1 + assign_count % 28);
+        scpy(a->issued_by, sizeof(a->issued_by), "Prof 1"); scpy(a->desc, sizeof(a->desc), "Chapters 1-3");
+    }
+
+    double t = MonoClockNow();
+    load_results();
+    double parseMs = (MonoClockNow() - t) * 1000.0;
+    PersistBuffer before[2] = {0}, after[2] = {0};
+    save_results(&before[0]); save_assignments(&before[1]);
+
+    t = MonoClockNow();
+    save_snapshot();
+    double writeMs = (MonoClockNow() - t) * 1000.0;
+    long bytes = 0;
+    FILE *f = fopen(FILE_SNAPSHOT, "rb");
+    if (f) { fseek(f, 0, SEEK_END); bytes = ftell(f); fclose(f); }
+
+    results_count = 0; assign_count = 0; TimetableStringsReset(&res_strings);
+    t = MonoClockNow();
+    bool loaded = load_snapshot();
+    double loadMs = (MonoClockNow() - t) * 1000.0;
+    save_results(&after[0]); save_assignments(&after[1]);
+    bool same = loaded;
+    for (int i = 0; i < 2; i++) {
+        same = same && before[i].length == after[i].length && memcmp(before[i].data, after[i].data, before[i].length) == 0;
+        PersistBufferFree(&before[i]); PersistBufferFree(&after[i]);
+    }
+
+    printf("%-10s %-10s %-12s %-10s %-10s %-10s %-12s %s\n", "rows", "strings", "snapshot MB", "B/row", "parse ms", "write ms", "load ms", "round trip");
+    printf("%-10d %-10d %-12.1f %-10.1f %-10.1f %-10.1f %-12.1f %s\n", results_count, res_strings.count, bytes / 1e6,
+        results_count ? (double)bytes / results_count : 0.0, parseMs, writeMs, loadMs, same ? "same" : "DIFFERS");
+    printf("(rows were %d bytes each in the snapshot before they were interned, now %d)\n",
+        (int)(4 * MAX_STR + 4 * sizeof(int)), (int)sizeof(ResultRecord));
+    remove(FILE_RES); remove(FILE_SNAPSHOT);
+    return same ? 0 : 1;
+}
+
+// Edits every table the way the tabs do, exits, and checks that the files hold exactly
+// the tables, that they load back unchanged, and that a session without edits (or with
+// one) rewrites nothing else. Uses persist_check.* files next to the real ones.
+static bool persist_check_files(const char *what, PersistBuffer *expected) {
+    bool same = true;
+    for (int i=0;i<TABLE_SAVER_COUNT;i++) {
+        PersistBuffer disk = {0};
+        FILE *f = fopen(*table_savers[i].path, "rb");
+        char chunk[4096]; size_t n;
+        while (f && (n = fread(chunk, 1, sizeof(chunk), f)) > 0) PersistAppend(&disk, "%.*s", (int)n, chunk);
+        if (f) fclose(f);
+        if (!f || disk.length != expected[i].length || (disk.length && memcmp(disk.data, expected[i].data, disk.length) != 0)) {
+            printf("FAIL %s: %s differs (%ld bytes on disk, %ld expected)\n", what, *table_savers[i].path, disk.length, expected[i].length);
+            same = false;
+        }
+        PersistBufferFree(&disk);
+    }
+    return same;
+}
+static void persist_check_format(PersistBuffer *out) {
+    for (int i=0;i<TABLE_SAVER_COUNT;i++) { PersistBufferFree(&out[i]); table_savers[i].save(&out[i]); }
+}
+static void persist_check_load(void) {
+    load_timetable(); load_assignments(); load_semester(); load_attendance(); load_results(); load_progress();
+}
+static int persist_check_cli(void) {
+    FILE_TT = "persist_check.tt"; FILE_ASSIGN = "persist_check.assign"; FILE_SEM = "persist_check.sem";
+    FILE_ATT = "persist_check.att"; FILE_RES = "persist_check.res"; FILE_PROGRESS = "persist_check.progress";
+    for (int i=0;i<TABLE_SAVER_COUNT;i++) remove(*table_savers[i].path);
+    persist_check_load();
+    PersistBuffer expected[TABLE_SAVER_COUNT], reloaded[TABLE_SAVER_COUNT];
+    memset(expected, 0, sizeof(expected)); memset(reloaded, 0, sizeof(reloaded));
+    char id[MAX_STR], text[MAX_STR];
+    bool ok = true;
+
+    // Session 1: edits in every table, then the exit path
+    PersistStart(&writer);
+    for (int i=0;i<200;i++) {
+        TimetableEntry e; memset(&e,0,sizeof(e));
+        e.day = (uint8_t)(i % 5); e.type = (uint8_t)(i % 2 ? TT_LAB : TT_LECTURE);
+        e.start = (uint16_t)(8*60 + (i/5 % 8) * 60); e.end = (uint16_t)(e.start + 60);
+        snprintf(text, sizeof(text), "Course %d", i % 40);  e.title = TimetableIntern(&tt_strings, text);
+        snprintf(text, sizeof(text), "Room %d", i % 12);    e.room = TimetableIntern(&tt_strings, text);
+        snprintf(text, sizeof(text), "Prof %d", i % 25);    e.professor = TimetableIntern(&tt_strings, text);
+        e.id = i + 1;
+        tt_entries[tt_count++] = e; tt_version++; mark_dirty(TABLE_TT);
+    }
+    for (int i=0;i<40;i++) {
+        Assignment a; memset(&a,0,sizeof(a));
+        a.id = i + 1; a.status = ASSIGNED;
+        snprintf(text, sizeof(text), "Problem set %d, \"part\" %d", i, i % 3); scpy(a.title, sizeof(a.title), text);
+        snprintf(text, sizeof(text), "2025-%02d-%02d", 1 + i % 12, 1 + i % 28); scpy(a.due_date, sizeof(a.due_date), text);
+        scpy(a.issued_by, sizeof(a.issued_by), "Prof 1"); scpy(a.desc, sizeof(a.desc), i % 4 ? "Chapters 1-3" : "");
+        assignments[assign_count++] = a;
+    }
+    sync_deadlines(); mark_dirty(TABLE_ASSIGN);
+    for (int i=0;i<300;i++) {
+        snprintf(id, sizeof(id), "S%08d", i);
+        int student = DeadlineAddStudent(&deadlines, id);
+        DeadlineSetTaskState(&deadlines, i % deadlines.taskCount, student, (i % 3) ? DL_SUBMITTED : DL_PENDING, 20250301);
+    }
+    mark_dirty(TABLE_PROGRESS);
+    scpy(seminfo.semester_name, sizeof(seminfo.semester_name), "Semester 5");
+    for (int i=0;i<20;i++) {
+        snprintf(text, sizeof(text), "Event %d", i);
+        CalendarAdd(&calendar, (CalendarType)(i % CAL_TYPE_COUNT), 20250110 + i, 20250110 + i + (i % 3), text);
+    }
+    mark_dirty(TABLE_SEM);
+    for (int sub=0;sub<4;sub++) {
+        snprintf(text, sizeof(text), "SUBJ%03d", sub);
+        int subject = AttendanceAddSubject(&attendance, text);
+        for (int i=0;i<150;i++) { snprintf(id, sizeof(id), "S%08d", i); AttendanceEnroll(&attendance, subject, AttendanceAddStudent(&attendance, id)); }
+        for (int session=0;session<70;session++) {
+            int absent[3] = { AttendanceFindStudent(&attendance, "S00000001"), (session * 7) % 150, (session * 13) % 150 };
+            AttendanceRecordSession(&attendance, subject, absent, session % 4);
+        }
+    }
+    attendance_version++; mark_dirty(TABLE_ATT);
+    for (int i=0;i<2000;i++) {
+        ResultRecord r; memset(&r,0,sizeof(r));
+        snprintf(id, sizeof(id), "S%08d", i % 300); r.student_id = res_intern(id);
+        snprintf(text, sizeof(text), "SUBJ%03d", i / 300); r.subject = res_intern(text);
+        r.total_credits = 2 + i % 3; r.credits_earned = (i % 9) ? r.total_credits : 0;
+        r.SPI = (i % 9) ? 10.0f - (float)(i % 7) : 0.0f; r.passed = (i % 9) != 0;
+        r.grade = res_intern(ANALYTICS_GRADES[i % 8]); r.remarks = res_intern(i % 5 ? "" : "late, reviewed");
+        results_insert(&r); mark_dirty(TABLE_RES);
+    }
+    persist_check_format(expected);
+    int written = flush_tables();
+    printf("%-44s %d files written, %d failed\n", "session 1 (every table edited):", written, writer.failed);
+    ok &= (written == TABLE_SAVER_COUNT && writer.failed == 0);
+    ok &= persist_check_files("session 1", expected);
+
+    // The files load back into the same tables
+    persist_check_load(); persist_check_format(reloaded);
+    for (int i=0;i<TABLE_SAVER_COUNT;i++) {
+        if (reloaded[i].length != expected[i].length || memcmp(reloaded[i].data, expected[i].data, expected[i].length) != 0) {
+            printf("FAIL reload: %s does not load back unchanged\n", *table_savers[i].path); ok = false;
+        }
+    }
+
+    // Session 2: no edits, nothing written
+    PersistStart(&writer);
+    written = flush_tables();
+    printf("%-44s %d files written\n", "session 2 (no edits):", written);
+    ok &= (written == 0) && persist_check_files("session 2", expected);
+
+    // Session 3: one results edit, only results written
+    PersistStart(&writer);
+    results_remove(0); mark_dirty(TABLE_RES);
+    persist_check_format(expected);
+    written = flush_tables();
+    printf("%-44s %d files written\n", "session 3 (one results row deleted):", written);
+    ok &= (written == 1) && persist_check_files("session 3", expected);
+
+    for (int i=0;i<TABLE_SAVER_COUNT;i++) {
+        snprintf(text, sizeof(text), "%s.tmp", *table_savers[i].path);
+        FILE *tmp = fopen(text, "rb");
+        if (tmp) { fclose(tmp); printf("FAIL %s left behind\n", text); ok = false; remove(text); }
+        remove(*table_savers[i].path);
+        PersistBufferFree(&expected[i]); PersistBufferFree(&reloaded[i]);
+    }
+    printf("%s\n", ok ? "PASS: nothing lost on a clean shutdown, clean tables untouched" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+// Synthetic term: every student in every subject, each with their own attendance rate
+#define ATTENDANCE_BENCH_STUDENTS 10000
+#define ATTENDANCE_BENCH_SUBJECTS 8
+#define ATTENDANCE_BENCH_SESSIONS 60
+static int attendance_bench_cli(int studentCount) {
+    AttendanceStore store; memset(&store,0,sizeof(store));
+    double start = MonoClockNow();
+    char id[ATTENDANCE_MAX_ID];
+    for (int i = 0; i < studentCount; i++) { snprintf(id, sizeof(id), "S%08d", i); AttendanceAddStudent(&store, id); }
+    int *absent = (int *)malloc(sizeof(int) * (studentCount + 1));
+    uint32_t seed = 12345;
+    for (int sub = 0; sub < ATTENDANCE_BENCH_SUBJECTS; sub++) {
+        snprintf(id, sizeof(id), "SUBJ%03d", sub);
+        int subject = AttendanceAddSubject(&store, id);
+        for (int i = 0; i < studentCount; i++) AttendanceEnroll(&store, subject, i);
+        for (int session = 0; session < ATTENDANCE_BENCH_SESSIONS; session++) {
+            int count = 0;
+            for (int i = 0; i < studentCount; i++) {
+                seed = seed * 1664525u + 1013904223u;
+                if ((seed >> 8) % 100 < (uint32_t)(2 + (i % 7) * 5)) absent[count++] = i;     // 2% to 32% absent
+            }
+            AttendanceRecordSession(&store, subject, absent, count);
+        }
+    }
+    double buildMs = (MonoClockNow() - start) * 1000.0;
+    long wasted = store.wastedWords * 8;
+    AttendanceCompact(&store);
+    int arrays = 0;
+    for (int i = 0; i < store.setCount; i++) arrays += (store.sets[i].type == ATT_ARRAY);
+
+    long marks = (long)store.setCount * ATTENDANCE_BENCH_SESSIONS;
+    printf("%d students x %d subjects x %d sessions: %ld marks recorded in %.1f ms\n", studentCount, ATTENDANCE_BENCH_SUBJECTS,
+        ATTENDANCE_BENCH_SESSIONS, marks, buildMs);
+    printf("store %ld KB (%d array / %d bitmap containers, %ld KB of moved containers compacted away)\n",
+        AttendanceBytes(&store) / 1024, arrays, store.setCount - arrays, wasted / 1024);
+    printf("one byte per mark would be %ld KB; one 264-byte AttendanceRecord per subject and student %ld KB\n",
+        marks / 1024, (long)store.setCount * 264 / 1024);
+
+    double t = MonoClockNow(), percentSum = 0.0;
+    for (int sub = 0; sub < store.subjectCount; sub++) {
+        for (int i = store.subjects[sub].firstSet; i < store.subjects[sub].firstSet + store.subjects[sub].setCount; i++) percentSum += AttendancePercent(&store, sub, &store.sets[i]);
+    }
+    printf("%-28s %8.3f ms  (mean %.2f%%)\n", "percent, every set", (MonoClockNow() - t) * 1000.0, percentSum / (store.setCount ? store.setCount : 1));
+    t = MonoClockNow();
+    int below = 0;
+    for (int sub = 0; sub < store.subjectCount; sub++) below += AttendanceBelow(&store, sub, ATTENDANCE_THRESHOLD, NULL, 0);
+    printf("%-28s %8.3f ms  (%d sets)\n", "below 75%, every subject", (MonoClockNow() - t) * 1000.0, below);
+    t = MonoClockNow();
+    long missed = 0;
+    for (int sub = 0; sub < store.subjectCount; sub++) {
+        for (int i = store.subjects[sub].firstSet; i < store.subjects[sub].firstSet + store.subjects[sub].setCount; i++) missed += AttendanceMissedLast(&store, sub, &store.sets[i], 5);
+    }
+    printf("%-28s %8.3f ms  (%ld missed)\n", "missed last 5, every set", (MonoClockNow() - t) * 1000.0, missed);
+    t = MonoClockNow();
+    uint64_t words[ATTENDANCE_MAX_WORDS];
+    int everyone = 0, anyone = 0;
+    for (int sub = 0; sub < store.subjectCount; sub++) { everyone += AttendanceCombine(&store, sub, true, words); anyone += AttendanceCombine(&store, sub, false, words); }
+    printf("%-28s %8.3f ms  (%d / %d sessions)\n", "AND / OR, every subject", (MonoClockNow() - t) * 1000.0, everyone, anyone);
+    t = MonoClockNow();
+    int imageWords = 0;
+    const uint64_t *image = AttendancePack(&store, &imageWords);
+    AttendanceStore view; memset(&view,0,sizeof(view));
+    bool ok = AttendanceLoadImage(&view, image, imageWords, true);
+    printf("%-28s %8.3f ms  (%d KB image, %s)\n", "pack + map snapshot image", (MonoClockNow() - t) * 1000.0, imageWords / 128,
+        ok && view.attended == store.attended ? "totals match" : "MISMATCH");
+    AttendanceFree(&view); AttendanceFree(&store); free(absent);
+    return ok ? 0 : 1;
+}
+
+// Synthetic cohort: assignments due one a day around today, most handed in
+#define DEADLINE_BENCH_STUDENTS 10000
+#define DEADLINE_BENCH_ASSIGNMENTS 500
+static int deadline_bench_cli(int studentCount, int assignmentCount) {
+    DeadlineTracker tracker; memset(&tracker,0,sizeof(tracker));
+    int32_t today = DeadlineToday();
+    if (studentCount < 1 || assignmentCount < 1) return 1;
+    int32_t *ids = (int32_t *)calloc(assignmentCount, sizeof(int32_t)), *dues = (int32_t *)calloc(assignmentCount, sizeof(int32_t));
+    for (int i = 0; i < assignmentCount; i++) {     // YYYYMMDD stays ordered if only the month and day are spread
+        ids[i] = i + 1;
+        dues[i] = (today / 10000) * 10000 + (1 + i % 12) * 100 + 1 + (i / 12) % 28;
+    }
+    char id[DEADLINE_MAX_ID];
+    for (int i = 0; i < studentCount; i++) { snprintf(id, sizeof(id), "S%08d", i); DeadlineAddStudent(&tracker, id); }
+    DeadlineSetTasks(&tracker, ids, dues, assignmentCount);
+
+    double t = MonoClockNow();
+    uint32_t seed = 12345;
+    long marks = 0;
+    for (int task = 0; task < assignmentCount; task++) {
+        bool past = tracker.tasks[task].due < today;
+        for (int s = 0; s < studentCount; s++) {
+            seed = seed * 1664525u + 1013904223u;
+            uint32_t roll = (seed >> 8) % 100;
+            if (past ? roll < 90 : roll < 20) { DeadlineSetTaskState(&tracker, task, s, DL_SUBMITTED, past ? tracker.tasks[task].due : today); marks++; }
+            else if (roll < 95) { DeadlineSetTaskState(&tracker, task, s, DL_PENDING, 0); marks++; }
+        }
+    }
+    printf("%d students x %d assignments: %ld states set in %.1f ms\n", studentCount, assignmentCount, marks, (MonoClockNow() - t) * 1000.0);
+    printf("tracker %ld KB, %d state columns (%.0f%% of pairs not \"assigned\")\n", DeadlineBytes(&tracker) / 1024, tracker.columnCount,
+        100.0 * marks / ((double)studentCount * assignmentCount));
+
+    int out[5];
+    t = MonoClockNow();
+    long listed = 0;
+    for (int s = 0; s < studentCount; s++) listed += DeadlineNext(&tracker, s, today, out, 5);
+    double nextMs = (MonoClockNow() - t) * 1000.0;
+    printf("%-30s %8.3f ms  (%.2f us each, %ld listed)\n", "next 5 deadlines, every student", nextMs, nextMs * 1000.0 / studentCount, listed);
+    t = MonoClockNow();
+    int overdueTasks = 0;
+    long missing = 0;
+    for (int k = 0; k < 1000; k++) missing = DeadlineOverdueCount(&tracker, today, &overdueTasks);
+    printf("%-30s %8.3f us  (%ld missing over %d assignments)\n", "overdue count, whole cohort", (MonoClockNow() - t) * 1000.0, missing, overdueTasks);
+    t = MonoClockNow();
+    long check = 0;                     // The same number the slow way
+    for (int task = 0; task < tracker.taskCount; task++) {
+        if (tracker.tasks[task].due >= today) continue;
+        for (int s = 0; s < studentCount; s++) check += !DeadlineDone(DeadlineStateAt(&tracker, task, s));
+    }
+    printf("%-30s %8.3f ms  (%ld, %s)\n", "overdue count by full scan", (MonoClockNow() - t) * 1000.0, check, check == missing ? "matches" : "MISMATCH");
+    t = MonoClockNow();
+    int imageWords = 0;
+    const uint64_t *image = DeadlinePack(&tracker, &imageWords);
+    DeadlineTracker view; memset(&view,0,sizeof(view));
+    bool ok = DeadlineLoadImage(&view, image, imageWords, true);
+    DeadlineSetTasks(&view, ids, dues, assignmentCount);
+    printf("%-30s %8.3f ms  (%d KB image)\n", "pack + map snapshot image", (MonoClockNow() - t) * 1000.0, imageWords / 128);
+    ok = ok && DeadlineOverdueCount(&view, today, NULL) == missing && check == missing;
+    DeadlineFree(&view); DeadlineFree(&tracker); free(ids); free(dues);
+    return ok ? 0 : 1;
+}
+
+// Dense synthetic week in a hidden window: each grid drawn directly every frame (as
+// before the cache) against the cached layer. Nothing is saved.
+#define GRID_BENCH_ENTRIES 500
+#define GRID_BENCH_FRAMES 300
+static int grid_bench_cli(int entryCount) {
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    PortalInitWindow(1920, 1080, "Academics grid bench");
+    tt_count = 0; TimetableStringsReset(&tt_strings);
+    char title[64], room[16];
+    for (int i = 0; i < entryCount && tt_count < MAX_TT_ENTRIES; i++) {
+        TimetableEntry e; memset(&e,0,sizeof(e));
+        e.type = (uint8_t)(i % 2 ? TT_LAB : TT_LECTURE);
+        e.day = (uint8_t)((i / 2) % 5);
+        e.start = (uint16_t)((e.type == TT_LAB ? 14 : 8) * 60 + ((i / 10) * 15) % 180);
+        e.end = (uint16_t)(e.start + 60);
+        snprintf(title, sizeof(title), "Course %03d", i); snprintf(room, sizeof(room), "R%d", i % 40);
+        e.title = TimetableIntern(&tt_strings, title); e.room = TimetableIntern(&tt_strings, room);
+        e.professor = TimetableIntern(&tt_strings, TT_DEFAULT_PROF);
+        e.id = i + 1;
+        tt_entries[tt_count++] = e;
+    }
+    tt_version++;
+    RebuildClashIndex();                // The direct runs skip DrawTimetableGridFixed(), which keeps these current
+    TimetableBuildView(&tt_view, tt_entries, tt_count); tt_view_version = tt_version;
+
+    int x = 50, y = 180, w = (int)(1920 * 0.65) - 70, h = 700;
+    printf("%d entries, %d frames per run\n", tt_count, GRID_BENCH_FRAMES);
+    for (int showLabs = 0; showLabs < 2; showLabs++) {
+        for (int cached = 0; cached < 2; cached++) {
+            int calls = 0;
+            double drawTime = 0.0, start = GetTime();
+            for (int frame = 0; frame < GRID_BENCH_FRAMES; frame++) {
+                BeginDrawing(); ClearBackground(RAYWHITE);
+                double t = GetTime();
+                if (cached) { DrawTimetableGridFixed(x, y, w, h, showLabs); calls = 1; }
+                else calls = DrawTimetableLayers(x, y, w, h, showLabs);
+                drawTime += GetTime() - t;
+                EndDrawing();
+            }
+            printf("%-7s grid, %-6s %5d draw calls/frame  %7.3f ms drawing  %7.3f ms per frame\n", showLabs ? "lab" : "lecture",
+                cached ? "cached" : "direct", calls, drawTime * 1000.0 / GRID_BENCH_FRAMES, (GetTime() - start) * 1000.0 / GRID_BENCH_FRAMES);
         }
     }
+    GridCacheUnload(&tt_grid_cache[0]); GridCacheUnload(&tt_grid_cache[1]);
+    PortalCloseWindow();
+    return 0;
 }
 
 // ---------------- MAIN (MODIFIED) ----------------
-int main(int argc, char *argv[]) {
+PORTAL_ENTRY(AcademicsFacultyMain) {
+    // Results analytics from the command line needs no window
+    if (argc >= 2 && strcmp(argv[1], "--results-report") == 0) return results_report_cli(argc >= 3 ? argv[2] : FILE_RES);
+    if (argc >= 2 && strcmp(argv[1], "--results-bench") == 0) return results_bench_cli(argc >= 3 ? atoi(argv[2]) : RESULTS_BENCH_ROWS);
+    if (argc >= 3 && strcmp(argv[1], "--import-results") == 0) return import_results_cli(argv[2], argc >= 4 ? atoi(argv[3]) : GRADEBOOK_THREADS);
+    if (argc >= 2 && strcmp(argv[1], "--snapshot-bench") == 0) return snapshot_bench_cli(argc >= 3 ? atoi(argv[2]) : IMPORT_BENCH_ROWS);
+    if (argc >= 2 && strcmp(argv[1], "--parse-bench") == 0) return parse_bench_cli(argc >= 3 ? atoi(argv[2]) : PARSE_BENCH_LINES);
+    if (argc >= 2 && strcmp(argv[1], "--import-bench") == 0) return import_bench_cli(argc >= 3 ? atoi(argv[2]) : IMPORT_BENCH_ROWS);
+    if (argc >= 2 && strcmp(argv[1], "--deadline-bench") == 0) {
+        return deadline_bench_cli(argc >= 3 ? atoi(argv[2]) : DEADLINE_BENCH_STUDENTS, argc >= 4 ? atoi(argv[3]) : DEADLINE_BENCH_ASSIGNMENTS);
+    }
+    if (argc >= 2 && strcmp(argv[1], "--grid-bench") == 0) return grid_bench_cli(argc >= 3 ? atoi(argv[2]) : GRID_BENCH_ENTRIES);
+    if (argc >= 2 && strcmp(argv[1], "--persist-check") == 0) return persist_check_cli();
+    if (argc >= 2 && strcmp(argv[1], "--attendance-bench") == 0) return attendance_bench_cli(argc >= 3 ? atoi(argv[2]) : ATTENDANCE_BENCH_STUDENTS);
     if(argc<3) return 0;
     const int screenWidth = 1920;
     const int screenHeight = 1080;
-    InitWindow(screenWidth, screenHeight, "University Portal - Academics (Faculty Window)");
+    PortalInitWindow(screenWidth, screenHeight, "University Portal - Academics (Faculty Window)");
     SetTargetFPS(60);
 
-    // load persistent data
-    load_timetable(); load_assignments(); load_events();
-    load_semester(); load_attendance(); load_results();
+    // load persistent data, from the binary snapshot when the files are unchanged
+    double loadStart = GetTime();
+    bool reloaded = true;
+    if (tables_loaded && tables_version == table_files_version()) {
+        reloaded = false;
+        TraceLog(LOG_INFO, "ACADFAC: Tables kept from the last visit.");
+    } else if (load_snapshot()) {
+        TraceLog(LOG_INFO, "ACADFAC: Loaded %s in %.3f ms.", FILE_SNAPSHOT, (GetTime() - loadStart) * 1000.0);
+    } else {
+        load_timetable(); load_assignments(); load_events();
+        load_semester(); load_attendance(); load_results(); load_progress();
+        TraceLog(LOG_INFO, "ACADFAC: Parsed text files in %.3f ms.", (GetTime() - loadStart) * 1000.0);
+        save_snapshot();
+    }
+    tables_loaded = true; tables_version = table_files_version();
+    // student_info.txt is the admin's file, so it is read on every start (in the shell, when it changed)
+    if (reloaded || cohort_version != PortalFileVersion(FILE_STUDENTS)) {
+        cohort_version = PortalFileVersion(FILE_STUDENTS);
+        load_cohort();
+    }
 
     // MODIFIED: Init InputBoxes with empty rects.
     // Their positions will be set dynamically in the Tab_... functions.
@@ -929,10 +2561,13 @@ int main(int argc, char *argv[]) {
     ib_assign_due      = MakeInput(0,0,0,0, "YYYY-MM-DD");
     ib_assign_issuedby = MakeInput(0,0,0,0, "Prof. name");
     ib_assign_desc     = MakeInput(0,0,0,0, "");
+    ib_assign_student  = MakeInput(0,0,0,0, "");
+    ib_assign_ref      = MakeInput(0,0,0,0, "");
 
     ib_event_title = MakeInput(0,0,0,0, "");
     ib_event_date  = MakeInput(0,0,0,0, "");
     ib_event_desc  = MakeInput(0,0,0,0, "");
+    ib_event_end   = MakeInput(0,0,0,0, "");
 
     ib_sem_name   = MakeInput(0,0,0,0, seminfo.semester_name);
     ib_sem_start  = MakeInput(0,0,0,0, seminfo.start_date);
@@ -941,8 +2576,8 @@ int main(int argc, char *argv[]) {
     ib_sem_credit = MakeInput(0,0,0,0, credbuf);
 
     ib_att_subject  = MakeInput(0,0,0,0, "");
-    ib_att_total    = MakeInput(0,0,0,0, "0");
-    ib_att_attended = MakeInput(0,0,0,0, "0");
+    ib_att_students = MakeInput(0,0,0,0, "");
+    ib_att_absent   = MakeInput(0,0,0,0, "");
 
     ib_res_id      = MakeInput(0,0,0,0, "");
     ib_res_subject = MakeInput(0,0,0,0, "");
@@ -951,18 +2586,21 @@ int main(int argc, char *argv[]) {
     ib_res_spi     = MakeInput(0,0,0,0, "9.00");
     ib_res_grade   = MakeInput(0,0,0,0, "A");
     ib_res_remarks = MakeInput(0,0,0,0, "");
+    ib_res_import  = MakeInput(0,0,0,0, FILE_RES_IMPORT);
 
+    PersistStart(&writer);
+    TraceLog(LOG_INFO, "ACADFAC: First frame after %.1f ms.", (GetTime() - loadStart) * 1000.0);
     while (!WindowShouldClose()) {
         // This array-copy method is complex but required for HandleInputs
         InputBox* all_inputs[] = {
             &ib_tt_title, &ib_tt_room, &ib_tt_prof, &ib_tt_start, &ib_tt_end,
             &ib_lab_title, &ib_lab_room, &ib_lab_prof, &ib_lab_start, &ib_lab_end,
-            &ib_assign_title, &ib_assign_due, &ib_assign_desc, &ib_assign_issuedby,
-            &ib_event_title, &ib_event_date, &ib_event_desc,
+            &ib_assign_title, &ib_assign_due, &ib_assign_desc, &ib_assign_issuedby, &ib_assign_student, &ib_assign_ref,
+            &ib_event_title, &ib_event_date, &ib_event_desc, &ib_event_end,
             &ib_sem_name, &ib_sem_start, &ib_sem_end, &ib_sem_credit,
-            &ib_att_subject, &ib_att_total, &ib_att_attended,
+            &ib_att_subject, &ib_att_students, &ib_att_absent,
             &ib_res_subject, &ib_res_credits, &ib_res_earned, &ib_res_spi, &ib_res_grade, &ib_res_remarks,
-            &ib_res_id
+            &ib_res_id, &ib_res_import
         };
         int nInputs = sizeof(all_inputs)/sizeof(all_inputs[0]);
         
@@ -995,12 +2633,17 @@ int main(int argc, char *argv[]) {
             default: Tab_Timetable(contentX, contentY, mainContentWidth, sideBarX); break;
         }
         EndDrawing();
+        persist_pump();
     }
 
-    // Save on exit
-    save_timetable(); save_assignments(); save_events();
-    save_semester(); save_attendance(); save_results();
+    // Save what is still dirty on exit; untouched files (and their .idx) are left alone
+    save_events();
+    int written = flush_tables();
+    tables_version = table_files_version();   // Our own saves, the tables already match them
+    TraceLog(LOG_INFO, "ACADFAC: Writer saved %d files, %d failed.", written, writer.failed);
+    if (written > 0) save_snapshot(); // Files changed this session, so the next start is warm again
 
-    CloseWindow();
+    GridCacheUnload(&tt_grid_cache[0]); GridCacheUnload(&tt_grid_cache[1]);
+    PortalCloseWindow();
     return 0;
 }
\ No newline at end of file
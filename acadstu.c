@@ -5,22 +5,48 @@
 // - Columns are now spread across the 1920px screen for better readability.
 // - "Issued By" and "Description" columns are now wider.
 // - All other tabs and functions remain unchanged from v2.
+// - Parsed tables are shared through datacache.h: the first window publishes them,
+//   later ones map the snapshot read-only while the source files are unchanged.
+// - After a clean parse the tables are also saved to acadstu.snap, so even the first
+//   window after a reboot maps a binary image instead of parsing the text files.
+// - Timetable rows are the compact, string-interned TimetableEntry of timetable.h. The
+//   grids draw from a TimetableView grouped by type and day.
+// - Semester Info lists the holidays and exams of the calendar store in semester.txt
+//   (calendar.h), the same events the faculty window edits.
+// - The table loaders read through records.h: one vectorized pass over the mapped file
+//   instead of fgets + strtok + atoi per line.
+// - Attendance reads the per-session store of attendance.h (mapped in place from the
+//   snapshot). Given a student ID as the first argument, the tab shows that student's
+//   subjects with percent and recent misses; otherwise the class figures per subject.
+// - With a student ID, Assignments also shows that student's overdue work and next
+//   deadlines, and the Status column is their own hand-in state from
+//   assignment_progress.txt (deadlines.h, mapped in place from the snapshot).
+// - The lecture and lab grids are drawn once into render textures (gridcache.h) and
+//   blitted every frame after that; they are redrawn only when load_all() runs.
+// - afterlog.c passes the logged-in student's ID. With it, the window reads only that
+//   student's results, attendance marks and hand-ins, through a per-file ID index
+//   (recordindex.h), and only the timetable rows of subjects they are enrolled in. Each
+//   tab's tables are read the first time the tab is opened. Without an ID it still
+//   loads everything for the class views.
 
 #include "raylib.h"
+#include "portal.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "datacache.h"
+#include "timetable.h"
+#include "calendar.h"
+#include "records.h"
+#include "attendance.h"
+#include "deadlines.h"
+#include "gridcache.h"
+#include "recordindex.h"
 
 #define MAX_STR 256
 #define MAX_ENTRIES 512
 
 // --- [Data Structures: Unchanged] ---
-typedef struct {
-    int day; int start_h, start_m; int end_h, end_m;
-    char title[MAX_STR]; char room[MAX_STR]; char professor[MAX_STR];
-    int is_lab; int id;
-} TimetableEntry;
-
 typedef enum { ASSIGNED=0, PENDING=1, SUBMITTED=2 } AssignStatus;
 
 typedef struct {
@@ -34,10 +60,6 @@ typedef struct {
     char end_date[MAX_STR]; int total_credits;
 } SemesterInfo;
 
-typedef struct {
-    char subject[MAX_STR]; int total_lectures; int attended;
-} AttendanceRecord;
-
 typedef struct {
     char student_id[MAX_STR]; char subject[MAX_STR]; int total_credits;
     int credits_earned; float SPI; char grade[MAX_STR]; char remarks[MAX_STR];
@@ -45,60 +67,103 @@ typedef struct {
 } ResultRecord;
 
 // --- [Storage & Files: Unchanged] ---
-static TimetableEntry tt_entries[MAX_ENTRIES];  static int tt_count = 0;
-static Assignment assignments[MAX_ENTRIES];     static int assign_count = 0;
+// The tables point either at the local storage the loaders fill or into a shared snapshot
+static TimetableEntry tt_storage[MAX_TT_ENTRIES];   static TimetableEntry *tt_entries = tt_storage;    static int tt_count = 0;
+static TimetableStrings tt_strings;                 // Titles, rooms and professors of tt_entries
+static TimetableView tt_view;                       // tt_entries by type and day, rebuilt by load_all()
+static int tt_version = 0;                          // Bumped when the timetable is loaded; the cached grids follow it
+static Assignment assign_storage[MAX_ENTRIES];      static Assignment *assignments = assign_storage;    static int assign_count = 0;
 static SemesterInfo seminfo;
-static AttendanceRecord attendance[MAX_ENTRIES];static int attendance_count = 0;
-static ResultRecord results[MAX_ENTRIES];       static int results_count = 0;
+static CalendarStore calendar;                      // Semester events from semester.txt
+static AttendanceStore attendance;                  // Per-session marks; read-only when mapped from a snapshot
+static char student_id[ATTENDANCE_MAX_ID] = "";     // Whose attendance is shown; class averages if empty
+static DeadlineTracker deadlines;                   // Hand-in state per student; read-only when mapped
+static ResultRecord results_storage[MAX_ENTRIES];   static ResultRecord *results = results_storage;     static int results_count = 0;
 
 static const char* FILE_TT    = "tt_entries.txt";
 static const char* FILE_ASSIGN= "assignments.txt";
 static const char* FILE_SEM   = "semester.txt";
 static const char* FILE_ATT   = "attendance.txt";
 static const char* FILE_RES   = "results.txt";
+static const char* FILE_PROGRESS = "assignment_progress.txt";
+static const char* FILE_SNAPSHOT = "acadstu.snap"; // Binary image of all of the above
+
+// Tables a tab draws from. With a student ID each is read the first time a tab needs it.
+enum { TABLE_TT=1, TABLE_ASSIGN=2, TABLE_SEM=4, TABLE_ATT=8, TABLE_RES=16, TABLE_PROGRESS=32, TABLE_ALL=63 };
+static unsigned loaded_tables = 0;
 
 // --- [Util Functions: Unchanged] ---
 static void trimnl(char *s) { int n = (int)strlen(s); while (n>0 && (s[n-1]=='\n' || s[n-1]=='\r')) { s[--n] = 0; } }
 static void scpy(char *dst, const char *src) { if (!src) { dst[0]=0; return; } strncpy(dst, src, MAX_STR-1); dst[MAX_STR-1]=0; }
 
 // --- [Load Functions: Unchanged (Bug fix is already here)] ---
+// The lines of 'path' this window reads: with a student ID only those filed under one
+// of 'keys' in the file's index (recordindex.h), otherwise the whole file. A NULL key
+// function also reads the whole file.
+static bool open_records(RecordFile *f, PersistBuffer *slice, const char *path, RecordKeyFunc key, const char **keys, int keyCount) {
+    memset(slice,0,sizeof(*slice));
+    if (!student_id[0] || !key) return RecordFileOpen(f, path);
+    RecordIndex index;
+    if (!RecordIndexOpen(&index, path, key)) return false;
+    for (int i=0;i<keyCount;i++) RecordIndexRead(&index, keys[i], slice);
+    RecordIndexClose(&index);
+    RecordFileBorrow(f, slice->data, slice->length);
+    return true;
+}
+static void close_records(RecordFile *f, PersistBuffer *slice) { RecordFileClose(f); PersistBufferFree(slice); }
+static bool results_key(const RecordLine *line, RecordField *key) { *key = line->fields[0]; return true; }
+static bool timetable_key(const RecordLine *line, RecordField *key) { if (line->count < 5) return false; *key = line->fields[4]; return true; }
+
+// Titles of the subjects the student is enrolled in (attendance.h sets); 0 if none, and
+// then the whole timetable is shown
+static int enrolled_subjects(const char **names, int max) {
+    int student = AttendanceFindStudent(&attendance, student_id), n = 0;
+    for (int i=0;student >= 0 && i<attendance.subjectCount && n < max;i++) {
+        if (AttendanceFindSet(&attendance, i, student) >= 0) names[n++] = attendance.subjects[i].name;
+    }
+    return n;
+}
 static void load_timetable(void) {
-    tt_count = 0; FILE *f = fopen(FILE_TT,"r"); if (!f) return; char line[1024];
-    while (fgets(line,sizeof(line),f)) {
-        trimnl(line); if (!line[0]) continue;
+    tt_count = 0; TimetableStringsReset(&tt_strings);
+    const char *subjects[64]; int subjectCount = student_id[0] ? enrolled_subjects(subjects, 64) : 0;
+    RecordFile f; PersistBuffer slice;
+    if (!open_records(&f, &slice, FILE_TT, subjectCount ? timetable_key : NULL, subjects, subjectCount)) return;
+    RecordLine line; char text[MAX_STR];
+    while (RecordNextLine(&f, &line)) {
+        if (line.count < 4) continue;
         TimetableEntry e; memset(&e,0,sizeof(e));
-        char *tok = strtok(line,"|"); if (!tok) continue; e.day = atoi(tok);
-        tok = strtok(NULL,"|"); if (!tok) continue; sscanf(tok,"%d:%d",&e.start_h,&e.start_m);
-        tok = strtok(NULL,"|"); if (!tok) continue; sscanf(tok,"%d:%d",&e.end_h,&e.end_m);
-        tok = strtok(NULL,"|"); if (!tok) continue; e.is_lab = atoi(tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(e.title, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(e.room, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(e.professor, tok);
-        tok = strtok(NULL,"|"); if (tok) e.id = atoi(tok);
-        if (tt_count < MAX_ENTRIES) tt_entries[tt_count++] = e;
-    } fclose(f);
+        e.day = (uint8_t)RecordInt(&line,0);
+        e.start = (uint16_t)RecordMinutes(&line,1); e.end = (uint16_t)RecordMinutes(&line,2);
+        e.type = RecordInt(&line,3) ? TT_LAB : TT_LECTURE;
+        RecordCopy(&line,4,text,MAX_STR); e.title = TimetableIntern(&tt_strings, text);
+        RecordCopy(&line,5,text,MAX_STR); e.room = TimetableIntern(&tt_strings, text);
+        RecordCopy(&line,6,text,MAX_STR); e.professor = TimetableIntern(&tt_strings, text);
+        e.id = RecordInt(&line,7);
+        if (tt_count < MAX_TT_ENTRIES) tt_entries[tt_count++] = e;
+    } close_records(&f, &slice);
 }
 
 static void load_assignments(void) {
-    assign_count = 0; FILE *f = fopen(FILE_ASSIGN,"r"); if (!f) return; char line[2048];
-    while (fgets(line,sizeof(line),f)) {
-        trimnl(line); if (!line[0]) continue; Assignment a; memset(&a,0,sizeof(a));
-        char *tok = strtok(line,"|"); if (!tok) continue; a.id = atoi(tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(a.title, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(a.due_date, tok);
-        tok = strtok(NULL,"|"); if (tok) a.status = (AssignStatus)atoi(tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(a.submitted_date, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(a.issued_by, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(a.desc, tok);
+    assign_count = 0; RecordFile f; if (!RecordFileOpen(&f, FILE_ASSIGN)) return; RecordLine line;
+    while (RecordNextLine(&f, &line)) {
+        Assignment a; memset(&a,0,sizeof(a));
+        a.id = RecordInt(&line,0);
+        RecordCopy(&line,1,a.title,MAX_STR);
+        RecordCopy(&line,2,a.due_date,MAX_STR);
+        a.status = (AssignStatus)RecordInt(&line,3);
+        RecordCopy(&line,4,a.submitted_date,MAX_STR);
+        RecordCopy(&line,5,a.issued_by,MAX_STR);
+        RecordCopy(&line,6,a.desc,MAX_STR);
         if (assign_count < MAX_ENTRIES) assignments[assign_count++] = a;
-    } fclose(f);
+    } RecordFileClose(&f);
 }
 static void load_semester(void) {
     scpy(seminfo.semester_name, "Semester 1");
     scpy(seminfo.start_date, "2025-01-10");
     scpy(seminfo.end_date,   "2025-05-30");
     seminfo.total_credits = 20;
-    FILE *f = fopen(FILE_SEM,"r"); if (!f) return; char line[512];
+    CalendarFree(&calendar);
+    FILE *f = fopen(FILE_SEM,"r"); if (!f) { CalendarAddDefaults(&calendar); return; } char line[512];
     if (fgets(line,sizeof(line),f)) {
         trimnl(line);
         char *tok = strtok(line,"|");
@@ -107,38 +172,180 @@ static void load_semester(void) {
         tok = strtok(NULL,"|"); if (tok) scpy(seminfo.end_date, tok);
         tok = strtok(NULL,"|"); if (tok) seminfo.total_credits = atoi(tok);
     }
+    while (fgets(line,sizeof(line),f)) { trimnl(line); if (line[0]) CalendarParseLine(&calendar, line); }
     fclose(f);
+    if (calendar.count == 0) CalendarAddDefaults(&calendar); // semester.txt from before the calendar store
 }
 static void load_attendance(void) {
-    attendance_count = 0; FILE *f = fopen(FILE_ATT,"r"); if (!f) return; char line[512];
-    while (fgets(line,sizeof(line),f)) {
-        trimnl(line); if (!line[0]) continue; AttendanceRecord a; memset(&a,0,sizeof(a));
-        char *tok = strtok(line,"|"); if (!tok) continue; scpy(a.subject, tok);
-        tok = strtok(NULL,"|"); if (tok) a.total_lectures = atoi(tok);
-        tok = strtok(NULL,"|"); if (tok) a.attended = atoi(tok);
-        if (attendance_count < MAX_ENTRIES) attendance[attendance_count++] = a;
-    } fclose(f);
+    AttendanceFree(&attendance); RecordFile f; PersistBuffer slice; RecordLine line;
+    const char *keys[2] = { "", student_id };          // Subjects, then the student's marks
+    if (!open_records(&f, &slice, FILE_ATT, AttendanceLineStudent, keys, 2)) return;
+    while (RecordNextLine(&f, &line)) AttendanceParseLine(&attendance, &line);
+    close_records(&f, &slice);
+}
+static void load_progress(void) {
+    DeadlineFree(&deadlines); RecordFile f; PersistBuffer slice; RecordLine line;
+    const char *keys[1] = { student_id };
+    if (!open_records(&f, &slice, FILE_PROGRESS, DeadlineLineStudent, keys, 1)) return;
+    while (RecordNextLine(&f, &line)) DeadlineParseLine(&deadlines, &line);
+    close_records(&f, &slice);
 }
 static void load_results(void) {
-    results_count = 0; FILE *f = fopen(FILE_RES,"r"); if (!f) return; char line[1024];
-    while (fgets(line,sizeof(line),f)) {
-        trimnl(line); if (!line[0]) continue; ResultRecord r; memset(&r,0,sizeof(r));
-        char *tok = strtok(line,"|"); if (!tok) continue; scpy(r.student_id, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(r.subject, tok);
-        tok = strtok(NULL,"|"); if (tok) r.total_credits = atoi(tok);
-        tok = strtok(NULL,"|"); if (tok) r.credits_earned = atoi(tok);
-        tok = strtok(NULL,"|"); if (tok) r.SPI = (float)atof(tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(r.grade, tok);
-        tok = strtok(NULL,"|"); if (tok) scpy(r.remarks, tok);
-        tok = strtok(NULL,"|"); if (tok) r.passed = atoi(tok);
+    results_count = 0; RecordFile f; PersistBuffer slice; RecordLine line;
+    const char *keys[1] = { student_id };
+    if (!open_records(&f, &slice, FILE_RES, results_key, keys, 1)) return;
+    while (RecordNextLine(&f, &line)) {
+        ResultRecord r; memset(&r,0,sizeof(r));
+        RecordCopy(&line,0,r.student_id,MAX_STR);
+        RecordCopy(&line,1,r.subject,MAX_STR);
+        r.total_credits = RecordInt(&line,2);
+        r.credits_earned = RecordInt(&line,3);
+        r.SPI = (float)RecordFloat(&line,4);
+        RecordCopy(&line,5,r.grade,MAX_STR);
+        RecordCopy(&line,6,r.remarks,MAX_STR);
+        r.passed = RecordInt(&line,7);
         if (results_count < MAX_ENTRIES) results[results_count++] = r;
-    } fclose(f);
+    } close_records(&f, &slice);
+}
+
+// Describes the loaded tables for datacache.h, in section order
+static int table_sources(DataCacheSource *sources) {
+    sources[0] = (DataCacheSource){ FILE_TT,     tt_entries,  sizeof(TimetableEntry),   tt_count };
+    sources[1] = (DataCacheSource){ FILE_ASSIGN, assignments, sizeof(Assignment),       assign_count };
+    sources[2] = (DataCacheSource){ FILE_SEM,    &seminfo,    sizeof(SemesterInfo),     1 };
+    int attendanceWords = 0;
+    const uint64_t *marks = AttendancePack(&attendance, &attendanceWords);
+    sources[3] = (DataCacheSource){ FILE_ATT,    marks,       sizeof(uint64_t),         attendanceWords };
+    sources[4] = (DataCacheSource){ FILE_RES,    results,     sizeof(ResultRecord),     results_count };
+    long stringBytes = 0;
+    const char *strings = TimetableStringsPack(&tt_strings, &stringBytes);
+    sources[5] = (DataCacheSource){ FILE_TT,     strings,     1,                        (int)stringBytes };
+    sources[6] = (DataCacheSource){ FILE_SEM,    calendar.events, sizeof(CalendarEvent), calendar.count };
+    int progressWords = 0;
+    const uint64_t *progress = DeadlinePack(&deadlines, &progressWords);
+    sources[7] = (DataCacheSource){ FILE_PROGRESS, progress,  sizeof(uint64_t),         progressWords };
+    return 8;
+}
+
+// Points the tables at a cached image; false if it is stale or its layout changed
+static bool use_snapshot(const DataCacheHeader *cache) {
+    if (!cache || !DataCacheIsFresh(cache)) return false;
+    int counts[8] = { 0 };
+    TimetableEntry *tt = (TimetableEntry *)DataCacheSectionData(cache, 0, sizeof(TimetableEntry), &counts[0]);
+    Assignment *as = (Assignment *)DataCacheSectionData(cache, 1, sizeof(Assignment), &counts[1]);
+    const SemesterInfo *sem = (const SemesterInfo *)DataCacheSectionData(cache, 2, sizeof(SemesterInfo), &counts[2]);
+    const uint64_t *marks = (const uint64_t *)DataCacheSectionData(cache, 3, sizeof(uint64_t), &counts[3]);
+    ResultRecord *res = (ResultRecord *)DataCacheSectionData(cache, 4, sizeof(ResultRecord), &counts[4]);
+    const char *strings = (const char *)DataCacheSectionData(cache, 5, 1, &counts[5]);
+    const CalendarEvent *events = (const CalendarEvent *)DataCacheSectionData(cache, 6, sizeof(CalendarEvent), &counts[6]);
+    const uint64_t *progress = (const uint64_t *)DataCacheSectionData(cache, 7, sizeof(uint64_t), &counts[7]);
+    if (!tt || !as || !sem || counts[2] != 1 || !marks || !res || !strings || !events || !progress) return false;
+    if (!TimetableStringsLoad(&tt_strings, strings, counts[5], true)) return false; // Used in place, like the rows
+    if (!CalendarLoad(&calendar, events, counts[6], true)) return false;
+    if (!AttendanceLoadImage(&attendance, marks, counts[3], true)) return false;
+    if (!DeadlineLoadImage(&deadlines, progress, counts[7], true)) return false;
+
+    tt_entries = tt; assignments = as; seminfo = *sem; results = res;
+    tt_count = counts[0]; assign_count = counts[1]; results_count = counts[4];
+    return true;
+}
+
+// Fastest source first: the shared segment another window published, then the
+// acadstu.snap file from an earlier run, and only then the text files
+static void load_tables(void) {
+    double start = GetTime();
+    DataCacheSource sources[DATACACHE_MAX_SECTIONS];
+
+    const DataCacheHeader *cache = DataCacheAttach("acadstu");
+    if (use_snapshot(cache)) {
+        TraceLog(LOG_INFO, "ACADSTU: Attached shared tables (generation %ld) in %.3f ms.", cache->generation, (GetTime() - start) * 1000.0);
+        return;
+    }
+
+    const DataCacheHeader *snapshot = DataCacheMapFile(FILE_SNAPSHOT);
+    if (use_snapshot(snapshot)) {
+        DataCachePublish("acadstu", sources, table_sources(sources));
+        TraceLog(LOG_INFO, "ACADSTU: Mapped %s in %.3f ms.", FILE_SNAPSHOT, (GetTime() - start) * 1000.0);
+        return;
+    }
+    DataCacheUnmapFile(snapshot); // Stale; it gets rewritten below
+
+    tt_entries = tt_storage; assignments = assign_storage; results = results_storage;
+    load_timetable(); load_assignments(); load_semester(); load_attendance(); load_results(); load_progress();
+    double parsed = GetTime();
+
+    int sourceCount = table_sources(sources);
+    DataCacheWriteFile(FILE_SNAPSHOT, sources, sourceCount);
+    DataCachePublish("acadstu", sources, sourceCount);
+    TraceLog(LOG_INFO, "ACADSTU: Parsed files in %.3f ms, saved snapshot and published in %.3f ms.",
+             (parsed - start) * 1000.0, (GetTime() - parsed) * 1000.0);
+}
+
+// Rebuilds what is derived from the given tables: the grid view and the deadline index
+static void index_tables(unsigned tables) {
+    if (tables & TABLE_TT) { TimetableBuildView(&tt_view, tt_entries, tt_count); tt_version++; }
+    if (tables & (TABLE_ASSIGN | TABLE_PROGRESS)) {
+        int32_t ids[MAX_ENTRIES], dues[MAX_ENTRIES];
+        for (int i=0;i<assign_count;i++) { ids[i] = assignments[i].id; dues[i] = CalendarParseDate(assignments[i].due_date); }
+        DeadlineSetTasks(&deadlines, ids, dues, assign_count);
+    }
+}
+
+// The single-process shell keeps these statics between visits. The same student (or again
+// none) keeps what the last visit loaded, unless another screen wrote one of the files
+// since (see PortalFileWritten() in portal.h). Anyone else starts empty, with the tables
+// back on their own storage rather than on a snapshot mapped by the last visit.
+static bool visited = false;
+static char visited_id[ATTENDANCE_MAX_ID] = "";
+static unsigned tables_version = 0;
+
+static unsigned table_files_version(void) {
+    const char *files[] = { FILE_TT, FILE_ASSIGN, FILE_SEM, FILE_ATT, FILE_RES, FILE_PROGRESS };
+    unsigned version = 0;
+    for (int i=0;i<(int)(sizeof(files)/sizeof(files[0]));i++) version += PortalFileVersion(files[i]);
+    return version;
+}
+
+static void reset_tables(void) {
+    loaded_tables = 0; student_id[0] = '\0';
+    tt_entries = tt_storage; assignments = assign_storage; results = results_storage;
+    tt_count = 0; assign_count = 0; results_count = 0;
+    TimetableStringsReset(&tt_strings); CalendarFree(&calendar);
+    AttendanceFree(&attendance); DeadlineFree(&deadlines);
+    tt_version++;
+}
+
+// Without a student ID the class figures need every row, so all tables are loaded at
+// once, through the shared snapshot when possible. The tables are read-only here, so
+// the grid view and the deadline index only change when they are loaded.
+static void load_all(void) {
+    load_tables();
+    index_tables(TABLE_ALL);
+    loaded_tables = TABLE_ALL;
+}
+
+// With a student ID only that student's lines are read, and each table only once a tab
+// shows it, so opening the window costs the same however large the files grow
+static void load_student_tables(unsigned tables) {
+    tables &= ~loaded_tables;
+    if (!tables) return;
+    double start = GetTime();
+    if (tables & TABLE_TT) tables |= TABLE_ATT & ~loaded_tables;    // Enrolment picks the timetable rows
+    if (tables & TABLE_ATT) load_attendance();
+    if (tables & TABLE_TT) load_timetable();
+    if (tables & TABLE_ASSIGN) load_assignments();
+    if (tables & TABLE_PROGRESS) load_progress();
+    if (tables & TABLE_SEM) load_semester();
+    if (tables & TABLE_RES) load_results();
+    loaded_tables |= tables;
+    index_tables(tables);
+    TraceLog(LOG_INFO, "ACADSTU: Loaded tables 0x%02x for %s in %.3f ms.", tables, student_id, (GetTime() - start) * 1000.0);
 }
 
 static const char* DAYS[7] = {"Mon","Tue","Wed","Thu","Fri","Sat","Sun"};
 
 // ---------------- Timetable Grids (Unchanged from v2) ----------------
-static void DrawLectureGridRO(int x, int y, int w, int h) {
+static void DrawLectureLayersRO(int x, int y, int w, int h) {
     int timeColW = 120, daysCols = 5, rows = 4;
     int contentW = w - timeColW, cellW = contentW / daysCols, cellH = h / rows;
     DrawRectangle(x, y, w, h, RAYWHITE);
@@ -158,21 +365,21 @@ static void DrawLectureGridRO(int x, int y, int w, int h) {
     for (r=0;r<=rows;r++) DrawLine(x + timeColW, y + r*cellH, x + timeColW + contentW, y + r*cellH, LIGHTGRAY);
 
     const float VSTART = 8.0f, VEND = 12.0f, VRANGE = VEND - VSTART;
-    int i; for (i=0;i<tt_count;i++) {
-        TimetableEntry *e = &tt_entries[i];
-        if (e->day < 0 || e->day >= 5) continue; if (e->is_lab) continue;
-        float st = e->start_h + e->start_m/60.0f, en = e->end_h + e->end_m/60.0f;
+    const TimetableView *view = &tt_view;
+    for (d=0; d<daysCols; d++) for (int k=TimetableRunBegin(view, TT_LECTURE, d); k<TimetableRunEnd(view, TT_LECTURE, d); k++) {
+        float st = view->start[k] / 60.0f, en = view->end[k] / 60.0f;
         if (en <= VSTART || st >= VEND) continue; if (st < VSTART) st = VSTART; if (en > VEND) en = VEND;
         float ry = y + ((st - VSTART) / VRANGE) * h, rh = ((en - st) / VRANGE) * h; if (rh < 6.0f) rh = 6.0f;
-        int rx = x + timeColW + e->day * cellW + 4, rw = cellW - 8;
+        int rx = x + timeColW + d * cellW + 4, rw = cellW - 8;
         DrawRectangle(rx, (int)ry + 4, rw, (int)rh - 6, Fade(SKYBLUE,0.65f));
         DrawRectangleLines(rx, (int)ry + 4, rw, (int)rh - 6, DARKGRAY);
-        DrawText(e->title, rx + 6, (int)ry + 8, 18, BLACK);
-        char info[160]; snprintf(info, sizeof(info), "%02d:%02d-%02d:%02d  %s", e->start_h, e->start_m, e->end_h, e->end_m, e->room);
+        DrawText(TimetableString(&tt_strings, view->title[k]), rx + 6, (int)ry + 8, 18, BLACK);
+        char info[160]; snprintf(info, sizeof(info), "%02d:%02d-%02d:%02d  %s", view->start[k]/60, view->start[k]%60,
+                                 view->end[k]/60, view->end[k]%60, TimetableString(&tt_strings, view->room[k]));
         DrawText(info, rx + 6, (int)ry + 30, 16, DARKGRAY);
     }
 }
-static void DrawLabGridRO(int x, int y, int w, int h) {
+static void DrawLabLayersRO(int x, int y, int w, int h) {
     int timeColW = 120, daysCols = 5, rows = 4;
     int contentW = w - timeColW, cellW = contentW / daysCols, cellH = h / rows;
     DrawRectangle(x, y, w, h, RAYWHITE);
@@ -192,24 +399,45 @@ static void DrawLabGridRO(int x, int y, int w, int h) {
     for (r=0;r<=rows;r++) DrawLine(x + timeColW, y + r*cellH, x + timeColW + contentW, y + r*cellH, LIGHTGRAY);
 
     const float VSTART = 14.0f, VEND = 18.0f, VRANGE = VEND - VSTART;
-    int i; for (i=0;i<tt_count;i++) {
-        TimetableEntry *e = &tt_entries[i];
-        if (e->day < 0 || e->day >= 5) continue; if (!e->is_lab) continue;
-        float st = e->start_h + e->start_m/60.0f, en = e->end_h + e->end_m/60.0f;
+    const TimetableView *view = &tt_view;
+    for (d=0; d<daysCols; d++) for (int k=TimetableRunBegin(view, TT_LAB, d); k<TimetableRunEnd(view, TT_LAB, d); k++) {
+        float st = view->start[k] / 60.0f, en = view->end[k] / 60.0f;
         if (en <= VSTART || st >= VEND) continue; if (st < VSTART) st = VSTART; if (en > VEND) en = VEND;
         float ry = y + ((st - VSTART) / VRANGE) * h, rh = ((en - st) / VRANGE) * h; if (rh < 6.0f) rh = 6.0f;
-        int rx = x + timeColW + e->day * cellW + 4, rw = cellW - 8;
+        int rx = x + timeColW + d * cellW + 4, rw = cellW - 8;
         DrawRectangle(rx, (int)ry + 4, rw, (int)rh - 6, Fade(GREEN,0.75f));
         DrawRectangleLines(rx, (int)ry + 4, rw, (int)rh - 6, DARKGRAY);
-        DrawText(e->title, rx + 6, (int)ry + 8, 18, BLACK);
-        char info[160]; snprintf(info, sizeof(info), "%02d:%02d-%02d:%02d  %s", e->start_h, e->start_m, e->end_h, e->end_m, e->room);
+        DrawText(TimetableString(&tt_strings, view->title[k]), rx + 6, (int)ry + 8, 18, BLACK);
+        char info[160]; snprintf(info, sizeof(info), "%02d:%02d-%02d:%02d  %s", view->start[k]/60, view->start[k]%60,
+                                 view->end[k]/60, view->end[k]%60, TimetableString(&tt_strings, view->room[k]));
         DrawText(info, rx + 6, (int)ry + 30, 16, DARKGRAY);
     }
 }
 
+// The grids above only change with tt_version, so each is drawn into a texture once
+static GridCache grid_cache[2];                     // Lecture, lab
+#define GRID_LABEL_H 30                             // Day names sit above the grid
+static void DrawCachedGridRO(GridCache *cache, void (*layers)(int, int, int, int), int x, int y, int w, int h) {
+    int width = w + 1, height = GRID_LABEL_H + h + 1;   // Lines on the right and bottom edge
+    if (!GridCacheFresh(cache, width, height, tt_version)) {
+        if (!GridCacheBegin(cache, width, height, RAYWHITE)) { layers(x, y, w, h); return; }
+        layers(0, GRID_LABEL_H, w, h);
+        GridCacheEnd(cache, tt_version);
+    }
+    GridCacheDraw(cache, x, y - GRID_LABEL_H);
+}
+static void DrawLectureGridRO(int x, int y, int w, int h) { DrawCachedGridRO(&grid_cache[0], DrawLectureLayersRO, x, y, w, h); }
+static void DrawLabGridRO(int x, int y, int w, int h) { DrawCachedGridRO(&grid_cache[1], DrawLabLayersRO, x, y, w, h); }
+
 enum { TAB_TIMETABLE=0, TAB_LABS=1, TAB_ASSIGN=2, TAB_SEM=3, TAB_ATT=4, TAB_RES=5 };
 static int active_tab = 0;
 
+// Tables each tab draws from
+static unsigned tab_tables(int tab) {
+    static const unsigned tables[] = { TABLE_TT, TABLE_TT, TABLE_ASSIGN | TABLE_PROGRESS, TABLE_SEM, TABLE_ATT, TABLE_RES };
+    return (tab >= TAB_TIMETABLE && tab <= TAB_RES) ? tables[tab] : TABLE_TT;
+}
+
 // ---------------- Header (Unchanged from v2) ----------------
 static void DrawHeaderRO(int screenWidth) {
     DrawRectangle(0,0,screenWidth, 64, BLUE);
@@ -242,11 +470,44 @@ static void Tab_LabsRO(int x, int y, int w) {
     DrawLabGridRO(x, y+50, w, 700);
 }
 
+static const char* DEADLINE_LABELS[DL_STATE_COUNT] = {"Assigned","Pending","Submitted","Late"};
+
+static const Assignment* assignment_by_id(int id) {
+    for (int i=0;i<assign_count;i++) if (assignments[i].id == id) return &assignments[i];
+    return NULL;
+}
+
+// One column of the per-student strip: task indices from the deadline index
+static void DrawDeadlineList(int x, int y, const char *title, Color color, const int *tasks, int n, int student) {
+    DrawText(title, x, y, 20, color);
+    if (n == 0) DrawText("None", x, y+30, 20, DARKGRAY);
+    for (int k=0;k<n;k++) {
+        const Assignment *a = assignment_by_id(deadlines.tasks[tasks[k]].id);
+        DeadlineState state = student >= 0 ? DeadlineStateAt(&deadlines, tasks[k], student) : DL_ASSIGNED;
+        DrawText(a ? a->title : "?", x, y+30+k*28, 20, BLACK);
+        DrawText(a ? a->due_date : "", x+420, y+30+k*28, 20, color);
+        DrawText(DEADLINE_LABELS[state], x+590, y+30+k*28, 20, DARKGRAY);
+    }
+}
+
 // MODIFIED: All fonts, layout, and new columns
 static void Tab_AssignRO(int x, int y, int w) {
-    DrawText("Assignments", x, y, 30, DARKBLUE);
+    DrawText(student_id[0] ? TextFormat("Assignments - %s", student_id) : "Assignments", x, y, 30, DARKBLUE);
     
     int listX=x, listY=y+50, listW=w, listH = 700;
+    // A student not in assignment_progress.txt yet has handed nothing in
+    int student = student_id[0] ? DeadlineFindStudent(&deadlines, student_id) : -1;
+    if (student_id[0]) {
+        int overdue[4], next[4], stripH = 150;
+        int32_t today = DeadlineToday();
+        int overdueCount = DeadlineOverdueFor(&deadlines, student, today, overdue, 4);
+        int nextCount = DeadlineNext(&deadlines, student, today, next, 4);
+        DrawRectangle(listX, listY, listW, stripH, Fade(LIGHTGRAY, 0.2f));
+        DrawRectangleLines(listX, listY, listW, stripH, LIGHTGRAY);
+        DrawDeadlineList(listX+20, listY+10, "Overdue", RED, overdue, overdueCount, student);
+        DrawDeadlineList(listX+listW/2, listY+10, "Next deadlines", DARKBLUE, next, nextCount, student);
+        listY += stripH + 10; listH -= stripH + 10;
+    }
     DrawRectangle(listX, listY, listW, listH, RAYWHITE);
     DrawRectangleLines(listX, listY, listW, listH, LIGHTGRAY);
     
@@ -270,6 +531,7 @@ static void Tab_AssignRO(int x, int y, int w) {
         DrawText(a->title,      col1, ly, 20, BLACK);
         DrawText(a->due_date,   col2, ly, 20, BLACK);
         const char* st="Assigned"; if (a->status==PENDING) st="Pending"; if (a->status==SUBMITTED) st="Submitted";
+        if (student_id[0]) st = DEADLINE_LABELS[student >= 0 ? DeadlineStateOf(&deadlines, student, a->id) : DL_ASSIGNED];
         DrawText(st,            col3, ly, 20, BLACK);
         DrawText(a->issued_by,  col4, ly, 20, DARKGRAY); // This is the prof name
         DrawText(a->desc,       col5, ly, 20, DARKGRAY);
@@ -288,27 +550,45 @@ static void Tab_SemRO(int x, int y, int w) {
     char cred[64]; snprintf(cred, sizeof(cred), "Total Credits: %d", seminfo.total_credits);
     DrawText(cred, x, mainY, 20, BLACK);
 
-    int col1x = x, topY = y + 200;
-    DrawText("Official Holiday List 2025", col1x, topY, 24, DARKBLUE);
-    
-    int hy = topY + 40;
-    DrawText("26/01/2025 (Sunday)  -  Republic Day", x, hy, 20, BLACK); hy += 30;
-    DrawText("26/02/2025 (Wednesday)  -  Maha Shivaratri", x, hy, 20, BLACK); hy += 30;
-    DrawText("14/03/2025 (Friday)  -  Holi / Dhulivandan", x, hy, 20, BLACK); hy += 30;
-    DrawText("15/08/2025 (Friday)  -  Independence Day", x, hy, 20, BLACK); hy += 30;
-    DrawText("02/10/2025 (Thursday)  -  Mahatma Gandhi’s Birthday", x, hy, 20, BLACK); hy += 30;
-    DrawText("20/10/2025 (Monday)  -  Diwali (Deepavali)", x, hy, 20, BLACK); hy += 30;
-    DrawText("25/12/2025 (Thursday)  -  Christmas Day", x, hy, 20, BLACK); hy += 30;
-
+    int topY = y + 200;
+    int year = atoi(seminfo.start_date);
+    if (year < 1900) year = 2025;
+    char header[64]; snprintf(header, sizeof(header), "Official Holiday List %d", year);
+    DrawText(header, x, topY, 24, DARKBLUE);
+
+    // Holidays on the left, the other event types of the same year on the right
+    static const char* titles[CAL_TYPE_COUNT] = {"Holidays", "Exams (Official):", "Tests:", "Orientation:", "Deadlines:"};
+    int begin, end;
+    CalendarRange(&calendar, year*10000 + 101, year*10000 + 1231, &begin, &end);
+    int hy = topY + 40, ey = topY;
+    for (int i=begin; i<end; i++) {
+        const CalendarEvent *e = &calendar.events[i];
+        if (e->type != CAL_HOLIDAY || e->end < year*10000 + 101) continue;
+        char date[16], line[256];
+        snprintf(line, sizeof(line), "%s (%s)  -  %s", CalendarFormatDate(e->start, date, 16), CalendarWeekdayName(e->start), e->title);
+        DrawText(line, x, hy, 20, BLACK); hy += 30;
+    }
     int examsX = x + 700;
-    DrawText("Exams (Official):", examsX, topY, 24, DARKBLUE);
-    DrawText("MIDSEM  :  03-10-2025  --->  08-10-2025", examsX, topY + 40, 20, BLACK);
-    DrawText("ENDSEM  :  03-12-2025  --->  08-12-2025", examsX, topY + 70, 20, BLACK);
+    for (int t=1; t<CAL_TYPE_COUNT; t++) {
+        bool shown = false;
+        for (int i=begin; i<end; i++) {
+            const CalendarEvent *e = &calendar.events[i];
+            if (e->type != t || e->end < year*10000 + 101) continue;
+            if (!shown) { DrawText(titles[t], examsX, ey, 24, DARKBLUE); ey += 40; shown = true; }
+            char from[16], to[16], line[256];
+            if (e->end != e->start) snprintf(line, sizeof(line), "%s  :  %s  --->  %s", e->title, CalendarFormatDate(e->start, from, 16), CalendarFormatDate(e->end, to, 16));
+            else snprintf(line, sizeof(line), "%s  :  %s", e->title, CalendarFormatDate(e->start, from, 16));
+            DrawText(line, examsX, ey, 20, BLACK); ey += 30;
+        }
+        if (shown) ey += 10;
+    }
 }
 
-// MODIFIED: All fonts and layout
+// MODIFIED: Reads the per-session attendance store. With a student ID each subject
+// shows that student's sessions; without one, the class figures.
 static void Tab_AttRO(int x, int y, int w) {
-    DrawText("Student Attendance", x, y, 30, DARKBLUE);
+    int student = student_id[0] ? AttendanceFindStudent(&attendance, student_id) : -1;
+    DrawText(student_id[0] ? TextFormat("Student Attendance - %s", student_id) : "Student Attendance (class)", x, y, 30, DARKBLUE);
 
     int listX=x, listY=y+50, listW=w, listH = 700;
     DrawRectangle(listX, listY, listW, listH, RAYWHITE);
@@ -316,23 +596,35 @@ static void Tab_AttRO(int x, int y, int w) {
     
     DrawText("Subject", x+10, y+60, 20, DARKGRAY);
     DrawText("Total", x+400, y+60, 20, DARKGRAY);
-    DrawText("Attended", x+500, y+60, 20, DARKGRAY);
-    DrawText("Missed", x+620, y+60, 20, DARKGRAY);
+    DrawText(student_id[0] ? "Attended" : "Students", x+500, y+60, 20, DARKGRAY);
+    DrawText(student_id[0] ? "Missed" : TextFormat("< %d%%", ATTENDANCE_THRESHOLD), x+620, y+60, 20, DARKGRAY);
     DrawText("Percent", x+720, y+60, 20, DARKGRAY);
+    if (student_id[0]) DrawText("Missed last 5", x+840, y+60, 20, DARKGRAY);
     DrawLine(listX, listY+40, listX+listW, listY+40, LIGHTGRAY);
 
-    int ly = y+100, i;
-    for (i=0;i<attendance_count;i++) {
-        AttendanceRecord *a = &attendance[i];
-        DrawText(a->subject, x+10, ly, 20, BLACK);
-        char buf[64];
-        snprintf(buf, sizeof(buf), "%d", a->total_lectures); DrawText(buf, x+400, ly, 20, BLACK);
-        snprintf(buf, sizeof(buf), "%d", a->attended);       DrawText(buf, x+500, ly, 20, BLACK);
-        snprintf(buf, sizeof(buf), "%d", a->total_lectures - a->attended); DrawText(buf, x+620, ly, 20, BLACK);
-        float pct = 0.0f; if (a->total_lectures) pct = 100.0f * a->attended / a->total_lectures;
-        char pctbuf[32]; snprintf(pctbuf, sizeof(pctbuf), "%.1f%%", pct); DrawText(pctbuf, x+720, ly, 20, BLACK);
+    int ly = y+100, i, shown = 0;
+    for (i=0;i<attendance.subjectCount;i++) {
+        const AttendanceSubject *sub = &attendance.subjects[i];
+        int set = student >= 0 ? AttendanceFindSet(&attendance, i, student) : -1;
+        if (student_id[0] && set < 0) continue;         // Not enrolled
+        DrawText(sub->name, x+10, ly, 20, BLACK);
+        DrawText(TextFormat("%d", sub->sessions), x+400, ly, 20, BLACK);
+        if (set >= 0) {
+            const AttendanceSet *a = &attendance.sets[set];
+            float pct = AttendancePercent(&attendance, i, a);
+            DrawText(TextFormat("%d", a->cardinality), x+500, ly, 20, BLACK);
+            DrawText(TextFormat("%d", sub->sessions - a->cardinality), x+620, ly, 20, BLACK);
+            DrawText(TextFormat("%.1f%%", pct), x+720, ly, 20, pct < ATTENDANCE_THRESHOLD ? RED : BLACK);
+            DrawText(TextFormat("%d", AttendanceMissedLast(&attendance, i, a, 5)), x+840, ly, 20, BLACK);
+        } else {
+            DrawText(TextFormat("%d", sub->setCount), x+500, ly, 20, BLACK);
+            DrawText(TextFormat("%d", AttendanceBelow(&attendance, i, ATTENDANCE_THRESHOLD, NULL, 0)), x+620, ly, 20, BLACK);
+            DrawText(TextFormat("%.1f%%", AttendanceSubjectPercent(&attendance, i)), x+720, ly, 20, BLACK);
+        }
+        shown++;
         ly += 44; if (ly > listY + listH - 30) break;
     }
+    if (student_id[0] && shown == 0) DrawText("Not enrolled in any subject yet.", x+10, ly, 20, DARKGRAY);
 }
 
 // MODIFIED: All fonts, layout, and NO SPI
@@ -366,16 +658,26 @@ static void Tab_ResRO(int x, int y, int w) {
 }
 
 // ---------------- MAIN (Unchanged from v2) ----------------
-int main(int argc, char *argv[]) {
-    if(argc<3) return 0;
+PORTAL_ENTRY(AcademicsStudentMain) {
+    const char *id = (argc >= 2) ? argv[1] : "";     // Optional student ID
+    if (!visited || strcmp(visited_id, id) != 0 || tables_version != table_files_version()) {
+        reset_tables();
+        snprintf(student_id, sizeof(student_id), "%s", id);
+    }
+    visited = true; snprintf(visited_id, sizeof(visited_id), "%s", id);
+    tables_version = table_files_version();
     const int screenWidth = 1920;
     const int screenHeight = 1080;
-    InitWindow(screenWidth, screenHeight, "University Portal - Academics (Student Window)");
+    PortalInitWindow(screenWidth, screenHeight, "University Portal - Academics (Student Window)");
+    double windowReady = GetTime();
     SetTargetFPS(60);
 
-    load_timetable(); load_assignments(); load_semester(); load_attendance(); load_results();
+    if (student_id[0]) load_student_tables(tab_tables(active_tab));
+    else if (loaded_tables != TABLE_ALL) load_all();
+    TraceLog(LOG_INFO, "ACADSTU: First frame after %.1f ms.", (GetTime() - windowReady) * 1000.0);
 
     while (!WindowShouldClose()) {
+        if (student_id[0]) load_student_tables(tab_tables(active_tab));  // First visit to a tab
         BeginDrawing(); ClearBackground(RAYWHITE); 
         DrawHeaderRO(screenWidth);
         
@@ -395,6 +697,7 @@ int main(int argc, char *argv[]) {
         EndDrawing();
     }
 
-    CloseWindow();
+    GridCacheUnload(&grid_cache[0]); GridCacheUnload(&grid_cache[1]);
+    PortalCloseWindow();
     return 0;
 }
\ No newline at end of file
@@ -13,6 +13,17 @@
 * - Allows ADDING users (launches main.exe).
 * - Added a REFRESH button to reload user lists.
 * - File I/O for users now correctly parses/writes .txt files.
+* - Rewriting a user file also rewrites its sorted .idx profile index.
+* - User lists are no longer capped at 100/50 entries: tables grow on demand
+* - and all their strings live in one arena per list, freed on reload.
+* - Removing a user only tombstones its record in place (the id line gets a
+* - leading '~'); the file is compacted once dead space passes 25%.
+* - Both user lists are virtualized: only the visible rows are drawn, their
+* - labels are cached until the list changes, and scrolling is clamped.
+* - Type-ahead search over ID, name, email and course/department, backed by
+* - a sorted prefix index that follows removals and Refresh-time appends.
+* - Fees are kept in an append-only ledger (feeledger.h) instead of being
+* - rewritten to fees.dat: Save posts one charge or payment per changed field.
 * -
 * - FIX: All DrawButton() calls moved into the drawing loop to make
 * - buttons visible.
@@ -20,9 +31,14 @@
 ********************************************************************************************/
 
 #include "raylib.h"
+#include "portal.h"
+#include "feeledger.h"
+#include "profileindex.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <ctype.h>
+#include <stdint.h>
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
@@ -31,14 +47,21 @@
 //----------------------------------------------------------------------------------
 // Defines and Macros
 //----------------------------------------------------------------------------------
-#define MAX_FACULTIES 50
-#define MAX_STUDENTS 100
-#define MAX_FEES 100
+#define USER_TABLE_INITIAL_CAPACITY 128
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define TOMBSTONE_MARK '~'          // Never typed into an ID box (input stops at 125)
+#define COMPACT_DEAD_RATIO 4        // Compact when dead bytes exceed 1/4 of the file
 #define MAX_COMPLAINTS 100
 #define MAX_INPUT_CHARS 50
 #define MAX_ADDRESS_CHARS 100
 #define MAX_COMPLAINT_CHARS 256
 #define MAX_LINE_LENGTH 256
+#define LIST_ROW_HEIGHT 40
+#define LIST_LABEL_CACHE 64         // More than the rows that fit in a list box
+#define LIST_LABEL_LENGTH 128
+#define MAX_SEARCH_RESULTS 8
+#define SEARCH_KEYS_PER_FIELD 8     // Word starts indexed per name/course field
+#define SEARCH_SCAN_LIMIT 256       // Index entries looked at per query, at most
 
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
@@ -48,32 +71,82 @@ typedef enum {
     SCREEN_MAIN_DASHBOARD
 } GameScreen;
 
-// Copied from afterreg.c for full user info
+// One block of a string arena; blocks are chained and freed together
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    int used;
+    int capacity;
+    char data[];
+} ArenaBlock;
+
+// Bump allocator holding every string of one user list load
+typedef struct {
+    ArenaBlock *head;
+    long totalBytes;
+} StringArena;
+
+// Same fields as StudentInfo in afterreg.c, but the strings live in studentArena
 typedef struct {
-    char id[MAX_INPUT_CHARS + 1];
-    char password[MAX_INPUT_CHARS + 1];
-    char name[MAX_INPUT_CHARS + 1];
-    char address[MAX_ADDRESS_CHARS + 1];
-    char phone[MAX_INPUT_CHARS + 1];
-    char email[MAX_INPUT_CHARS + 15];
-    char course[MAX_INPUT_CHARS + 1];
-    char semester[MAX_INPUT_CHARS + 1];
-    char height[MAX_INPUT_CHARS + 1];
-    char bloodGroup[5];
+    const char *id;
+    const char *password;
+    const char *name;
+    const char *address;
+    const char *phone;
+    const char *email;
+    const char *course;
+    const char *semester;
+    const char *height;
+    const char *bloodGroup;
+    long fileOffset;        // Where the record's id line starts in student_info.txt
+    long recordBytes;
 } StudentInfo;
 
+// Same fields as FacultyInfo in afterreg.c, but the strings live in facultyArena
 typedef struct {
-    char id[MAX_INPUT_CHARS + 1];
-    char password[MAX_INPUT_CHARS + 1];
-    char name[MAX_INPUT_CHARS + 1];
-    char address[MAX_ADDRESS_CHARS + 1];
-    char phone[MAX_INPUT_CHARS + 1];
-    char email[MAX_INPUT_CHARS + 15];
-    char department[MAX_INPUT_CHARS + 1];
-    char designation[MAX_INPUT_CHARS + 1];
+    const char *id;
+    const char *password;
+    const char *name;
+    const char *address;
+    const char *phone;
+    const char *email;
+    const char *department;
+    const char *designation;
+    long fileOffset;        // Where the record's id line starts in faculty_info.txt
+    long recordBytes;
 } FacultyInfo;
 
 
+// Scroll state and label cache for a virtualized user list
+typedef struct {
+    float scroll;                   // <= 0, same convention as the other scroll vectors
+    int version;                    // Bumped whenever the backing table changes
+    int labelIndex[LIST_LABEL_CACHE];   // Row each cache slot holds, -1 if empty
+    int labelVersion[LIST_LABEL_CACHE];
+    char labels[LIST_LABEL_CACHE][LIST_LABEL_LENGTH];
+} VirtualList;
+
+// One searchable word: a lowercased field, or a suffix of it starting at a word
+typedef struct {
+    const char *key;
+    const char *id;         // Points into the user list's arena, stable until reload
+    const char *name;
+} SearchEntry;
+
+// Entries sorted by (key, id) so prefix queries are a binary search plus a short scan
+typedef struct {
+    SearchEntry *entries;
+    int count;
+    int capacity;
+    int version;            // Bumped on every change so cached results can be dropped
+    StringArena keys;       // Lowercased copies of the indexed fields
+} SearchIndex;
+
+typedef struct {
+    const char *id;
+    const char *name;
+    bool isFaculty;
+} SearchResult;
+
 // Struct for fee data (unchanged)
 typedef struct {
     char id[MAX_INPUT_CHARS];
@@ -100,6 +173,7 @@ typedef enum {
     TEXTBOX_NONE,
     // REMOVED LOGIN TEXTBOXES
     TEXTBOX_FEE_SEARCH_ID,
+    TEXTBOX_USER_SEARCH,
     TEXTBOX_FEE_TUITION_TOTAL,
     TEXTBOX_FEE_TUITION_PAID,
     TEXTBOX_FEE_HOSTEL_TOTAL,
@@ -110,41 +184,59 @@ typedef enum {
 //----------------------------------------------------------------------------------
 // Global Variables
 //----------------------------------------------------------------------------------
-const int screenWidth = 1920;
-const int screenHeight = 1080;
+static const int screenWidth = 1920;
+static const int screenHeight = 1080;
 
-GameScreen currentScreen = SCREEN_MAIN_DASHBOARD; // Start at dashboard
-int activeTab = 0; // 0=Fees, 1=Users, 2=Complaints
+static GameScreen currentScreen = SCREEN_MAIN_DASHBOARD; // Start at dashboard
+static int activeTab = 0; // 0=Fees, 1=Users, 2=Complaints
 Vector2 scroll = { 0 };
-int framesCounter = 0; // For blinking cursor
+static int framesCounter = 0; // For blinking cursor
 
 // --- User Management Data (NEW) ---
-StudentInfo allStudents[MAX_STUDENTS];
+StudentInfo *allStudents = NULL;
 int allStudentCount = 0;
-FacultyInfo allFaculties[MAX_FACULTIES];
+int allStudentCapacity = 0;
+StringArena studentArena = { 0 };
+long studentFileBytes = 0;
+long studentDeadBytes = 0;         // Bytes held by tombstoned student records
+FacultyInfo *allFaculties = NULL;
 int allFacultyCount = 0;
-Vector2 studentScroll = { 0 };
-Vector2 facultyScroll = { 0 };
-
-
-// --- Fee Management Data (Unchanged) ---
-FeeData fees[MAX_FEES];
-int feeCount = 0;
+int allFacultyCapacity = 0;
+StringArena facultyArena = { 0 };
+long facultyFileBytes = 0;
+long facultyDeadBytes = 0;
+unsigned int studentTableVersion = 0;  // PortalFileVersion() of each file when its table was read
+unsigned int facultyTableVersion = 0;
+VirtualList studentList = { 0 };
+VirtualList facultyList = { 0 };
+SearchIndex studentSearch = { 0 };
+SearchIndex facultySearch = { 0 };
+char userSearchQuery[MAX_INPUT_CHARS] = { 0 };
+char userSearchLastQuery[MAX_INPUT_CHARS] = { 0 };
+int userSearchVersion = -1;        // studentSearch + facultySearch versions the results match
+SearchResult userSearchResults[MAX_SEARCH_RESULTS];
+int userSearchResultCount = 0;
+double userSearchMs = 0.0;
+
+
+// --- Fee Management Data ---
+static FeeLedger feeLedger = { 0 };
 FeeData currentFeeEntry = { 0 }; // The entry being edited
-int currentFeeIndex = -1; // Index in the fees array, -1 if new
 char feeSearchId[MAX_INPUT_CHARS] = { 0 };
 char feeTuitionTotalStr[MAX_INPUT_CHARS] = { 0 };
 char feeTuitionPaidStr[MAX_INPUT_CHARS] = { 0 };
 char feeHostelTotalStr[MAX_INPUT_CHARS] = { 0 };
 char feeHostelPaidStr[MAX_INPUT_CHARS] = { 0 };
 bool feeEditorActive = false;
-char statusMessage[100] = { 0 };
+static char statusMessage[100] = { 0 };
 
 // --- Complaint Data (Unchanged) ---
 Complaint complaints[MAX_COMPLAINTS];
 int complaintCount = 0; // <<< FIX: ADD THIS LINE BACK
+static bool complaintsLoaded = false;
+static unsigned int complaintsVersion = 0;
 // --- Text Input State (Removed login vars) ---
-ActiveTextBox activeTextBox = TEXTBOX_NONE;
+static ActiveTextBox activeTextBox = TEXTBOX_NONE;
 // char loginId[MAX_INPUT_CHARS] = { 0 }; // REMOVED
 // char loginPass[MAX_INPUT_CHARS] = { 0 }; // REMOVED
 // char loginError[100] = { 0 }; // REMOVED
@@ -169,27 +261,48 @@ static void LoadAllStudentInfo(void);
 static void SaveAllStudentInfo(void);
 static void LoadAllFacultyInfo(void);
 static void SaveAllFacultyInfo(void);
-static void safe_fgets_and_strip_admin(char* dest, int n, FILE* file, int maxLen);
+static void RefreshUserTables(void);
+static void NoteUserFileWritten(const char *filename, unsigned int *tableVersion);
+static const char *ArenaReadLine(StringArena *arena, FILE *file, int maxLen);
+static const char *ArenaStrndup(StringArena *arena, const char *src, int maxLen);
+static void ArenaFree(StringArena *arena);
+static void WriteProfileIndex(const char *indexFile, ProfileIndexEntry *entries, int count, long sourceSize);
+static bool TombstoneRecord(const char *filename, const char *id, long offset);
+static long SkipTombstonedRecord(FILE *file, long offset);
+static void RemoveStudentAt(int index);
+static void RemoveFacultyAt(int index);
+
+// --- User Search ---
+static void SearchReset(SearchIndex *index);
+static void SearchAddUser(SearchIndex *index, const char *id, const char *name, const char *email, const char *group, bool keepSorted);
+static void SearchRemoveUser(SearchIndex *index, const char *id, const char *name, const char *email, const char *group);
+static void SearchSort(SearchIndex *index);
+static void UpdateUserSearch(void);
+static void ShowSearchResult(const SearchResult *result);
 
 
 // --- GUI Helper Functions ---
 static void DrawMyTextBox(Rectangle bounds, const char *text, bool active);
 static void HandleTextInput(char *buffer, int maxChars);
 static bool DrawButton(Rectangle bounds, const char* text, Color color); // NEW Button helper
+static void InvalidateVirtualList(VirtualList *list);
+static int ClampVirtualList(VirtualList *list, int itemCount, float viewHeight, int *first);
+static const char *GetVirtualListLabel(VirtualList *list, int index, const char *id, const char *name);
 
 //----------------------------------------------------------------------------------
 // Main Entry Point
 //----------------------------------------------------------------------------------
-int main(int argc, char *argv[])
+PORTAL_ENTRY(AdminPortalMain)
 {   if(argc<3) return 0;
-    InitWindow(screenWidth, screenHeight, "University Admin Portal");
+    PortalInitWindow(screenWidth, screenHeight, "University Admin Portal");
 
     // Load initial data
     // LoadFaculties(); // REMOVED
-    LoadAllStudentInfo(); // NEW
-    LoadAllFacultyInfo(); // NEW
-    LoadFees();
-    LoadComplaints();
+    // Inside the portal shell everything stays loaded between visits; only files another
+    // screen wrote since are read again (registration appends, student complaints)
+    RefreshUserTables(); // NEW
+    if (feeLedger.log == NULL) LoadFees();
+    if (!complaintsLoaded || complaintsVersion != PortalFileVersion("complaints.dat")) LoadComplaints();
 
     SetTargetFPS(60);
 
@@ -202,14 +315,26 @@ int main(int argc, char *argv[])
     }
 #endif
 
-    CloseWindow();
+#if defined(PORTAL_SHELL)
+    // The ledger stays open for the next visit; checkpoint what this one posted
+    if (feeLedger.records > feeLedger.checkpointed) FeeCheckpoint(&feeLedger);
+#else
+    FeeLedgerClose(&feeLedger);
+    free(allStudents);
+    free(allFaculties);
+    ArenaFree(&studentArena);
+    ArenaFree(&facultyArena);
+    SearchReset(&studentSearch);
+    SearchReset(&facultySearch);
+#endif
+    PortalCloseWindow();
     return 0;
 }
 
 //----------------------------------------------------------------------------------
 // Main Update/Draw Loop
 //----------------------------------------------------------------------------------
-void UpdateDrawFrame(void)
+static void UpdateDrawFrame(void)
 {
     framesCounter++;
 
@@ -231,59 +356,136 @@ void UpdateDrawFrame(void)
 // File I/O Functions
 //----------------------------------------------------------------------------------
 
-// Helper function to read a line from the .txt file
-static void safe_fgets_and_strip_admin(char* dest, int n, FILE* file, int maxLen) {
-    if (fgets(dest, n, file) != NULL) {
-        dest[strcspn(dest, "\r\n")] = 0; // Strip newline
-        dest[maxLen] = '\0'; 
+// Copies at most maxLen chars of src into the arena and returns the copy
+static const char *ArenaStrndup(StringArena *arena, const char *src, int maxLen) {
+    int len = (int)strnlen(src, maxLen);
+    if (arena->head == NULL || arena->head->used + len + 1 > arena->head->capacity) {
+        int capacity = (len + 1 > ARENA_BLOCK_SIZE) ? len + 1 : ARENA_BLOCK_SIZE;
+        ArenaBlock *block = (ArenaBlock *)malloc(sizeof(ArenaBlock) + capacity);
+        block->next = arena->head;
+        block->used = 0;
+        block->capacity = capacity;
+        arena->head = block;
+        arena->totalBytes += sizeof(ArenaBlock) + capacity;
+    }
+    char *dest = arena->head->data + arena->head->used;
+    memcpy(dest, src, len);
+    dest[len] = '\0';
+    arena->head->used += len + 1;
+    return dest;
+}
+
+// Releases every string of a load in one step
+static void ArenaFree(StringArena *arena) {
+    ArenaBlock *block = arena->head;
+    while (block != NULL) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+    arena->totalBytes = 0;
+}
+
+// Helper function to read a line from the .txt file into the arena
+static const char *ArenaReadLine(StringArena *arena, FILE *file, int maxLen) {
+    char line[MAX_LINE_LENGTH];
+    if (fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = 0; // Strip newline
     } else {
-        dest[0] = '\0'; // Set to empty string on error
+        line[0] = '\0'; // Set to empty string on error
     }
+    return ArenaStrndup(arena, line, maxLen);
 }
 
 void LoadAllStudentInfo(void) {
-    FILE *file = fopen("student_info.txt", "r");
+    studentTableVersion = PortalFileVersion("student_info.txt");
+    FILE *file = fopen("student_info.txt", "rb"); // Binary, so ftell gives byte offsets
     if (!file) {
         TraceLog(LOG_WARNING, "student_info.txt not found.");
         return;
     }
 
-    allStudentCount = 0;
+    // Registration only ever appends, so if the file just grew read the new
+    // records and keep everything already loaded
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    bool appendOnly = (allStudentCount > 0 && studentFileBytes > 0 && fileSize > studentFileBytes);
+    int firstNew = appendOnly ? allStudentCount : 0;
+    if (appendOnly) {
+        fseek(file, studentFileBytes, SEEK_SET);
+    } else {
+        // Drop the previous load in one step
+        fseek(file, 0, SEEK_SET);
+        allStudentCount = 0;
+        studentDeadBytes = 0;
+        ArenaFree(&studentArena);
+        SearchReset(&studentSearch);
+    }
+    InvalidateVirtualList(&studentList);
     char line[MAX_LINE_LENGTH];
+    long recordStart = ftell(file);
     
-    while (fgets(line, sizeof(line), file) != NULL && allStudentCount < MAX_STUDENTS) {
+    while (fgets(line, sizeof(line), file) != NULL) {
         line[strcspn(line, "\r\n")] = 0;
-        if (strlen(line) < 2) continue; // Skip empty lines
+        if (strlen(line) < 2) { recordStart = ftell(file); continue; } // Skip empty lines
+        if (line[0] == TOMBSTONE_MARK) { // Removed user, only counts as dead space
+            studentDeadBytes += SkipTombstonedRecord(file, recordStart);
+            recordStart = ftell(file);
+            continue;
+        }
 
+        if (allStudentCount == allStudentCapacity) {
+            allStudentCapacity = allStudentCapacity ? allStudentCapacity * 2 : USER_TABLE_INITIAL_CAPACITY;
+            allStudents = (StudentInfo *)realloc(allStudents, allStudentCapacity * sizeof(StudentInfo));
+        }
         StudentInfo* s = &allStudents[allStudentCount];
         
-        strcpy(s->id, line);
-        safe_fgets_and_strip_admin(s->password,   sizeof(line), file, MAX_INPUT_CHARS);
-        safe_fgets_and_strip_admin(s->name,       sizeof(line), file, MAX_INPUT_CHARS);
-        safe_fgets_and_strip_admin(s->address,    sizeof(line), file, MAX_ADDRESS_CHARS);
-        safe_fgets_and_strip_admin(s->phone,      sizeof(line), file, MAX_INPUT_CHARS);
-        safe_fgets_and_strip_admin(s->email,      sizeof(line), file, MAX_INPUT_CHARS + 15);
-        safe_fgets_and_strip_admin(s->course,     sizeof(line), file, MAX_INPUT_CHARS);
-        safe_fgets_and_strip_admin(s->semester,   sizeof(line), file, MAX_INPUT_CHARS);
-        safe_fgets_and_strip_admin(s->height,     sizeof(line), file, MAX_INPUT_CHARS);
-        safe_fgets_and_strip_admin(s->bloodGroup, sizeof(line), file, 4);
+        s->id         = ArenaStrndup(&studentArena, line, MAX_INPUT_CHARS);
+        s->password   = ArenaReadLine(&studentArena, file, MAX_INPUT_CHARS);
+        s->name       = ArenaReadLine(&studentArena, file, MAX_INPUT_CHARS);
+        s->address    = ArenaReadLine(&studentArena, file, MAX_ADDRESS_CHARS);
+        s->phone      = ArenaReadLine(&studentArena, file, MAX_INPUT_CHARS);
+        s->email      = ArenaReadLine(&studentArena, file, MAX_INPUT_CHARS + 14);
+        s->course     = ArenaReadLine(&studentArena, file, MAX_INPUT_CHARS);
+        s->semester   = ArenaReadLine(&studentArena, file, MAX_INPUT_CHARS);
+        s->height     = ArenaReadLine(&studentArena, file, MAX_INPUT_CHARS);
+        s->bloodGroup = ArenaReadLine(&studentArena, file, 4);
         fgets(line, sizeof(line), file); // Read the "--END--" separator
+        s->fileOffset = recordStart;
+        recordStart = ftell(file);
+        s->recordBytes = recordStart - s->fileOffset;
         
         allStudentCount++;
     }
+    studentFileBytes = ftell(file);
     fclose(file);
-    TraceLog(LOG_INFO, TextFormat("Loaded %d students.", allStudentCount));
+
+    double searchStart = GetTime();
+    for (int i = firstNew; i < allStudentCount; i++) {
+        StudentInfo *s = &allStudents[i];
+        SearchAddUser(&studentSearch, s->id, s->name, s->email, s->course, appendOnly);
+    }
+    if (!appendOnly) SearchSort(&studentSearch);
+    TraceLog(LOG_INFO, "Indexed %d new students for search in %.1f ms (%d keys).",
+             allStudentCount - firstNew, (GetTime() - searchStart) * 1000.0, studentSearch.count);
+    TraceLog(LOG_INFO, "Loaded %d students (%ld KB strings, %ld KB table).", allStudentCount,
+             studentArena.totalBytes / 1024, (long)(allStudentCapacity * sizeof(StudentInfo)) / 1024);
 }
 
 void SaveAllStudentInfo(void) {
-    FILE *file = fopen("student_info.txt", "w"); // "w" = overwrite
+    FILE *file = fopen("student_info.txt", "wb"); // Overwrite; binary so offsets match the loader
     if (!file) {
         TraceLog(LOG_ERROR, "Could not open student_info.txt for writing.");
         return;
     }
     
+    ProfileIndexEntry *entries = (ProfileIndexEntry *)calloc(allStudentCount + 1, sizeof(ProfileIndexEntry));
     for (int i = 0; i < allStudentCount; i++) {
         StudentInfo* s = &allStudents[i];
+        strcpy(entries[i].id, s->id);
+        entries[i].offset = ftell(file);
+        s->fileOffset = entries[i].offset;
         fprintf(file, "%s\n", s->id);
         fprintf(file, "%s\n", s->password);
         fprintf(file, "%s\n", s->name);
@@ -295,52 +497,104 @@ void SaveAllStudentInfo(void) {
         fprintf(file, "%s\n", s->height);
         fprintf(file, "%s\n", s->bloodGroup);
         fprintf(file, "--END--\n");
+        s->recordBytes = ftell(file) - s->fileOffset;
     }
+    long sourceSize = ftell(file);
     fclose(file);
-    TraceLog(LOG_INFO, TextFormat("Saved %d students.", allStudentCount));
+    studentFileBytes = sourceSize;
+    studentDeadBytes = 0;
+    WriteProfileIndex("student_info.idx", entries, allStudentCount, sourceSize);
+    NoteUserFileWritten("student_info.txt", &studentTableVersion);
+    free(entries);
+    TraceLog(LOG_INFO, "Saved %d students.", allStudentCount);
 }
 
 void LoadAllFacultyInfo(void) {
-    FILE *file = fopen("faculty_info.txt", "r");
+    facultyTableVersion = PortalFileVersion("faculty_info.txt");
+    FILE *file = fopen("faculty_info.txt", "rb"); // Binary, so ftell gives byte offsets
     if (!file) {
         TraceLog(LOG_WARNING, "faculty_info.txt not found.");
         return;
     }
 
-    allFacultyCount = 0;
+    // Registration only ever appends, so if the file just grew read the new
+    // records and keep everything already loaded
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    bool appendOnly = (allFacultyCount > 0 && facultyFileBytes > 0 && fileSize > facultyFileBytes);
+    int firstNew = appendOnly ? allFacultyCount : 0;
+    if (appendOnly) {
+        fseek(file, facultyFileBytes, SEEK_SET);
+    } else {
+        // Drop the previous load in one step
+        fseek(file, 0, SEEK_SET);
+        allFacultyCount = 0;
+        facultyDeadBytes = 0;
+        ArenaFree(&facultyArena);
+        SearchReset(&facultySearch);
+    }
+    InvalidateVirtualList(&facultyList);
     char line[MAX_LINE_LENGTH];
+    long recordStart = ftell(file);
 
-    while (fgets(line, sizeof(line), file) != NULL && allFacultyCount < MAX_FACULTIES) {
+    while (fgets(line, sizeof(line), file) != NULL) {
         line[strcspn(line, "\r\n")] = 0;
-        if (strlen(line) < 2) continue;
+        if (strlen(line) < 2) { recordStart = ftell(file); continue; }
+        if (line[0] == TOMBSTONE_MARK) {
+            facultyDeadBytes += SkipTombstonedRecord(file, recordStart);
+            recordStart = ftell(file);
+            continue;
+        }
 
+        if (allFacultyCount == allFacultyCapacity) {
+            allFacultyCapacity = allFacultyCapacity ? allFacultyCapacity * 2 : USER_TABLE_INITIAL_CAPACITY;
+            allFaculties = (FacultyInfo *)realloc(allFaculties, allFacultyCapacity * sizeof(FacultyInfo));
+        }
         FacultyInfo* f = &allFaculties[allFacultyCount];
 
-        strcpy(f->id, line);
-        safe_fgets_and_strip_admin(f->password,   sizeof(line), file, MAX_INPUT_CHARS);
-        safe_fgets_and_strip_admin(f->name,       sizeof(line), file, MAX_INPUT_CHARS);
-        safe_fgets_and_strip_admin(f->address,    sizeof(line), file, MAX_ADDRESS_CHARS);
-        safe_fgets_and_strip_admin(f->phone,      sizeof(line), file, MAX_INPUT_CHARS);
-        safe_fgets_and_strip_admin(f->email,      sizeof(line), file, MAX_INPUT_CHARS + 15);
-        safe_fgets_and_strip_admin(f->department, sizeof(line), file, MAX_INPUT_CHARS);
-        safe_fgets_and_strip_admin(f->designation,sizeof(line), file, MAX_INPUT_CHARS);
+        f->id          = ArenaStrndup(&facultyArena, line, MAX_INPUT_CHARS);
+        f->password    = ArenaReadLine(&facultyArena, file, MAX_INPUT_CHARS);
+        f->name        = ArenaReadLine(&facultyArena, file, MAX_INPUT_CHARS);
+        f->address     = ArenaReadLine(&facultyArena, file, MAX_ADDRESS_CHARS);
+        f->phone       = ArenaReadLine(&facultyArena, file, MAX_INPUT_CHARS);
+        f->email       = ArenaReadLine(&facultyArena, file, MAX_INPUT_CHARS + 14);
+        f->department  = ArenaReadLine(&facultyArena, file, MAX_INPUT_CHARS);
+        f->designation = ArenaReadLine(&facultyArena, file, MAX_INPUT_CHARS);
         fgets(line, sizeof(line), file); // Read the "--END--" separator
+        f->fileOffset = recordStart;
+        recordStart = ftell(file);
+        f->recordBytes = recordStart - f->fileOffset;
         
         allFacultyCount++;
     }
+    facultyFileBytes = ftell(file);
     fclose(file);
-    TraceLog(LOG_INFO, TextFormat("Loaded %d faculties.", allFacultyCount));
+
+    double searchStart = GetTime();
+    for (int i = firstNew; i < allFacultyCount; i++) {
+        FacultyInfo *f = &allFaculties[i];
+        SearchAddUser(&facultySearch, f->id, f->name, f->email, f->department, appendOnly);
+    }
+    if (!appendOnly) SearchSort(&facultySearch);
+    TraceLog(LOG_INFO, "Indexed %d new faculties for search in %.1f ms (%d keys).",
+             allFacultyCount - firstNew, (GetTime() - searchStart) * 1000.0, facultySearch.count);
+    TraceLog(LOG_INFO, "Loaded %d faculties (%ld KB strings, %ld KB table).", allFacultyCount,
+             facultyArena.totalBytes / 1024, (long)(allFacultyCapacity * sizeof(FacultyInfo)) / 1024);
 }
 
 void SaveAllFacultyInfo(void) {
-    FILE *file = fopen("faculty_info.txt", "w"); // "w" = overwrite
+    FILE *file = fopen("faculty_info.txt", "wb"); // Overwrite; binary so offsets match the loader
     if (!file) {
         TraceLog(LOG_ERROR, "Could not open faculty_info.txt for writing.");
         return;
     }
     
+    ProfileIndexEntry *entries = (ProfileIndexEntry *)calloc(allFacultyCount + 1, sizeof(ProfileIndexEntry));
     for (int i = 0; i < allFacultyCount; i++) {
         FacultyInfo* f = &allFaculties[i];
+        strcpy(entries[i].id, f->id);
+        entries[i].offset = ftell(file);
+        f->fileOffset = entries[i].offset;
         fprintf(file, "%s\n", f->id);
         fprintf(file, "%s\n", f->password);
         fprintf(file, "%s\n", f->name);
@@ -350,73 +604,317 @@ void SaveAllFacultyInfo(void) {
         fprintf(file, "%s\n", f->department);
         fprintf(file, "%s\n", f->designation);
         fprintf(file, "--END--\n");
+        f->recordBytes = ftell(file) - f->fileOffset;
     }
+    long sourceSize = ftell(file);
     fclose(file);
-    TraceLog(LOG_INFO, TextFormat("Saved %d faculties.", allFacultyCount));
+    facultyFileBytes = sourceSize;
+    facultyDeadBytes = 0;
+    WriteProfileIndex("faculty_info.idx", entries, allFacultyCount, sourceSize);
+    NoteUserFileWritten("faculty_info.txt", &facultyTableVersion);
+    free(entries);
+    TraceLog(LOG_INFO, "Saved %d faculties.", allFacultyCount);
+}
+
+// Replaces the profile index with a fully sorted one for the rewritten file
+void WriteProfileIndex(const char *indexFile, ProfileIndexEntry *entries, int count, long sourceSize) {
+    if (!ProfileIndexWrite(indexFile, entries, count, sourceSize)) TraceLog(LOG_WARNING, "Could not write %s.", indexFile);
 }
 
+// Reads whatever other screens of the portal shell wrote to the user files since the
+// tables were loaded. Standalone the tables are loaded once, and Refresh rereads them.
+void RefreshUserTables(void) {
+    if (allStudents == NULL || studentTableVersion != PortalFileVersion("student_info.txt")) LoadAllStudentInfo();
+    if (allFaculties == NULL || facultyTableVersion != PortalFileVersion("faculty_info.txt")) LoadAllFacultyInfo();
+}
 
-// --- Fee and Complaint I/O (Unchanged) ---
+// Tells the other screens the file changed; the table here already matches it
+void NoteUserFileWritten(const char *filename, unsigned int *tableVersion) {
+    PortalFileWritten(filename);
+    *tableVersion = PortalFileVersion(filename);
+}
 
-void LoadFees(void) {
-    FILE* file = fopen("fees.dat", "r");
-    if (file == NULL) {
-        TraceLog(LOG_INFO, "fees.dat not found. A new one will be created.");
-        return;
+// Reads past the rest of a tombstoned record and returns its size in bytes
+static long SkipTombstonedRecord(FILE *file, long offset) {
+    char line[MAX_LINE_LENGTH];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = 0;
+        if (strcmp(line, "--END--") == 0) break;
     }
-    feeCount = 0;
-    while (feeCount < MAX_FEES &&
-           fscanf(file, "%[^|]|%d|%d|%d|%d\n",
-                  fees[feeCount].studentId,
-                  &fees[feeCount].tuitionTotal,
-                  &fees[feeCount].tuitionPaid,
-                  &fees[feeCount].hostelTotal,
-                  &fees[feeCount].hostelPaid) == 5) {
-        feeCount++;
+    return ftell(file) - offset;
+}
+
+// Marks a record as removed by overwriting the first byte of its id line.
+// The file size does not change, so the profile index stays valid and
+// afterlog.c simply no longer finds a matching id at that offset.
+bool TombstoneRecord(const char *filename, const char *id, long offset) {
+    FILE *file = fopen(filename, "r+b");
+    if (!file) return false;
+
+    // Make sure the record is still where we loaded it from
+    char line[MAX_LINE_LENGTH];
+    fseek(file, offset, SEEK_SET);
+    bool matches = (fgets(line, sizeof(line), file) != NULL);
+    if (matches) {
+        line[strcspn(line, "\r\n")] = 0;
+        matches = (strcmp(line, id) == 0);
+    }
+    if (matches) {
+        fseek(file, offset, SEEK_SET);
+        fputc(TOMBSTONE_MARK, file);
     }
     fclose(file);
+    return matches;
 }
 
-void SaveFees(void) {
-    // This function rewrites the *entire* fees file.
-    // First, update the fees array with the data from the editor.
-    if (currentFeeIndex != -1) { // Update existing
-        fees[currentFeeIndex] = currentFeeEntry;
-    } else { // Add new
-        if (feeCount < MAX_FEES) {
-            fees[feeCount] = currentFeeEntry;
-            feeCount++;
-        }
+void RemoveStudentAt(int index) {
+    StudentInfo removed = allStudents[index];
+    SearchRemoveUser(&studentSearch, removed.id, removed.name, removed.email, removed.course);
+    for (int j = index; j < allStudentCount - 1; j++) {
+        allStudents[j] = allStudents[j+1];
     }
+    allStudentCount--;
+    InvalidateVirtualList(&studentList);
 
-    FILE* file = fopen("fees.dat", "w");
-    if (file == NULL) {
-        TraceLog(LOG_ERROR, "Could not open fees.dat for writing.");
+    if (!TombstoneRecord("student_info.txt", removed.id, removed.fileOffset)) {
+        SaveAllStudentInfo(); // File changed under us, fall back to a full rewrite
         return;
     }
-    for (int i = 0; i < feeCount; i++) {
-        fprintf(file, "%s|%d|%d|%d|%d\n",
-                fees[i].studentId,
-                fees[i].tuitionTotal,
-                fees[i].tuitionPaid,
-                fees[i].hostelTotal,
-                fees[i].hostelPaid);
+    NoteUserFileWritten("student_info.txt", &studentTableVersion);
+    studentDeadBytes += removed.recordBytes;
+    TraceLog(LOG_INFO, "Tombstoned student %s (1 byte written, %ld of %ld bytes dead).",
+             removed.id, studentDeadBytes, studentFileBytes);
+
+    if (studentDeadBytes * COMPACT_DEAD_RATIO > studentFileBytes) {
+        SaveAllStudentInfo(); // Compaction: rewrite live records only
+        TraceLog(LOG_INFO, "Compacted student_info.txt (%ld bytes written).", studentFileBytes);
+    }
+}
+
+void RemoveFacultyAt(int index) {
+    FacultyInfo removed = allFaculties[index];
+    SearchRemoveUser(&facultySearch, removed.id, removed.name, removed.email, removed.department);
+    for (int j = index; j < allFacultyCount - 1; j++) {
+        allFaculties[j] = allFaculties[j+1];
+    }
+    allFacultyCount--;
+    InvalidateVirtualList(&facultyList);
+
+    if (!TombstoneRecord("faculty_info.txt", removed.id, removed.fileOffset)) {
+        SaveAllFacultyInfo();
+        return;
+    }
+    NoteUserFileWritten("faculty_info.txt", &facultyTableVersion);
+    facultyDeadBytes += removed.recordBytes;
+    TraceLog(LOG_INFO, "Tombstoned faculty %s (1 byte written, %ld of %ld bytes dead).",
+             removed.id, facultyDeadBytes, facultyFileBytes);
+
+    if (facultyDeadBytes * COMPACT_DEAD_RATIO > facultyFileBytes) {
+        SaveAllFacultyInfo();
+        TraceLog(LOG_INFO, "Compacted faculty_info.txt (%ld bytes written).", facultyFileBytes);
     }
-    fclose(file);
-    
-    // Reload fees to ensure consistency
-    LoadFees();
-    sprintf(statusMessage, "Fees for %s saved.", currentFeeEntry.studentId);
+}
+
+
+//----------------------------------------------------------------------------------
+// User Search Index
+//----------------------------------------------------------------------------------
+
+// Frees the entries and key strings; the index is empty afterwards
+static void SearchReset(SearchIndex *index) {
+    free(index->entries);
+    ArenaFree(&index->keys);
+    index->entries = NULL;
+    index->count = 0;
+    index->capacity = 0;
+    index->version++;
+}
+
+static void LowerCopy(char *dest, const char *src, int size) {
+    int i = 0;
+    for (; src[i] != '\0' && i < size - 1; i++) dest[i] = (char)tolower((unsigned char)src[i]);
+    dest[i] = '\0';
+}
+
+// Splits a lowercased field into the keys a prefix can match: the whole field,
+// plus the start of every later word when words is set ("neel shah" -> "shah")
+static int FieldSearchKeys(const char *lower, bool words, const char **keys) {
+    if (lower[0] == '\0') return 0;
+    int count = 0;
+    keys[count++] = lower;
+    for (const char *c = lower; words && *c != '\0' && count < SEARCH_KEYS_PER_FIELD; c++) {
+        if (*c == ' ' && c[1] != ' ' && c[1] != '\0') keys[count++] = c + 1;
+    }
+    return count;
+}
+
+static int CompareSearchEntry(const SearchEntry *a, const char *key, const char *id) {
+    int cmp = strcmp(a->key, key);
+    if (cmp != 0) return cmp;
+    if ((uintptr_t)a->id == (uintptr_t)id) return 0;
+    return ((uintptr_t)a->id < (uintptr_t)id) ? -1 : 1;
+}
+
+static int CompareSearchEntries(const void *a, const void *b) {
+    const SearchEntry *eb = (const SearchEntry *)b;
+    return CompareSearchEntry((const SearchEntry *)a, eb->key, eb->id);
+}
+
+// First entry not ordered before (key, id); a NULL id sorts before every user
+static int SearchLowerBound(const SearchIndex *index, const char *key, const char *id) {
+    int lo = 0, hi = index->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (CompareSearchEntry(&index->entries[mid], key, id) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static void SearchSort(SearchIndex *index) {
+    qsort(index->entries, index->count, sizeof(SearchEntry), CompareSearchEntries);
+    index->version++;
+}
+
+// Indexes one user. During a full load entries are appended and sorted once at
+// the end; keepSorted inserts them in place for users added after that.
+static void SearchAddUser(SearchIndex *index, const char *id, const char *name, const char *email, const char *group, bool keepSorted) {
+    const char *fields[4] = { id, name, email, group };
+    const bool words[4] = { false, true, false, true };
+    char lower[MAX_LINE_LENGTH];
+    const char *keys[SEARCH_KEYS_PER_FIELD];
+
+    for (int f = 0; f < 4; f++) {
+        LowerCopy(lower, fields[f], sizeof(lower));
+        int keyCount = FieldSearchKeys(ArenaStrndup(&index->keys, lower, MAX_LINE_LENGTH), words[f], keys);
+        for (int k = 0; k < keyCount; k++) {
+            if (index->count == index->capacity) {
+                index->capacity = index->capacity ? index->capacity * 2 : USER_TABLE_INITIAL_CAPACITY * 4;
+                index->entries = (SearchEntry *)realloc(index->entries, index->capacity * sizeof(SearchEntry));
+            }
+            int pos = keepSorted ? SearchLowerBound(index, keys[k], id) : index->count;
+            memmove(&index->entries[pos + 1], &index->entries[pos], (index->count - pos) * sizeof(SearchEntry));
+            index->entries[pos] = (SearchEntry){ keys[k], id, name };
+            index->count++;
+        }
+    }
+    index->version++;
+}
+
+// Drops a user's entries. The key strings stay in the arena until the next full load.
+static void SearchRemoveUser(SearchIndex *index, const char *id, const char *name, const char *email, const char *group) {
+    const char *fields[4] = { id, name, email, group };
+    const bool words[4] = { false, true, false, true };
+    char lower[MAX_LINE_LENGTH];
+    const char *keys[SEARCH_KEYS_PER_FIELD];
+
+    for (int f = 0; f < 4; f++) {
+        LowerCopy(lower, fields[f], sizeof(lower));
+        int keyCount = FieldSearchKeys(lower, words[f], keys);
+        for (int k = 0; k < keyCount; k++) {
+            int pos = SearchLowerBound(index, keys[k], id);
+            if (pos < index->count && CompareSearchEntry(&index->entries[pos], keys[k], id) == 0) {
+                memmove(&index->entries[pos], &index->entries[pos + 1], (index->count - pos - 1) * sizeof(SearchEntry));
+                index->count--;
+            }
+        }
+    }
+    index->version++;
+}
+
+// Reruns the type-ahead query when the text or either index has changed.
+// Matches from both indexes are merged in key order, one result per user.
+static void UpdateUserSearch(void) {
+    int version = studentSearch.version * 31 + facultySearch.version;
+    if (version == userSearchVersion && strcmp(userSearchQuery, userSearchLastQuery) == 0) return;
+    userSearchVersion = version;
+    strcpy(userSearchLastQuery, userSearchQuery);
+    userSearchResultCount = 0;
+
+    char query[MAX_INPUT_CHARS];
+    LowerCopy(query, userSearchQuery, sizeof(query));
+    int queryLen = (int)strlen(query);
+    if (queryLen == 0) return;
+
+    double start = GetTime();
+    int s = SearchLowerBound(&studentSearch, query, NULL);
+    int f = SearchLowerBound(&facultySearch, query, NULL);
+    for (int scanned = 0; scanned < SEARCH_SCAN_LIMIT && userSearchResultCount < MAX_SEARCH_RESULTS; scanned++) {
+        bool studentOk = s < studentSearch.count && strncmp(studentSearch.entries[s].key, query, queryLen) == 0;
+        bool facultyOk = f < facultySearch.count && strncmp(facultySearch.entries[f].key, query, queryLen) == 0;
+        if (!studentOk && !facultyOk) break;
+
+        bool isFaculty = !studentOk || (facultyOk && strcmp(facultySearch.entries[f].key, studentSearch.entries[s].key) < 0);
+        const SearchEntry *e = isFaculty ? &facultySearch.entries[f++] : &studentSearch.entries[s++];
+
+        bool listed = false;
+        for (int r = 0; r < userSearchResultCount && !listed; r++) listed = (userSearchResults[r].id == e->id);
+        if (!listed) userSearchResults[userSearchResultCount++] = (SearchResult){ e->id, e->name, isFaculty };
+    }
+    userSearchMs = (GetTime() - start) * 1000.0;
+}
+
+// Scrolls the matching list so the chosen user is the top row
+static void ShowSearchResult(const SearchResult *result) {
+    if (result->isFaculty) {
+        for (int i = 0; i < allFacultyCount; i++) {
+            if (allFaculties[i].id == result->id) { facultyList.scroll = -(float)i * LIST_ROW_HEIGHT; break; }
+        }
+    } else {
+        for (int i = 0; i < allStudentCount; i++) {
+            if (allStudents[i].id == result->id) { studentList.scroll = -(float)i * LIST_ROW_HEIGHT; break; }
+        }
+    }
+    sprintf(statusMessage, "Showing %s: %s", result->isFaculty ? "faculty" : "student", result->id);
+}
+
+
+// --- Fee and Complaint I/O ---
+
+void LoadFees(void) {
+    FeeLedgerOpen(&feeLedger, &FEE_FILES, true);
+    if (feeLedger.log == NULL) TraceLog(LOG_ERROR, "Could not open " FEE_LEDGER_FILE ".");
+    TraceLog(LOG_INFO, "Fee ledger: %d students, %lld records (%lld replayed).", feeLedger.count,
+                                  (long long)feeLedger.records, (long long)(feeLedger.records - feeLedger.checkpointed));
+}
+
+void SaveFees(void) {
+    PortalFileWritten(FEE_LEDGER_FILE); // The student portal reads its balance again
+    // Post the difference between the editor and the ledger balance, one record per field
+    FeeBalance current = { 0 };
+    const FeeBalance *found = FeeFind(&feeLedger, currentFeeEntry.studentId);
+    if (found) current = *found;
+    struct { int delta; FeeKind kind; FeeAccount account; } changes[4] = {
+        { currentFeeEntry.tuitionTotal - current.tuitionTotal, FEE_CHARGE, FEE_TUITION },
+        { currentFeeEntry.tuitionPaid - current.tuitionPaid, FEE_PAYMENT, FEE_TUITION },
+        { currentFeeEntry.hostelTotal - current.hostelTotal, FEE_CHARGE, FEE_HOSTEL },
+        { currentFeeEntry.hostelPaid - current.hostelPaid, FEE_PAYMENT, FEE_HOSTEL },
+    };
+    int posted = 0;
+    for (int i = 0; i < 4; i++) {
+        if (changes[i].delta == 0) continue;
+        if (!FeePost(&feeLedger, currentFeeEntry.studentId, changes[i].kind, changes[i].account, changes[i].delta)) {
+            TraceLog(LOG_ERROR, "Could not write to " FEE_LEDGER_FILE ".");
+            sprintf(statusMessage, "Fees for %.40s NOT saved.", currentFeeEntry.studentId);
+            return;
+        }
+        posted++;
+    }
+    // A new student saved with all zeros still gets a (zero) charge, so they are listed
+    if (found == NULL && posted == 0 && FeePost(&feeLedger, currentFeeEntry.studentId, FEE_CHARGE, FEE_TUITION, 0)) posted++;
+    sprintf(statusMessage, "Fees for %.40s saved (%d posted).", currentFeeEntry.studentId, posted);
 }
 
 
 void LoadComplaints(void) {
+    complaintsLoaded = true;
+    complaintsVersion = PortalFileVersion("complaints.dat");
+    complaintCount = 0;
     FILE* file = fopen("complaints.dat", "r");
     if (file == NULL) {
         TraceLog(LOG_INFO, "complaints.dat not found.");
         return;
     }
-    complaintCount = 0;
     while (complaintCount < MAX_COMPLAINTS &&
            fscanf(file, "%[^|]|%[^\n]\n",
                   complaints[complaintCount].studentId,
@@ -470,6 +968,38 @@ static bool DrawButton(Rectangle bounds, const char* text, Color color)
 }
 
 
+// Drops every cached label; call after the list's table changes
+static void InvalidateVirtualList(VirtualList *list) {
+    list->version++;
+}
+
+// Clamps the scroll offset to the list length and returns how many rows are
+// visible, starting at *first. Only these rows are touched when drawing.
+static int ClampVirtualList(VirtualList *list, int itemCount, float viewHeight, int *first) {
+    float maxScroll = (float)itemCount * LIST_ROW_HEIGHT + 20 - viewHeight;
+    if (maxScroll < 0) maxScroll = 0;
+    if (list->scroll < -maxScroll) list->scroll = -maxScroll;
+    if (list->scroll > 0) list->scroll = 0;
+
+    int start = (int)(-list->scroll) / LIST_ROW_HEIGHT;
+    int end = (int)((-list->scroll + viewHeight) / LIST_ROW_HEIGHT) + 1;
+    if (end > itemCount) end = itemCount;
+    *first = start;
+    return (end > start) ? end - start : 0;
+}
+
+// Returns the "ID: x (name)" label for a row, formatting it only on a cache miss
+static const char *GetVirtualListLabel(VirtualList *list, int index, const char *id, const char *name) {
+    int slot = index % LIST_LABEL_CACHE;
+    if (list->labelIndex[slot] != index + 1 || list->labelVersion[slot] != list->version) {
+        snprintf(list->labels[slot], LIST_LABEL_LENGTH, "ID: %s (%s)", id, name);
+        list->labelIndex[slot] = index + 1; // +1 so a zeroed cache never matches
+        list->labelVersion[slot] = list->version;
+    }
+    return list->labels[slot];
+}
+
+
 // A simple text input handler
 void HandleTextInput(char *buffer, int maxChars) {
     int key = GetCharPressed();
@@ -573,19 +1103,25 @@ void UpdateDrawMainScreen(void)
     // --- Tab 1: Manage Users (Update) ---
     else if (activeTab == 1)
     {
+        // Type-ahead search box
+        Rectangle userSearchBox = { contentBox.x + 330, contentBox.y + 60, 400, 40 };
+        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+            activeTextBox = CheckCollisionPointRec(mousePos, userSearchBox) ? TEXTBOX_USER_SEARCH : TEXTBOX_NONE;
+        }
+        if (activeTextBox == TEXTBOX_USER_SEARCH) {
+            HandleTextInput(userSearchQuery, MAX_INPUT_CHARS - 1);
+        }
+        UpdateUserSearch();
+
         // Update scrolling for both lists
         if (CheckCollisionPointRec(mousePos, (Rectangle){ contentBox.x, contentBox.y, contentBox.width / 2, contentBox.height }))
         {
-            studentScroll.y += GetMouseWheelMove() * 20;
-            if (studentScroll.y > 0) studentScroll.y = 0;
-            // Add max scroll
+            studentList.scroll += GetMouseWheelMove() * 20; // Clamped when the list is drawn
         }
         
         if (CheckCollisionPointRec(mousePos, (Rectangle){ contentBox.x + contentBox.width / 2, contentBox.y, contentBox.width / 2, contentBox.height }))
         {
-            facultyScroll.y += GetMouseWheelMove() * 20;
-            if (facultyScroll.y > 0) facultyScroll.y = 0;
-            // Add max scroll
+            facultyList.scroll += GetMouseWheelMove() * 20;
         }
 
         // All DrawButton() calls are now in the drawing loop.
@@ -635,19 +1171,16 @@ void UpdateDrawMainScreen(void)
         // Search Button (Moved to Draw)
         Rectangle searchButton = { contentBox.x + 350, contentBox.y + 60, 120, 40 };
         if (DrawButton(searchButton, "Search", BLUE)) {
-            currentFeeIndex = -1;
-            feeEditorActive = true;
-            strcpy(statusMessage, "");
-            for (int i = 0; i < feeCount; i++) {
-                if (strcmp(fees[i].studentId, feeSearchId) == 0) {
-                    currentFeeEntry = fees[i];
-                    currentFeeIndex = i;
-                    break;
-                }
-            }
-            if (currentFeeIndex == -1) {
-                memset(&currentFeeEntry, 0, sizeof(FeeData));
-                strcpy(currentFeeEntry.studentId, feeSearchId);
+            feeEditorActive = strlen(feeSearchId) > 0 && strlen(feeSearchId) < FEE_MAX_ID;
+            strcpy(statusMessage, feeEditorActive ? "" : "Enter a valid student ID.");
+            const FeeBalance *found = FeeFind(&feeLedger, feeSearchId);
+            memset(&currentFeeEntry, 0, sizeof(FeeData));
+            strcpy(currentFeeEntry.studentId, feeSearchId);
+            if (found) {
+                currentFeeEntry.tuitionTotal = found->tuitionTotal;
+                currentFeeEntry.tuitionPaid = found->tuitionPaid;
+                currentFeeEntry.hostelTotal = found->hostelTotal;
+                currentFeeEntry.hostelPaid = found->hostelPaid;
             }
             sprintf(feeTuitionTotalStr, "%d", currentFeeEntry.tuitionTotal);
             sprintf(feeTuitionPaidStr, "%d", currentFeeEntry.tuitionPaid);
@@ -697,7 +1230,8 @@ void UpdateDrawMainScreen(void)
         Rectangle refreshStudentButton = { studentBox.x + 210, studentBox.y + 60, 100, 40 };
         
         if (DrawButton(addStudentButton, "Add New Student", BLUE)) {
-            system("start main.exe"); // Launch registration
+            PortalLaunch("start main.exe"); // Launch registration
+            RefreshUserTables(); // In the shell registration has finished by now
             strcpy(statusMessage, "Launched registration. Click Refresh.");
         }
         if (DrawButton(refreshStudentButton, "Refresh", GREEN)) {
@@ -711,24 +1245,19 @@ void UpdateDrawMainScreen(void)
         DrawRectangleLinesEx(studentListBounds, 1, DARKGRAY);
         
         BeginScissorMode(studentListBounds.x, studentListBounds.y, studentListBounds.width, studentListBounds.height);
-            int studentY = studentListBounds.y + 10 + (int)studentScroll.y;
-            for(int i = 0; i < allStudentCount; i++) {
-                if (studentY > studentListBounds.y - 40 && studentY < studentListBounds.y + studentListBounds.height) {
-                    DrawText(TextFormat("ID: %s (%s)", allStudents[i].id, allStudents[i].name), studentListBounds.x + 10, studentY, 20, GRAY);
-                    Rectangle removeBtnBounds = { studentListBounds.x + studentListBounds.width - 100, studentY - 5, 80, 30 };
-                    if (DrawButton(removeBtnBounds, "Remove", RED)) {
-                        char removedName[100];
-                        strcpy(removedName, allStudents[i].name);
-                        for (int j = i; j < allStudentCount - 1; j++) {
-                            allStudents[j] = allStudents[j+1];
-                        }
-                        allStudentCount--;
-                        SaveAllStudentInfo();
-                        sprintf(statusMessage, "Removed student: %s", removedName);
-                        break; 
-                    }
+            int firstStudent = 0;
+            int visibleStudents = ClampVirtualList(&studentList, allStudentCount, studentListBounds.height, &firstStudent);
+            for(int i = firstStudent; i < firstStudent + visibleStudents; i++) {
+                int studentY = studentListBounds.y + 10 + (int)studentList.scroll + i * LIST_ROW_HEIGHT;
+                DrawText(GetVirtualListLabel(&studentList, i, allStudents[i].id, allStudents[i].name), studentListBounds.x + 10, studentY, 20, GRAY);
+                Rectangle removeBtnBounds = { studentListBounds.x + studentListBounds.width - 100, studentY - 5, 80, 30 };
+                if (DrawButton(removeBtnBounds, "Remove", RED)) {
+                    char removedName[100];
+                    strcpy(removedName, allStudents[i].name);
+                    RemoveStudentAt(i);
+                    sprintf(statusMessage, "Removed student: %s", removedName);
+                    break; 
                 }
-                studentY += 40;
             }
         EndScissorMode();
         
@@ -740,7 +1269,8 @@ void UpdateDrawMainScreen(void)
         Rectangle refreshFacultyButton = { facultyBox.x + 210, facultyBox.y + 60, 100, 40 };
         
         if (DrawButton(addFacultyButton, "Add New Faculty", BLUE)) {
-            system("start main.exe"); // Launch registration
+            PortalLaunch("start main.exe"); // Launch registration
+            RefreshUserTables(); // In the shell registration has finished by now
             strcpy(statusMessage, "Launched registration. Click Refresh.");
         }
         if (DrawButton(refreshFacultyButton, "Refresh", GREEN)) {
@@ -754,26 +1284,48 @@ void UpdateDrawMainScreen(void)
         DrawRectangleLinesEx(facultyListBounds, 1, DARKGRAY);
         
         BeginScissorMode(facultyListBounds.x, facultyListBounds.y, facultyListBounds.width, facultyListBounds.height);
-            int facultyY = facultyListBounds.y + 10 + (int)facultyScroll.y;
-            for(int i = 0; i < allFacultyCount; i++) {
-                if (facultyY > facultyListBounds.y - 40 && facultyY < facultyListBounds.y + facultyListBounds.height) {
-                    DrawText(TextFormat("ID: %s (%s)", allFaculties[i].id, allFaculties[i].name), facultyListBounds.x + 10, facultyY, 20, GRAY);
-                    Rectangle removeBtnBounds = { facultyListBounds.x + facultyListBounds.width - 100, facultyY - 5, 80, 30 };
-                    if (DrawButton(removeBtnBounds, "Remove", RED)) {
-                        char removedName[100];
-                        strcpy(removedName, allFaculties[i].name);
-                        for (int j = i; j < allFacultyCount - 1; j++) {
-                            allFaculties[j] = allFaculties[j+1];
-                        }
-                        allFacultyCount--;
-                        SaveAllFacultyInfo();
-                        sprintf(statusMessage, "Removed faculty: %s", removedName);
-                        break;
-                    }
+            int firstFaculty = 0;
+            int visibleFaculties = ClampVirtualList(&facultyList, allFacultyCount, facultyListBounds.height, &firstFaculty);
+            for(int i = firstFaculty; i < firstFaculty + visibleFaculties; i++) {
+                int facultyY = facultyListBounds.y + 10 + (int)facultyList.scroll + i * LIST_ROW_HEIGHT;
+                DrawText(GetVirtualListLabel(&facultyList, i, allFaculties[i].id, allFaculties[i].name), facultyListBounds.x + 10, facultyY, 20, GRAY);
+                Rectangle removeBtnBounds = { facultyListBounds.x + facultyListBounds.width - 100, facultyY - 5, 80, 30 };
+                if (DrawButton(removeBtnBounds, "Remove", RED)) {
+                    char removedName[100];
+                    strcpy(removedName, allFaculties[i].name);
+                    RemoveFacultyAt(i);
+                    sprintf(statusMessage, "Removed faculty: %s", removedName);
+                    break;
                 }
-                facultyY += 40;
             }
         EndScissorMode();
+
+        // Search box and its results, drawn last so they sit on top of the student list
+        Rectangle userSearchBox = { contentBox.x + 330, contentBox.y + 60, 400, 40 };
+        DrawMyTextBox(userSearchBox, userSearchQuery, (activeTextBox == TEXTBOX_USER_SEARCH));
+        if (userSearchQuery[0] == '\0' && activeTextBox != TEXTBOX_USER_SEARCH) {
+            DrawText("Search ID, name, email, course", userSearchBox.x + 5, userSearchBox.y + 10, 20, GRAY);
+        }
+        if (userSearchQuery[0] != '\0') {
+            Rectangle dropdown = { userSearchBox.x, userSearchBox.y + 45, userSearchBox.width, userSearchResultCount * 30 + 30 };
+            DrawRectangleRec(dropdown, RAYWHITE);
+            DrawRectangleLinesEx(dropdown, 1, DARKGRAY);
+            for (int r = 0; r < userSearchResultCount; r++) {
+                SearchResult *result = &userSearchResults[r];
+                Rectangle row = { dropdown.x, dropdown.y + r * 30, dropdown.width, 30 };
+                if (CheckCollisionPointRec(mousePos, row)) {
+                    DrawRectangleRec(row, SKYBLUE);
+                    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+                        ShowSearchResult(result);
+                        userSearchQuery[0] = '\0';
+                    }
+                }
+                DrawText(TextFormat("%s (%s)", result->id, result->name), row.x + 8, row.y + 6, 18, BLACK);
+                DrawText(result->isFaculty ? "Faculty" : "Student", row.x + row.width - 80, row.y + 6, 18, GRAY);
+            }
+            DrawText(TextFormat("%d matches in %.3f ms", userSearchResultCount, userSearchMs),
+                     dropdown.x + 8, dropdown.y + dropdown.height - 24, 16, GRAY);
+        }
     }
     // --- Tab 2: View Complaints (Draw) ---
     else if (activeTab == 2)
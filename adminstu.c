@@ -8,6 +8,10 @@
 * - LOGIN SCREEN REMOVED.
 * - Now accepts Student ID as a command-line argument (argv[1]).
 * - Loads fee data for that specific student on startup.
+* - Fee balances come from the admin's fee ledger (feeledger.h): a point
+*   lookup in its checkpoint plus the records posted since, instead of fees.dat.
+*   "adminstu --fee-bench [students]" times it against loading every balance.
+*   The bench clock (monoclock.h) needs -lpthread on MinGW.
 *
 * - FIX: Moved DrawButton() call for submit button into the
 * - drawing loop to make it visible.
@@ -21,9 +25,13 @@
 ********************************************************************************************/
 
 #include "raylib.h"
+#include "portal.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
+#include "feeledger.h"
+#include "monoclock.h"   // --fee-bench timings; needs -lpthread on MinGW
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
@@ -32,10 +40,11 @@
 //----------------------------------------------------------------------------------
 // Defines and Macros
 //----------------------------------------------------------------------------------
-#define MAX_FEES 100
 #define MAX_INPUT_CHARS 50
 #define MAX_COMPLAINT_CHARS 256
 #define MAX_STUDENT_COMPLAINTS 50 // Max complaints to load into memory
+#define FEE_BENCH_STUDENTS 200000
+#define FEE_BENCH_LOOKUPS 1000
 
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
@@ -67,15 +76,17 @@ typedef enum {
 //----------------------------------------------------------------------------------
 // Global Variables
 //----------------------------------------------------------------------------------
-const int screenWidth = 1920;
-const int screenHeight = 1080;
+static const int screenWidth = 1920;
+static const int screenHeight = 1080;
 
-GameScreen currentScreen = SCREEN_MAIN_DASHBOARD; // Start at dashboard
-int activeTab = 0; // 0=Fees, 1=My Complaints, 2=Submit Complaint
-int framesCounter = 0; // For blinking cursor
+static GameScreen currentScreen = SCREEN_MAIN_DASHBOARD; // Start at dashboard
+static int activeTab = 0; // 0=Fees, 1=My Complaints, 2=Submit Complaint
+static int framesCounter = 0; // For blinking cursor
 
 // --- Student Data ---
 char loggedInStudentId[MAX_INPUT_CHARS] = { 0 }; // Will be set from argv
+static char loadedStudentId[MAX_INPUT_CHARS] = { 0 }; // Whose fees and complaints are loaded
+static unsigned int feeVersion = 0, complaintsVersion = 0;  // PortalFileVersion() when they were read
 
 // --- Fee Data ---
 FeeData studentFee = { 0 };
@@ -83,7 +94,7 @@ bool feeDataFound = false;
 
 // --- Complaint Data ---
 char complaintMessage[MAX_COMPLAINT_CHARS] = { 0 }; // For NEW complaints
-char statusMessage[100] = { 0 };
+static char statusMessage[100] = { 0 };
 
 // NEW: Array to hold student's loaded complaints
 Complaint studentComplaints[MAX_STUDENT_COMPLAINTS];
@@ -91,7 +102,7 @@ int studentComplaintCount = 0;
 int complaintScrollY = 0; // For scrolling the complaints list
 
 // --- Text Input State ---
-ActiveTextBox activeTextBox = TEXTBOX_NONE;
+static ActiveTextBox activeTextBox = TEXTBOX_NONE;
 
 //----------------------------------------------------------------------------------
 // Module Functions Declaration
@@ -104,6 +115,7 @@ static void LoadStudentFeeData(const char* studentId);
 static void SaveComplaint(void);
 static void LoadStudentComplaints(void); // NEW
 static void DeleteComplaintByIndex(int originalIndex); // NEW
+static int FeeBench(int studentCount);
 
 // --- GUI Helper Functions ---
 static void DrawMyTextBox(Rectangle bounds, const char *text, bool active);
@@ -115,19 +127,24 @@ static bool DrawButton(Rectangle bounds, const char* text, Color color);
 //----------------------------------------------------------------------------------
 // Main Entry Point
 //----------------------------------------------------------------------------------
-int main(int argc, char *argv[])
+PORTAL_ENTRY(StudentPortalMain)
 {
     // Need Student ID to run
     if (argc < 2) {
         printf("ERROR: No Student ID provided.\n");
         return 1;
     }
+    if (strcmp(argv[1], "--fee-bench") == 0) return FeeBench(argc >= 3 ? atoi(argv[2]) : FEE_BENCH_STUDENTS);
     strcpy(loggedInStudentId, argv[1]); // Set student ID from arg
 
-    InitWindow(screenWidth, screenHeight, "University Portal - Student Portal"); // Changed title
+    PortalInitWindow(screenWidth, screenHeight, "University Portal - Student Portal"); // Changed title
 
-    LoadStudentFeeData(loggedInStudentId); // Load data for this student
-    LoadStudentComplaints(); // NEW: Load initial complaints for this student
+    // In the portal shell the same student's data stays loaded between visits, unless the
+    // admin portal posted fees or complaints changed since
+    bool sameStudent = (strcmp(loadedStudentId, loggedInStudentId) == 0);
+    if (!sameStudent || feeVersion != PortalFileVersion(FEE_LEDGER_FILE)) LoadStudentFeeData(loggedInStudentId); // Load data for this student
+    if (!sameStudent || complaintsVersion != PortalFileVersion("complaints.dat")) LoadStudentComplaints(); // NEW: Load initial complaints for this student
+    strcpy(loadedStudentId, loggedInStudentId);
 
     SetTargetFPS(60);
 
@@ -140,14 +157,14 @@ int main(int argc, char *argv[])
     }
 #endif
 
-    CloseWindow();
+    PortalCloseWindow();
     return 0;
 }
 
 //----------------------------------------------------------------------------------
 // Main Update/Draw Loop
 //----------------------------------------------------------------------------------
-void UpdateDrawFrame(void)
+static void UpdateDrawFrame(void)
 {
     framesCounter++;
 
@@ -167,32 +184,79 @@ void UpdateDrawFrame(void)
 //----------------------------------------------------------------------------------
 
 void LoadStudentFeeData(const char* studentId) {
-    FILE* file = fopen("fees.dat", "r");
-    if (file == NULL) {
-        feeDataFound = false;
-        return;
-    }
-    
     feeDataFound = false;
-    FeeData tempFee;
-    while (fscanf(file, "%[^|]|%d|%d|%d|%d\n",
-                  tempFee.studentId,
-                  &tempFee.tuitionTotal,
-                  &tempFee.tuitionPaid,
-                  &tempFee.hostelTotal,
-                  &tempFee.hostelPaid) == 5) {
-        if (strcmp(tempFee.studentId, studentId) == 0) {
-            studentFee = tempFee;
-            feeDataFound = true;
-            break;
-        }
+    feeVersion = PortalFileVersion(FEE_LEDGER_FILE);
+    double start = GetTime();
+
+    // Read-only: posting and checkpointing are left to the admin portal
+    FeeBalance balance;
+    if (FeeLookup(&FEE_FILES, studentId, &balance)) {
+        memset(&studentFee, 0, sizeof(studentFee));
+        strncpy(studentFee.studentId, balance.studentId, MAX_INPUT_CHARS - 1);
+        studentFee.tuitionTotal = balance.tuitionTotal;
+        studentFee.tuitionPaid = balance.tuitionPaid;
+        studentFee.hostelTotal = balance.hostelTotal;
+        studentFee.hostelPaid = balance.hostelPaid;
+        feeDataFound = true;
     }
-    fclose(file);
+    TraceLog(LOG_INFO, "Fee lookup took %.3f ms.", (GetTime() - start) * 1000.0);
+}
+
+// Synthetic ledger in fee_bench.* (removed afterwards): one charge per account for every
+// student, then the longest tail a lookup can meet. Times a student window's fee lookup
+// against loading every balance, as the admin side does.
+static int FeeBench(int studentCount) {
+    if (studentCount < 1) studentCount = 1;
+    const FeeFiles files = { "fee_bench.ledger", "fee_bench.ckpt", "fee_bench.dat" };
+    remove(files.ledger); remove(files.checkpoint); remove(files.legacy);
+    char id[FEE_MAX_ID];
+    FeeLedger ledger;
+    FeeLedgerOpen(&ledger, &files, true);
+    ledger.deferCheckpoints = true;
+    double start = MonoClockNow();
+    for (int i = 0; i < studentCount; i++) {
+        snprintf(id, sizeof(id), "S%08d", i);
+        FeePost(&ledger, id, FEE_CHARGE, FEE_TUITION, 50000 + i % 1000);
+        FeePost(&ledger, id, FEE_CHARGE, FEE_HOSTEL, 20000);
+    }
+    double postMs = (MonoClockNow() - start) * 1000.0;
+    bool written = FeeCheckpoint(&ledger);
+    uint32_t seed = 12345;
+    for (int i = 0; i < FEE_CHECKPOINT_INTERVAL - 1; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        snprintf(id, sizeof(id), "S%08d", (int)((seed >> 8) % (uint32_t)studentCount));
+        FeePost(&ledger, id, FEE_PAYMENT, FEE_TUITION, 100);
+    }
+    int64_t records = ledger.records;
+    FeeLedgerClose(&ledger);
+
+    start = MonoClockNow();
+    FeeLedgerOpen(&ledger, &files, false);
+    double loadMs = (MonoClockNow() - start) * 1000.0;
+
+    FeeBalance balance;
+    int mismatches = 0;
+    start = MonoClockNow();
+    for (int i = 0; i < FEE_BENCH_LOOKUPS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        snprintf(id, sizeof(id), "S%08d", (int)((seed >> 8) % (uint32_t)studentCount));
+        const FeeBalance *expected = FeeFind(&ledger, id);
+        if (!FeeLookup(&files, id, &balance) || expected == NULL || memcmp(&balance, expected, sizeof(balance)) != 0) mismatches++;
+    }
+    double lookupMs = (MonoClockNow() - start) * 1000.0 / FEE_BENCH_LOOKUPS;
+    FeeLedgerClose(&ledger);
+    remove(files.ledger); remove(files.checkpoint);
+
+    printf("%-10s %-10s %-12s %-12s %-14s %s\n", "students", "records", "post us", "load ms", "lookup ms", "mismatches");
+    printf("%-10d %-10lld %-12.2f %-12.2f %-14.4f %d%s\n", studentCount, (long long)records, postMs * 1000.0 / (2.0 * studentCount),
+           loadMs, lookupMs, mismatches, written ? "" : " (checkpoint FAILED)");
+    return (written && mismatches == 0) ? 0 : 1;
 }
 
 // NEW: Loads *only* the logged-in student's complaints into the global array
 void LoadStudentComplaints(void) {
     studentComplaintCount = 0; // Reset count
+    complaintsVersion = PortalFileVersion("complaints.dat");
     FILE* file = fopen("complaints.dat", "r");
     if (file == NULL) {
         return; // No complaints file, that's fine.
@@ -274,6 +338,7 @@ void DeleteComplaintByIndex(int originalIndex) {
     if (deleted) {
         remove("complaints.dat");
         rename("complaints.tmp", "complaints.dat");
+        PortalFileWritten("complaints.dat"); // The admin portal reads the list again
         strcpy(statusMessage, "Complaint marked as solved.");
     } else {
         remove("complaints.tmp"); // Just remove the temp file
@@ -302,6 +367,7 @@ void SaveComplaint(void) {
     
     fprintf(file, "%s|%s\n", loggedInStudentId, complaintMessage);
     fclose(file);
+    PortalFileWritten("complaints.dat"); // The admin portal reads the list again
     
     strcpy(statusMessage, "Complaint submitted successfully.");
     strcpy(complaintMessage, ""); // Clear message box
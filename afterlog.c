@@ -9,16 +9,23 @@
 * student_portal.exe based on admin status and user ID.
 * - CRITICAL FIX: Fixed buffer overflow in LoadStudentInfo/LoadFacultyInfo.
 * The code now passes the correct destination buffer size to fgets.
+* - Profiles are found through student_info.idx / faculty_info.idx, a sorted
+* ID -> byte offset index, so a load is one seek plus one record read.
+* The index is rebuilt here whenever it no longer matches its .txt file.
+* Records removed by adminad.c start with '~' and are left out of it.
 *
 ********************************************************************************************/
 
 #define PLATFORM_DESKTOP
 
 #include "raylib.h"
+#include "portal.h"
+#include "profileindex.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <time.h>
 
 #define MAX_INPUT_CHARS      50
 #define MAX_ADDRESS_CHARS    100
@@ -56,16 +63,18 @@ typedef struct {
 //----------------------------------------------------------------------------------
 // Global Variables
 //----------------------------------------------------------------------------------
-const int screenWidth = 1920;
-const int screenHeight = 1080;
+static const int screenWidth = 1920;
+static const int screenHeight = 1080;
 
-UserType currentUserType = USER_TYPE_UNKNOWN;
-StudentInfo currentStudent;
-FacultyInfo currentFaculty;
+static UserType currentUserType = USER_TYPE_UNKNOWN;
+static StudentInfo currentStudent;
+static FacultyInfo currentFaculty;
 
 bool dataLoaded = false;
 bool isAdmin = false; // NEW: Admin status flag
-char statusMessage[128] = "";
+static char loadedId[MAX_INPUT_CHARS + 1] = "";    // Whose profile dataLoaded refers to
+static unsigned int loadedVersion = 0;              // PortalFileVersion() of its file then
+static char statusMessage[128] = "";
 
 //----------------------------------------------------------------------------------
 // Module Functions Declaration
@@ -77,16 +86,19 @@ static void DrawStudentDashboard(void);
 static void DrawFacultyDashboard(void);
 // NEW: Helper for text file parsing
 static void safe_fgets_and_strip(char* dest, int destSize, FILE* file);
+static bool FindProfileOffset(const char *dataFile, const char *indexFile, const char *id, long *offset);
 
 //----------------------------------------------------------------------------------
 // Main Entry Point
 //----------------------------------------------------------------------------------
-int main(int argc, char *argv[]) {
+PORTAL_ENTRY(DashboardMain) {
     if (argc < 3) return 1; // Now requires at least id and type
 
     const char *id = argv[1];
     const char *userTypeStr = argv[2];
 
+    isAdmin = false; // In the portal shell the previous login's dashboard ran in this process
+    statusMessage[0] = '\0';
     // Check for 3rd argument (admin flag)
     if (argc > 3 && strcmp(argv[3], "admin") == 0) {
         isAdmin = true;
@@ -94,37 +106,47 @@ int main(int argc, char *argv[]) {
 
     if(atoi(argv[1]) >= 202501024 && atoi(argv[1]) <= 202501034) isAdmin = true;
 
-    if (strcmp(userTypeStr, "student") == 0) {
-        currentUserType = USER_TYPE_STUDENT;
-        memset(&currentStudent, 0, sizeof(StudentInfo)); 
-        dataLoaded = LoadStudentInfo(id);
-    } else if (strcmp(userTypeStr, "faculty") == 0) {
-        currentUserType = USER_TYPE_FACULTY;
-        memset(&currentFaculty, 0, sizeof(FacultyInfo)); 
-        dataLoaded = LoadFacultyInfo(id);
-    } else {
-        return 1;
+    UserType userType;
+    if (strcmp(userTypeStr, "student") == 0) userType = USER_TYPE_STUDENT;
+    else if (strcmp(userTypeStr, "faculty") == 0) userType = USER_TYPE_FACULTY;
+    else return 1;
+
+    // The same user logging in again keeps the profile read last time, unless it was edited since
+    const char *profileFile = (userType == USER_TYPE_STUDENT) ? "student_info.txt" : "faculty_info.txt";
+    bool profileKept = dataLoaded && userType == currentUserType && strcmp(loadedId, id) == 0 &&
+                       loadedVersion == PortalFileVersion(profileFile);
+    if (!profileKept) {
+        currentUserType = userType;
+        if (userType == USER_TYPE_STUDENT) {
+            memset(&currentStudent, 0, sizeof(StudentInfo)); 
+            dataLoaded = LoadStudentInfo(id);
+        } else {
+            memset(&currentFaculty, 0, sizeof(FacultyInfo)); 
+            dataLoaded = LoadFacultyInfo(id);
+        }
+        snprintf(loadedId, sizeof(loadedId), "%s", id);
+        loadedVersion = PortalFileVersion(profileFile);
     }
     
     if (!dataLoaded) {
         sprintf(statusMessage, "Error: Could not find profile for ID %s.", id);
     }
 
-    InitWindow(screenWidth, screenHeight, "University Portal - Dashboard");
+    PortalInitWindow(screenWidth, screenHeight, "University Portal - Dashboard");
     SetTargetFPS(60);
 
     while (!WindowShouldClose()) {
         UpdateDrawFrame();
     }
 
-    CloseWindow();
+    PortalCloseWindow();
     return 0;
 }
 
 //----------------------------------------------------------------------------------
 // Main Update and Draw Loop
 //----------------------------------------------------------------------------------
-void UpdateDrawFrame(void) {
+static void UpdateDrawFrame(void) {
     Vector2 mousePos = GetMousePosition();
     
     // Define the new button names
@@ -147,28 +169,31 @@ void UpdateDrawFrame(void) {
                 char cmd[256];
                 //int a = 28;
                 strcpy(cmd,"start prostr.exe 28 10");
-                system(cmd); // Launch the executable (Updated name)
+                PortalLaunch(cmd); // Launch the executable (Updated name)
             }
             else if (i == 0 && currentUserType == USER_TYPE_STUDENT) { // Academics (Student)
                 sprintf(statusMessage, "Launching Academics...");
-                system("start acadstu.exe 28 10"); // Launch the executable
+                // Pass the student's ID, so only their slice of the Academics data is loaded
+                char cmd[256];
+                snprintf(cmd, sizeof(cmd), "start acadstu.exe %s", currentStudent.id);
+                PortalLaunch(cmd); // Launch the executable
             } 
             else if (i == 0 && currentUserType == USER_TYPE_FACULTY) { // Academics (Faculty)
                 sprintf(statusMessage, "Launching Academics...");
-                system("start acadfac.exe 28 10"); // Launch the executable
+                PortalLaunch("start acadfac.exe 28 10"); // Launch the executable
             }
             else if (i == 3) { // Button 3 is "Administration Window"
                 if (isAdmin) {
                     // User is an admin
                     sprintf(statusMessage, "Launching Admin Portal...");
-                    system("start admin_portal.exe 28 10"); // Launch the main admin portal
+                    PortalLaunch("start admin_portal.exe 28 10"); // Launch the main admin portal
                 } else if (currentUserType == USER_TYPE_STUDENT) {
                     // User is a student
                     sprintf(statusMessage, "Launching Student Portal...");
                     // Pass the student's ID to the student portal
                     char cmd[256];
                     sprintf(cmd, "start student_portal.exe %s", currentStudent.id);
-                    system(cmd);
+                    PortalLaunch(cmd);
                 } else {
                     // User is a non-admin faculty, do nothing or show message
                     sprintf(statusMessage, "This section is for students or admins.");
@@ -179,7 +204,7 @@ void UpdateDrawFrame(void) {
                  char cmd[256];
                  //char type[] = "Student";
                  sprintf(cmd,"start anstu.exe %s %s", currentStudent.id, currentStudent.name);
-                 system(cmd);
+                 PortalLaunch(cmd);
                  
                  // system("start announcements.exe"); // Uncomment when ready
             }
@@ -187,7 +212,7 @@ void UpdateDrawFrame(void) {
                  sprintf(statusMessage, "Launching Announcements...");
                  char cmd[256];
                  sprintf(cmd,"start anadm.exe 28 10");
-                 system(cmd);
+                 PortalLaunch(cmd);
                  // system("start announcements.exe"); // Uncomment when ready
             }
         }
@@ -276,10 +301,85 @@ static void safe_fgets_and_strip(char* dest, int destSize, FILE* file) {
 }
 
 
+// Returns the size of a file in bytes, or -1 if it cannot be opened
+static long GetFileSizeBytes(const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) return -1;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+// Scans the whole data file once, writes a fresh fully sorted index and
+// answers the lookup from the entries still in memory
+static bool RebuildProfileIndex(const char *dataFile, const char *indexFile, const char *id, long *offset) {
+    FILE *file = fopen(dataFile, "rb");
+    if (file == NULL) return false;
+
+    int count = 0, capacity = 1024;
+    ProfileIndexEntry *entries = (ProfileIndexEntry *)malloc(capacity * sizeof(ProfileIndexEntry));
+    char line[MAX_LINE_LENGTH];
+    bool atRecordStart = true;
+    long lineStart = ftell(file);
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = 0;
+        if (atRecordStart) {
+            if (line[0] == '~') { // Tombstoned by adminad.c, skip to its --END--
+                atRecordStart = false;
+            } else if (strlen(line) >= 2) { // Same rule as adminad.c: skip blank lines between records
+                if (count == capacity) {
+                    capacity *= 2;
+                    entries = (ProfileIndexEntry *)realloc(entries, capacity * sizeof(ProfileIndexEntry));
+                }
+                memset(&entries[count], 0, sizeof(ProfileIndexEntry));
+                strncpy(entries[count].id, line, MAX_INPUT_CHARS);
+                entries[count].offset = lineStart;
+                count++;
+                atRecordStart = false;
+            }
+        } else if (strcmp(line, "--END--") == 0) {
+            atRecordStart = true;
+        }
+        lineStart = ftell(file);
+    }
+    long sourceSize = ftell(file);
+    fclose(file);
+
+    if (!ProfileIndexWrite(indexFile, entries, count, sourceSize)) TraceLog(LOG_WARNING, "Could not write %s.", indexFile);
+
+    ProfileIndexEntry key = { 0 };
+    strncpy(key.id, id, MAX_INPUT_CHARS);
+    key.offset = -1; // Sorts before any real offset, so the search lands on the first match
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (ProfileIndexCompare(&entries[mid], &key) < 0) lo = mid + 1; else hi = mid;
+    }
+    bool found = (lo < count && strcmp(entries[lo].id, id) == 0);
+    if (found) *offset = entries[lo].offset;
+
+    free(entries);
+    TraceLog(LOG_INFO, "Rebuilt %s with %d profiles.", indexFile, count);
+    return found;
+}
+
+// Resolves an id to the byte offset of its record, rebuilding a stale index
+bool FindProfileOffset(const char *dataFile, const char *indexFile, const char *id, long *offset) {
+    int result = ProfileIndexLookup(indexFile, GetFileSizeBytes(dataFile), id, offset);
+    if (result < 0) return RebuildProfileIndex(dataFile, indexFile, id, offset);
+    return result == 1;
+}
+
 // ✅ REPLACED FUNCTION
-// Now reads from the text student_info.txt
+// Now seeks straight to the record in student_info.txt through the index
 bool LoadStudentInfo(const char* id) {
-    FILE *file = fopen("student_info.txt", "r"); // "r" = read text
+    clock_t startTime = clock();
+    long offset = 0;
+    if (!FindProfileOffset("student_info.txt", "student_info.idx", id, &offset)) return false;
+
+    FILE *file = fopen("student_info.txt", "rb");
     if (!file) {
         TraceLog(LOG_WARNING, "student_info.txt not found.");
         return false;
@@ -288,8 +388,9 @@ bool LoadStudentInfo(const char* id) {
     char line[MAX_LINE_LENGTH];
     bool found = false;
     
-    // Read 10 lines at a time
-    while (fgets(line, sizeof(line), file) != NULL) {
+    // Read the 10 lines of the record at the indexed offset
+    fseek(file, offset, SEEK_SET);
+    if (fgets(line, sizeof(line), file) != NULL) {
         line[strcspn(line, "\r\n")] = 0; // Strip newline
         
         if (strcmp(line, id) == 0) { // Found the ID
@@ -311,18 +412,22 @@ bool LoadStudentInfo(const char* id) {
             fgets(line, sizeof(line), file);
             
             found = true;
-            break;
         }
     }
     
     fclose(file);
+    TraceLog(LOG_INFO, "Student profile loaded in %.2f ms.", (clock() - startTime) * 1000.0 / CLOCKS_PER_SEC);
     return found; // ID not found
 }
 
 // ✅ REPLACED FUNCTION
-// Now reads from the text faculty_info.txt
+// Now seeks straight to the record in faculty_info.txt through the index
 bool LoadFacultyInfo(const char* id) {
-    FILE *file = fopen("faculty_info.txt", "r"); // "r" = read text
+    clock_t startTime = clock();
+    long offset = 0;
+    if (!FindProfileOffset("faculty_info.txt", "faculty_info.idx", id, &offset)) return false;
+
+    FILE *file = fopen("faculty_info.txt", "rb");
     if (!file) {
         TraceLog(LOG_WARNING, "faculty_info.txt not found.");
         return false;
@@ -331,8 +436,9 @@ bool LoadFacultyInfo(const char* id) {
     char line[MAX_LINE_LENGTH];
     bool found = false;
 
-    // Read 8 lines at a time
-    while (fgets(line, sizeof(line), file) != NULL) {
+    // Read the 8 lines of the record at the indexed offset
+    fseek(file, offset, SEEK_SET);
+    if (fgets(line, sizeof(line), file) != NULL) {
         line[strcspn(line, "\r\n")] = 0; // Strip newline
         
         if (strcmp(line, id) == 0) { // Found the ID
@@ -352,10 +458,10 @@ bool LoadFacultyInfo(const char* id) {
             fgets(line, sizeof(line), file);
             
             found = true;
-            break;
         }
     }
     
     fclose(file);
+    TraceLog(LOG_INFO, "Faculty profile loaded in %.2f ms.", (clock() - startTime) * 1000.0 / CLOCKS_PER_SEC);
     return found; // ID not found
 }
\ No newline at end of file
@@ -10,6 +10,10 @@
 * to receive command-line arguments.
 * gcc afterreg.c -o afterreg.exe -lraylib -lgdi32 -lwinmm
 *
+* - New profiles are also appended to the tail of student_info.idx /
+*   faculty_info.idx (profileindex.h) so the index stays valid. A full tail
+*   is sorted into the rest, so logins never scan a long tail.
+*
 ********************************************************************************************/
 
 // This define is the KEY to fixing the compile error.
@@ -17,6 +21,8 @@
 #define PLATFORM_DESKTOP
 
 #include "raylib.h"
+#include "portal.h"
+#include "profileindex.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -68,12 +74,12 @@ typedef struct {
 //----------------------------------------------------------------------------------
 // Global Variables
 //----------------------------------------------------------------------------------
-const int screenWidth = 1920;
-const int screenHeight = 1080;
+static const int screenWidth = 1920;
+static const int screenHeight = 1080;
 
-UserType currentUserType = USER_TYPE_UNKNOWN;
-StudentInfo currentStudent;
-FacultyInfo currentFaculty;
+static UserType currentUserType = USER_TYPE_UNKNOWN;
+static StudentInfo currentStudent;
+static FacultyInfo currentFaculty;
 
 TextBox studentTextBoxes[NUM_STUDENT_TEXTBOXES];
 TextBox facultyTextBoxes[NUM_FACULTY_TEXTBOXES];
@@ -94,8 +100,9 @@ char f_infoPhoneText[MAX_INPUT_CHARS + 1] = {0};
 char f_infoDeptText[MAX_INPUT_CHARS + 1] = {0};
 char f_infoDesignationText[MAX_INPUT_CHARS + 1] = {0};
 
-char statusMessage[128] = "Please fill all details. All fields are mandatory.";
-Color statusMessageColor = DARKGRAY;
+static char statusMessage[128] = "Please fill all details. All fields are mandatory.";
+static bool profileSubmitted = false;
+static Color statusMessageColor = DARKGRAY;
 
 //----------------------------------------------------------------------------------
 // Module Functions Declaration
@@ -110,7 +117,7 @@ static void UpdateDrawFrame(void);
 //----------------------------------------------------------------------------------
 // Main Entry Point
 //----------------------------------------------------------------------------------
-int main(int argc, char *argv[]) {
+PORTAL_ENTRY(ProfileSetupMain) {
     if (argc < 4) {
         // This program is not meant to be run directly.
         // It requires ID, password, and user type as arguments.
@@ -137,23 +144,24 @@ int main(int argc, char *argv[]) {
         return 1; // Invalid user type
     }
     
-    InitWindow(screenWidth, screenHeight, "University Portal - Complete Your Profile");
+    PortalInitWindow(screenWidth, screenHeight, "University Portal - Complete Your Profile");
     InitStudentTextBoxes();
     InitFacultyTextBoxes();
     SetTargetFPS(60);
 
-    while (!WindowShouldClose()) {
+    profileSubmitted = false;
+    while (!profileSubmitted && !WindowShouldClose()) {
         UpdateDrawFrame();
     }
 
-    CloseWindow();
+    PortalCloseWindow();
     return 0;
 }
 
 //----------------------------------------------------------------------------------
 // Main Update and Draw Loop (Unchanged)
 //----------------------------------------------------------------------------------
-void UpdateDrawFrame(void) {
+static void UpdateDrawFrame(void) {
     Vector2 mousePos = GetMousePosition();
     TextBox *currentTextBoxes = (currentUserType == USER_TYPE_STUDENT) ? studentTextBoxes : facultyTextBoxes;
     int numTextBoxes = (currentUserType == USER_TYPE_STUDENT) ? NUM_STUDENT_TEXTBOXES : NUM_FACULTY_TEXTBOXES;
@@ -202,8 +210,11 @@ void UpdateDrawFrame(void) {
              DrawText(statusMessage, screenWidth / 2 - MeasureText(statusMessage, 40) / 2, screenHeight / 2 - 20, 40, LIME);
             EndDrawing();
             WaitTime(2.5);
-            system("start main.exe"); // Wait 2.5 seconds
-            exit(0);
+            // Standalone, start the login portal again; in the shell it is the screen that
+            // opened this one, so returning from ProfileSetupMain goes back to it
+            if (PORTAL_HANDOFF_EXITS) PortalLaunch("start main.exe");
+            profileSubmitted = true;
+            return;
         }
     }
 
@@ -309,6 +320,8 @@ void SaveStudentInfo(void) {
         TraceLog(LOG_ERROR, "Could not open student_info.txt for writing.");
         return;
     }
+    fseek(file, 0, SEEK_END);
+    long recordOffset = ftell(file);
 
     // Write the data as text, matching the format LoadStudentInfo expects
     fprintf(file, "%s\n", currentStudent.id);
@@ -322,8 +335,11 @@ void SaveStudentInfo(void) {
     fprintf(file, "%s\n", currentStudent.height);
     fprintf(file, "%s\n", currentStudent.bloodGroup);
     fprintf(file, "--END--\n"); // Add the separator line
+    long newSize = ftell(file);
 
     fclose(file);
+    ProfileIndexAppend("student_info.idx", currentStudent.id, recordOffset, newSize);
+    PortalFileWritten("student_info.txt"); // Screens that loaded the profiles read them again
 }
 
 // *** FIX: CHANGED TO TEXT I/O ***
@@ -341,6 +357,8 @@ void SaveFacultyInfo(void) {
         TraceLog(LOG_ERROR, "Could not open faculty_info.txt for writing.");
         return;
     }
+    fseek(file, 0, SEEK_END);
+    long recordOffset = ftell(file);
 
     // Write the data as text, matching the format LoadFacultyInfo expects
     fprintf(file, "%s\n", currentFaculty.id);
@@ -352,6 +370,9 @@ void SaveFacultyInfo(void) {
     fprintf(file, "%s\n", currentFaculty.department);
     fprintf(file, "%s\n", currentFaculty.designation);
     fprintf(file, "--END--\n"); // Add the separator line
+    long newSize = ftell(file);
 
     fclose(file);
-}
\ No newline at end of file
+    ProfileIndexAppend("faculty_info.idx", currentFaculty.id, recordOffset, newSize);
+    PortalFileWritten("faculty_info.txt"); // Screens that loaded the profiles read them again
+}
@@ -0,0 +1,371 @@
+/*******************************************************************************************
+*
+* University Portal System - Cohort Results Analytics
+*
+* Groups result rows (student, subject, credits, earned, grade point, grade) by
+* student and by subject and reports:
+*
+* - per student: credits, earned credits, credit-weighted CPI and its percentile
+*   among all students
+* - per subject: credit-weighted mean grade point, pass rate, grade histogram and
+*   the 25th/50th/90th percentile grade points
+* - per row: the percentile rank of the row's grade point within its subject
+*
+* Rows are hash-partitioned across threads (by student for the student table, by
+* subject for the subject table), so every partition is aggregated by one thread
+* with its own hash table and no locks. Keys are pointer + length, so rows can point
+* straight into a mapped results.txt.
+*
+* Uses pthreads (winpthreads on MinGW), like the timetable generator.
+*
+********************************************************************************************/
+
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include "monoclock.h"
+
+#define ANALYTICS_THREADS 4
+#define ANALYTICS_MAX_THREADS 16
+#define ANALYTICS_GRADE_COUNT 21         // The grades below plus "other"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct {
+    const char *text;                   // Not NUL-terminated
+    int length;
+} AnalyticsText;
+
+typedef struct {
+    AnalyticsText student, subject, grade;
+    int credits, earned;
+    float gradePoint;                   // The SPI column of results.txt
+    int passed;
+} AnalyticsRow;
+
+typedef struct {
+    AnalyticsText id;
+    int rows, passed;
+    long credits, earned;
+    double weighted;                    // Sum of gradePoint * credits
+    double cpi;
+    float percentile;                   // Of cpi among all students
+} AnalyticsStudent;
+
+typedef struct {
+    AnalyticsText name;
+    int rows, passed;
+    long credits;
+    double weighted;
+    double meanGradePoint;              // Credit-weighted
+    float p25, p50, p90;
+    uint32_t grades[ANALYTICS_GRADE_COUNT];
+} AnalyticsSubject;
+
+typedef struct {
+    AnalyticsStudent *students;
+    int studentCount;
+    AnalyticsSubject *subjects;
+    int subjectCount;
+    float *rowPercentile;               // Per input row, within its subject
+    int rows, threads;
+    double ms;
+} AnalyticsReport;
+
+// Per-thread state; each thread owns one partition of the students and one of the subjects
+typedef struct {
+    const AnalyticsRow *rows;
+    int count;
+    int first, last;                    // The chunk of rows this thread hashes and scatters
+    int threads, index;
+    uint32_t *studentHash, *subjectHash;
+    int *studentOffsets, *subjectOffsets;   // [threads * threads], see AnalyticsRun()
+    int *studentOrder, *subjectOrder;
+    int *rowSlot;
+    float *rowPercentile;
+    int phase;
+
+    AnalyticsStudent *students;         // Phase 2 output, this partition only
+    int studentCount;
+    AnalyticsSubject *subjects;
+    int subjectCount;
+} AnalyticsWorker;
+
+static const char *const ANALYTICS_GRADES[ANALYTICS_GRADE_COUNT - 1] = {
+    "AA", "AB", "BB", "BC", "CC", "CD", "DD", "FF",
+    "O", "A+", "A", "A-", "B+", "B", "B-", "C+", "C", "C-", "D", "F"
+};
+
+//----------------------------------------------------------------------------------
+// Helpers
+//----------------------------------------------------------------------------------
+static inline uint32_t AnalyticsHash(AnalyticsText key) {
+    uint32_t hash = 2166136261u;        // FNV-1a
+    for (int i = 0; i < key.length; i++) hash = (hash ^ (unsigned char)key.text[i]) * 16777619u;
+    return hash;
+}
+
+static inline bool AnalyticsTextEqual(AnalyticsText a, AnalyticsText b) {
+    return a.length == b.length && memcmp(a.text, b.text, a.length) == 0;
+}
+
+static inline AnalyticsText AnalyticsTextOf(const char *text) {
+    return (AnalyticsText){ text, (int)strlen(text) };
+}
+
+static inline int AnalyticsGradeIndex(AnalyticsText grade) {
+    for (int g = 0; g < ANALYTICS_GRADE_COUNT - 1; g++) {
+        if ((int)strlen(ANALYTICS_GRADES[g]) == grade.length && memcmp(ANALYTICS_GRADES[g], grade.text, grade.length) == 0) return g;
+    }
+    return ANALYTICS_GRADE_COUNT - 1;
+}
+
+static inline const char *AnalyticsGradeName(int index) {
+    return (index < ANALYTICS_GRADE_COUNT - 1) ? ANALYTICS_GRADES[index] : "other";
+}
+
+// The high hash bits pick the partition, the low bits the hash table slot
+static inline int AnalyticsPartition(uint32_t hash, int threads) { return (int)((hash >> 20) % (uint32_t)threads); }
+
+// A grade point and its row in one integer that sorts by grade point: the float's bits,
+// flipped so negative values order correctly, above the row index
+static inline uint64_t AnalyticsPointKey(float value, int row) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    return ((uint64_t)bits << 32) | (uint32_t)row;
+}
+
+static inline float AnalyticsKeyPoint(uint64_t key) {
+    uint32_t bits = (uint32_t)(key >> 32);
+    bits = (bits & 0x80000000u) ? (bits & 0x7FFFFFFFu) : ~bits;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline int AnalyticsCompareKeys(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static inline float AnalyticsQuantile(const uint64_t *sorted, int count, float q) {
+    return count ? AnalyticsKeyPoint(sorted[(int)(q * (count - 1) + 0.5f)]) : 0.0f;
+}
+
+//----------------------------------------------------------------------------------
+// Partition Aggregation
+//----------------------------------------------------------------------------------
+static inline int AnalyticsTableSize(int rows) {
+    int size = 16;
+    while (size < rows * 2) size *= 2;
+    return size;
+}
+
+static inline void AnalyticsAggregateStudents(AnalyticsWorker *w, const int *order, int count) {
+    int size = AnalyticsTableSize(count);
+    int *table = (int *)malloc(sizeof(int) * size);
+    memset(table, 0xFF, sizeof(int) * size);
+    w->students = (AnalyticsStudent *)calloc(count > 0 ? count : 1, sizeof(AnalyticsStudent));
+    w->studentCount = 0;
+
+    for (int k = 0; k < count; k++) {
+        const AnalyticsRow *row = &w->rows[order[k]];
+        uint32_t slot = w->studentHash[order[k]] & (size - 1);
+        while (table[slot] >= 0 && !AnalyticsTextEqual(w->students[table[slot]].id, row->student)) slot = (slot + 1) & (size - 1);
+        if (table[slot] < 0) { table[slot] = w->studentCount; w->students[w->studentCount++].id = row->student; }
+
+        AnalyticsStudent *s = &w->students[table[slot]];
+        s->rows++; s->passed += row->passed ? 1 : 0;
+        s->credits += row->credits; s->earned += row->earned;
+        s->weighted += (double)row->gradePoint * row->credits;
+    }
+    for (int i = 0; i < w->studentCount; i++) {
+        AnalyticsStudent *s = &w->students[i];
+        s->cpi = s->credits ? s->weighted / s->credits : 0.0;
+    }
+    free(table);
+}
+
+static inline void AnalyticsAggregateSubjects(AnalyticsWorker *w, const int *order, int count) {
+    int size = AnalyticsTableSize(count);
+    int *table = (int *)malloc(sizeof(int) * size);
+    memset(table, 0xFF, sizeof(int) * size);
+    w->subjects = (AnalyticsSubject *)calloc(count > 0 ? count : 1, sizeof(AnalyticsSubject));
+    w->subjectCount = 0;
+
+    for (int k = 0; k < count; k++) {
+        int r = order[k];
+        const AnalyticsRow *row = &w->rows[r];
+        uint32_t slot = w->subjectHash[r] & (size - 1);
+        while (table[slot] >= 0 && !AnalyticsTextEqual(w->subjects[table[slot]].name, row->subject)) slot = (slot + 1) & (size - 1);
+        if (table[slot] < 0) { table[slot] = w->subjectCount; w->subjects[w->subjectCount++].name = row->subject; }
+
+        AnalyticsSubject *s = &w->subjects[table[slot]];
+        s->rows++; s->passed += row->passed ? 1 : 0;
+        s->credits += row->credits;
+        s->weighted += (double)row->gradePoint * row->credits;
+        s->grades[AnalyticsGradeIndex(row->grade)]++;
+        w->rowSlot[r] = table[slot];
+    }
+    free(table);
+
+    // Rows of each subject sorted by grade point. The quantiles are read off the sorted run,
+    // and one walk over its ties gives every row its percentile (share below, ties counted half).
+    int *start = (int *)calloc(w->subjectCount + 1, sizeof(int));
+    for (int i = 0; i < w->subjectCount; i++) start[i + 1] = start[i] + w->subjects[i].rows;
+    uint64_t *keys = (uint64_t *)malloc(sizeof(uint64_t) * (count > 0 ? count : 1));
+    int *next = (int *)malloc(sizeof(int) * (w->subjectCount > 0 ? w->subjectCount : 1));
+    memcpy(next, start, sizeof(int) * w->subjectCount);
+    for (int k = 0; k < count; k++) keys[next[w->rowSlot[order[k]]]++] = AnalyticsPointKey(w->rows[order[k]].gradePoint, order[k]);
+
+    for (int i = 0; i < w->subjectCount; i++) {
+        AnalyticsSubject *s = &w->subjects[i];
+        uint64_t *sorted = keys + start[i];
+        qsort(sorted, s->rows, sizeof(uint64_t), AnalyticsCompareKeys);
+        s->meanGradePoint = s->credits ? s->weighted / s->credits : 0.0;
+        s->p25 = AnalyticsQuantile(sorted, s->rows, 0.25f);
+        s->p50 = AnalyticsQuantile(sorted, s->rows, 0.50f);
+        s->p90 = AnalyticsQuantile(sorted, s->rows, 0.90f);
+        for (int a = 0; a < s->rows; ) {
+            int b = a;
+            while (b < s->rows && (sorted[b] >> 32) == (sorted[a] >> 32)) b++;
+            float percentile = 100.0f * (a + 0.5f * (b - a)) / s->rows;
+            for (int k = a; k < b; k++) w->rowPercentile[(uint32_t)sorted[k]] = percentile;
+            a = b;
+        }
+    }
+    free(start); free(keys); free(next);
+}
+
+// Phase 0 hashes a chunk and counts rows per partition, phase 1 scatters the chunk's
+// row indices into the partitions, phase 2 aggregates this thread's partition
+static inline void *AnalyticsWorkerMain(void *arg) {
+    AnalyticsWorker *w = (AnalyticsWorker *)arg;
+    int T = w->threads, t = w->index;
+
+    if (w->phase == 0) {
+        int *studentCounts = w->studentOffsets + t*T, *subjectCounts = w->subjectOffsets + t*T;
+        for (int r = w->first; r < w->last; r++) {
+            w->studentHash[r] = AnalyticsHash(w->rows[r].student);
+            w->subjectHash[r] = AnalyticsHash(w->rows[r].subject);
+            studentCounts[AnalyticsPartition(w->studentHash[r], T)]++;
+            subjectCounts[AnalyticsPartition(w->subjectHash[r], T)]++;
+        }
+    } else if (w->phase == 1) {
+        int studentNext[ANALYTICS_MAX_THREADS], subjectNext[ANALYTICS_MAX_THREADS];
+        memcpy(studentNext, w->studentOffsets + t*T, sizeof(int) * T);
+        memcpy(subjectNext, w->subjectOffsets + t*T, sizeof(int) * T);
+        for (int r = w->first; r < w->last; r++) {
+            w->studentOrder[studentNext[AnalyticsPartition(w->studentHash[r], T)]++] = r;
+            w->subjectOrder[subjectNext[AnalyticsPartition(w->subjectHash[r], T)]++] = r;
+        }
+    } else {
+        // Partition t starts where thread 0 started writing it and ends where partition t + 1 starts
+        int studentBegin = w->studentOffsets[t], studentEnd = (t + 1 < T) ? w->studentOffsets[t + 1] : w->count;
+        int subjectBegin = w->subjectOffsets[t], subjectEnd = (t + 1 < T) ? w->subjectOffsets[t + 1] : w->count;
+        AnalyticsAggregateStudents(w, w->studentOrder + studentBegin, studentEnd - studentBegin);
+        AnalyticsAggregateSubjects(w, w->subjectOrder + subjectBegin, subjectEnd - subjectBegin);
+    }
+    return NULL;
+}
+
+static inline void AnalyticsRunPhase(AnalyticsWorker *workers, int threads, int phase) {
+    pthread_t ids[ANALYTICS_MAX_THREADS];
+    for (int t = 0; t < threads; t++) workers[t].phase = phase;
+    for (int t = 1; t < threads; t++) pthread_create(&ids[t], NULL, AnalyticsWorkerMain, &workers[t]);
+    AnalyticsWorkerMain(&workers[0]);   // The calling thread does partition 0
+    for (int t = 1; t < threads; t++) pthread_join(ids[t], NULL);
+}
+
+static inline int AnalyticsCompareCpi(const void *a, const void *b) {
+    double x = (*(const AnalyticsStudent * const *)a)->cpi, y = (*(const AnalyticsStudent * const *)b)->cpi;
+    return (x > y) - (x < y);
+}
+
+//----------------------------------------------------------------------------------
+// Entry Points
+//----------------------------------------------------------------------------------
+static inline void AnalyticsFree(AnalyticsReport *report) {
+    free(report->students); free(report->subjects); free(report->rowPercentile);
+    memset(report, 0, sizeof(*report));
+}
+
+// Replaces 'report' with the analytics of rows[count]; the rows' text must outlive it
+static inline void AnalyticsRun(const AnalyticsRow *rows, int count, int threads, AnalyticsReport *report) {
+    double start = MonoClockNow();
+    AnalyticsFree(report);
+    if (threads < 1) threads = 1;
+    if (threads > ANALYTICS_MAX_THREADS) threads = ANALYTICS_MAX_THREADS;
+    if (threads > count / 1024 + 1) threads = count / 1024 + 1;    // Small inputs are not worth a thread
+
+    int T = threads;
+    uint32_t *studentHash = (uint32_t *)malloc(sizeof(uint32_t) * (count + 1));
+    uint32_t *subjectHash = (uint32_t *)malloc(sizeof(uint32_t) * (count + 1));
+    int *studentOrder = (int *)malloc(sizeof(int) * (count + 1));
+    int *subjectOrder = (int *)malloc(sizeof(int) * (count + 1));
+    int *rowSlot = (int *)malloc(sizeof(int) * (count + 1));
+    int *studentOffsets = (int *)calloc(T*T, sizeof(int)), *subjectOffsets = (int *)calloc(T*T, sizeof(int));
+    report->rowPercentile = (float *)malloc(sizeof(float) * (count + 1));
+
+    AnalyticsWorker workers[ANALYTICS_MAX_THREADS];
+    for (int t = 0; t < T; t++) {
+        workers[t] = (AnalyticsWorker){ rows, count, (int)((long)count * t / T), (int)((long)count * (t + 1) / T), T, t,
+                                         studentHash, subjectHash, studentOffsets, subjectOffsets,
+                                         studentOrder, subjectOrder, rowSlot, report->rowPercentile };
+    }
+    AnalyticsRunPhase(workers, T, 0);
+
+    // offsets[t*T + p] = rows of thread t in partition p; turn them into write positions,
+    // partition-major, so partition p ends up contiguous in the order arrays
+    int studentSum = 0, subjectSum = 0;
+    for (int p = 0; p < T; p++) {
+        for (int t = 0; t < T; t++) {
+            int s = studentOffsets[t*T + p], j = subjectOffsets[t*T + p];
+            studentOffsets[t*T + p] = studentSum; studentSum += s;
+            subjectOffsets[t*T + p] = subjectSum; subjectSum += j;
+        }
+    }
+    AnalyticsRunPhase(workers, T, 1);
+    AnalyticsRunPhase(workers, T, 2);
+
+    // Gather the partitions
+    for (int t = 0; t < T; t++) { report->studentCount += workers[t].studentCount; report->subjectCount += workers[t].subjectCount; }
+    report->students = (AnalyticsStudent *)malloc(sizeof(AnalyticsStudent) * (report->studentCount + 1));
+    report->subjects = (AnalyticsSubject *)malloc(sizeof(AnalyticsSubject) * (report->subjectCount + 1));
+    int studentAt = 0, subjectAt = 0;
+    for (int t = 0; t < T; t++) {
+        memcpy(report->students + studentAt, workers[t].students, sizeof(AnalyticsStudent) * workers[t].studentCount);
+        studentAt += workers[t].studentCount;
+        memcpy(report->subjects + subjectAt, workers[t].subjects, sizeof(AnalyticsSubject) * workers[t].subjectCount);
+        subjectAt += workers[t].subjectCount;
+        free(workers[t].students); free(workers[t].subjects);
+    }
+
+    // CPI percentile of each student among all students
+    AnalyticsStudent **byCpi = (AnalyticsStudent **)malloc(sizeof(AnalyticsStudent *) * (report->studentCount + 1));
+    for (int i = 0; i < report->studentCount; i++) byCpi[i] = &report->students[i];
+    qsort(byCpi, report->studentCount, sizeof(AnalyticsStudent *), AnalyticsCompareCpi);
+    for (int i = 0; i < report->studentCount; ) {
+        int j = i;
+        while (j < report->studentCount && byCpi[j]->cpi == byCpi[i]->cpi) j++;
+        for (int k = i; k < j; k++) byCpi[k]->percentile = 100.0f * (i + 0.5f * (j - i)) / report->studentCount;
+        i = j;
+    }
+
+    free(byCpi); free(studentHash); free(subjectHash); free(studentOrder); free(subjectOrder);
+    free(rowSlot); free(studentOffsets); free(subjectOffsets);
+    report->rows = count;
+    report->threads = T;
+    report->ms = (MonoClockNow() - start) * 1000.0;
+}
+
+#endif // ANALYTICS_H
@@ -13,6 +13,7 @@
 ********************************************************************************************/
 
 #include "raylib.h"
+#include "portal.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -56,8 +57,8 @@ typedef struct {
 // ----------------------------------------------------------------------------------
 // Global Variables
 // ----------------------------------------------------------------------------------
-const int screenWidth = 1920;
-const int screenHeight = 1080;
+static const int screenWidth = 1920;
+static const int screenHeight = 1080;
 
 typedef enum {
     SCREEN_MAIN_MENU,
@@ -69,20 +70,22 @@ typedef enum {
     SCREEN_DETAIL_EVENT         // NEW: Added detail screen
 } PortalScreen;
 
-PortalScreen currentScreen = SCREEN_MAIN_MENU;
+static PortalScreen currentScreen = SCREEN_MAIN_MENU;
 
 // Loaded data
 Announcement *g_ann = NULL;
 int g_ann_count = 0;
 Event *g_evt = NULL;
 int g_evt_count = 0;
+static bool g_loaded = false;       // In the portal shell the lists outlive a visit...
+static unsigned int g_version = 0;  // ...while the files are at this PortalFileVersion() sum
 
 // UI state
-Vector2 g_mouse_pos = { 0 };
-float g_scroll_y = 0;
+static Vector2 g_mouse_pos = { 0 };
+static float g_scroll_y = 0;
 char g_status_msg[128] = {0};
 Color g_status_color = GRAY;
-int g_selected_id = -1;     // NEW: ID of item to view in detail
+static int g_selected_id = -1;     // NEW: ID of item to view in detail
 
 // Text boxes for Add forms
 TextBox addTextBoxes[3]; // [0] = Title, [1] = Body, [2] = Date
@@ -118,7 +121,7 @@ int valid_date(const char *s) {
 // ----------------------------------------------------------------------------------
 // File I/O Functions (from original admin.c)
 // ----------------------------------------------------------------------------------
-int load_announcements(Announcement **out, int *count) {
+static int load_announcements(Announcement **out, int *count) {
     *out = NULL; *count = 0;
     FILE *f = fopen(ANN_FILE, "rb");
     if (!f) return 0;
@@ -141,10 +144,12 @@ int save_announcements(Announcement *arr, int count) {
     FILE *f = fopen(ANN_FILE, "wb");
     if (!f) return -1;
     fwrite(arr, sizeof(Announcement), count, f);
-    fclose(f); return 0;
+    fclose(f);
+    PortalFileWritten(ANN_FILE);    // The student window reads it again
+    return 0;
 }
 
-int load_events(Event **out, int *count) {
+static int load_events(Event **out, int *count) {
     *out = NULL; *count = 0;
     FILE *f = fopen(EVT_FILE, "rb");
     if (!f) return 0;
@@ -162,17 +167,21 @@ int load_events(Event **out, int *count) {
     *out = arr; *count = read; return 1;
 }
 
-int save_events(Event *arr, int count) {
+static int save_events(Event *arr, int count) {
     FILE *f = fopen(EVT_FILE, "wb");
     if (!f) return -1;
     fwrite(arr, sizeof(Event), count, f);
-    fclose(f); return 0;
+    fclose(f);
+    PortalFileWritten(EVT_FILE);
+    return 0;
 }
 
 // ----------------------------------------------------------------------------------
 // GUI Helper Functions
 // ----------------------------------------------------------------------------------
 void ReloadData(void) {
+    g_loaded = true;
+    g_version = PortalFileVersion(ANN_FILE) + PortalFileVersion(EVT_FILE);
     free(g_ann); g_ann = NULL; g_ann_count = 0;
     free(g_evt); g_evt = NULL; g_evt_count = 0;
     load_announcements(&g_ann, &g_ann_count);
@@ -225,21 +234,21 @@ void HandleTextBoxInput(TextBox *textBox, bool allowNewline) {
 // ----------------------------------------------------------------------------------
 // Module Functions Declaration
 // ----------------------------------------------------------------------------------
-void UpdateDrawFrame(void);
-void UpdateMainMenu(void);
-void DrawMainMenu(void);
+static void UpdateDrawFrame(void);
+static void UpdateMainMenu(void);
+static void DrawMainMenu(void);
 void UpdateListScreen(bool isAnnouncements);
 void DrawListScreen(bool isAnnouncements);
 void UpdateAddScreen(bool isAnnouncements);
 void DrawAddScreen(bool isAnnouncements);
-void UpdateDetailView(void);        // NEW
-void DrawDetailView(bool isAnnouncement); // NEW
+static void UpdateDetailView(void);        // NEW
+static void DrawDetailView(bool isAnnouncement); // NEW
 
 // --- NEW HELPER FUNCTION ---
 // This function draws text, manually handling newlines ('\n')
 // and allowing for vertical scrolling.
 // This is a replacement for DrawTextRec() for older Raylib versions.
-void DrawTextScrollable(const char *text, Rectangle bounds, float scrollY, int fontSize, Color color) {
+static void DrawTextScrollable(const char *text, Rectangle bounds, float scrollY, int fontSize, Color color) {
     // Create a mutable copy of the text to use with strtok
     // BODY_LEN is 2048, which is a safe buffer size.
     char textCopy[BODY_LEN];
@@ -269,12 +278,12 @@ void DrawTextScrollable(const char *text, Rectangle bounds, float scrollY, int f
 // ----------------------------------------------------------------------------------
 // Main Entry Point
 // ----------------------------------------------------------------------------------
-int main(int argc, char *argv[]) {
+PORTAL_ENTRY(AnnouncementsAdminMain) {
     if(argc<3) return 0;
-    InitWindow(screenWidth, screenHeight, "University Portal - Announcements");
+    PortalInitWindow(screenWidth, screenHeight, "University Portal - Announcements");
     
     InitAddTextBoxes();
-    ReloadData();
+    if (!g_loaded || g_version != PortalFileVersion(ANN_FILE) + PortalFileVersion(EVT_FILE)) ReloadData();
 
     SetTargetFPS(60);
 
@@ -282,16 +291,18 @@ int main(int argc, char *argv[]) {
         UpdateDrawFrame();
     }
 
+#if !defined(PORTAL_SHELL)
     free(g_ann);
     free(g_evt);
-    CloseWindow();
+#endif
+    PortalCloseWindow();
     return 0;
 }
 
 // ----------------------------------------------------------------------------------
 // Main Update and Draw Loop
 // ----------------------------------------------------------------------------------
-void UpdateDrawFrame(void) {
+static void UpdateDrawFrame(void) {
     g_mouse_pos = GetMousePosition();
 
     // Update logic
@@ -330,7 +341,7 @@ void UpdateDrawFrame(void) {
 // ----------------------------------------------------------------------------------
 // Main Menu Screen
 // ----------------------------------------------------------------------------------
-void UpdateMainMenu(void) {
+static void UpdateMainMenu(void) {
     int btnWidth = 500;
     int btnX = screenWidth / 2 - btnWidth / 2; // Centered
     
@@ -353,7 +364,7 @@ void UpdateMainMenu(void) {
     }
 }
 
-void DrawMainMenu(void) {
+static void DrawMainMenu(void) {
     DrawText("Main Menu", screenWidth / 2 - MeasureText("Main Menu", 40) / 2, 100, 40, DARKGRAY);
 
     int btnWidth = 500;
@@ -661,7 +672,7 @@ void DrawAddScreen(bool isAnnouncements) {
 // ----------------------------------------------------------------------------------
 // Detail View Screen (NEW FOR ADMIN)
 // ----------------------------------------------------------------------------------
-void UpdateDetailView() {
+static void UpdateDetailView() {
     // Check for Back Button click
     Rectangle backBtnRec = { 20, 80, 100, 40 };
     if (CheckCollisionPointRec(g_mouse_pos, backBtnRec) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
@@ -676,7 +687,7 @@ void UpdateDetailView() {
     if (g_scroll_y < -(BODY_LEN / 20 * 25)) g_scroll_y = -(BODY_LEN / 20 * 25);
 }
 
-void DrawDetailView(bool isAnnouncement) {
+static void DrawDetailView(bool isAnnouncement) {
     // Draw Back Button
     Rectangle backBtnRec = { 20, 80, 100, 40 };
     bool backHover = CheckCollisionPointRec(g_mouse_pos, backBtnRec);
@@ -6,6 +6,8 @@
 * - It is launched by 'login_system.exe' (main.c).
 * - It receives the user's ID and type as command-line arguments.
 * - It uses Raylib to display announcements and events from .dat files.
+* - The records are shared through datacache.h, so a second window maps the
+*   first one's snapshot instead of reading the .dat files again.
 *
 * How to Compile (Windows with MinGW-w64):
 * This file DOES take command-line arguments, so we do NOT use -mwindows.
@@ -14,9 +16,11 @@
 ********************************************************************************************/
 
 #include "raylib.h"
+#include "portal.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "datacache.h"
 
 // ----------------------------------------------------------------------------------
 // Data Definitions (from original student.c)
@@ -44,8 +48,8 @@ typedef struct {
 // ----------------------------------------------------------------------------------
 // Global Variables
 // ----------------------------------------------------------------------------------
-const int screenWidth = 1920;  // Increased from 1280
-const int screenHeight = 1080; // Increased from 720
+static const int screenWidth = 1920;  // Increased from 1280
+static const int screenHeight = 1080; // Increased from 720
 
 // Screen state
 typedef enum {
@@ -56,27 +60,30 @@ typedef enum {
     SCREEN_DETAIL_EVENT
 } PortalScreen;
 
-PortalScreen currentScreen = SCREEN_MAIN_MENU;
+static PortalScreen currentScreen = SCREEN_MAIN_MENU;
 
 // Loaded data
 Announcement *g_announcements = NULL;
 int g_announcement_count = 0;
 Event *g_events = NULL;
 int g_event_count = 0;
+bool g_data_shared = false; // Arrays point into a read-only shared snapshot
+static bool g_data_loaded = false;      // In the portal shell the lists outlive a visit...
+static unsigned int g_data_version = 0; // ...until the admin window saves (PortalFileVersion() sum)
 
 // Logged-in user info
 char g_user_id[64] = "Unknown";
 char g_user_type[64] = "User";
 
 // UI state
-Vector2 g_mouse_pos = { 0 };
-float g_scroll_y = 0;       // For list scrolling
-int g_selected_id = -1;     // ID of item to view in detail
+static Vector2 g_mouse_pos = { 0 };
+static float g_scroll_y = 0;       // For list scrolling
+static int g_selected_id = -1;     // ID of item to view in detail
 
 // ----------------------------------------------------------------------------------
 // File Loading Functions (from original student.c)
 // ----------------------------------------------------------------------------------
-int load_announcements(Announcement **out, int *count) {
+static int load_announcements(Announcement **out, int *count) {
     *out = NULL; *count = 0;
     FILE *f = fopen(ANN_FILE, "rb");
     if (!f) return 0;
@@ -94,7 +101,7 @@ int load_announcements(Announcement **out, int *count) {
     *out = arr; *count = read; return 1;
 }
 
-int load_events(Event **out, int *count) {
+static int load_events(Event **out, int *count) {
     *out = NULL; *count = 0;
     FILE *f = fopen(EVT_FILE, "rb");
     if (!f) return 0;
@@ -112,22 +119,50 @@ int load_events(Event **out, int *count) {
     *out = arr; *count = read; return 1;
 }
 
+// Maps the shared snapshot when the .dat files are unchanged, else reads and publishes them
+static void load_shared_data(void) {
+    double start = GetTime();
+    g_data_loaded = true;
+    g_data_version = PortalFileVersion(ANN_FILE) + PortalFileVersion(EVT_FILE);
+    const DataCacheHeader *cache = DataCacheAttach("anstu");
+    if (cache && DataCacheIsFresh(cache)) {
+        Announcement *ann = (Announcement *)DataCacheSectionData(cache, 0, sizeof(Announcement), &g_announcement_count);
+        Event *evt = (Event *)DataCacheSectionData(cache, 1, sizeof(Event), &g_event_count);
+        if (ann && evt) {
+            g_announcements = ann; g_events = evt; g_data_shared = true;
+            TraceLog(LOG_INFO, "ANSTU: Attached shared records (generation %ld) in %.3f ms.", cache->generation, (GetTime() - start) * 1000.0);
+            return;
+        }
+    }
+
+    load_announcements(&g_announcements, &g_announcement_count);
+    load_events(&g_events, &g_event_count);
+    double loaded = GetTime();
+    DataCacheSource sources[] = {
+        { ANN_FILE, g_announcements, sizeof(Announcement), g_announcement_count },
+        { EVT_FILE, g_events,        sizeof(Event),        g_event_count },
+    };
+    DataCachePublish("anstu", sources, 2);
+    TraceLog(LOG_INFO, "ANSTU: Read files in %.3f ms, published in %.3f ms.",
+             (loaded - start) * 1000.0, (GetTime() - loaded) * 1000.0);
+}
+
 // ----------------------------------------------------------------------------------
 // Module Functions Declaration
 // ----------------------------------------------------------------------------------
-void UpdateDrawFrame(void);
-void UpdateMainMenu(void);
-void DrawMainMenu(void);
+static void UpdateDrawFrame(void);
+static void UpdateMainMenu(void);
+static void DrawMainMenu(void);
 void UpdateListView(bool isAnnouncements);
 void DrawListView(bool isAnnouncements);
-void UpdateDetailView(void);
-void DrawDetailView(bool isAnnouncement);
+static void UpdateDetailView(void);
+static void DrawDetailView(bool isAnnouncement);
 
 // --- NEW HELPER FUNCTION ---
 // This function draws text, manually handling newlines ('\n')
 // and allowing for vertical scrolling.
 // This is a replacement for DrawTextRec() for older Raylib versions.
-void DrawTextScrollable(const char *text, Rectangle bounds, float scrollY, int fontSize, Color color) {
+static void DrawTextScrollable(const char *text, Rectangle bounds, float scrollY, int fontSize, Color color) {
     // Create a mutable copy of the text to use with strtok
     // BODY_LEN is 2048, which is a safe buffer size.
     char textCopy[BODY_LEN];
@@ -158,7 +193,7 @@ void DrawTextScrollable(const char *text, Rectangle bounds, float scrollY, int f
 // ----------------------------------------------------------------------------------
 // Main Entry Point
 // ----------------------------------------------------------------------------------
-int main(int argc, char *argv[]) {
+PORTAL_ENTRY(AnnouncementsStudentMain) {
     // Capture user info from command-line args (passed by login_system)
     if (argc >= 3) {
         strncpy(g_user_id, argv[1], 63);
@@ -170,11 +205,17 @@ int main(int argc, char *argv[]) {
         return 0;
     }
 
-    InitWindow(screenWidth, screenHeight, "University Portal - Announcements");
+    PortalInitWindow(screenWidth, screenHeight, "University Portal - Announcements");
     
-    // Load data
-    load_announcements(&g_announcements, &g_announcement_count);
-    load_events(&g_events, &g_event_count);
+    // Load data, unless the shell still holds it from the last visit
+    if (!g_data_loaded || g_data_version != PortalFileVersion(ANN_FILE) + PortalFileVersion(EVT_FILE)) {
+        if (g_data_loaded && !g_data_shared) {
+            free(g_announcements);
+            free(g_events);
+        }
+        g_announcements = NULL; g_events = NULL; g_data_shared = false;
+        load_shared_data();
+    }
 
     SetTargetFPS(60);
 
@@ -182,18 +223,23 @@ int main(int argc, char *argv[]) {
         UpdateDrawFrame();
     }
 
-    // Unload data
-    free(g_announcements);
-    free(g_events);
+    // Unload data (a shared snapshot just stays mapped); the shell keeps it for next time
+#if !defined(PORTAL_SHELL)
+    if (!g_data_shared) {
+        free(g_announcements);
+        free(g_events);
+    }
+    g_announcements = NULL; g_events = NULL; g_data_shared = false;
+#endif
 
-    CloseWindow();
+    PortalCloseWindow();
     return 0;
 }
 
 // ----------------------------------------------------------------------------------
 // Main Update and Draw Loop
 // ----------------------------------------------------------------------------------
-void UpdateDrawFrame(void) {
+static void UpdateDrawFrame(void) {
     g_mouse_pos = GetMousePosition();
 
     // Update logic based on screen
@@ -231,7 +277,7 @@ void UpdateDrawFrame(void) {
 // ----------------------------------------------------------------------------------
 // Main Menu Screen
 // ----------------------------------------------------------------------------------
-void UpdateMainMenu(void) {
+static void UpdateMainMenu(void) {
     // Button for Announcements
     Rectangle annBtnRec = { screenWidth / 2 - 250, 300, 500, 100 };
     if (CheckCollisionPointRec(g_mouse_pos, annBtnRec) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
@@ -247,7 +293,7 @@ void UpdateMainMenu(void) {
     }
 }
 
-void DrawMainMenu(void) {
+static void DrawMainMenu(void) {
     DrawText("Main Menu", screenWidth / 2 - MeasureText("Main Menu", 40) / 2, 150, 40, DARKGRAY);
 
     // Button for Announcements
@@ -349,7 +395,7 @@ void DrawListView(bool isAnnouncements) {
 // ----------------------------------------------------------------------------------
 // Detail View Screen
 // ----------------------------------------------------------------------------------
-void UpdateDetailView() {
+static void UpdateDetailView() {
     // Check for Back Button click
     Rectangle backBtnRec = { 20, 80, 100, 40 };
     if (CheckCollisionPointRec(g_mouse_pos, backBtnRec) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
@@ -366,7 +412,7 @@ void UpdateDetailView() {
     if (g_scroll_y < -(BODY_LEN / 20 * 25)) g_scroll_y = -(BODY_LEN / 20 * 25);
 }
 
-void DrawDetailView(bool isAnnouncement) {
+static void DrawDetailView(bool isAnnouncement) {
     // Draw Back Button
     Rectangle backBtnRec = { 20, 80, 100, 40 };
     bool backHover = CheckCollisionPointRec(g_mouse_pos, backBtnRec);
@@ -0,0 +1,646 @@
+/*******************************************************************************************
+*
+* University Portal System - Per-Session Attendance Store
+*
+* Shared by the faculty (acadfac.c) and student (acadstu.c) Academics windows.
+*
+* - Every subject counts the sessions it has held. Each (subject, student) pair owns one
+*   set of the sessions that student attended.
+* - Sets are stored roaring-style: a sorted array of uint16 session numbers while that
+*   is smaller, otherwise a bitmap of uint64 words, one bit per session. 60 sessions
+*   take one word; a set with nothing in it takes none.
+* - The containers live in one word pool. A container that outgrows its room moves to
+*   the end of the pool; AttendanceCompact() drops the holes and re-picks the kinds.
+* - Each set caches its cardinality, so percentages and "below 75%" need no scan.
+*   "Missed last N" is a masked popcount, and the sessions everyone (or anyone)
+*   attended are a word-wise AND (OR) over the subject's sets.
+* - AttendancePack() flattens the store into one image for datacache.h snapshots, and
+*   AttendanceLoadImage() uses such an image in place (read-only) or copies it.
+*
+* attendance.txt lines:
+*   SUBJECT|name|sessions
+*   MARK|subject|student|hex      (bit k of the hex string is session k, low bit first)
+*   name|total|attended           (the old per-subject counters, see AttendanceParseLine)
+*
+********************************************************************************************/
+
+#ifndef ATTENDANCE_H
+#define ATTENDANCE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "records.h"
+
+#define ATTENDANCE_MAX_ID 32
+#define ATTENDANCE_MAX_SUBJECT 64
+#define ATTENDANCE_MAX_WORDS 255        // Per container, so at most 16320 sessions a subject
+#define ATTENDANCE_MAX_SESSIONS (ATTENDANCE_MAX_WORDS * 64)
+#define ATTENDANCE_THRESHOLD 75         // Percent below which a student is flagged
+#define ATTENDANCE_IMAGE_MAGIC 0x31545441u  // "ATT1"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum { ATT_ARRAY = 0, ATT_BITMAP = 1 } AttendanceContainer;
+
+typedef struct {
+    char name[ATTENDANCE_MAX_SUBJECT];
+    int32_t sessions;                   // Held so far
+    int32_t firstSet, setCount;         // Its sets in AttendanceStore.sets, sorted by student
+    int32_t reserved;
+    int64_t attended;                   // Sum of its sets' cardinalities
+} AttendanceSubject;
+
+typedef struct {
+    char id[ATTENDANCE_MAX_ID];
+} AttendanceStudent;
+
+typedef struct {
+    int32_t student;
+    uint32_t offset;                    // First word of the container in AttendanceStore.words
+    uint16_t cardinality;               // Sessions attended
+    uint8_t type;                       // AttendanceContainer
+    uint8_t capacity;                   // Words reserved at offset
+} AttendanceSet;
+
+typedef struct {
+    AttendanceSubject *subjects;
+    int subjectCount, subjectCapacity;
+    AttendanceStudent *students;
+    int studentCount, studentCapacity;
+    AttendanceSet *sets;                // Grouped by subject, see AttendanceSubject
+    int setCount, setCapacity;
+    uint64_t *words;                    // Container pool
+    long wordCount, wordCapacity;
+    long wastedWords;                   // Left behind by containers that moved
+    int *studentSlots;                  // ID hash, open addressing (-1 = empty); never saved
+    int studentSlotCapacity;
+    bool readOnly;                      // The arrays belong to a snapshot image
+    uint64_t *packed;                   // Last AttendancePack() image
+    int64_t attended, possible;         // Over all subjects, for summary lines
+} AttendanceStore;
+
+// Header of an AttendancePack() image; the four arrays follow it, each 8-byte aligned
+typedef struct {
+    uint32_t magic;
+    int32_t subjectCount, studentCount, setCount;
+    int64_t wordCount;
+} AttendanceImage;
+
+//----------------------------------------------------------------------------------
+// Helpers
+//----------------------------------------------------------------------------------
+static inline uint32_t AttendanceHash(const char *str) {
+    uint32_t hash = 2166136261u;        // FNV-1a
+    while (*str) hash = (hash ^ (unsigned char)*str++) * 16777619u;
+    return hash;
+}
+
+static inline int AttendanceBitmapWords(int sessions) { return (sessions + 63) / 64; }
+static inline int AttendanceArrayWords(int cardinality) { return (cardinality + 3) / 4; }     // Four uint16 per word
+
+// Bits of bitmap word w that are sessions actually held
+static inline uint64_t AttendanceWordMask(int sessions, int w) {
+    int valid = sessions - w*64;
+    return valid >= 64 ? ~0ull : valid <= 0 ? 0 : (1ull << valid) - 1;
+}
+
+static inline uint16_t *AttendanceArray(const AttendanceStore *store, const AttendanceSet *set) { return (uint16_t *)(store->words + set->offset); }
+static inline uint64_t *AttendanceBitmap(const AttendanceStore *store, const AttendanceSet *set) { return store->words + set->offset; }
+
+static inline long AttendanceBytes(const AttendanceStore *store) {
+    return (long)(sizeof(AttendanceSubject) * store->subjectCount + sizeof(AttendanceStudent) * store->studentCount +
+                  sizeof(AttendanceSet) * store->setCount) + (long)sizeof(uint64_t) * store->wordCount;
+}
+
+static inline void AttendanceFree(AttendanceStore *store) {
+    if (!store->readOnly) { free(store->subjects); free(store->students); free(store->sets); free(store->words); }
+    free(store->studentSlots); free(store->packed);
+    memset(store, 0, sizeof(*store));
+}
+
+// Reserves n zeroed words at the end of the pool; returns their offset
+static inline uint32_t AttendanceAlloc(AttendanceStore *store, int n) {
+    if (store->wordCount + n > store->wordCapacity) {
+        long capacity = store->wordCapacity ? store->wordCapacity * 2 : 4096;
+        while (capacity < store->wordCount + n) capacity *= 2;
+        store->words = (uint64_t *)realloc(store->words, sizeof(uint64_t) * capacity);
+        store->wordCapacity = capacity;
+    }
+    uint32_t offset = (uint32_t)store->wordCount;
+    memset(store->words + offset, 0, sizeof(uint64_t) * n);
+    store->wordCount += n;
+    return offset;
+}
+
+//----------------------------------------------------------------------------------
+// Students and Subjects
+//----------------------------------------------------------------------------------
+static inline void AttendanceIndexStudent(AttendanceStore *store, int student) {
+    uint32_t slot = AttendanceHash(store->students[student].id) & (store->studentSlotCapacity - 1);
+    while (store->studentSlots[slot] >= 0) slot = (slot + 1) & (store->studentSlotCapacity - 1);
+    store->studentSlots[slot] = student;
+}
+
+static inline void AttendanceRebuildStudentIndex(AttendanceStore *store) {
+    free(store->studentSlots);
+    store->studentSlotCapacity = 1024;
+    while (store->studentSlotCapacity < store->studentCount * 2 + 2) store->studentSlotCapacity *= 2;
+    store->studentSlots = (int *)malloc(sizeof(int) * store->studentSlotCapacity);
+    memset(store->studentSlots, 0xFF, sizeof(int) * store->studentSlotCapacity);
+    for (int i = 0; i < store->studentCount; i++) AttendanceIndexStudent(store, i);
+}
+
+static inline int AttendanceFindStudent(const AttendanceStore *store, const char *id) {
+    if (store->studentSlotCapacity == 0) return -1;
+    uint32_t slot = AttendanceHash(id) & (store->studentSlotCapacity - 1);
+    for (; store->studentSlots[slot] >= 0; slot = (slot + 1) & (store->studentSlotCapacity - 1)) {
+        if (strcmp(store->students[store->studentSlots[slot]].id, id) == 0) return store->studentSlots[slot];
+    }
+    return -1;
+}
+
+// Index of the student, added if new; -1 for a read-only store or an ID that is too long
+static inline int AttendanceAddStudent(AttendanceStore *store, const char *id) {
+    int found = AttendanceFindStudent(store, id);
+    if (found >= 0 || store->readOnly || strlen(id) >= ATTENDANCE_MAX_ID) return found;
+    if (store->studentCount == store->studentCapacity) {
+        store->studentCapacity = store->studentCapacity ? store->studentCapacity * 2 : 256;
+        store->students = (AttendanceStudent *)realloc(store->students, sizeof(AttendanceStudent) * store->studentCapacity);
+    }
+    int student = store->studentCount++;
+    memset(&store->students[student], 0, sizeof(AttendanceStudent));
+    strcpy(store->students[student].id, id);
+    if ((store->studentCount + 1) * 2 > store->studentSlotCapacity) AttendanceRebuildStudentIndex(store);
+    else AttendanceIndexStudent(store, student);
+    return student;
+}
+
+static inline int AttendanceFindSubject(const AttendanceStore *store, const char *name) {
+    for (int i = 0; i < store->subjectCount; i++) if (strcmp(store->subjects[i].name, name) == 0) return i;
+    return -1;
+}
+
+static inline int AttendanceAddSubject(AttendanceStore *store, const char *name) {
+    int found = AttendanceFindSubject(store, name);
+    if (found >= 0 || store->readOnly || name[0] == '\0') return found;
+    if (store->subjectCount == store->subjectCapacity) {
+        store->subjectCapacity = store->subjectCapacity ? store->subjectCapacity * 2 : 16;
+        store->subjects = (AttendanceSubject *)realloc(store->subjects, sizeof(AttendanceSubject) * store->subjectCapacity);
+    }
+    AttendanceSubject *s = &store->subjects[store->subjectCount];
+    memset(s, 0, sizeof(*s));
+    size_t length = strlen(name);
+    memcpy(s->name, name, length < ATTENDANCE_MAX_SUBJECT ? length : ATTENDANCE_MAX_SUBJECT - 1);   // Zeroed above, so still terminated
+    s->firstSet = store->setCount;
+    return store->subjectCount++;
+}
+
+static inline void AttendanceRemoveSubject(AttendanceStore *store, int subject) {
+    if (store->readOnly || subject < 0 || subject >= store->subjectCount) return;
+    AttendanceSubject *s = &store->subjects[subject];
+    for (int i = s->firstSet; i < s->firstSet + s->setCount; i++) store->wastedWords += store->sets[i].capacity;
+    memmove(&store->sets[s->firstSet], &store->sets[s->firstSet + s->setCount], sizeof(AttendanceSet) * (store->setCount - s->firstSet - s->setCount));
+    store->setCount -= s->setCount;
+    for (int i = subject + 1; i < store->subjectCount; i++) store->subjects[i].firstSet -= s->setCount;
+    store->attended -= s->attended;
+    store->possible -= (int64_t)s->sessions * s->setCount;
+    memmove(s, s + 1, sizeof(AttendanceSubject) * (store->subjectCount - subject - 1));
+    store->subjectCount--;
+}
+
+// The student's set in the subject, or -1 if the student is not enrolled
+static inline int AttendanceFindSet(const AttendanceStore *store, int subject, int student) {
+    const AttendanceSubject *s = &store->subjects[subject];
+    int lo = s->firstSet, hi = s->firstSet + s->setCount;
+    while (lo < hi) { int mid = (lo + hi) / 2; if (store->sets[mid].student < student) lo = mid + 1; else hi = mid; }
+    return (lo < s->firstSet + s->setCount && store->sets[lo].student == student) ? lo : -1;
+}
+
+// The student's set, created empty (absent from every earlier session) if needed
+static inline int AttendanceEnroll(AttendanceStore *store, int subject, int student) {
+    int found = AttendanceFindSet(store, subject, student);
+    if (found >= 0 || store->readOnly) return found;
+    AttendanceSubject *s = &store->subjects[subject];
+    int lo = s->firstSet, hi = s->firstSet + s->setCount;
+    while (lo < hi) { int mid = (lo + hi) / 2; if (store->sets[mid].student < student) lo = mid + 1; else hi = mid; }
+
+    if (store->setCount == store->setCapacity) {
+        store->setCapacity = store->setCapacity ? store->setCapacity * 2 : 1024;
+        store->sets = (AttendanceSet *)realloc(store->sets, sizeof(AttendanceSet) * store->setCapacity);
+    }
+    memmove(&store->sets[lo + 1], &store->sets[lo], sizeof(AttendanceSet) * (store->setCount - lo));
+    store->sets[lo] = (AttendanceSet){ student, 0, 0, ATT_ARRAY, 0 };
+    store->setCount++;
+    s->setCount++;
+    for (int i = subject + 1; i < store->subjectCount; i++) store->subjects[i].firstSet++;
+    store->possible += s->sessions;
+    return lo;
+}
+
+//----------------------------------------------------------------------------------
+// Containers
+//----------------------------------------------------------------------------------
+static inline bool AttendanceHas(const AttendanceStore *store, const AttendanceSet *set, int session) {
+    if (set->type == ATT_BITMAP) {
+        return session / 64 < set->capacity && ((AttendanceBitmap(store, set)[session / 64] >> (session % 64)) & 1);
+    }
+    const uint16_t *array = AttendanceArray(store, set);
+    int lo = 0, hi = set->cardinality;
+    while (lo < hi) { int mid = (lo + hi) / 2; if (array[mid] < session) lo = mid + 1; else hi = mid; }
+    return lo < set->cardinality && array[lo] == session;
+}
+
+// Moves the container to 'words' fresh words of the given kind, keeping its sessions
+static inline void AttendanceRehome(AttendanceStore *store, int index, AttendanceContainer type, int words) {
+    AttendanceSet *set = &store->sets[index];
+    uint32_t offset = AttendanceAlloc(store, words);            // May move store->words
+    set = &store->sets[index];
+    uint64_t *dest = store->words + offset;
+    if (set->type == ATT_ARRAY && type == ATT_BITMAP) {
+        const uint16_t *array = AttendanceArray(store, set);
+        for (int i = 0; i < set->cardinality; i++) dest[array[i] / 64] |= 1ull << (array[i] % 64);
+    } else if (set->type == ATT_BITMAP && type == ATT_ARRAY) {
+        uint16_t *array = (uint16_t *)dest;
+        int n = 0;
+        for (int w = 0; w < set->capacity; w++) {
+            for (uint64_t bits = AttendanceBitmap(store, set)[w]; bits; bits &= bits - 1) array[n++] = (uint16_t)(w*64 + __builtin_ctzll(bits));
+        }
+    } else {
+        memcpy(dest, store->words + set->offset, sizeof(uint64_t) * (set->capacity < words ? set->capacity : words));
+    }
+    store->wastedWords += set->capacity;
+    set->offset = offset;
+    set->capacity = (uint8_t)words;
+    set->type = (uint8_t)type;
+}
+
+// Marks one session present or absent. Arrays grow by doubling and turn into bitmaps
+// once a bitmap of the subject's sessions would be smaller.
+static inline bool AttendanceMark(AttendanceStore *store, int subject, int index, int session, bool present) {
+    AttendanceSubject *s = &store->subjects[subject];
+    if (store->readOnly || session < 0 || session >= s->sessions) return false;
+    if (AttendanceHas(store, &store->sets[index], session) == present) return true;
+    AttendanceSet *set = &store->sets[index];
+
+    if (set->type == ATT_ARRAY && present) {
+        int bitmapWords = AttendanceBitmapWords(s->sessions);
+        if (AttendanceArrayWords(set->cardinality + 1) > bitmapWords) AttendanceRehome(store, index, ATT_BITMAP, bitmapWords);
+        else if (AttendanceArrayWords(set->cardinality + 1) > set->capacity) {
+            int words = set->capacity ? set->capacity * 2 : 1;
+            AttendanceRehome(store, index, ATT_ARRAY, words < bitmapWords ? words : bitmapWords);
+        }
+        set = &store->sets[index];
+    }
+    if (set->type == ATT_BITMAP) {
+        if (session / 64 >= set->capacity) {
+            int words = set->capacity * 2;
+            if (words < session / 64 + 1) words = session / 64 + 1;
+            AttendanceRehome(store, index, ATT_BITMAP, words > ATTENDANCE_MAX_WORDS ? ATTENDANCE_MAX_WORDS : words);
+            set = &store->sets[index];
+        }
+        AttendanceBitmap(store, set)[session / 64] ^= 1ull << (session % 64);
+    } else {
+        uint16_t *array = AttendanceArray(store, set);
+        int lo = 0, hi = set->cardinality;
+        while (lo < hi) { int mid = (lo + hi) / 2; if (array[mid] < session) lo = mid + 1; else hi = mid; }
+        if (present) { memmove(&array[lo + 1], &array[lo], sizeof(uint16_t) * (set->cardinality - lo)); array[lo] = (uint16_t)session; }
+        else memmove(&array[lo], &array[lo + 1], sizeof(uint16_t) * (set->cardinality - lo - 1));
+    }
+    int delta = present ? 1 : -1;
+    set->cardinality += delta;
+    s->attended += delta;
+    store->attended += delta;
+    return true;
+}
+
+// Replaces a set's sessions with bits[words], in whichever container is smaller
+static inline void AttendanceSetBits(AttendanceStore *store, int subject, int index, const uint64_t *bits, int words) {
+    if (store->readOnly) return;
+    int sessions = store->subjects[subject].sessions;
+    if (words > AttendanceBitmapWords(sessions)) words = AttendanceBitmapWords(sessions);
+    int cardinality = 0;
+    for (int w = 0; w < words; w++) cardinality += __builtin_popcountll(bits[w] & AttendanceWordMask(sessions, w));
+    AttendanceSet *set = &store->sets[index];
+    AttendanceSubject *s = &store->subjects[subject];
+    s->attended += cardinality - set->cardinality;
+    store->attended += cardinality - set->cardinality;
+
+    bool array = AttendanceArrayWords(cardinality) < words;
+    int need = array ? AttendanceArrayWords(cardinality) : words;
+    if (need > set->capacity) {
+        store->wastedWords += set->capacity;
+        uint32_t offset = AttendanceAlloc(store, need);
+        set = &store->sets[index];
+        set->offset = offset; set->capacity = (uint8_t)need;
+    } else memset(store->words + set->offset, 0, sizeof(uint64_t) * set->capacity);
+    set->type = array ? ATT_ARRAY : ATT_BITMAP;
+    set->cardinality = (uint16_t)cardinality;
+    uint64_t *dest = store->words + set->offset;
+    if (!array) {
+        for (int w = 0; w < words; w++) dest[w] = bits[w] & AttendanceWordMask(sessions, w);
+    } else {
+        uint16_t *out = (uint16_t *)dest;
+        int n = 0;
+        for (int w = 0; w < words; w++) {
+            for (uint64_t word = bits[w] & AttendanceWordMask(sessions, w); word; word &= word - 1) out[n++] = (uint16_t)(w*64 + __builtin_ctzll(word));
+        }
+    }
+}
+
+// A set as bitmap words (out has AttendanceBitmapWords(sessions) words)
+static inline void AttendanceExpand(const AttendanceStore *store, const AttendanceSet *set, uint64_t *out, int words) {
+    memset(out, 0, sizeof(uint64_t) * words);
+    if (set->type == ATT_BITMAP) memcpy(out, AttendanceBitmap(store, set), sizeof(uint64_t) * (set->capacity < words ? set->capacity : words));
+    else {
+        const uint16_t *array = AttendanceArray(store, set);
+        for (int i = 0; i < set->cardinality; i++) if (array[i] / 64 < words) out[array[i] / 64] |= 1ull << (array[i] % 64);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Sessions and Queries
+//----------------------------------------------------------------------------------
+
+static inline int AttendanceCompareInts(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Appends a session in which every enrolled student is present except those in
+// absent[] (student indices, sorted here); returns the session number, or -1
+static inline int AttendanceRecordSession(AttendanceStore *store, int subject, int *absent, int absentCount) {
+    AttendanceSubject *s = &store->subjects[subject];
+    if (store->readOnly || s->sessions >= ATTENDANCE_MAX_SESSIONS) return -1;
+    int session = s->sessions++;
+    store->possible += s->setCount;
+    if (absentCount > 1) qsort(absent, absentCount, sizeof(int), AttendanceCompareInts);
+    for (int i = 0, a = 0; i < s->setCount; i++) {     // Sets are sorted by student too
+        int index = s->firstSet + i;
+        while (a < absentCount && absent[a] < store->sets[index].student) a++;
+        if (a < absentCount && absent[a] == store->sets[index].student) continue;
+        AttendanceMark(store, subject, index, session, true);
+    }
+    return session;
+}
+
+static inline float AttendancePercent(const AttendanceStore *store, int subject, const AttendanceSet *set) {
+    int sessions = store->subjects[subject].sessions;
+    return sessions ? 100.0f * set->cardinality / sessions : 0.0f;
+}
+
+static inline float AttendanceSubjectPercent(const AttendanceStore *store, int subject) {
+    const AttendanceSubject *s = &store->subjects[subject];
+    int64_t possible = (int64_t)s->sessions * s->setCount;
+    return possible ? (float)(100.0 * s->attended / possible) : 0.0f;
+}
+
+// Sessions missed among the subject's last n
+static inline int AttendanceMissedLast(const AttendanceStore *store, int subject, const AttendanceSet *set, int n) {
+    int sessions = store->subjects[subject].sessions;
+    if (n > sessions) n = sessions;
+    int from = sessions - n, attended = 0;
+    if (set->type == ATT_BITMAP) {
+        for (int w = from / 64; w <= (sessions - 1) / 64 && w < set->capacity && n > 0; w++) {
+            uint64_t word = AttendanceBitmap(store, set)[w];
+            if (w == from / 64) word &= ~0ull << (from % 64);
+            word &= AttendanceWordMask(sessions, w);
+            attended += __builtin_popcountll(word);
+        }
+    } else {
+        const uint16_t *array = AttendanceArray(store, set);
+        int lo = 0, hi = set->cardinality;
+        while (lo < hi) { int mid = (lo + hi) / 2; if (array[mid] < from) lo = mid + 1; else hi = mid; }
+        attended = set->cardinality - lo;
+    }
+    return n - attended;
+}
+
+// Sets of the subject below 'percent'; all are counted, the first 'max' go to out[]
+static inline int AttendanceBelow(const AttendanceStore *store, int subject, int percent, int *out, int max) {
+    const AttendanceSubject *s = &store->subjects[subject];
+    int found = 0;
+    for (int i = s->firstSet; i < s->firstSet + s->setCount; i++) {
+        if ((int64_t)store->sets[i].cardinality * 100 < (int64_t)percent * s->sessions) {
+            if (found < max) out[found] = i;
+            found++;
+        }
+    }
+    return found;
+}
+
+// Sessions every enrolled student attended (everyone = true, AND) or at least one did
+// (OR), as bitmap words in out[AttendanceBitmapWords(sessions)]; returns their count
+static inline int AttendanceCombine(const AttendanceStore *store, int subject, bool everyone, uint64_t *out) {
+    const AttendanceSubject *s = &store->subjects[subject];
+    int words = AttendanceBitmapWords(s->sessions);
+    if (words == 0) return 0;
+    for (int w = 0; w < words; w++) out[w] = (everyone && s->setCount > 0) ? ~0ull : 0;
+    uint64_t scratch[ATTENDANCE_MAX_WORDS];
+    for (int i = s->firstSet; i < s->firstSet + s->setCount; i++) {
+        const AttendanceSet *set = &store->sets[i];
+        const uint64_t *bits = scratch;
+        if (set->type == ATT_BITMAP && set->capacity >= words) bits = AttendanceBitmap(store, set);
+        else AttendanceExpand(store, set, scratch, words);
+        if (everyone) for (int w = 0; w < words; w++) out[w] &= bits[w];
+        else for (int w = 0; w < words; w++) out[w] |= bits[w];
+    }
+    out[words - 1] &= AttendanceWordMask(s->sessions, words - 1);
+    int count = 0;
+    for (int w = 0; w < words; w++) count += __builtin_popcountll(out[w]);
+    return count;
+}
+
+// Rewrites the pool in set order without holes, each set in its smaller container
+static inline void AttendanceCompact(AttendanceStore *store) {
+    if (store->readOnly) return;
+    uint64_t *old = store->words;
+    AttendanceSet *oldSets = (AttendanceSet *)malloc(sizeof(AttendanceSet) * (store->setCount + 1));
+    memcpy(oldSets, store->sets, sizeof(AttendanceSet) * store->setCount);
+    store->words = NULL; store->wordCount = store->wordCapacity = 0; store->wastedWords = 0;
+    AttendanceStore source = *store;
+    source.words = old; source.sets = oldSets;
+
+    uint64_t bits[ATTENDANCE_MAX_WORDS];
+    for (int subject = 0; subject < store->subjectCount; subject++) {
+        const AttendanceSubject *s = &store->subjects[subject];
+        int words = AttendanceBitmapWords(s->sessions);
+        for (int i = s->firstSet; i < s->firstSet + s->setCount; i++) {
+            AttendanceExpand(&source, &oldSets[i], bits, words);
+            store->sets[i].capacity = 0; store->sets[i].cardinality = 0;
+            store->subjects[subject].attended -= oldSets[i].cardinality;
+            store->attended -= oldSets[i].cardinality;
+            AttendanceSetBits(store, subject, i, bits, words);
+        }
+    }
+    store->wastedWords = 0;
+    free(old); free(oldSets);
+}
+
+//----------------------------------------------------------------------------------
+// Snapshot Images
+//----------------------------------------------------------------------------------
+static inline long AttendanceAlign(long bytes) { return (bytes + 7) & ~7L; }
+
+// Flattens the store (compacted first) into an image of uint64 words, owned by the store
+static inline const uint64_t *AttendancePack(AttendanceStore *store, int *wordCount) {
+    AttendanceCompact(store);
+    long subjectBytes = AttendanceAlign(sizeof(AttendanceSubject) * store->subjectCount);
+    long studentBytes = AttendanceAlign(sizeof(AttendanceStudent) * store->studentCount);
+    long setBytes = AttendanceAlign(sizeof(AttendanceSet) * store->setCount);
+    long total = AttendanceAlign(sizeof(AttendanceImage)) + subjectBytes + studentBytes + setBytes + sizeof(uint64_t) * store->wordCount;
+    free(store->packed);
+    uint64_t *image = store->packed = (uint64_t *)calloc(total / 8, sizeof(uint64_t));
+    AttendanceImage *header = (AttendanceImage *)image;
+    *header = (AttendanceImage){ ATTENDANCE_IMAGE_MAGIC, store->subjectCount, store->studentCount, store->setCount, store->wordCount };
+    char *p = (char *)image + AttendanceAlign(sizeof(AttendanceImage));
+    if (store->subjectCount) memcpy(p, store->subjects, sizeof(AttendanceSubject) * store->subjectCount);
+    p += subjectBytes;
+    if (store->studentCount) memcpy(p, store->students, sizeof(AttendanceStudent) * store->studentCount);
+    p += studentBytes;
+    if (store->setCount) memcpy(p, store->sets, sizeof(AttendanceSet) * store->setCount);
+    p += setBytes;
+    if (store->wordCount) memcpy(p, store->words, sizeof(uint64_t) * store->wordCount);
+    *wordCount = (int)(total / 8);
+    return image;
+}
+
+// Reads a packed image back. With inPlace the arrays are used where they are (read-only,
+// the image must outlive the store); otherwise they are copied. False if it is malformed.
+static inline bool AttendanceLoadImage(AttendanceStore *store, const uint64_t *image, int wordCount, bool inPlace) {
+    AttendanceFree(store);
+    const AttendanceImage *header = (const AttendanceImage *)image;
+    long bytes = (long)wordCount * 8;
+    if (bytes < (long)sizeof(AttendanceImage) || header->magic != ATTENDANCE_IMAGE_MAGIC) return false;
+    long subjectBytes = AttendanceAlign(sizeof(AttendanceSubject) * header->subjectCount);
+    long studentBytes = AttendanceAlign(sizeof(AttendanceStudent) * header->studentCount);
+    long setBytes = AttendanceAlign(sizeof(AttendanceSet) * header->setCount);
+    long total = AttendanceAlign(sizeof(AttendanceImage)) + subjectBytes + studentBytes + setBytes + (long)sizeof(uint64_t) * header->wordCount;
+    if (header->subjectCount < 0 || header->studentCount < 0 || header->setCount < 0 || header->wordCount < 0 || total != bytes) return false;
+
+    const char *p = (const char *)image + AttendanceAlign(sizeof(AttendanceImage));
+    const AttendanceSubject *subjects = (const AttendanceSubject *)p; p += subjectBytes;
+    const AttendanceStudent *students = (const AttendanceStudent *)p; p += studentBytes;
+    const AttendanceSet *sets = (const AttendanceSet *)p; p += setBytes;
+    const uint64_t *words = (const uint64_t *)p;
+    for (int i = 0, next = 0; i < header->subjectCount; i++) {     // Sets must tile the subjects in order
+        if (subjects[i].firstSet != next || subjects[i].setCount < 0) return false;
+        next += subjects[i].setCount;
+        if (next > header->setCount) return false;
+    }
+    for (int i = 0; i < header->setCount; i++) {
+        if (sets[i].student < 0 || sets[i].student >= header->studentCount || sets[i].offset + (int64_t)sets[i].capacity > header->wordCount) return false;
+    }
+
+    store->subjectCount = header->subjectCount; store->studentCount = header->studentCount;
+    store->setCount = header->setCount; store->wordCount = header->wordCount;
+    if (inPlace) {
+        store->subjects = (AttendanceSubject *)subjects; store->students = (AttendanceStudent *)students;
+        store->sets = (AttendanceSet *)sets; store->words = (uint64_t *)words;
+        store->readOnly = true;
+    } else {
+        store->subjectCapacity = store->subjectCount; store->studentCapacity = store->studentCount;
+        store->setCapacity = store->setCount; store->wordCapacity = store->wordCount;
+        store->subjects = (AttendanceSubject *)malloc(sizeof(AttendanceSubject) * (store->subjectCount + 1));
+        store->students = (AttendanceStudent *)malloc(sizeof(AttendanceStudent) * (store->studentCount + 1));
+        store->sets = (AttendanceSet *)malloc(sizeof(AttendanceSet) * (store->setCount + 1));
+        store->words = (uint64_t *)malloc(sizeof(uint64_t) * (store->wordCount + 1));
+        memcpy(store->subjects, subjects, sizeof(AttendanceSubject) * store->subjectCount);
+        memcpy(store->students, students, sizeof(AttendanceStudent) * store->studentCount);
+        memcpy(store->sets, sets, sizeof(AttendanceSet) * store->setCount);
+        memcpy(store->words, words, sizeof(uint64_t) * store->wordCount);
+    }
+    for (int i = 0; i < store->subjectCount; i++) {
+        store->attended += store->subjects[i].attended;
+        store->possible += (int64_t)store->subjects[i].sessions * store->subjects[i].setCount;
+    }
+    AttendanceRebuildStudentIndex(store);
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// attendance.txt Lines
+//----------------------------------------------------------------------------------
+static inline bool AttendanceFieldIs(const RecordLine *line, int index, const char *text) {
+    int length = (int)strlen(text);
+    return index < line->count && line->fields[index].length == length && memcmp(line->fields[index].text, text, length) == 0;
+}
+
+// Student a line belongs to, for recordindex.h: the ID of a MARK line. SUBJECT and old
+// per-subject lines get the empty key, since every student's slice needs them.
+static inline bool AttendanceLineStudent(const RecordLine *line, RecordField *key) {
+    bool mark = AttendanceFieldIs(line, 0, "MARK") && line->count >= 4;
+    *key = mark ? line->fields[2] : (RecordField){ "", 0 };
+    return true;
+}
+
+// One line of attendance.txt. An old "subject|total|attended" line becomes a subject with
+// that many sessions and one unnamed student who attended the first 'attended' of them,
+// so its numbers survive until per-student marks replace them.
+static inline bool AttendanceParseLine(AttendanceStore *store, const RecordLine *line) {
+    char name[ATTENDANCE_MAX_SUBJECT], id[ATTENDANCE_MAX_ID];
+    uint64_t bits[ATTENDANCE_MAX_WORDS];
+    if (AttendanceFieldIs(line, 0, "SUBJECT")) {
+        RecordCopy(line, 1, name, sizeof(name));
+        int subject = AttendanceAddSubject(store, name);
+        if (subject < 0) return false;
+        int sessions = RecordInt(line, 2);
+        if (sessions > store->subjects[subject].sessions && sessions <= ATTENDANCE_MAX_SESSIONS) {
+            store->possible += (int64_t)(sessions - store->subjects[subject].sessions) * store->subjects[subject].setCount;
+            store->subjects[subject].sessions = sessions;
+        }
+        return true;
+    }
+    if (AttendanceFieldIs(line, 0, "MARK")) {
+        if (line->count < 4) return false;
+        RecordCopy(line, 1, name, sizeof(name));
+        RecordCopy(line, 2, id, sizeof(id));
+        int subject = AttendanceAddSubject(store, name), student = AttendanceAddStudent(store, id);
+        if (subject < 0 || student < 0) return false;
+        const RecordField *hex = &line->fields[3];
+        int digits = hex->length < ATTENDANCE_MAX_SESSIONS / 4 ? hex->length : ATTENDANCE_MAX_SESSIONS / 4;
+        memset(bits, 0, sizeof(uint64_t) * AttendanceBitmapWords(digits * 4));
+        for (int d = 0; d < digits; d++) {
+            char c = hex->text[d];
+            uint64_t v = (c >= '0' && c <= '9') ? (uint64_t)(c - '0') : (c >= 'a' && c <= 'f') ? (uint64_t)(c - 'a' + 10) : (c >= 'A' && c <= 'F') ? (uint64_t)(c - 'A' + 10) : 0;
+            bits[d / 16] |= v << ((d % 16) * 4);
+        }
+        int index = AttendanceEnroll(store, subject, student);
+        AttendanceSetBits(store, subject, index, bits, AttendanceBitmapWords(digits * 4));
+        return true;
+    }
+    if (line->count >= 3) {                 // Old counters
+        RecordCopy(line, 0, name, sizeof(name));
+        int total = RecordInt(line, 1), attended = RecordInt(line, 2);
+        if (total < 0 || total > ATTENDANCE_MAX_SESSIONS) return false;
+        if (attended > total) attended = total;
+        int subject = AttendanceAddSubject(store, name), student = AttendanceAddStudent(store, "");
+        if (subject < 0 || student < 0) return false;
+        if (total > store->subjects[subject].sessions) {
+            store->possible += (int64_t)(total - store->subjects[subject].sessions) * store->subjects[subject].setCount;
+            store->subjects[subject].sessions = total;
+        }
+        memset(bits, 0, sizeof(uint64_t) * AttendanceBitmapWords(total));
+        for (int k = 0; k < attended; k++) bits[k / 64] |= 1ull << (k % 64);
+        int index = AttendanceEnroll(store, subject, student);
+        AttendanceSetBits(store, subject, index, bits, AttendanceBitmapWords(total));
+        return true;
+    }
+    return false;
+}
+
+// The hex field of a MARK line: one digit per four sessions, low bits first
+static inline const char *AttendanceFormatBits(const AttendanceStore *store, int subject, const AttendanceSet *set, char *buffer, int size) {
+    int sessions = store->subjects[subject].sessions, digits = (sessions + 3) / 4;
+    uint64_t bits[ATTENDANCE_MAX_WORDS];
+    AttendanceExpand(store, set, bits, AttendanceBitmapWords(sessions));
+    if (digits > size - 1) digits = size - 1;
+    for (int d = 0; d < digits; d++) buffer[d] = "0123456789abcdef"[(bits[d / 16] >> ((d % 16) * 4)) & 15];
+    buffer[digits] = '\0';
+    return buffer;
+}
+
+#endif // ATTENDANCE_H
@@ -0,0 +1,196 @@
+/*******************************************************************************************
+*
+* University Portal System - Semester Calendar Store
+*
+* Shared by the faculty (acadfac.c) and student (acadstu.c) Academics windows.
+*
+* - Holidays, exams, tests, orientations and deadlines are typed CalendarEvents in
+*   one growable array, kept sorted by start date.
+* - maxEnd[i] is the latest end date among events 0..i. It never decreases, so the
+*   events overlapping a date range are found with two binary searches.
+* - Dates are YYYYMMDD integers, which compare in calendar order.
+* - semester.txt keeps the semester line first; every following line is an event,
+*   TYPE|YYYY-MM-DD|YYYY-MM-DD|Title.
+*
+********************************************************************************************/
+
+#ifndef CALENDAR_H
+#define CALENDAR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CALENDAR_MAX_TITLE 96
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum { CAL_HOLIDAY = 0, CAL_EXAM, CAL_TEST, CAL_ORIENTATION, CAL_DEADLINE, CAL_TYPE_COUNT } CalendarType;
+
+typedef struct {
+    int32_t start, end;                 // YYYYMMDD, both inclusive
+    int32_t id;
+    int32_t type;                       // CalendarType
+    char title[CALENDAR_MAX_TITLE];
+} CalendarEvent;
+
+typedef struct {
+    CalendarEvent *events;              // Sorted by start, then insertion order
+    int32_t *maxEnd;                    // Range index, see above
+    int count, capacity;                // capacity 0: events belong to a snapshot
+    int nextId;
+} CalendarStore;
+
+static const char *const CALENDAR_TYPE_NAMES[CAL_TYPE_COUNT] = { "HOLIDAY", "EXAM", "TEST", "ORIENTATION", "DEADLINE" };
+
+//----------------------------------------------------------------------------------
+// Dates
+//----------------------------------------------------------------------------------
+
+// "YYYY-MM-DD" or "DD/MM/YYYY" to YYYYMMDD; 0 if it is not a date
+static inline int32_t CalendarParseDate(const char *text) {
+    int y = 0, m = 0, d = 0;
+    if (sscanf(text, "%d-%d-%d", &y, &m, &d) != 3 && sscanf(text, "%d/%d/%d", &d, &m, &y) != 3) return 0;
+    if (y < 1900 || y > 9999 || m < 1 || m > 12 || d < 1 || d > 31) return 0;
+    return y*10000 + m*100 + d;
+}
+
+static inline int CalendarWeekday(int32_t date) {    // 0 = Sunday
+    static const int offsets[12] = { 0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4 };
+    int y = date/10000, m = (date/100)%100, d = date%100;
+    if (m < 3) y--;
+    return (y + y/4 - y/100 + y/400 + offsets[m - 1] + d) % 7;
+}
+
+static inline const char *CalendarWeekdayName(int32_t date) {
+    static const char *names[7] = { "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday" };
+    return names[CalendarWeekday(date)];
+}
+
+// DD/MM/YYYY, the way the Semester tabs show dates
+static inline const char *CalendarFormatDate(int32_t date, char *buffer, int size) {
+    snprintf(buffer, size, "%02d/%02d/%04d", date%100, (date/100)%100, date/10000);
+    return buffer;
+}
+
+//----------------------------------------------------------------------------------
+// Store
+//----------------------------------------------------------------------------------
+static inline void CalendarFree(CalendarStore *store) {
+    if (store->capacity > 0) free(store->events);
+    free(store->maxEnd);
+    memset(store, 0, sizeof(*store));
+}
+
+static inline void CalendarReindex(CalendarStore *store, int from) {
+    for (int i = from; i < store->count; i++) {
+        int32_t previous = (i > 0) ? store->maxEnd[i - 1] : 0;
+        store->maxEnd[i] = (store->events[i].end > previous) ? store->events[i].end : previous;
+    }
+}
+
+// Keeps the events sorted by start; returns the new event's index, or -1 for bad dates
+static inline int CalendarAdd(CalendarStore *store, CalendarType type, int32_t start, int32_t end, const char *title) {
+    if (start == 0 || type < 0 || type >= CAL_TYPE_COUNT) return -1;
+    if (store->capacity == 0 && store->count > 0) return -1;   // Read-only snapshot
+    if (end < start) end = start;
+    if (store->count == store->capacity) {
+        int capacity = store->capacity ? store->capacity * 2 : 32;
+        CalendarEvent *events = (CalendarEvent *)malloc(sizeof(CalendarEvent) * capacity);
+        if (store->count > 0) memcpy(events, store->events, sizeof(CalendarEvent) * store->count);
+        if (store->capacity > 0) free(store->events);
+        store->events = events;
+        store->maxEnd = (int32_t *)realloc(store->maxEnd, sizeof(int32_t) * capacity);
+        store->capacity = capacity;
+    }
+
+    int lo = 0, hi = store->count;      // First event starting after 'start'
+    while (lo < hi) { int mid = (lo + hi) / 2; if (store->events[mid].start <= start) lo = mid + 1; else hi = mid; }
+    memmove(&store->events[lo + 1], &store->events[lo], sizeof(CalendarEvent) * (store->count - lo));
+    store->count++;
+
+    CalendarEvent *event = &store->events[lo];
+    memset(event, 0, sizeof(*event));
+    event->start = start; event->end = end; event->type = type;
+    event->id = ++store->nextId;
+    strncpy(event->title, title ? title : "", CALENDAR_MAX_TITLE - 1);
+    CalendarReindex(store, lo);
+    return lo;
+}
+
+static inline void CalendarRemove(CalendarStore *store, int index) {
+    if (index < 0 || index >= store->count || store->capacity == 0) return;
+    memmove(&store->events[index], &store->events[index + 1], sizeof(CalendarEvent) * (store->count - index - 1));
+    store->count--;
+    CalendarReindex(store, index);
+}
+
+// Takes the events of a snapshot section, already sorted. With inPlace they are used where
+// they are (read-only, the image must outlive the store); otherwise they are copied.
+static inline bool CalendarLoad(CalendarStore *store, const CalendarEvent *events, int count, bool inPlace) {
+    CalendarFree(store);
+    for (int i = 1; i < count; i++) if (events[i].start < events[i - 1].start) return false;
+    if (inPlace) store->events = (CalendarEvent *)events;
+    else {
+        store->capacity = (count > 32) ? count : 32;
+        store->events = (CalendarEvent *)malloc(sizeof(CalendarEvent) * store->capacity);
+        if (count > 0) memcpy(store->events, events, sizeof(CalendarEvent) * count);
+    }
+    store->count = count;
+    store->maxEnd = (int32_t *)malloc(sizeof(int32_t) * (inPlace ? (count > 0 ? count : 1) : store->capacity));
+    for (int i = 0; i < count; i++) if (events[i].id > store->nextId) store->nextId = events[i].id;
+    CalendarReindex(store, 0);
+    return true;
+}
+
+// Events in [*begin, *end) are the only ones that can overlap [from, to]; callers still
+// skip the few that ended before 'from'
+static inline void CalendarRange(const CalendarStore *store, int32_t from, int32_t to, int *begin, int *end) {
+    int lo = 0, hi = store->count;      // First event whose maxEnd reaches 'from'
+    while (lo < hi) { int mid = (lo + hi) / 2; if (store->maxEnd[mid] < from) lo = mid + 1; else hi = mid; }
+    *begin = lo;
+    hi = store->count;                  // First event starting after 'to'
+    while (lo < hi) { int mid = (lo + hi) / 2; if (store->events[mid].start <= to) lo = mid + 1; else hi = mid; }
+    *end = lo;
+}
+
+//----------------------------------------------------------------------------------
+// semester.txt Event Lines
+//----------------------------------------------------------------------------------
+
+// One TYPE|start|end|title line; false if it is not an event line
+static inline bool CalendarParseLine(CalendarStore *store, char *line) {
+    char *type = strtok(line, "|"), *start = strtok(NULL, "|"), *end = strtok(NULL, "|"), *title = strtok(NULL, "|");
+    if (!type || !start) return false;
+    for (int t = 0; t < CAL_TYPE_COUNT; t++) {
+        if (strcmp(type, CALENDAR_TYPE_NAMES[t]) != 0) continue;
+        int32_t first = CalendarParseDate(start);
+        return CalendarAdd(store, (CalendarType)t, first, end ? CalendarParseDate(end) : first, title) >= 0;
+    }
+    return false;
+}
+
+// The semester.txt line for one event, without the newline
+static inline const char *CalendarFormatLine(const CalendarEvent *e, char *buffer, int size) {
+    snprintf(buffer, size, "%s|%04d-%02d-%02d|%04d-%02d-%02d|%s", CALENDAR_TYPE_NAMES[e->type],
+             e->start/10000, (e->start/100)%100, e->start%100, e->end/10000, (e->end/100)%100, e->end%100, e->title);
+    return buffer;
+}
+
+// The official list the Semester tabs used to hardcode; used when semester.txt has no events
+static inline void CalendarAddDefaults(CalendarStore *store) {
+    CalendarAdd(store, CAL_HOLIDAY, 20250126, 20250126, "Republic Day");
+    CalendarAdd(store, CAL_HOLIDAY, 20250226, 20250226, "Maha Shivaratri");
+    CalendarAdd(store, CAL_HOLIDAY, 20250314, 20250314, "Holi / Dhulivandan");
+    CalendarAdd(store, CAL_HOLIDAY, 20250815, 20250815, "Independence Day");
+    CalendarAdd(store, CAL_HOLIDAY, 20251002, 20251002, "Mahatma Gandhi's Birthday");
+    CalendarAdd(store, CAL_HOLIDAY, 20251020, 20251020, "Diwali (Deepavali)");
+    CalendarAdd(store, CAL_HOLIDAY, 20251225, 20251225, "Christmas Day");
+    CalendarAdd(store, CAL_EXAM, 20251003, 20251008, "MIDSEM");
+    CalendarAdd(store, CAL_EXAM, 20251203, 20251208, "ENDSEM");
+}
+
+#endif // CALENDAR_H
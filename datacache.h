@@ -0,0 +1,335 @@
+/*******************************************************************************************
+*
+* University Portal System - Shared Data Cache
+*
+* Lets a module publish the tables it parsed from its data files into shared memory,
+* so the next process that opens the same module maps them read-only instead of
+* parsing the files again.
+*
+* - One immutable segment per module and generation ("/portal_acadstu_3"), laid out
+*   as a header plus sections of fixed-size records. Sections are addressed by offset,
+*   so the snapshot works at whatever address it gets mapped.
+* - A tiny control segment ("/portal_acadstu") holds the current generation. Writers
+*   fill a new segment and then bump the generation; readers never see a half-written
+*   snapshot, and mappings of older generations stay valid.
+* - Every section remembers the size and mtime of its source file. A snapshot whose
+*   sources changed on disk is stale and gets reparsed and republished.
+*
+* POSIX shared memory (shm_open/mmap) on Linux/macOS, named file mappings on Windows.
+* Windows drops a mapping once no process has it open, so there the cache lives as
+* long as some portal window does.
+*
+* The same image can also be written to disk (DataCacheWriteFile) as a warm-start
+* snapshot that survives reboots; DataCacheMapFile maps it back read-only.
+*
+********************************************************************************************/
+
+#ifndef DATACACHE_H
+#define DATACACHE_H
+
+#include "raylib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+    // <windows.h> clashes with raylib (CloseWindow, DrawText, Rectangle...), so only
+    // the few kernel32 calls used here are declared
+    typedef void *DataCacheHandle;
+    __declspec(dllimport) DataCacheHandle __stdcall CreateFileMappingA(DataCacheHandle file, void *security, unsigned long protect, unsigned long sizeHigh, unsigned long sizeLow, const char *name);
+    __declspec(dllimport) DataCacheHandle __stdcall OpenFileMappingA(unsigned long access, int inherit, const char *name);
+    __declspec(dllimport) void *__stdcall MapViewOfFile(DataCacheHandle mapping, unsigned long access, unsigned long offsetHigh, unsigned long offsetLow, size_t bytes);
+    __declspec(dllimport) unsigned long __stdcall GetLastError(void);
+    #define DATACACHE_INVALID_HANDLE ((DataCacheHandle)(long long)-1)
+    #define DATACACHE_PAGE_READWRITE 0x04
+    #define DATACACHE_MAP_WRITE 0x0002
+    #define DATACACHE_MAP_READ 0x0004
+    #define DATACACHE_ALREADY_EXISTS 183
+#else
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#define DATACACHE_MAGIC 0x32434450      // "PDC2"
+#define DATACACHE_MAX_SECTIONS 12
+#define DATACACHE_NAME_LENGTH 64
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct {
+    unsigned int magic;
+    long generation;            // 0 until the first snapshot is published
+} DataCacheControl;
+
+typedef struct {
+    char source[DATACACHE_NAME_LENGTH];   // File the records were parsed from
+    long sourceSize;            // -1 if the file did not exist
+    long sourceMtime;
+    long offset;                // From the start of the segment
+    long elementSize;
+    int count;
+} DataCacheSection;
+
+typedef struct {
+    unsigned int magic;
+    long generation;
+    long totalBytes;
+    int sectionCount;
+    DataCacheSection sections[DATACACHE_MAX_SECTIONS];
+} DataCacheHeader;
+
+// One table handed to DataCachePublish()
+typedef struct {
+    const char *source;
+    const void *data;
+    long elementSize;
+    int count;
+} DataCacheSource;
+
+//----------------------------------------------------------------------------------
+// Segment Helpers
+//----------------------------------------------------------------------------------
+static inline void DataCacheSegmentName(char *dest, const char *module, long generation) {
+#if defined(_WIN32)
+    if (generation > 0) sprintf(dest, "Local\\portal_%s_%ld", module, generation);
+    else sprintf(dest, "Local\\portal_%s", module);
+#else
+    if (generation > 0) sprintf(dest, "/portal_%s_%ld", module, generation);
+    else sprintf(dest, "/portal_%s", module);
+#endif
+}
+
+// Maps a segment. create: make a new one of `bytes` (failing if it exists) unless
+// shared is set, in which case an existing one is reused. Otherwise opens read-only.
+static inline void *DataCacheMap(const char *name, long bytes, bool create, bool shared, long *mappedBytes) {
+#if defined(_WIN32)
+    DataCacheHandle mapping;
+    if (create) {
+        mapping = CreateFileMappingA(DATACACHE_INVALID_HANDLE, NULL, DATACACHE_PAGE_READWRITE, 0, (unsigned long)bytes, name);
+        if (mapping == NULL || (!shared && GetLastError() == DATACACHE_ALREADY_EXISTS)) return NULL;
+    } else {
+        mapping = OpenFileMappingA(DATACACHE_MAP_READ, 0, name);
+        if (mapping == NULL) return NULL;
+    }
+    // The handle is kept open on purpose: it is what keeps the snapshot alive
+    void *view = MapViewOfFile(mapping, create ? DATACACHE_MAP_WRITE : DATACACHE_MAP_READ, 0, 0, 0);
+    if (mappedBytes) *mappedBytes = bytes;
+    return view;
+#else
+    int flags = create ? (O_RDWR | O_CREAT | (shared ? 0 : O_EXCL)) : O_RDONLY;
+    int fd = shm_open(name, flags, 0644);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (create && ftruncate(fd, bytes) != 0) { close(fd); return NULL; }
+    if (!create) {
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) { close(fd); return NULL; }
+        bytes = (long)st.st_size;
+    }
+    void *view = mmap(NULL, bytes, create ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return NULL;
+    if (mappedBytes) *mappedBytes = bytes;
+    return view;
+#endif
+}
+
+static inline void DataCacheUnlink(const char *name) {
+#if !defined(_WIN32)
+    shm_unlink(name);
+#else
+    (void)name; // Released when its last handle closes
+#endif
+}
+
+static inline void DataCacheStatSource(const char *source, long *size, long *mtime) {
+    struct stat st;
+    if (stat(source, &st) == 0) { *size = (long)st.st_size; *mtime = (long)st.st_mtime; }
+    else { *size = -1; *mtime = 0; }
+}
+
+//----------------------------------------------------------------------------------
+// Reader API
+//----------------------------------------------------------------------------------
+
+// Maps the current snapshot of a module read-only, or returns NULL if there is none
+static inline const DataCacheHeader *DataCacheAttach(const char *module) {
+    char name[DATACACHE_NAME_LENGTH];
+    DataCacheSegmentName(name, module, 0);
+    const DataCacheControl *control = (const DataCacheControl *)DataCacheMap(name, sizeof(DataCacheControl), false, false, NULL);
+    if (control == NULL || control->magic != DATACACHE_MAGIC) return NULL;
+
+    // A writer may retire the generation we read in between, so look twice
+    for (int attempt = 0; attempt < 2; attempt++) {
+        long generation = __atomic_load_n(&control->generation, __ATOMIC_ACQUIRE);
+        if (generation <= 0) return NULL;
+        DataCacheSegmentName(name, module, generation);
+        long bytes = 0;
+        const DataCacheHeader *cache = (const DataCacheHeader *)DataCacheMap(name, 0, false, false, &bytes);
+        if (cache != NULL && cache->magic == DATACACHE_MAGIC && cache->generation == generation) return cache;
+    }
+    return NULL;
+}
+
+// True while every source file still has the size and mtime it was parsed at
+static inline bool DataCacheIsFresh(const DataCacheHeader *cache) {
+    for (int i = 0; i < cache->sectionCount; i++) {
+        long size, mtime;
+        DataCacheStatSource(cache->sections[i].source, &size, &mtime);
+        if (size != cache->sections[i].sourceSize || mtime != cache->sections[i].sourceMtime) return false;
+    }
+    return true;
+}
+
+// Records of one section, or NULL if the section is missing or its record layout changed
+static inline const void *DataCacheSectionData(const DataCacheHeader *cache, int index, long elementSize, int *count) {
+    if (index >= cache->sectionCount || cache->sections[index].elementSize != elementSize) return NULL;
+    *count = cache->sections[index].count;
+    return (const char *)cache + cache->sections[index].offset;
+}
+
+//----------------------------------------------------------------------------------
+// Writer API
+//----------------------------------------------------------------------------------
+
+// Bytes an image of these tables takes; sections are 16-byte aligned
+static inline long DataCacheImageSize(const DataCacheSource *sources, int sourceCount) {
+    long totalBytes = sizeof(DataCacheHeader);
+    for (int i = 0; i < sourceCount; i++) totalBytes += (sources[i].elementSize * sources[i].count + 15) & ~15L;
+    return totalBytes;
+}
+
+// Lays the header, source signatures and records out in `image`
+static inline void DataCacheFillImage(DataCacheHeader *image, long totalBytes, long generation, const DataCacheSource *sources, int sourceCount) {
+    memset(image, 0, sizeof(DataCacheHeader));
+    image->magic = DATACACHE_MAGIC;
+    image->generation = generation;
+    image->totalBytes = totalBytes;
+    image->sectionCount = sourceCount;
+    long offset = sizeof(DataCacheHeader);
+    for (int i = 0; i < sourceCount; i++) {
+        DataCacheSection *section = &image->sections[i];
+        strncpy(section->source, sources[i].source, DATACACHE_NAME_LENGTH - 1);
+        DataCacheStatSource(sources[i].source, &section->sourceSize, &section->sourceMtime);
+        section->offset = offset;
+        section->elementSize = sources[i].elementSize;
+        section->count = sources[i].count;
+        if (sources[i].count > 0) memcpy((char *)image + offset, sources[i].data, sources[i].elementSize * sources[i].count);
+        offset += (sources[i].elementSize * sources[i].count + 15) & ~15L;
+    }
+}
+
+// Copies the tables into a new generation and makes it current. Returns the new
+// snapshot, or NULL if shared memory is unavailable.
+static inline const DataCacheHeader *DataCachePublish(const char *module, const DataCacheSource *sources, int sourceCount) {
+    if (sourceCount > DATACACHE_MAX_SECTIONS) return NULL;
+
+    char name[DATACACHE_NAME_LENGTH];
+    DataCacheSegmentName(name, module, 0);
+    DataCacheControl *control = (DataCacheControl *)DataCacheMap(name, sizeof(DataCacheControl), true, true, NULL);
+    if (control == NULL) return NULL;
+    if (control->magic != DATACACHE_MAGIC) {
+        control->generation = 0;
+        control->magic = DATACACHE_MAGIC;
+    }
+
+    long totalBytes = DataCacheImageSize(sources, sourceCount);
+
+    // Another process publishing at the same moment takes the next number first
+    long previous = __atomic_load_n(&control->generation, __ATOMIC_ACQUIRE);
+    long generation = previous;
+    DataCacheHeader *cache = NULL;
+    for (int attempt = 0; attempt < 8 && cache == NULL; attempt++) {
+        generation++;
+        DataCacheSegmentName(name, module, generation);
+        cache = (DataCacheHeader *)DataCacheMap(name, totalBytes, true, false, NULL);
+    }
+    if (cache == NULL) return NULL;
+
+    DataCacheFillImage(cache, totalBytes, generation, sources, sourceCount);
+
+    __atomic_store_n(&control->generation, generation, __ATOMIC_RELEASE);
+    if (previous > 0) {
+        DataCacheSegmentName(name, module, previous);
+        DataCacheUnlink(name); // Processes still using it keep their mapping
+    }
+    TraceLog(LOG_INFO, TextFormat("DATACACHE: Published %s generation %ld (%ld bytes).", module, generation, totalBytes));
+    return cache;
+}
+
+//----------------------------------------------------------------------------------
+// Snapshot Files
+//----------------------------------------------------------------------------------
+
+// Writes the tables as a snapshot file. Goes through a temp file and a rename, so a
+// crash mid-write leaves the previous snapshot (or none) rather than a torn one.
+static inline bool DataCacheWriteFile(const char *path, const DataCacheSource *sources, int sourceCount) {
+    if (sourceCount > DATACACHE_MAX_SECTIONS) return false;
+    long totalBytes = DataCacheImageSize(sources, sourceCount);
+    DataCacheHeader *image = (DataCacheHeader *)calloc(1, totalBytes);
+    if (image == NULL) return false;
+    DataCacheFillImage(image, totalBytes, 0, sources, sourceCount);
+
+    char tempPath[DATACACHE_NAME_LENGTH + 8];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE *file = fopen(tempPath, "wb");
+    bool written = (file != NULL) && (fwrite(image, 1, totalBytes, file) == (size_t)totalBytes);
+    if (file) written = (fclose(file) == 0) && written;
+    free(image);
+    if (!written) { remove(tempPath); return false; }
+
+    remove(path); // rename() does not replace an existing file on Windows
+    return rename(tempPath, path) == 0;
+}
+
+// Maps a snapshot file read-only (read into memory on Windows). NULL if it is
+// missing or damaged; callers still check DataCacheIsFresh() before using it.
+static inline const DataCacheHeader *DataCacheMapFile(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0 || st.st_size < (long)sizeof(DataCacheHeader)) return NULL;
+    long bytes = (long)st.st_size;
+#if defined(_WIN32)
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+    DataCacheHeader *image = (DataCacheHeader *)malloc(bytes);
+    bool ok = (image != NULL) && (fread(image, 1, bytes, file) == (size_t)bytes);
+    fclose(file);
+    if (!ok) { free(image); return NULL; }
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    DataCacheHeader *image = (DataCacheHeader *)mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) return NULL;
+#endif
+    bool valid = image->magic == DATACACHE_MAGIC && image->totalBytes == bytes && image->sectionCount <= DATACACHE_MAX_SECTIONS;
+    for (int i = 0; valid && i < image->sectionCount; i++) {
+        const DataCacheSection *section = &image->sections[i];
+        valid = section->offset >= (long)sizeof(DataCacheHeader) && section->count >= 0 &&
+                section->offset + section->elementSize * section->count <= bytes;
+    }
+    if (!valid) {
+#if defined(_WIN32)
+        free(image);
+#else
+        munmap(image, bytes);
+#endif
+        return NULL;
+    }
+    return image;
+}
+
+// Releases a snapshot returned by DataCacheMapFile() once its records were copied out
+static inline void DataCacheUnmapFile(const DataCacheHeader *image) {
+    if (image == NULL) return;
+#if defined(_WIN32)
+    free((void *)image);
+#else
+    munmap((void *)image, image->totalBytes);
+#endif
+}
+
+#endif // DATACACHE_H
@@ -0,0 +1,452 @@
+/*******************************************************************************************
+*
+* University Portal System - Assignment Deadline Tracker
+*
+* Shared by the faculty (acadfac.c) and student (acadstu.c) Academics windows.
+*
+* - Per-student assignment state (assigned, pending, submitted, late) is two bits per
+*   student, kept in a column per assignment. A column only exists once some student's
+*   state for that assignment left "assigned", so untouched assignments cost nothing.
+*   The high bit plane is "handed in", which makes missing counts a popcount.
+* - The deadline index is the task array itself, kept sorted by due date. A heap would
+*   only hand out the earliest deadline; "next N after today" and "everything due
+*   before today" both need a split point, which here is one binary search.
+* - A Fenwick tree over that order counts hand-ins, so the number of missing
+*   submissions among all overdue assignments is one prefix sum: O(log A).
+* - Listing the next N deadlines of one student walks forward from the split point and
+*   skips what the student already handed in, one bit test per assignment.
+* - DeadlinePack() flattens students and columns for datacache.h snapshots; tasks are
+*   rebuilt from the assignment rows with DeadlineSetTasks().
+*
+* assignment_progress.txt lines:
+*   assignmentId|studentId|STATE        (only states other than ASSIGNED are written)
+*
+********************************************************************************************/
+
+#ifndef DEADLINES_H
+#define DEADLINES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "records.h"
+
+#define DEADLINE_MAX_ID 32
+#define DEADLINE_IMAGE_MAGIC 0x31544c44u    // "DLT1"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// The first three match AssignStatus in the Academics windows. Bit 1 is "handed in".
+typedef enum { DL_ASSIGNED = 0, DL_PENDING = 1, DL_SUBMITTED = 2, DL_LATE = 3, DL_STATE_COUNT } DeadlineState;
+
+static const char *const DEADLINE_STATE_NAMES[DL_STATE_COUNT] = { "ASSIGNED", "PENDING", "SUBMITTED", "LATE" };
+
+typedef struct {
+    int32_t id;                         // Assignment.id
+    int32_t due;                        // YYYYMMDD; 0 (no valid date) sorts first
+    int32_t column;                     // Index in DeadlineTracker.columns, -1 if none yet
+    int32_t submitted;                  // Students who handed it in, late or not
+} DeadlineTask;
+
+typedef struct {
+    char id[DEADLINE_MAX_ID];
+} DeadlineStudent;
+
+typedef struct {
+    int32_t assignment;                 // -1 once the assignment is deleted
+    uint32_t offset;                    // Low plane at words[offset], high plane right after
+} DeadlineColumn;
+
+typedef struct {
+    DeadlineTask *tasks;                // Sorted by due, then id
+    int taskCount, taskCapacity;
+    int32_t *submittedTree;             // Fenwick tree of tasks[].submitted, 1-based
+    DeadlineStudent *students;
+    int studentCount, studentCapacity;
+    int *studentSlots;                  // ID hash, open addressing (-1 = empty)
+    int studentSlotCapacity;
+    DeadlineColumn *columns;
+    int columnCount, columnCapacity;
+    uint64_t *words;                    // Bit planes of all columns
+    long wordCount, wordCapacity;
+    int planeWords;                     // Words per plane: room for planeWords*64 students
+    bool readOnly;                      // students, columns and words belong to a snapshot image
+    uint64_t *packed;                   // Last DeadlinePack() image
+} DeadlineTracker;
+
+// Header of a DeadlinePack() image; students, columns and words follow, 8-byte aligned
+typedef struct {
+    uint32_t magic;
+    int32_t studentCount, columnCount, planeWords;
+} DeadlineImage;
+
+//----------------------------------------------------------------------------------
+// Helpers
+//----------------------------------------------------------------------------------
+static inline uint32_t DeadlineHash(const char *str) {
+    uint32_t hash = 2166136261u;        // FNV-1a
+    while (*str) hash = (hash ^ (unsigned char)*str++) * 16777619u;
+    return hash;
+}
+
+// Local date as YYYYMMDD
+static inline int32_t DeadlineToday(void) {
+    time_t now = time(NULL);
+    struct tm *t = localtime(&now);
+    return (t->tm_year + 1900)*10000 + (t->tm_mon + 1)*100 + t->tm_mday;
+}
+
+static inline bool DeadlineDone(DeadlineState state) { return (state & 2) != 0; }
+
+static inline long DeadlineBytes(const DeadlineTracker *tracker) {
+    return (long)(sizeof(DeadlineStudent) * tracker->studentCount + sizeof(DeadlineColumn) * tracker->columnCount +
+                  sizeof(DeadlineTask) * tracker->taskCount) + (long)sizeof(uint64_t) * tracker->wordCount;
+}
+
+static inline void DeadlineFree(DeadlineTracker *tracker) {
+    if (!tracker->readOnly) { free(tracker->students); free(tracker->columns); free(tracker->words); }
+    free(tracker->tasks); free(tracker->submittedTree);
+    free(tracker->studentSlots); free(tracker->packed);
+    memset(tracker, 0, sizeof(*tracker));
+}
+
+//----------------------------------------------------------------------------------
+// Columns
+//----------------------------------------------------------------------------------
+
+// Re-lays every column out with planes of 'planeWords' words
+static inline void DeadlineWiden(DeadlineTracker *tracker, int planeWords) {
+    uint64_t *words = (uint64_t *)calloc((size_t)tracker->columnCount * 2 * planeWords + 1, sizeof(uint64_t));
+    for (int c = 0; c < tracker->columnCount; c++) {
+        for (int plane = 0; plane < 2; plane++) {
+            memcpy(words + ((size_t)c*2 + plane) * planeWords, tracker->words + tracker->columns[c].offset + (size_t)plane * tracker->planeWords,
+                sizeof(uint64_t) * tracker->planeWords);
+        }
+        tracker->columns[c].offset = (uint32_t)((size_t)c * 2 * planeWords);
+    }
+    free(tracker->words);
+    tracker->words = words;
+    tracker->wordCount = tracker->wordCapacity = (long)tracker->columnCount * 2 * planeWords;
+    tracker->planeWords = planeWords;
+}
+
+static inline int DeadlineFindColumn(const DeadlineTracker *tracker, int32_t assignment) {
+    for (int c = 0; c < tracker->columnCount; c++) if (tracker->columns[c].assignment == assignment) return c;
+    return -1;
+}
+
+// The assignment's column, created all "assigned" if it has none
+static inline int DeadlineAddColumn(DeadlineTracker *tracker, int32_t assignment) {
+    int found = DeadlineFindColumn(tracker, assignment);
+    if (found >= 0 || tracker->readOnly) return found;
+    if (tracker->columnCount == tracker->columnCapacity) {
+        tracker->columnCapacity = tracker->columnCapacity ? tracker->columnCapacity * 2 : 64;
+        tracker->columns = (DeadlineColumn *)realloc(tracker->columns, sizeof(DeadlineColumn) * tracker->columnCapacity);
+    }
+    long need = tracker->wordCount + 2L * tracker->planeWords;
+    if (need > tracker->wordCapacity) {
+        tracker->wordCapacity = tracker->wordCapacity ? tracker->wordCapacity * 2 : 4096;
+        while (tracker->wordCapacity < need) tracker->wordCapacity *= 2;
+        tracker->words = (uint64_t *)realloc(tracker->words, sizeof(uint64_t) * tracker->wordCapacity);
+    }
+    memset(tracker->words + tracker->wordCount, 0, sizeof(uint64_t) * 2 * tracker->planeWords);
+    tracker->columns[tracker->columnCount] = (DeadlineColumn){ assignment, (uint32_t)tracker->wordCount };
+    tracker->wordCount = need;
+    for (int i = 0; i < tracker->taskCount; i++) if (tracker->tasks[i].id == assignment) tracker->tasks[i].column = tracker->columnCount;
+    return tracker->columnCount++;
+}
+
+static inline DeadlineState DeadlineColumnState(const DeadlineTracker *tracker, int column, int student) {
+    if (column < 0) return DL_ASSIGNED;
+    const uint64_t *low = tracker->words + tracker->columns[column].offset, *high = low + tracker->planeWords;
+    uint64_t bit = 1ull << (student % 64);
+    return (DeadlineState)((((high[student / 64] & bit) != 0) << 1) | ((low[student / 64] & bit) != 0));
+}
+
+static inline void DeadlineColumnSet(DeadlineTracker *tracker, int column, int student, DeadlineState state) {
+    uint64_t *low = tracker->words + tracker->columns[column].offset, *high = low + tracker->planeWords;
+    uint64_t bit = 1ull << (student % 64);
+    low[student / 64] = (state & 1) ? (low[student / 64] | bit) : (low[student / 64] & ~bit);
+    high[student / 64] = (state & 2) ? (high[student / 64] | bit) : (high[student / 64] & ~bit);
+}
+
+//----------------------------------------------------------------------------------
+// Students
+//----------------------------------------------------------------------------------
+static inline void DeadlineIndexStudent(DeadlineTracker *tracker, int student) {
+    uint32_t slot = DeadlineHash(tracker->students[student].id) & (tracker->studentSlotCapacity - 1);
+    while (tracker->studentSlots[slot] >= 0) slot = (slot + 1) & (tracker->studentSlotCapacity - 1);
+    tracker->studentSlots[slot] = student;
+}
+
+static inline void DeadlineRebuildStudentIndex(DeadlineTracker *tracker) {
+    free(tracker->studentSlots);
+    tracker->studentSlotCapacity = 1024;
+    while (tracker->studentSlotCapacity < tracker->studentCount * 2 + 2) tracker->studentSlotCapacity *= 2;
+    tracker->studentSlots = (int *)malloc(sizeof(int) * tracker->studentSlotCapacity);
+    memset(tracker->studentSlots, 0xFF, sizeof(int) * tracker->studentSlotCapacity);
+    for (int i = 0; i < tracker->studentCount; i++) DeadlineIndexStudent(tracker, i);
+}
+
+static inline int DeadlineFindStudent(const DeadlineTracker *tracker, const char *id) {
+    if (tracker->studentSlotCapacity == 0) return -1;
+    uint32_t slot = DeadlineHash(id) & (tracker->studentSlotCapacity - 1);
+    for (; tracker->studentSlots[slot] >= 0; slot = (slot + 1) & (tracker->studentSlotCapacity - 1)) {
+        if (strcmp(tracker->students[tracker->studentSlots[slot]].id, id) == 0) return tracker->studentSlots[slot];
+    }
+    return -1;
+}
+
+// Index of the student, added if new; -1 for a read-only tracker or an unusable ID
+static inline int DeadlineAddStudent(DeadlineTracker *tracker, const char *id) {
+    int found = DeadlineFindStudent(tracker, id);
+    if (found >= 0 || tracker->readOnly || id[0] == '\0' || strlen(id) >= DEADLINE_MAX_ID) return found;
+    if (tracker->studentCount == tracker->studentCapacity) {
+        tracker->studentCapacity = tracker->studentCapacity ? tracker->studentCapacity * 2 : 256;
+        tracker->students = (DeadlineStudent *)realloc(tracker->students, sizeof(DeadlineStudent) * tracker->studentCapacity);
+    }
+    if (tracker->studentCount >= tracker->planeWords * 64) DeadlineWiden(tracker, tracker->planeWords ? tracker->planeWords * 2 : 4);
+    int student = tracker->studentCount++;
+    memset(&tracker->students[student], 0, sizeof(DeadlineStudent));
+    strcpy(tracker->students[student].id, id);
+    if ((tracker->studentCount + 1) * 2 > tracker->studentSlotCapacity) DeadlineRebuildStudentIndex(tracker);
+    else DeadlineIndexStudent(tracker, student);
+    return student;
+}
+
+//----------------------------------------------------------------------------------
+// Deadline Index
+//----------------------------------------------------------------------------------
+static inline void DeadlineTreeAdd(DeadlineTracker *tracker, int task, int delta) {
+    for (int i = task + 1; i <= tracker->taskCount; i += i & -i) tracker->submittedTree[i] += delta;
+}
+
+// Hand-ins for tasks[0..count)
+static inline long DeadlineTreeSum(const DeadlineTracker *tracker, int count) {
+    long sum = 0;
+    for (int i = count; i > 0; i -= i & -i) sum += tracker->submittedTree[i];
+    return sum;
+}
+
+static inline int DeadlineCompareTasks(const void *a, const void *b) {
+    const DeadlineTask *x = (const DeadlineTask *)a, *y = (const DeadlineTask *)b;
+    if (x->due != y->due) return (x->due > y->due) - (x->due < y->due);
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+// Index of the task for an assignment, or -1. Tasks are few (hundreds), so a scan.
+static inline int DeadlineFindTask(const DeadlineTracker *tracker, int32_t assignment) {
+    for (int i = 0; i < tracker->taskCount; i++) if (tracker->tasks[i].id == assignment) return i;
+    return -1;
+}
+
+// First task due on or after 'date'
+static inline int DeadlineLowerBound(const DeadlineTracker *tracker, int32_t date) {
+    int lo = 0, hi = tracker->taskCount;
+    while (lo < hi) { int mid = (lo + hi) / 2; if (tracker->tasks[mid].due < date) lo = mid + 1; else hi = mid; }
+    return lo;
+}
+
+// Replaces the task list with the given assignments and recounts their hand-ins from
+// the columns. Called whenever assignments are loaded, added or removed.
+static inline void DeadlineSetTasks(DeadlineTracker *tracker, const int32_t *ids, const int32_t *dues, int count) {
+    if (count > tracker->taskCapacity) {
+        tracker->taskCapacity = count * 2;
+        tracker->tasks = (DeadlineTask *)realloc(tracker->tasks, sizeof(DeadlineTask) * tracker->taskCapacity);
+    }
+    free(tracker->submittedTree);
+    tracker->submittedTree = (int32_t *)calloc(count + 1, sizeof(int32_t));
+    tracker->taskCount = count;
+    for (int i = 0; i < count; i++) {
+        DeadlineTask *t = &tracker->tasks[i];
+        *t = (DeadlineTask){ ids[i], dues[i], DeadlineFindColumn(tracker, ids[i]), 0 };
+        if (t->column < 0) continue;
+        const uint64_t *high = tracker->words + tracker->columns[t->column].offset + tracker->planeWords;
+        for (int w = 0; w < tracker->planeWords; w++) t->submitted += __builtin_popcountll(high[w]);
+    }
+    qsort(tracker->tasks, count, sizeof(DeadlineTask), DeadlineCompareTasks);
+    for (int i = 0; i < count; i++) DeadlineTreeAdd(tracker, i, tracker->tasks[i].submitted);
+}
+
+static inline DeadlineState DeadlineStateAt(const DeadlineTracker *tracker, int task, int student) {
+    return DeadlineColumnState(tracker, tracker->tasks[task].column, student);
+}
+
+// Sets one student's state for tasks[task]. Handing in after the due date is recorded
+// as late. False if the tracker is read-only.
+static inline bool DeadlineSetTaskState(DeadlineTracker *tracker, int task, int student, DeadlineState state, int32_t today) {
+    if (tracker->readOnly || student < 0 || student >= tracker->studentCount) return false;
+    DeadlineTask *t = &tracker->tasks[task];
+    if (state == DL_SUBMITTED && t->due && today > t->due) state = DL_LATE;
+    DeadlineState old = DeadlineStateAt(tracker, task, student);
+    if (old == state) return true;
+    if (t->column < 0) DeadlineAddColumn(tracker, t->id);
+    DeadlineColumnSet(tracker, t->column, student, state);
+    int delta = DeadlineDone(state) - DeadlineDone(old);
+    if (delta) { t->submitted += delta; DeadlineTreeAdd(tracker, task, delta); }
+    return true;
+}
+
+// Same, by assignment id; false also when no such assignment exists
+static inline bool DeadlineSetState(DeadlineTracker *tracker, int student, int32_t assignment, DeadlineState state, int32_t today) {
+    int task = DeadlineFindTask(tracker, assignment);
+    return task >= 0 && DeadlineSetTaskState(tracker, task, student, state, today);
+}
+
+static inline DeadlineState DeadlineStateOf(const DeadlineTracker *tracker, int student, int32_t assignment) {
+    return DeadlineColumnState(tracker, DeadlineFindColumn(tracker, assignment), student);
+}
+
+// Forgets every student's state for a deleted assignment, so a later assignment that
+// reuses its id starts clean. The column's words are dropped by the next DeadlinePack().
+static inline void DeadlineDropAssignment(DeadlineTracker *tracker, int32_t assignment) {
+    int column = DeadlineFindColumn(tracker, assignment);
+    if (column >= 0 && !tracker->readOnly) tracker->columns[column].assignment = -1;
+}
+
+//----------------------------------------------------------------------------------
+// Queries
+//----------------------------------------------------------------------------------
+
+// The student's next deadlines on or after 'today' that are not handed in, soonest
+// first; returns how many task indices went to out[]. student -1 lists every task.
+static inline int DeadlineNext(const DeadlineTracker *tracker, int student, int32_t today, int *out, int max) {
+    int found = 0;
+    for (int i = DeadlineLowerBound(tracker, today); i < tracker->taskCount && found < max; i++) {
+        if (student < 0 || !DeadlineDone(DeadlineStateAt(tracker, i, student))) out[found++] = i;
+    }
+    return found;
+}
+
+// The student's assignments due before 'today' and not handed in, oldest first.
+// Undated assignments are never overdue.
+static inline int DeadlineOverdueFor(const DeadlineTracker *tracker, int student, int32_t today, int *out, int max) {
+    int found = 0, end = DeadlineLowerBound(tracker, today);
+    for (int i = DeadlineLowerBound(tracker, 1); i < end && found < max; i++) {
+        if (student < 0 || !DeadlineDone(DeadlineStateAt(tracker, i, student))) out[found++] = i;
+    }
+    return found;
+}
+
+// Missing hand-ins across the cohort for everything due before 'today'. *tasks gets
+// how many assignments that covers. Two binary searches and two prefix sums.
+static inline long DeadlineOverdueCount(const DeadlineTracker *tracker, int32_t today, int *tasks) {
+    int from = DeadlineLowerBound(tracker, 1), end = DeadlineLowerBound(tracker, today);
+    if (end < from) end = from;
+    if (tasks) *tasks = end - from;
+    return (long)(end - from) * tracker->studentCount - (DeadlineTreeSum(tracker, end) - DeadlineTreeSum(tracker, from));
+}
+
+// Students who have not handed in tasks[task]: returns how many, the first 'max' go to
+// out[]. Scans the "handed in" plane a word (64 students) at a time.
+static inline int DeadlineMissing(const DeadlineTracker *tracker, int task, int *out, int max) {
+    const DeadlineTask *t = &tracker->tasks[task];
+    const uint64_t *high = t->column >= 0 ? tracker->words + tracker->columns[t->column].offset + tracker->planeWords : NULL;
+    for (int w = 0, found = 0; w*64 < tracker->studentCount && found < max; w++) {
+        uint64_t missing = high ? ~high[w] : ~0ull;
+        if (tracker->studentCount - w*64 < 64) missing &= (1ull << (tracker->studentCount - w*64)) - 1;
+        for (; missing && found < max; missing &= missing - 1) out[found++] = w*64 + __builtin_ctzll(missing);
+    }
+    return tracker->studentCount - t->submitted;
+}
+
+//----------------------------------------------------------------------------------
+// Snapshot Images
+//----------------------------------------------------------------------------------
+static inline long DeadlineAlign(long bytes) { return (bytes + 7) & ~7L; }
+
+// Flattens students and the live columns into an image of uint64 words, owned by the tracker
+static inline const uint64_t *DeadlinePack(DeadlineTracker *tracker, int *wordCount) {
+    int live = 0;
+    for (int c = 0; c < tracker->columnCount; c++) live += (tracker->columns[c].assignment >= 0);
+    long studentBytes = DeadlineAlign(sizeof(DeadlineStudent) * tracker->studentCount);
+    long columnBytes = DeadlineAlign(sizeof(DeadlineColumn) * live);
+    long total = DeadlineAlign(sizeof(DeadlineImage)) + studentBytes + columnBytes + (long)sizeof(uint64_t) * live * 2 * tracker->planeWords;
+    free(tracker->packed);
+    uint64_t *image = tracker->packed = (uint64_t *)calloc(total / 8, sizeof(uint64_t));
+    *(DeadlineImage *)image = (DeadlineImage){ DEADLINE_IMAGE_MAGIC, tracker->studentCount, live, tracker->planeWords };
+    char *p = (char *)image + DeadlineAlign(sizeof(DeadlineImage));
+    if (tracker->studentCount) memcpy(p, tracker->students, sizeof(DeadlineStudent) * tracker->studentCount);
+    DeadlineColumn *columns = (DeadlineColumn *)(p + studentBytes);
+    uint64_t *words = (uint64_t *)(p + studentBytes + columnBytes);
+    for (int c = 0, n = 0; c < tracker->columnCount; c++) {
+        if (tracker->columns[c].assignment < 0) continue;
+        columns[n] = (DeadlineColumn){ tracker->columns[c].assignment, (uint32_t)((size_t)n * 2 * tracker->planeWords) };
+        memcpy(words + columns[n].offset, tracker->words + tracker->columns[c].offset, sizeof(uint64_t) * 2 * tracker->planeWords);
+        n++;
+    }
+    *wordCount = (int)(total / 8);
+    return image;
+}
+
+// Reads a packed image back, in place (read-only) or copied. The tasks are cleared, so
+// DeadlineSetTasks() follows. False if the image is malformed.
+static inline bool DeadlineLoadImage(DeadlineTracker *tracker, const uint64_t *image, int wordCount, bool inPlace) {
+    DeadlineFree(tracker);
+    const DeadlineImage *header = (const DeadlineImage *)image;
+    if ((long)wordCount * 8 < (long)sizeof(DeadlineImage) || header->magic != DEADLINE_IMAGE_MAGIC) return false;
+    if (header->studentCount < 0 || header->columnCount < 0 || header->planeWords < 0 || header->studentCount > header->planeWords * 64) return false;
+    long studentBytes = DeadlineAlign(sizeof(DeadlineStudent) * header->studentCount);
+    long columnBytes = DeadlineAlign(sizeof(DeadlineColumn) * header->columnCount);
+    long words = (long)header->columnCount * 2 * header->planeWords;
+    if (DeadlineAlign(sizeof(DeadlineImage)) + studentBytes + columnBytes + words * 8 != (long)wordCount * 8) return false;
+
+    const char *p = (const char *)image + DeadlineAlign(sizeof(DeadlineImage));
+    const DeadlineStudent *students = (const DeadlineStudent *)p;
+    const DeadlineColumn *columns = (const DeadlineColumn *)(p + studentBytes);
+    const uint64_t *bits = (const uint64_t *)(p + studentBytes + columnBytes);
+    for (int c = 0; c < header->columnCount; c++) if (columns[c].offset + 2L * header->planeWords > words) return false;
+
+    tracker->studentCount = header->studentCount; tracker->columnCount = header->columnCount;
+    tracker->wordCount = words; tracker->planeWords = header->planeWords;
+    if (inPlace) {
+        tracker->students = (DeadlineStudent *)students; tracker->columns = (DeadlineColumn *)columns;
+        tracker->words = (uint64_t *)bits;
+        tracker->readOnly = true;
+    } else {
+        tracker->studentCapacity = tracker->studentCount; tracker->columnCapacity = tracker->columnCount; tracker->wordCapacity = words;
+        tracker->students = (DeadlineStudent *)malloc(sizeof(DeadlineStudent) * (tracker->studentCount + 1));
+        tracker->columns = (DeadlineColumn *)malloc(sizeof(DeadlineColumn) * (tracker->columnCount + 1));
+        tracker->words = (uint64_t *)malloc(sizeof(uint64_t) * (words + 1));
+        memcpy(tracker->students, students, sizeof(DeadlineStudent) * tracker->studentCount);
+        memcpy(tracker->columns, columns, sizeof(DeadlineColumn) * tracker->columnCount);
+        memcpy(tracker->words, bits, sizeof(uint64_t) * words);
+    }
+    DeadlineRebuildStudentIndex(tracker);
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// assignment_progress.txt Lines
+//----------------------------------------------------------------------------------
+
+// Student a line belongs to, for recordindex.h
+static inline bool DeadlineLineStudent(const RecordLine *line, RecordField *key) {
+    if (line->count < 3) return false;
+    *key = line->fields[1];
+    return true;
+}
+
+// Loads one line straight into the assignment's column; DeadlineSetTasks() counts it
+// later. A later line for the same pair replaces the earlier one.
+static inline bool DeadlineParseLine(DeadlineTracker *tracker, const RecordLine *line) {
+    char id[DEADLINE_MAX_ID];
+    if (line->count < 3 || tracker->readOnly) return false;
+    int state = -1;
+    for (int s = 0; s < DL_STATE_COUNT; s++) {
+        int length = (int)strlen(DEADLINE_STATE_NAMES[s]);
+        if (line->fields[2].length == length && memcmp(line->fields[2].text, DEADLINE_STATE_NAMES[s], length) == 0) state = s;
+    }
+    RecordCopy(line, 1, id, sizeof(id));
+    int student = DeadlineAddStudent(tracker, id);
+    if (state < 0 || student < 0) return false;
+    DeadlineColumnSet(tracker, DeadlineAddColumn(tracker, RecordInt(line, 0)), student, (DeadlineState)state);
+    return true;
+}
+
+#endif // DEADLINES_H
@@ -0,0 +1,377 @@
+/*******************************************************************************************
+*
+* University Portal System - Fee Ledger
+*
+* Shared by the admin portal (adminad.c), which posts charges and payments, and the
+* student portal (adminstu.c), which reads one student's balance.
+*
+* - fees.ledger is an append-only log of fixed-size FeeTransactions. A charge raises
+*   what a student owes on an account, a payment what they paid; negative amounts are
+*   corrections. Posting is one 64-byte write; nothing is ever rewritten.
+* - Balances live in an open-addressing hash on the student ID (FNV-1a), kept current
+*   as transactions are posted.
+* - fees.ckpt holds the balances as of some record count, stored as the hash itself
+*   (slot table + balances). Opening the ledger loads it as is and replays only the
+*   records after it; the admin side writes a new one whenever that tail reaches
+*   FEE_CHECKPOINT_INTERVAL records, so the tail stays short.
+* - FeeLookup() reads one student's balance without loading the others: a probe of the
+*   slot table on disk, one balance read, then the short tail. Its cost does not grow
+*   with the number of students.
+* - The checkpoint keeps a copy of the last record it covers, so a checkpoint that does
+*   not belong to the ledger on disk is ignored and the whole log is replayed.
+* - A ledger cut short mid-record (crash during a write) ends at its last whole record;
+*   the next post overwrites the partial one.
+* - The first admin start without a ledger imports fees.dat (the old table of totals) as
+*   charges and payments. fees.dat is left as it was.
+*
+********************************************************************************************/
+
+#ifndef FEELEDGER_H
+#define FEELEDGER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "persist.h"
+
+#define FEE_MAX_ID 48
+#define FEE_LEDGER_FILE "fees.ledger"
+#define FEE_CHECKPOINT_FILE "fees.ckpt"
+#define FEE_LEGACY_FILE "fees.dat"
+#define FEE_CHECKPOINT_MAGIC 0x32504B43u    // "CKP2"
+#define FEE_CHECKPOINT_INTERVAL 4096        // Records replayed on open before a new checkpoint pays off
+#define FEE_REPLAY_CHUNK 1024
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum { FEE_CHARGE = 0, FEE_PAYMENT = 1 } FeeKind;
+typedef enum { FEE_TUITION = 0, FEE_HOSTEL = 1 } FeeAccount;
+
+// One ledger record, 64 bytes on disk
+typedef struct {
+    char studentId[FEE_MAX_ID];
+    uint8_t kind;                       // FeeKind
+    uint8_t account;                    // FeeAccount
+    uint16_t reserved;
+    int32_t amount;
+    int64_t postedAt;                   // time(NULL) when posted
+} FeeTransaction;
+
+// Same fields as the portals' FeeData
+typedef struct {
+    char studentId[FEE_MAX_ID];
+    int32_t tuitionTotal, tuitionPaid;
+    int32_t hostelTotal, hostelPaid;
+} FeeBalance;
+
+// Followed by int32 slots[slotCapacity] and FeeBalance balances[count]
+typedef struct {
+    uint32_t magic;
+    int32_t count;
+    int64_t covered;                    // Ledger records folded into the balances
+    int32_t slotCapacity;               // Power of two, or 0 when there are no balances
+    int32_t reserved;
+    FeeTransaction last;                // Record covered - 1, to recognise the ledger
+} FeeCheckpointHeader;
+
+// Where a ledger lives; the portals use FEE_FILES
+typedef struct {
+    const char *ledger, *checkpoint, *legacy;
+} FeeFiles;
+
+static const FeeFiles FEE_FILES = { FEE_LEDGER_FILE, FEE_CHECKPOINT_FILE, FEE_LEGACY_FILE };
+
+typedef struct {
+    FeeFiles files;
+    FeeBalance *balances;
+    int count, capacity;
+    int *slots;                         // Balance index per slot, -1 = empty
+    int slotCapacity;
+    FILE *log;                          // fees.ledger, NULL if there is none yet
+    bool writable;
+    bool deferCheckpoints;              // Bulk posting: checkpoint once, by hand
+    int64_t records;                    // Whole records in the ledger
+    int64_t checkpointed;               // Records covered by fees.ckpt
+} FeeLedger;
+
+//----------------------------------------------------------------------------------
+// Balances
+//----------------------------------------------------------------------------------
+static inline uint32_t FeeHash(const char *id) {
+    uint32_t hash = 2166136261u;        // FNV-1a
+    while (*id) hash = (hash ^ (unsigned char)*id++) * 16777619u;
+    return hash;
+}
+
+static inline void FeeIndex(FeeLedger *ledger, int balance) {
+    uint32_t slot = FeeHash(ledger->balances[balance].studentId) & (ledger->slotCapacity - 1);
+    while (ledger->slots[slot] >= 0) slot = (slot + 1) & (ledger->slotCapacity - 1);
+    ledger->slots[slot] = balance;
+}
+
+static inline void FeeRehash(FeeLedger *ledger, int slotCapacity) {
+    free(ledger->slots);
+    ledger->slotCapacity = slotCapacity;
+    ledger->slots = (int *)malloc(sizeof(int) * slotCapacity);
+    memset(ledger->slots, 0xFF, sizeof(int) * slotCapacity);
+    for (int i = 0; i < ledger->count; i++) FeeIndex(ledger, i);
+}
+
+// The student's balance, or NULL if nothing was ever posted for them
+static inline FeeBalance *FeeFind(const FeeLedger *ledger, const char *id) {
+    if (ledger->slotCapacity == 0) return NULL;
+    uint32_t slot = FeeHash(id) & (ledger->slotCapacity - 1);
+    for (; ledger->slots[slot] >= 0; slot = (slot + 1) & (ledger->slotCapacity - 1)) {
+        FeeBalance *balance = &ledger->balances[ledger->slots[slot]];
+        if (strcmp(balance->studentId, id) == 0) return balance;
+    }
+    return NULL;
+}
+
+static inline FeeBalance *FeeFindOrAdd(FeeLedger *ledger, const char *id) {
+    FeeBalance *found = FeeFind(ledger, id);
+    if (found) return found;
+    if (ledger->count == ledger->capacity) {
+        ledger->capacity = ledger->capacity ? ledger->capacity * 2 : 256;
+        ledger->balances = (FeeBalance *)realloc(ledger->balances, sizeof(FeeBalance) * ledger->capacity);
+    }
+    FeeBalance *balance = &ledger->balances[ledger->count];
+    memset(balance, 0, sizeof(*balance));
+    size_t length = strlen(id);
+    memcpy(balance->studentId, id, length < FEE_MAX_ID ? length : FEE_MAX_ID - 1);   // Zeroed above, so still terminated
+    ledger->count++;
+    if (ledger->count * 2 > ledger->slotCapacity) FeeRehash(ledger, ledger->slotCapacity ? ledger->slotCapacity * 2 : 1024);
+    else FeeIndex(ledger, ledger->count - 1);
+    return balance;
+}
+
+static inline bool FeeValidId(const char *id) {
+    return id[0] != '\0' && memchr(id, '\0', FEE_MAX_ID) != NULL;
+}
+
+static inline void FeeApplyTo(FeeBalance *balance, const FeeTransaction *t) {
+    int32_t *field = (t->account == FEE_HOSTEL) ? (t->kind == FEE_PAYMENT ? &balance->hostelPaid : &balance->hostelTotal)
+                                                 : (t->kind == FEE_PAYMENT ? &balance->tuitionPaid : &balance->tuitionTotal);
+    *field += t->amount;
+}
+
+static inline void FeeApply(FeeLedger *ledger, const FeeTransaction *t) {
+    if (FeeValidId(t->studentId)) FeeApplyTo(FeeFindOrAdd(ledger, t->studentId), t);    // Else a damaged record
+}
+
+//----------------------------------------------------------------------------------
+// Ledger File
+//----------------------------------------------------------------------------------
+static inline bool FeeReadRecord(FILE *file, int64_t index, FeeTransaction *t) {
+    return fseek(file, (long)(index * (int64_t)sizeof(FeeTransaction)), SEEK_SET) == 0 && fread(t, sizeof(*t), 1, file) == 1;
+}
+
+// Writes the checkpoint for the balances as they are now (temp file + rename)
+static inline bool FeeCheckpoint(FeeLedger *ledger) {
+    FeeCheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = FEE_CHECKPOINT_MAGIC;
+    header.count = ledger->count;
+    header.covered = ledger->records;
+    header.slotCapacity = ledger->slotCapacity;
+    if (ledger->records > 0 && !FeeReadRecord(ledger->log, ledger->records - 1, &header.last)) return false;
+
+    // Replaced in one step (persist.h), so there is always a whole checkpoint on disk
+    long slotBytes = (long)sizeof(int) * ledger->slotCapacity, balanceBytes = (long)sizeof(FeeBalance) * ledger->count;
+    long bytes = (long)sizeof(header) + slotBytes + balanceBytes;
+    char *image = (char *)malloc(bytes);
+    if (image == NULL) return false;
+    memcpy(image, &header, sizeof(header));
+    if (slotBytes) memcpy(image + sizeof(header), ledger->slots, slotBytes);
+    if (balanceBytes) memcpy(image + sizeof(header) + slotBytes, ledger->balances, balanceBytes);
+    bool written = PersistWriteFile(ledger->files.checkpoint, image, bytes);
+    free(image);
+    if (!written) return false;
+    ledger->checkpointed = ledger->records;
+    return true;
+}
+
+// Appends one transaction and applies it. False for a read-only ledger, an ID that does
+// not fit, or a failed write (the balance is then left as it was).
+static inline bool FeePost(FeeLedger *ledger, const char *id, FeeKind kind, FeeAccount account, int32_t amount) {
+    if (!ledger->writable || ledger->log == NULL || id[0] == '\0' || strlen(id) >= FEE_MAX_ID) return false;
+    FeeTransaction t;
+    memset(&t, 0, sizeof(t));
+    strcpy(t.studentId, id);
+    t.kind = (uint8_t)kind; t.account = (uint8_t)account;
+    t.amount = amount;
+    t.postedAt = (int64_t)time(NULL);
+    bool written = fseek(ledger->log, (long)(ledger->records * (int64_t)sizeof(t)), SEEK_SET) == 0 &&
+                   fwrite(&t, sizeof(t), 1, ledger->log) == 1 && fflush(ledger->log) == 0;
+    if (!written) return false;
+    ledger->records++;
+    FeeApply(ledger, &t);
+    if (!ledger->deferCheckpoints && ledger->records - ledger->checkpointed >= FEE_CHECKPOINT_INTERVAL) FeeCheckpoint(ledger);
+    return true;
+}
+
+// Reads and checks a checkpoint header against the ledger in 'log' ('records' long)
+static inline bool FeeReadCheckpointHeader(FILE *file, FILE *log, int64_t records, FeeCheckpointHeader *header) {
+    FeeTransaction last;
+    return fread(header, sizeof(*header), 1, file) == 1 && header->magic == FEE_CHECKPOINT_MAGIC &&
+           header->count >= 0 && header->slotCapacity >= 0 && (header->slotCapacity & (header->slotCapacity - 1)) == 0 &&
+           header->count <= header->slotCapacity / 2 && header->covered > 0 && header->covered <= records &&
+           FeeReadRecord(log, header->covered - 1, &last) && memcmp(&last, &header->last, sizeof(last)) == 0;
+}
+
+// Loads the checkpoint if it matches the ledger; returns the records it covers (0 if unusable)
+static inline int64_t FeeLoadCheckpoint(FeeLedger *ledger) {
+    FeeCheckpointHeader header;
+    FILE *file = fopen(ledger->files.checkpoint, "rb");
+    if (file == NULL) return 0;
+    bool usable = FeeReadCheckpointHeader(file, ledger->log, ledger->records, &header);
+    if (usable) {
+        ledger->slotCapacity = header.slotCapacity;
+        ledger->capacity = header.count > 256 ? header.count : 256;
+        ledger->slots = (int *)malloc(sizeof(int) * (header.slotCapacity ? header.slotCapacity : 1));
+        ledger->balances = (FeeBalance *)malloc(sizeof(FeeBalance) * ledger->capacity);
+        ledger->count = header.count;
+        usable = fread(ledger->slots, sizeof(int), header.slotCapacity, file) == (size_t)header.slotCapacity &&
+                 fread(ledger->balances, sizeof(FeeBalance), header.count, file) == (size_t)header.count;
+        for (int i = 0; usable && i < header.slotCapacity; i++) usable = ledger->slots[i] >= -1 && ledger->slots[i] < header.count;
+        for (int i = 0; usable && i < header.count; i++) usable = FeeValidId(ledger->balances[i].studentId);
+    }
+    fclose(file);
+    if (usable) return header.covered;
+    free(ledger->slots); free(ledger->balances);    // Start over from the first record
+    ledger->slots = NULL; ledger->balances = NULL;
+    ledger->count = ledger->capacity = ledger->slotCapacity = 0;
+    return 0;
+}
+
+// fees.dat rows ("id|tuitionTotal|tuitionPaid|hostelTotal|hostelPaid") as transactions:
+// posted when the ledger is being created, only applied when it is read-only
+static inline int FeeImportLegacy(FeeLedger *ledger) {
+    FILE *file = fopen(ledger->files.legacy, "r");
+    if (file == NULL) return 0;
+    char id[64];
+    int values[4], rows = 0;
+    static const struct { FeeKind kind; FeeAccount account; } fields[4] = {
+        { FEE_CHARGE, FEE_TUITION }, { FEE_PAYMENT, FEE_TUITION }, { FEE_CHARGE, FEE_HOSTEL }, { FEE_PAYMENT, FEE_HOSTEL },
+    };
+    ledger->deferCheckpoints = true;
+    while (fscanf(file, "%63[^|]|%d|%d|%d|%d\n", id, &values[0], &values[1], &values[2], &values[3]) == 5) {
+        if (strlen(id) >= FEE_MAX_ID) continue;
+        bool empty = !values[0] && !values[1] && !values[2] && !values[3];
+        for (int f = 0; f < 4; f++) {
+            if (values[f] == 0 && !(empty && f == 0)) continue;    // An all-zero row still lists the student
+            if (ledger->writable) { FeePost(ledger, id, fields[f].kind, fields[f].account, values[f]); continue; }
+            FeeTransaction t;
+            memset(&t, 0, sizeof(t));
+            strcpy(t.studentId, id);
+            t.kind = (uint8_t)fields[f].kind; t.account = (uint8_t)fields[f].account; t.amount = values[f];
+            FeeApply(ledger, &t);
+        }
+        rows++;
+    }
+    ledger->deferCheckpoints = false;
+    fclose(file);
+    return rows;
+}
+
+// Opens the ledger and rebuilds the balances: checkpoint, then the records after it.
+// 'writable' is for the admin side, which may post, import fees.dat and checkpoint.
+static inline void FeeLedgerOpen(FeeLedger *ledger, const FeeFiles *files, bool writable) {
+    memset(ledger, 0, sizeof(*ledger));
+    ledger->files = *files;
+    ledger->writable = writable;
+    ledger->log = fopen(files->ledger, writable ? "r+b" : "rb");
+    if (ledger->log == NULL) {
+        if (writable) ledger->log = fopen(files->ledger, "w+b");
+        FeeImportLegacy(ledger);
+        if (ledger->log && ledger->records > 0) FeeCheckpoint(ledger);
+        return;
+    }
+    fseek(ledger->log, 0, SEEK_END);
+    ledger->records = (int64_t)ftell(ledger->log) / (int64_t)sizeof(FeeTransaction);
+    int64_t next = ledger->checkpointed = FeeLoadCheckpoint(ledger);
+
+    FeeTransaction *chunk = (FeeTransaction *)malloc(sizeof(FeeTransaction) * FEE_REPLAY_CHUNK);
+    fseek(ledger->log, (long)(next * (int64_t)sizeof(FeeTransaction)), SEEK_SET);
+    while (next < ledger->records) {
+        int64_t want = ledger->records - next < FEE_REPLAY_CHUNK ? ledger->records - next : FEE_REPLAY_CHUNK;
+        size_t got = fread(chunk, sizeof(FeeTransaction), (size_t)want, ledger->log);
+        for (size_t i = 0; i < got; i++) FeeApply(ledger, &chunk[i]);
+        if (got < (size_t)want) { ledger->records = next + (int64_t)got; break; }
+        next += want;
+    }
+    free(chunk);
+    if (writable && ledger->records - ledger->checkpointed >= FEE_CHECKPOINT_INTERVAL) FeeCheckpoint(ledger);
+}
+
+static inline void FeeLedgerClose(FeeLedger *ledger) {
+    if (ledger->log) {
+        if (ledger->writable && !ledger->deferCheckpoints && ledger->records > ledger->checkpointed) FeeCheckpoint(ledger);
+        fclose(ledger->log);
+    }
+    free(ledger->balances); free(ledger->slots);
+    memset(ledger, 0, sizeof(*ledger));
+}
+
+//----------------------------------------------------------------------------------
+// Point Lookup
+//----------------------------------------------------------------------------------
+
+// One student's balance, read from the checkpoint's slot table on disk plus the records
+// after it. Falls back to FeeLedgerOpen() when there is no usable checkpoint (no ledger
+// yet, or the admin side has not written one for it). False if the student has none.
+static inline bool FeeLookup(const FeeFiles *files, const char *id, FeeBalance *out) {
+    memset(out, 0, sizeof(*out));
+    if (id[0] == '\0' || strlen(id) >= FEE_MAX_ID) return false;
+    FILE *log = fopen(files->ledger, "rb");
+    FILE *file = log ? fopen(files->checkpoint, "rb") : NULL;
+    FeeCheckpointHeader header;
+    int64_t records = 0;
+    if (log) { fseek(log, 0, SEEK_END); records = (int64_t)ftell(log) / (int64_t)sizeof(FeeTransaction); }
+    if (file == NULL || !FeeReadCheckpointHeader(file, log, records, &header)) {
+        if (file) fclose(file);
+        if (log) fclose(log);
+        FeeLedger ledger;
+        FeeLedgerOpen(&ledger, files, false);
+        const FeeBalance *balance = FeeFind(&ledger, id);
+        if (balance) *out = *balance;
+        FeeLedgerClose(&ledger);
+        return balance != NULL;
+    }
+
+    bool found = false;
+    long balancesAt = (long)sizeof(header) + (long)sizeof(int) * header.slotCapacity;
+    uint32_t slot = header.slotCapacity ? FeeHash(id) & (header.slotCapacity - 1) : 0;
+    for (int probe = 0; probe < header.slotCapacity; probe++, slot = (slot + 1) & (header.slotCapacity - 1)) {
+        int32_t balance;
+        if (fseek(file, (long)sizeof(header) + (long)sizeof(int) * (long)slot, SEEK_SET) != 0 ||
+            fread(&balance, sizeof(balance), 1, file) != 1 || balance < 0 || balance >= header.count) break;
+        if (fseek(file, balancesAt + (long)sizeof(FeeBalance) * balance, SEEK_SET) != 0 || fread(out, sizeof(*out), 1, file) != 1) break;
+        if (strncmp(out->studentId, id, FEE_MAX_ID) == 0) { found = true; break; }
+    }
+    fclose(file);
+    if (!found) { memset(out, 0, sizeof(*out)); strcpy(out->studentId, id); }
+
+    // The tail is shorter than FEE_CHECKPOINT_INTERVAL records while the admin side is running
+    FeeTransaction chunk[64];
+    fseek(log, (long)(header.covered * (int64_t)sizeof(FeeTransaction)), SEEK_SET);
+    for (int64_t next = header.covered; next < records;) {
+        size_t want = records - next < 64 ? (size_t)(records - next) : 64;
+        size_t got = fread(chunk, sizeof(FeeTransaction), want, log);
+        for (size_t i = 0; i < got; i++) {
+            if (strncmp(chunk[i].studentId, id, FEE_MAX_ID) != 0) continue;
+            FeeApplyTo(out, &chunk[i]);
+            found = true;
+        }
+        if (got < want) break;
+        next += (int64_t)got;
+    }
+    fclose(log);
+    return found;
+}
+
+#endif // FEELEDGER_H
@@ -0,0 +1,469 @@
+/*******************************************************************************************
+*
+* University Portal System - Bulk Gradebook Import
+*
+* Reads a CSV of results (student_id,subject,credits,earned,spi,grade[,remarks]) and
+* returns the rows that may go into results.txt, plus the lines it rejected and why.
+*
+* The work is a pipeline over chunks of the file:
+*
+* - The caller's thread cuts the file into chunks at line ends.
+* - Worker threads parse and validate chunks: known student ID (when a roster is
+*   given), credits and earned credits in range, SPI from 0 to 10, a grade that
+*   analytics.h knows, and no '|' (results.txt is pipe-delimited).
+* - Meanwhile the caller's thread dedupes finished chunks in file order on
+*   (student, subject): a later line replaces an earlier one, which is reported.
+*
+* Rows point into the CSV data (pointer + length), so it must outlive the result.
+* Quoted fields are taken verbatim between the quotes; "" escapes are rejected.
+* A first line whose credits column is not a number is taken as a header.
+*
+* Uses pthreads (winpthreads on MinGW), like the timetable generator.
+*
+********************************************************************************************/
+
+#ifndef GRADEBOOK_H
+#define GRADEBOOK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "records.h"
+#include "analytics.h"
+
+#define GRADEBOOK_THREADS 4
+#define GRADEBOOK_MAX_THREADS 16
+#define GRADEBOOK_CHUNK_BYTES (256*1024)
+#define GRADEBOOK_MAX_FIELD 255         // Longest text that fits a MAX_STR field
+#define GRADEBOOK_MAX_CREDITS 12
+#define GRADEBOOK_MAX_COLUMNS 8
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum {
+    GRADE_REJECT_COLUMNS = 0, GRADE_REJECT_QUOTING, GRADE_REJECT_FIELD, GRADE_REJECT_STUDENT,
+    GRADE_REJECT_CREDITS, GRADE_REJECT_SPI, GRADE_REJECT_GRADE, GRADE_REJECT_DUPLICATE, GRADE_REJECT_COUNT
+} GradebookReason;
+
+static const char *const GRADEBOOK_REASONS[GRADE_REJECT_COUNT] = {
+    "wrong number of columns", "bad quoting", "empty, too long or contains '|'", "unknown student ID",
+    "credits out of range", "SPI not between 0 and 10", "unknown grade", "replaced by a later line"
+};
+
+typedef struct {
+    AnalyticsText student, subject, grade, remarks;
+    int credits, earned;
+    float spi;
+    int passed;
+    uint32_t hash;                      // GradebookKeyHash(student, subject)
+    int line;                           // 1-based line in the CSV
+    long offset;                        // Start of the line in the CSV
+} GradebookRow;
+
+typedef struct {
+    int line;
+    int reason;                         // GradebookReason
+    long offset;                        // Start of the line in the CSV
+} GradebookReject;
+
+// Student IDs from student_info.txt, for the "known student" check
+typedef struct {
+    RecordFile file;                    // IDs point into this mapping
+    AnalyticsText *ids;
+    int count, capacity;
+    int *slots;                         // Open addressing, id index (-1 = empty)
+    int slotCapacity;
+} GradebookRoster;
+
+// (student, subject) -> row index in a GradebookRow array
+typedef struct {
+    int *slots;                         // -1 = empty
+    int capacity, count;
+} GradebookIndex;
+
+typedef struct {
+    long begin, end;                    // Byte range, whole lines
+    GradebookRow *rows;
+    int rowCount, rowCapacity;
+    GradebookReject *rejects;
+    int rejectCount, rejectCapacity;
+    int lines;                          // Lines in the chunk, empty ones included
+    bool done;
+} GradebookChunk;
+
+typedef struct {
+    GradebookRow *rows;                 // Accepted and deduped, in order of first appearance
+    int rowCount;
+    GradebookIndex index;               // Over rows, for merging into an existing table
+    GradebookReject *rejects;           // Sorted by line
+    int rejectCount;
+    int reasons[GRADE_REJECT_COUNT];
+    int lines, threads;
+    double ms;
+} GradebookImport;
+
+typedef struct {
+    const char *data;
+    long size;
+    const GradebookRoster *roster;
+    GradebookChunk *chunks;
+    int chunkCount;
+    int nextChunk;                      // Next chunk a worker claims
+    pthread_mutex_t lock;
+    pthread_cond_t chunkDone;
+} GradebookPipeline;
+
+//----------------------------------------------------------------------------------
+// Key Index
+//----------------------------------------------------------------------------------
+static inline uint32_t GradebookKeyHash(AnalyticsText student, AnalyticsText subject) {
+    return AnalyticsHash(student) * 31u + AnalyticsHash(subject);
+}
+
+static inline void GradebookIndexFree(GradebookIndex *index) {
+    free(index->slots);
+    memset(index, 0, sizeof(*index));
+}
+
+// 'hash' is GradebookKeyHash(student, subject); rows with another hash are skipped unread
+static inline int GradebookIndexFind(const GradebookIndex *index, const GradebookRow *rows, uint32_t hash, AnalyticsText student, AnalyticsText subject) {
+    if (index->capacity == 0) return -1;
+    uint32_t slot = hash & (index->capacity - 1);
+    for (; index->slots[slot] >= 0; slot = (slot + 1) & (index->capacity - 1)) {
+        const GradebookRow *row = &rows[index->slots[slot]];
+        if (row->hash == hash && AnalyticsTextEqual(row->student, student) && AnalyticsTextEqual(row->subject, subject)) return index->slots[slot];
+    }
+    return -1;
+}
+
+// Room for 'count' keys without growing
+static inline void GradebookIndexReserve(GradebookIndex *index, const GradebookRow *rows, int count) {
+    if (count * 2 <= index->capacity) return;
+    int *old = index->slots, oldCapacity = index->capacity;
+    int capacity = oldCapacity ? oldCapacity : 1024;
+    while (capacity < count * 2) capacity *= 2;
+    index->capacity = capacity;
+    index->slots = (int *)malloc(sizeof(int) * capacity);
+    memset(index->slots, 0xFF, sizeof(int) * capacity);
+    for (int i = 0; i < oldCapacity; i++) {
+        if (old[i] < 0) continue;
+        uint32_t slot = rows[old[i]].hash & (capacity - 1);
+        while (index->slots[slot] >= 0) slot = (slot + 1) & (capacity - 1);
+        index->slots[slot] = old[i];
+    }
+    free(old);
+}
+
+// Adds rows[row], whose key is not in the index yet
+static inline void GradebookIndexAdd(GradebookIndex *index, const GradebookRow *rows, int row) {
+    GradebookIndexReserve(index, rows, index->count + 1);
+    uint32_t slot = rows[row].hash & (index->capacity - 1);
+    while (index->slots[slot] >= 0) slot = (slot + 1) & (index->capacity - 1);
+    index->slots[slot] = row;
+    index->count++;
+}
+
+//----------------------------------------------------------------------------------
+// Roster
+//----------------------------------------------------------------------------------
+static inline bool GradebookRosterHas(const GradebookRoster *roster, AnalyticsText id) {
+    if (roster->slotCapacity == 0) return false;
+    uint32_t slot = AnalyticsHash(id) & (roster->slotCapacity - 1);
+    for (; roster->slots[slot] >= 0; slot = (slot + 1) & (roster->slotCapacity - 1)) {
+        if (AnalyticsTextEqual(roster->ids[roster->slots[slot]], id)) return true;
+    }
+    return false;
+}
+
+// 'id' must outlive the roster
+static inline void GradebookRosterAdd(GradebookRoster *roster, AnalyticsText id) {
+    if (id.length == 0 || GradebookRosterHas(roster, id)) return;
+    if (roster->count == roster->capacity) {
+        roster->capacity = roster->capacity ? roster->capacity * 2 : 256;
+        roster->ids = (AnalyticsText *)realloc(roster->ids, sizeof(AnalyticsText) * roster->capacity);
+    }
+    if ((roster->count + 1) * 2 > roster->slotCapacity) {
+        free(roster->slots);
+        roster->slotCapacity = roster->slotCapacity ? roster->slotCapacity * 2 : 1024;
+        roster->slots = (int *)malloc(sizeof(int) * roster->slotCapacity);
+        memset(roster->slots, 0xFF, sizeof(int) * roster->slotCapacity);
+        for (int i = 0; i < roster->count; i++) {
+            uint32_t slot = AnalyticsHash(roster->ids[i]) & (roster->slotCapacity - 1);
+            while (roster->slots[slot] >= 0) slot = (slot + 1) & (roster->slotCapacity - 1);
+            roster->slots[slot] = i;
+        }
+    }
+    roster->ids[roster->count] = id;
+    uint32_t slot = AnalyticsHash(id) & (roster->slotCapacity - 1);
+    while (roster->slots[slot] >= 0) slot = (slot + 1) & (roster->slotCapacity - 1);
+    roster->slots[slot] = roster->count++;
+}
+
+// student_info.txt: records of lines ending in "--END--", the ID first. Records of
+// removed users start with '~' and are skipped. False if the file cannot be read.
+static inline bool GradebookRosterLoad(GradebookRoster *roster, const char *path) {
+    memset(roster, 0, sizeof(*roster));
+    if (!RecordFileOpen(&roster->file, path)) return false;
+    RecordLine line;
+    bool recordStart = true;
+    while (RecordNextLine(&roster->file, &line)) {
+        RecordField *f = &line.fields[0];
+        if (f->length == 7 && memcmp(f->text, "--END--", 7) == 0) { recordStart = true; continue; }
+        if (recordStart && f->length > 0 && f->text[0] != '~') GradebookRosterAdd(roster, (AnalyticsText){ f->text, f->length });
+        recordStart = false;
+    }
+    return true;
+}
+
+static inline void GradebookRosterFree(GradebookRoster *roster) {
+    RecordFileClose(&roster->file);
+    free(roster->ids); free(roster->slots);
+    memset(roster, 0, sizeof(*roster));
+}
+
+//----------------------------------------------------------------------------------
+// Parse and Validate
+//----------------------------------------------------------------------------------
+
+// Whole field as an integer, surrounding spaces allowed; false if it is anything else
+static inline bool GradebookParseInt(AnalyticsText field, int *value) {
+    if (field.length == 0 || field.length > 9) return false;
+    int v = 0;
+    for (int i = 0; i < field.length; i++) {
+        if (field.text[i] < '0' || field.text[i] > '9') return false;
+        v = v*10 + (field.text[i] - '0');
+    }
+    *value = v;
+    return true;
+}
+
+// Plain decimal like "8.75"
+static inline bool GradebookParseFloat(AnalyticsText field, float *value) {
+    double v = 0.0, scale = 1.0;
+    int i = 0, digits = 0;
+    for (; i < field.length && field.text[i] >= '0' && field.text[i] <= '9'; i++, digits++) v = v*10.0 + (field.text[i] - '0');
+    if (i < field.length && field.text[i] == '.') {
+        for (i++; i < field.length && field.text[i] >= '0' && field.text[i] <= '9'; i++, digits++) { v = v*10.0 + (field.text[i] - '0'); scale *= 10.0; }
+    }
+    if (i != field.length || digits == 0 || digits > 12) return false;
+    *value = (float)(v / scale);
+    return true;
+}
+
+static inline AnalyticsText GradebookTrim(const char *begin, const char *end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t')) begin++;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) end--;
+    return (AnalyticsText){ begin, (int)(end - begin) };
+}
+
+// Splits one line at commas; returns the column count, or -1 for bad quoting
+static inline int GradebookSplit(const char *p, const char *end, AnalyticsText *fields) {
+    int count = 0;
+    for (;;) {
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        const char *fieldEnd;
+        AnalyticsText field;
+        if (p < end && *p == '"') {
+            const char *close = (const char *)memchr(p + 1, '"', end - p - 1);
+            if (close == NULL) return -1;
+            field = (AnalyticsText){ p + 1, (int)(close - p - 1) };
+            fieldEnd = close + 1;
+            while (fieldEnd < end && (*fieldEnd == ' ' || *fieldEnd == '\t' || *fieldEnd == '\r')) fieldEnd++;
+            if (fieldEnd < end && *fieldEnd != ',') return -1;     // Text after the quote, or a "" escape
+        } else {
+            fieldEnd = (p < end) ? (const char *)memchr(p, ',', end - p) : NULL;
+            if (fieldEnd == NULL) fieldEnd = end;
+            field = GradebookTrim(p, fieldEnd);
+        }
+        if (count < GRADEBOOK_MAX_COLUMNS) fields[count] = field;
+        count++;
+        if (fieldEnd >= end) return count;
+        p = fieldEnd + 1;
+    }
+}
+
+static inline bool GradebookTextOk(AnalyticsText text, bool allowEmpty) {
+    if (text.length > GRADEBOOK_MAX_FIELD || (!allowEmpty && text.length == 0)) return false;
+    return memchr(text.text, '|', text.length) == NULL;
+}
+
+// GRADE_REJECT_COUNT if the line is accepted into *row
+static inline int GradebookValidate(const GradebookRoster *roster, const char *p, const char *end, GradebookRow *row) {
+    AnalyticsText f[GRADEBOOK_MAX_COLUMNS];
+    int columns = GradebookSplit(p, end, f);
+    if (columns < 0) return GRADE_REJECT_QUOTING;
+    if (columns != 6 && columns != 7) return GRADE_REJECT_COLUMNS;
+    row->student = f[0]; row->subject = f[1]; row->grade = f[5];
+    row->remarks = (columns == 7) ? f[6] : (AnalyticsText){ "", 0 };
+    if (!GradebookTextOk(row->student, false) || !GradebookTextOk(row->subject, false) ||
+        !GradebookTextOk(row->remarks, true)) return GRADE_REJECT_FIELD;
+    if (roster && !GradebookRosterHas(roster, row->student)) return GRADE_REJECT_STUDENT;
+    if (!GradebookParseInt(f[2], &row->credits) || !GradebookParseInt(f[3], &row->earned) ||
+        row->credits < 1 || row->credits > GRADEBOOK_MAX_CREDITS || row->earned > row->credits) return GRADE_REJECT_CREDITS;
+    if (!GradebookParseFloat(f[4], &row->spi) || row->spi > 10.0f) return GRADE_REJECT_SPI;
+    int grade = AnalyticsGradeIndex(row->grade);
+    if (grade == ANALYTICS_GRADE_COUNT - 1) return GRADE_REJECT_GRADE;
+    bool failed = (strcmp(ANALYTICS_GRADES[grade], "FF") == 0 || strcmp(ANALYTICS_GRADES[grade], "F") == 0);
+    row->passed = (!failed && row->spi > 0.0f) ? 1 : 0;       // Same rule as the Add Result form
+    row->hash = GradebookKeyHash(row->student, row->subject);  // Here, so the dedupe stage does not hash
+    return GRADE_REJECT_COUNT;
+}
+
+// "student_id,subject,credits,..." and the like: a credits column that is not a number
+static inline bool GradebookIsHeader(const char *p, const char *end) {
+    AnalyticsText f[GRADEBOOK_MAX_COLUMNS];
+    int value = 0;
+    return GradebookSplit(p, end, f) >= 3 && !GradebookParseInt(f[2], &value);
+}
+
+static inline void GradebookChunkReject(GradebookChunk *chunk, int line, int reason, long offset) {
+    if (chunk->rejectCount == chunk->rejectCapacity) {
+        chunk->rejectCapacity = chunk->rejectCapacity ? chunk->rejectCapacity * 2 : 64;
+        chunk->rejects = (GradebookReject *)realloc(chunk->rejects, sizeof(GradebookReject) * chunk->rejectCapacity);
+    }
+    chunk->rejects[chunk->rejectCount++] = (GradebookReject){ line, reason, offset };
+}
+
+// Line numbers are chunk-local here; the dedupe stage makes them file lines
+static inline void GradebookParseChunk(GradebookPipeline *pipe, GradebookChunk *chunk, bool first) {
+    chunk->rowCapacity = (int)((chunk->end - chunk->begin) / 24) + 16;
+    chunk->rows = (GradebookRow *)malloc(sizeof(GradebookRow) * chunk->rowCapacity);
+    const char *p = pipe->data + chunk->begin, *end = pipe->data + chunk->end;
+    while (p < end) {
+        const char *lineEnd = (const char *)memchr(p, '\n', end - p);
+        if (lineEnd == NULL) lineEnd = end;
+        int line = ++chunk->lines;
+        AnalyticsText whole = GradebookTrim(p, lineEnd);
+        if (whole.length > 0) {
+            if (chunk->rowCount == chunk->rowCapacity) {
+                chunk->rowCapacity *= 2;
+                chunk->rows = (GradebookRow *)realloc(chunk->rows, sizeof(GradebookRow) * chunk->rowCapacity);
+            }
+            GradebookRow *row = &chunk->rows[chunk->rowCount];
+            int reason = GradebookValidate(pipe->roster, p, lineEnd, row);
+            if (reason == GRADE_REJECT_COUNT) { row->line = line; row->offset = (long)(p - pipe->data); chunk->rowCount++; }
+            else if (!(first && line == 1 && GradebookIsHeader(p, lineEnd))) GradebookChunkReject(chunk, line, reason, (long)(p - pipe->data));
+        }
+        p = lineEnd + 1;
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Pipeline
+//----------------------------------------------------------------------------------
+static inline void *GradebookWorkerMain(void *arg) {
+    GradebookPipeline *pipe = (GradebookPipeline *)arg;
+    for (;;) {
+        pthread_mutex_lock(&pipe->lock);
+        int c = pipe->nextChunk++;
+        pthread_mutex_unlock(&pipe->lock);
+        if (c >= pipe->chunkCount) return NULL;
+
+        GradebookParseChunk(pipe, &pipe->chunks[c], c == 0);
+
+        pthread_mutex_lock(&pipe->lock);
+        pipe->chunks[c].done = true;
+        pthread_cond_broadcast(&pipe->chunkDone);
+        pthread_mutex_unlock(&pipe->lock);
+    }
+}
+
+static inline void GradebookAddReject(GradebookImport *out, int *capacity, GradebookReject reject) {
+    if (out->rejectCount == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 256;
+        out->rejects = (GradebookReject *)realloc(out->rejects, sizeof(GradebookReject) * *capacity);
+    }
+    out->rejects[out->rejectCount++] = reject;
+    out->reasons[reject.reason]++;
+}
+
+static inline int GradebookCompareRejects(const void *a, const void *b) {
+    return ((const GradebookReject *)a)->line - ((const GradebookReject *)b)->line;
+}
+
+static inline void GradebookFree(GradebookImport *out) {
+    free(out->rows); free(out->rejects);
+    GradebookIndexFree(&out->index);
+    memset(out, 0, sizeof(*out));
+}
+
+// Imports data[size]; roster may be NULL to accept any student ID
+static inline void GradebookRun(const char *data, long size, const GradebookRoster *roster, int threads, GradebookImport *out) {
+    double start = MonoClockNow();
+    GradebookFree(out);
+    if (threads < 1) threads = 1;
+    if (threads > GRADEBOOK_MAX_THREADS) threads = GRADEBOOK_MAX_THREADS;
+
+    // Stage 1: chunks of whole lines
+    GradebookPipeline pipe = { data, size, roster };
+    int chunkCapacity = (int)(size / GRADEBOOK_CHUNK_BYTES) + 2;
+    pipe.chunks = (GradebookChunk *)calloc(chunkCapacity, sizeof(GradebookChunk));
+    for (long begin = 0; begin < size; ) {
+        long end = begin + GRADEBOOK_CHUNK_BYTES;
+        if (end >= size) end = size;
+        else {
+            const char *newline = (const char *)memchr(data + end, '\n', size - end);
+            end = newline ? (long)(newline - data) + 1 : size;
+        }
+        pipe.chunks[pipe.chunkCount++] = (GradebookChunk){ begin, end };
+        begin = end;
+    }
+    if (threads > pipe.chunkCount) threads = pipe.chunkCount > 0 ? pipe.chunkCount : 1;
+    pthread_mutex_init(&pipe.lock, NULL);
+    pthread_cond_init(&pipe.chunkDone, NULL);
+
+    // Stage 2: workers parse and validate
+    pthread_t ids[GRADEBOOK_MAX_THREADS];
+    int started = 0;
+    for (int t = 0; t < threads; t++) if (pthread_create(&ids[started], NULL, GradebookWorkerMain, &pipe) == 0) started++;
+    if (started == 0) GradebookWorkerMain(&pipe);      // No threads: parse everything here first
+
+    // Stage 3: dedupe chunks in file order as they finish
+    int rowCapacity = 0, rejectCapacity = 0, lineBase = 0;
+    for (int c = 0; c < pipe.chunkCount; c++) {
+        GradebookChunk *chunk = &pipe.chunks[c];
+        pthread_mutex_lock(&pipe.lock);
+        while (!chunk->done) pthread_cond_wait(&pipe.chunkDone, &pipe.lock);
+        pthread_mutex_unlock(&pipe.lock);
+
+        for (int k = 0; k < chunk->rejectCount; k++) {
+            GradebookReject reject = chunk->rejects[k];
+            reject.line += lineBase;
+            GradebookAddReject(out, &rejectCapacity, reject);
+        }
+        for (int k = 0; k < chunk->rowCount; k++) {
+            GradebookRow row = chunk->rows[k];
+            row.line += lineBase;
+            int existing = GradebookIndexFind(&out->index, out->rows, row.hash, row.student, row.subject);
+            if (existing >= 0) {
+                GradebookAddReject(out, &rejectCapacity, (GradebookReject){ out->rows[existing].line, GRADE_REJECT_DUPLICATE, out->rows[existing].offset });
+                out->rows[existing] = row;
+                continue;
+            }
+            if (out->rowCount == rowCapacity) {
+                rowCapacity = rowCapacity ? rowCapacity * 2 : (int)(size / 32) + 1024;    // About one row per 32 bytes
+                out->rows = (GradebookRow *)realloc(out->rows, sizeof(GradebookRow) * rowCapacity);
+                GradebookIndexReserve(&out->index, out->rows, rowCapacity);
+            }
+            out->rows[out->rowCount] = row;
+            GradebookIndexAdd(&out->index, out->rows, out->rowCount++);
+        }
+        lineBase += chunk->lines;
+        free(chunk->rows); free(chunk->rejects);
+    }
+    for (int t = 0; t < started; t++) pthread_join(ids[t], NULL);
+    pthread_mutex_destroy(&pipe.lock);
+    pthread_cond_destroy(&pipe.chunkDone);
+    free(pipe.chunks);
+
+    qsort(out->rejects, out->rejectCount, sizeof(GradebookReject), GradebookCompareRejects);
+    out->lines = lineBase;
+    out->threads = started > 0 ? started : 1;
+    out->ms = (MonoClockNow() - start) * 1000.0;
+}
+
+#endif // GRADEBOOK_H
@@ -0,0 +1,80 @@
+/*******************************************************************************************
+*
+* University Portal System - Cached Grid Layers
+*
+* Shared by the faculty (acadfac.c) and student (acadstu.c) Academics windows.
+*
+* - The timetable grids change only when their rows do, yet drawing one takes a few hundred
+*   rectangles, lines and text runs per frame once the week is busy. A GridCache draws
+*   such a layer once into a RenderTexture2D; every frame after that is one textured quad.
+* - The caller passes a version counter it bumps on every change. The layer is redrawn
+*   when that version or the layer's size differs from the cached one.
+* - Needs the window's GL context: create nothing before PortalInitWindow(), and call
+*   GridCacheUnload() before the module returns, since the shell keeps the context.
+*
+********************************************************************************************/
+
+#ifndef GRIDCACHE_H
+#define GRIDCACHE_H
+
+#include "raylib.h"
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct {
+    RenderTexture2D target;
+    int width, height;
+    int version;                        // Caller's version the texture was drawn for
+    bool loaded;
+} GridCache;
+
+//----------------------------------------------------------------------------------
+// Functions
+//----------------------------------------------------------------------------------
+
+// True if the texture still shows this version at this size
+static inline bool GridCacheFresh(const GridCache *cache, int width, int height, int version) {
+    return cache->loaded && cache->version == version && cache->width == width && cache->height == height;
+}
+
+static inline void GridCacheUnload(GridCache *cache) {
+    if (cache->loaded) UnloadRenderTexture(cache->target);
+    cache->loaded = false;
+}
+
+// Starts redrawing the layer: until GridCacheEnd(), draws go into the texture with (0,0)
+// at its top-left corner. False if no render texture could be made; the caller then
+// draws straight to the screen instead.
+static inline bool GridCacheBegin(GridCache *cache, int width, int height, Color background) {
+    if (cache->loaded && (cache->width != width || cache->height != height)) GridCacheUnload(cache);
+    if (!cache->loaded) {
+        cache->target = LoadRenderTexture(width, height);
+        cache->loaded = cache->target.id != 0;
+        cache->width = width; cache->height = height;
+    }
+    if (!cache->loaded) return false;
+    BeginTextureMode(cache->target);
+    ClearBackground(background);
+    return true;
+}
+
+static inline void GridCacheEnd(GridCache *cache, int version) {
+    // Translucent boxes leave alpha below 1 where they were blended in, which would let the
+    // screen show through the blit. Additive black raises alpha to 1 and keeps the colour.
+    BeginBlendMode(BLEND_ADDITIVE);
+    DrawRectangle(0, 0, cache->width, cache->height, BLACK);
+    EndBlendMode();
+    EndTextureMode();
+    cache->version = version;
+}
+
+// Blits the layer with its top-left corner at (x, y). Render textures are stored
+// bottom-up, hence the negative source height.
+static inline void GridCacheDraw(const GridCache *cache, int x, int y) {
+    if (!cache->loaded) return;
+    DrawTextureRec(cache->target.texture, (Rectangle){ 0, 0, (float)cache->width, -(float)cache->height }, (Vector2){ (float)x, (float)y }, WHITE);
+}
+
+#endif // GRIDCACHE_H
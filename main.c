@@ -5,19 +5,40 @@
 * This program provides the main authentication interface.
 * - Handles student and faculty login and registration.
 * - Launches 'afterreg.exe' for new users or 'afterlog.exe' for existing users.
+* - Credentials are loaded once into an in-memory hash index per user type,
+*   so login and duplicate-ID checks no longer rescan the .dat files.
+* - A persisted Bloom filter (students.bloom / faculties.bloom) rejects new IDs
+*   during registration without reading the credential file at all.
+* - Built with -DPORTAL_SHELL this is the first screen of portal.c, and the
+*   "start X.exe" hand-offs open the next screen in the same window.
+* - "main --login-bench [accounts]" times login and ID checks on a synthetic
+*   credential file of 1k, 100k and 1M accounts against the old per-call file scan.
 *
 * How to Compile (Windows with MinGW-w64):
 * This file does NOT take command-line arguments, so we use -mwindows to hide the console.
 * gcc login_system.c -o login_system -lraylib -lgdi32 -lwinmm -mwindows
+* (--login-bench prints its table to the console: build it without -mwindows, with -lpthread)
 *
 ********************************************************************************************/
 
 #include "raylib.h"
+#include "portal.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
+#include <sys/stat.h>
+#include "monoclock.h"   // --login-bench timings; needs -lpthread on MinGW
 
 #define MAX_INPUT_CHARS 50
+#define CRED_INDEX_INITIAL_CAPACITY 1024 // Must be a power of two
+#define BLOOM_MAGIC 0x324D4C42             // "BLM2"
+#define BLOOM_BITS_PER_ID 10               // ~0.8% false positives with 7 hashes
+#define BLOOM_HASH_COUNT 7
+#define BLOOM_MIN_BITS (64 * 1024)
+#define LOGIN_BENCH_ACCOUNTS 1000000       // Largest synthetic credential file
+#define LOGIN_BENCH_LOOKUPS 100000
+#define LOGIN_BENCH_SCANS 20               // The old file scan is slow, time a few
 
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
@@ -35,22 +56,64 @@ typedef struct {
     const char* label;
 } TextBox;
 
+// One slot of the open-addressing credential table
+typedef struct {
+    unsigned int hash;
+    int offset;             // Offset of "id\0password\0" in the pool, -1 if empty
+} CredentialSlot;
+
+// On-disk header of a .bloom file, followed by bitCount / 8 bytes of bits
+typedef struct {
+    unsigned int magic;
+    long sourceSize;        // Size and mtime of the credential file the bits describe
+    long sourceMtime;
+    int bitCount;
+    int idCount;
+} BloomHeader;
+
+// Persisted Bloom filter over the ids of one credential file
+typedef struct {
+    BloomHeader header;
+    unsigned char *bits;
+    bool loaded;
+    int maybeLookups;       // Lookups the filter could not reject
+    int falsePositives;     // ...of which the id turned out to be absent
+} BloomFilter;
+
+// Hash index over one credential file (students.dat or faculties.dat)
+typedef struct {
+    const char *filename;
+    const char *bloomFilename;
+    BloomFilter bloom;
+    CredentialSlot *slots;
+    int capacity;
+    int count;
+    char *pool;             // All ids and passwords, packed back to back
+    int poolSize;
+    int poolCapacity;
+    bool built;
+} CredentialIndex;
+
 //----------------------------------------------------------------------------------
 // Global Variables
 //----------------------------------------------------------------------------------
-const int screenWidth = 1920;
-const int screenHeight = 1080;
+static const int screenWidth = 1920;
+static const int screenHeight = 1080;
 
 AuthMode currentAuthMode = AUTH_MODE_LOGIN;
-UserType currentUserType = USER_TYPE_STUDENT;
+static UserType currentUserType = USER_TYPE_STUDENT;
 
 TextBox authTextBoxes[3];
 char authIdText[MAX_INPUT_CHARS + 1] = {0};
 char authPassText[MAX_INPUT_CHARS + 1] = {0};
 char authConfirmPassText[MAX_INPUT_CHARS + 1] = {0};
 
-char statusMessage[128] = "Please enter your credentials.";
-Color statusMessageColor = LIGHTGRAY;
+static char statusMessage[128] = "Please enter your credentials.";
+static bool closeLogin = false;         // A standalone hand-off started the next program
+static Color statusMessageColor = LIGHTGRAY;
+
+CredentialIndex studentIndex = { "students.dat", "students.bloom" };
+CredentialIndex facultyIndex = { "faculties.dat", "faculties.bloom" };
 
 //----------------------------------------------------------------------------------
 // Module Functions Declaration
@@ -58,33 +121,49 @@ Color statusMessageColor = LIGHTGRAY;
 static bool UserExists(const char *filename, const char *id);
 static bool AuthenticateUser(const char *filename, const char *id, const char *password);
 static void SaveUser(const char *filename, const char *id, const char *password);
+static CredentialIndex *SelectCredentialIndex(const char *filename);
+static CredentialIndex *GetCredentialIndex(const char *filename);
+static void BuildCredentialIndex(CredentialIndex *index);
+static void InsertCredential(CredentialIndex *index, const char *id, const char *password);
+static int FindCredential(CredentialIndex *index, const char *id);
+static void FreeCredentialIndex(CredentialIndex *index);
+static BloomFilter *GetBloomFilter(CredentialIndex *index);
+static void RebuildBloomFilter(CredentialIndex *index, long sourceSize, long sourceMtime);
+static bool BloomMayContain(const BloomFilter *bloom, const char *id);
+static void BloomAddAndPersist(CredentialIndex *index, const char *id);
 static void InitAuthTextBoxes(void);
 static void ClearTextBoxes(TextBox *textBoxes, int count);
 static void HandleTextBoxInput(TextBox *textBox);
 static void UpdateDrawFrame(void);
 static void UpdateAuthScreen(void);
 static void DrawAuthScreen(void);
+static int LoginBench(int maxAccounts);
 
 //----------------------------------------------------------------------------------
 // Main Entry Point
 //----------------------------------------------------------------------------------
-int main(void) {
-    InitWindow(screenWidth, screenHeight, "University Portal - Authentication");
+PORTAL_ENTRY(LoginMain) {
+    if (argc >= 2 && strcmp(argv[1], "--login-bench") == 0) return LoginBench(argc >= 3 ? atoi(argv[2]) : LOGIN_BENCH_ACCOUNTS);
+
+    PortalInitWindow(screenWidth, screenHeight, "University Portal - Authentication");
     InitAuthTextBoxes();
     SetTargetFPS(60);
 
-    while (!WindowShouldClose()) {
+    closeLogin = false;
+    while (!closeLogin && !WindowShouldClose()) {
         UpdateDrawFrame();
     }
 
-    CloseWindow();
+    FreeCredentialIndex(&studentIndex);
+    FreeCredentialIndex(&facultyIndex);
+    PortalCloseWindow();
     return 0;
 }
 
 //----------------------------------------------------------------------------------
 // Main Update and Draw Loop
 //----------------------------------------------------------------------------------
-void UpdateDrawFrame(void) {
+static void UpdateDrawFrame(void) {
     UpdateAuthScreen();
 
     BeginDrawing();
@@ -159,10 +238,14 @@ void UpdateAuthScreen(void) {
                 strcpy(statusMessage, "ID and Password cannot be empty.");
                 statusMessageColor = MAROON;
             } else if (AuthenticateUser(currentFilename, id, pass)) {
-                // Launch the after-login program and exit
+                // Launch the after-login program; standalone this closes the login portal,
+                // in the shell the dashboard has been closed (logged out) by now
                 sprintf(command, "start afterlog.exe %s %s", id, userTypeStr);
-                system(command);
-                exit(0); // Close the login portal
+                PortalLaunch(command);
+                closeLogin = PORTAL_HANDOFF_EXITS;
+                ClearTextBoxes(authTextBoxes, 3);
+                strcpy(statusMessage, "Logged out. Please enter your credentials.");
+                statusMessageColor = LIGHTGRAY;
             } else {
                 strcpy(statusMessage, "Invalid ID or Password.");
                 statusMessageColor = MAROON;
@@ -179,10 +262,15 @@ void UpdateAuthScreen(void) {
                 statusMessageColor = ORANGE;
             } else {
                 SaveUser(currentFilename, id, pass);
-                // Launch the after-registration program and exit
+                // Launch the after-registration program; standalone this closes the login
+                // portal, in the shell the profile screen has returned here to log in
                 sprintf(command, "start afterreg.exe %s %s %s", id, pass, userTypeStr);
-                system(command);
-                exit(0); // Close the login portal
+                PortalLaunch(command);
+                closeLogin = PORTAL_HANDOFF_EXITS;
+                currentAuthMode = AUTH_MODE_LOGIN;
+                ClearTextBoxes(authTextBoxes, 3);
+                strcpy(statusMessage, "Account created. Please log in.");
+                statusMessageColor = DARKGREEN;
             }
         }
     }
@@ -285,37 +373,298 @@ void HandleTextBoxInput(TextBox *textBox) {
     }
 }
 
-bool UserExists(const char *filename, const char *id) {
-    FILE *file = fopen(filename, "r");
-    if (file == NULL) return false;
+//----------------------------------------------------------------------------------
+// Credential Index Functions
+//----------------------------------------------------------------------------------
+
+// FNV-1a, good enough for short numeric IDs
+static unsigned int HashId(const char *id) {
+    unsigned int h = 2166136261u;
+    while (*id) {
+        h ^= (unsigned char)*id++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Maps a credential filename to its index without loading anything
+CredentialIndex *SelectCredentialIndex(const char *filename) {
+    return (strcmp(filename, facultyIndex.filename) == 0) ? &facultyIndex : &studentIndex;
+}
+
+// Returns the index for the given file, building it on first use
+CredentialIndex *GetCredentialIndex(const char *filename) {
+    CredentialIndex *index = SelectCredentialIndex(filename);
+    if (!index->built) BuildCredentialIndex(index);
+    return index;
+}
+
+// Reads the whole credential file once and hashes every id
+void BuildCredentialIndex(CredentialIndex *index) {
+    double startTime = GetTime();
+
+    index->capacity = CRED_INDEX_INITIAL_CAPACITY;
+    index->slots = (CredentialSlot *)malloc(index->capacity * sizeof(CredentialSlot));
+    for (int i = 0; i < index->capacity; i++) index->slots[i].offset = -1;
+    index->count = 0;
+    index->poolSize = 0;
+    index->built = true;
+
+    FILE *file = fopen(index->filename, "r");
+    if (file == NULL) return; // No accounts yet, the index stays empty
+
     char fileId[MAX_INPUT_CHARS + 1], filePass[MAX_INPUT_CHARS + 1];
-    bool found = false;
-    while (fscanf(file, "%s %s", fileId, filePass) == 2) {
-        if (strcmp(fileId, id) == 0) {
-            found = true;
-            break;
-        }
+    while (fscanf(file, "%50s %50s", fileId, filePass) == 2) {
+        InsertCredential(index, fileId, filePass);
     }
     fclose(file);
-    return found;
+
+    TraceLog(LOG_INFO, "Indexed %d accounts from %s in %.2f ms.",
+             index->count, index->filename, (GetTime() - startTime) * 1000.0);
 }
 
-bool AuthenticateUser(const char *filename, const char *id, const char *password) {
-    FILE *file = fopen(filename, "r");
-    if (file == NULL) return false;
-    char fileId[MAX_INPUT_CHARS + 1], filePass[MAX_INPUT_CHARS + 1];
-    bool authenticated = false;
-    while (fscanf(file, "%s %s", fileId, filePass) == 2) {
-        if (strcmp(fileId, id) == 0 && strcmp(filePass, password) == 0) {
-            authenticated = true;
-            break;
+// Doubles the table and re-inserts every occupied slot
+static void GrowCredentialIndex(CredentialIndex *index) {
+    int oldCapacity = index->capacity;
+    CredentialSlot *oldSlots = index->slots;
+
+    index->capacity = oldCapacity * 2;
+    index->slots = (CredentialSlot *)malloc(index->capacity * sizeof(CredentialSlot));
+    for (int i = 0; i < index->capacity; i++) index->slots[i].offset = -1;
+
+    unsigned int mask = index->capacity - 1;
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldSlots[i].offset < 0) continue;
+        unsigned int pos = oldSlots[i].hash & mask;
+        while (index->slots[pos].offset >= 0) pos = (pos + 1) & mask;
+        index->slots[pos] = oldSlots[i];
+    }
+    free(oldSlots);
+}
+
+// Adds an id/password pair; the first entry wins if the id is already present
+void InsertCredential(CredentialIndex *index, const char *id, const char *password) {
+    if (FindCredential(index, id) >= 0) return;
+    if ((index->count + 1) * 10 > index->capacity * 7) GrowCredentialIndex(index); // Keep load under 70%
+
+    int idLen = (int)strlen(id) + 1;
+    int passLen = (int)strlen(password) + 1;
+    if (index->poolSize + idLen + passLen > index->poolCapacity) {
+        int newCapacity = index->poolCapacity ? index->poolCapacity * 2 : 16 * 1024;
+        while (newCapacity < index->poolSize + idLen + passLen) newCapacity *= 2;
+        index->pool = (char *)realloc(index->pool, newCapacity);
+        index->poolCapacity = newCapacity;
+    }
+    int offset = index->poolSize;
+    memcpy(index->pool + offset, id, idLen);
+    memcpy(index->pool + offset + idLen, password, passLen);
+    index->poolSize += idLen + passLen;
+
+    unsigned int hash = HashId(id);
+    unsigned int mask = index->capacity - 1;
+    unsigned int pos = hash & mask;
+    while (index->slots[pos].offset >= 0) pos = (pos + 1) & mask;
+    index->slots[pos].hash = hash;
+    index->slots[pos].offset = offset;
+    index->count++;
+}
+
+// Returns the pool offset of the id, or -1 if it is not indexed
+int FindCredential(CredentialIndex *index, const char *id) {
+    if (index->slots == NULL) return -1;
+    unsigned int hash = HashId(id);
+    unsigned int mask = index->capacity - 1;
+    unsigned int pos = hash & mask;
+    while (index->slots[pos].offset >= 0) {
+        if (index->slots[pos].hash == hash && strcmp(index->pool + index->slots[pos].offset, id) == 0) {
+            return index->slots[pos].offset;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+void FreeCredentialIndex(CredentialIndex *index) {
+    free(index->slots);
+    free(index->pool);
+    index->slots = NULL;
+    index->pool = NULL;
+    index->capacity = index->count = 0;
+    index->poolSize = index->poolCapacity = 0;
+    index->built = false;
+
+    if (index->bloom.maybeLookups > 0) {
+        TraceLog(LOG_INFO, "%s: %d of %d possible hits were false positives.",
+                 index->bloomFilename, index->bloom.falsePositives, index->bloom.maybeLookups);
+    }
+    free(index->bloom.bits);
+    index->bloom.bits = NULL;
+    index->bloom.loaded = false;
+}
+
+//----------------------------------------------------------------------------------
+// Bloom Filter Functions
+//----------------------------------------------------------------------------------
+
+// Size and mtime of a file, so an edit that keeps the size is still noticed; -1 / 0 if missing
+static void GetFileStamp(const char *filename, long *size, long *mtime) {
+    struct stat st;
+    if (stat(filename, &st) == 0) { *size = (long)st.st_size; *mtime = (long)st.st_mtime; }
+    else { *size = -1; *mtime = 0; }
+}
+
+// Second hash for double hashing, independent of HashId
+static unsigned int HashId2(const char *id) {
+    unsigned int h = 5381;
+    while (*id) h = h * 33 + (unsigned char)*id++;
+    return h | 1; // Odd, so the probe sequence never collapses
+}
+
+// Expected false positive rate for n ids in m bits with k hashes
+static double BloomExpectedRate(const BloomHeader *header) {
+    if (header->bitCount == 0) return 1.0;
+    double fill = 1.0 - exp(-(double)BLOOM_HASH_COUNT * header->idCount / header->bitCount);
+    return pow(fill, BLOOM_HASH_COUNT);
+}
+
+// Loads the persisted filter, rebuilding it when the credential file changed
+// behind its back or the filter has become too full to be useful
+BloomFilter *GetBloomFilter(CredentialIndex *index) {
+    BloomFilter *bloom = &index->bloom;
+    if (bloom->loaded) return bloom;
+
+    long sourceSize, sourceMtime;
+    GetFileStamp(index->filename, &sourceSize, &sourceMtime);
+    FILE *file = fopen(index->bloomFilename, "rb");
+    if (file != NULL) {
+        BloomHeader header;
+        bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                     header.magic == BLOOM_MAGIC &&
+                     header.sourceSize == sourceSize && header.sourceMtime == sourceMtime &&
+                     header.bitCount >= BLOOM_MIN_BITS &&
+                     (long)header.idCount * BLOOM_BITS_PER_ID <= (long)header.bitCount * 2;
+        if (valid) {
+            bloom->bits = (unsigned char *)malloc(header.bitCount / 8);
+            valid = fread(bloom->bits, 1, header.bitCount / 8, file) == (size_t)(header.bitCount / 8);
+            if (valid) {
+                bloom->header = header;
+                bloom->loaded = true;
+            } else {
+                free(bloom->bits);
+                bloom->bits = NULL;
+            }
         }
+        fclose(file);
+    }
+
+    if (!bloom->loaded) RebuildBloomFilter(index, sourceSize, sourceMtime);
+    TraceLog(LOG_INFO, "%s: %d ids in %d bits, expected false positive rate %.3f%%.",
+             index->bloomFilename, bloom->header.idCount, bloom->header.bitCount,
+             BloomExpectedRate(&bloom->header) * 100.0);
+    return bloom;
+}
+
+static void BloomSetBits(BloomFilter *bloom, const char *id, int *touchedBytes) {
+    unsigned int h1 = HashId(id);
+    unsigned int h2 = HashId2(id);
+    for (int i = 0; i < BLOOM_HASH_COUNT; i++) {
+        unsigned int bit = (h1 + i * h2) % (unsigned int)bloom->header.bitCount;
+        bloom->bits[bit / 8] |= (unsigned char)(1u << (bit % 8));
+        if (touchedBytes) touchedBytes[i] = (int)(bit / 8);
+    }
+}
+
+// Sizes a fresh filter from one pass over the credential file and saves it
+void RebuildBloomFilter(CredentialIndex *index, long sourceSize, long sourceMtime) {
+    BloomFilter *bloom = &index->bloom;
+    int idCount = 0;
+    char fileId[MAX_INPUT_CHARS + 1], filePass[MAX_INPUT_CHARS + 1];
+
+    FILE *file = fopen(index->filename, "r");
+    if (file != NULL) {
+        while (fscanf(file, "%50s %50s", fileId, filePass) == 2) idCount++;
+    }
+
+    int bitCount = BLOOM_MIN_BITS;
+    while ((long)bitCount < (long)idCount * BLOOM_BITS_PER_ID * 2) bitCount *= 2; // Room to grow
+
+    free(bloom->bits);
+    bloom->bits = (unsigned char *)calloc(bitCount / 8, 1);
+    bloom->header = (BloomHeader){ BLOOM_MAGIC, sourceSize, sourceMtime, bitCount, idCount };
+    bloom->loaded = true;
+
+    if (file != NULL) {
+        rewind(file);
+        while (fscanf(file, "%50s %50s", fileId, filePass) == 2) BloomSetBits(bloom, fileId, NULL);
+        fclose(file);
+    }
+
+    FILE *out = fopen(index->bloomFilename, "wb");
+    if (out == NULL) {
+        TraceLog(LOG_WARNING, "Could not write %s.", index->bloomFilename);
+        return;
+    }
+    fwrite(&bloom->header, sizeof(bloom->header), 1, out);
+    fwrite(bloom->bits, 1, bitCount / 8, out);
+    fclose(out);
+}
+
+bool BloomMayContain(const BloomFilter *bloom, const char *id) {
+    unsigned int h1 = HashId(id);
+    unsigned int h2 = HashId2(id);
+    for (int i = 0; i < BLOOM_HASH_COUNT; i++) {
+        unsigned int bit = (h1 + i * h2) % (unsigned int)bloom->header.bitCount;
+        if (!(bloom->bits[bit / 8] & (1u << (bit % 8)))) return false;
+    }
+    return true;
+}
+
+// Adds a freshly appended id and writes back only the header and changed bytes
+void BloomAddAndPersist(CredentialIndex *index, const char *id) {
+    BloomFilter *bloom = GetBloomFilter(index);
+    int touchedBytes[BLOOM_HASH_COUNT];
+    BloomSetBits(bloom, id, touchedBytes);
+    bloom->header.idCount++;
+    GetFileStamp(index->filename, &bloom->header.sourceSize, &bloom->header.sourceMtime);
+
+    FILE *file = fopen(index->bloomFilename, "r+b");
+    if (file == NULL) return; // Next load will see the stale stamp and rebuild
+    fwrite(&bloom->header, sizeof(bloom->header), 1, file);
+    for (int i = 0; i < BLOOM_HASH_COUNT; i++) {
+        fseek(file, (long)sizeof(BloomHeader) + touchedBytes[i], SEEK_SET);
+        fputc(bloom->bits[touchedBytes[i]], file);
     }
     fclose(file);
-    return authenticated;
+}
+
+//----------------------------------------------------------------------------------
+// Credential File Functions
+//----------------------------------------------------------------------------------
+bool UserExists(const char *filename, const char *id) {
+    CredentialIndex *index = SelectCredentialIndex(filename);
+    BloomFilter *bloom = GetBloomFilter(index);
+    if (!BloomMayContain(bloom, id)) return false; // Definitely new, file untouched
+
+    // Possible hit: confirm against the exact index
+    bloom->maybeLookups++;
+    bool found = FindCredential(GetCredentialIndex(filename), id) >= 0;
+    if (!found) bloom->falsePositives++;
+    return found;
+}
+
+bool AuthenticateUser(const char *filename, const char *id, const char *password) {
+    CredentialIndex *index = GetCredentialIndex(filename);
+    int offset = FindCredential(index, id);
+    if (offset < 0) return false;
+    const char *storedPass = index->pool + offset + strlen(id) + 1;
+    return strcmp(storedPass, password) == 0;
 }
 
 void SaveUser(const char *filename, const char *id, const char *password) {
+    // Load the filter before appending so its stamp check still matches the file
+    CredentialIndex *index = SelectCredentialIndex(filename);
+    GetBloomFilter(index);
+
     FILE *file = fopen(filename, "a");
     if (file == NULL) {
         strcpy(statusMessage, "Error: Could not open data file.");
@@ -324,5 +673,112 @@ void SaveUser(const char *filename, const char *id, const char *password) {
     }
     fprintf(file, "%s %s\n", id, password);
     fclose(file);
+
+    // Keep the resident index and the Bloom filter in step with the file
+    if (index->built) InsertCredential(index, id, password);
+    BloomAddAndPersist(index, id);
+}
+
+//----------------------------------------------------------------------------------
+// Login Bench
+//----------------------------------------------------------------------------------
+
+// The lookup main.c used before the index: reopen the file and fscanf up to the id
+static bool ScanCredentialFile(const char *filename, const char *id, const char *password) {
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) return false;
+    char fileId[MAX_INPUT_CHARS + 1], filePass[MAX_INPUT_CHARS + 1];
+    bool found = false;
+    while (fscanf(file, "%50s %50s", fileId, filePass) == 2) {
+        if (strcmp(fileId, id) == 0 && strcmp(filePass, password) == 0) {
+            found = true;
+            break;
+        }
+    }
+    fclose(file);
+    return found;
 }
 
+// Synthetic credentials in login_bench.* (removed afterwards), read through the
+// student index. Times the first-use index and filter builds, then logins, checks of
+// registered ids and of new ids, against the old scan of the file for each login.
+static int LoginBench(int maxAccounts) {
+    const int sizes[] = { 1000, 100000, LOGIN_BENCH_ACCOUNTS };
+    const char *savedFilename = studentIndex.filename;
+    const char *savedBloomFilename = studentIndex.bloomFilename;
+    FreeCredentialIndex(&studentIndex);
+    studentIndex.filename = "login_bench.dat";
+    studentIndex.bloomFilename = "login_bench.bloom";
+
+    SetTraceLogLevel(LOG_WARNING);
+    printf("accounts   index ms   bloom ms   login us   known us   new us     scan us      errors\n");
+
+    char id[MAX_INPUT_CHARS + 1], pass[MAX_INPUT_CHARS + 1];
+    bool ran = false;
+    for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+        int accounts = (sizes[s] < maxAccounts) ? sizes[s] : maxAccounts;
+        if (accounts < 1 || (ran && accounts <= sizes[s - 1])) break;
+        ran = true;
+
+        FILE *file = fopen(studentIndex.filename, "w");
+        if (file == NULL) { printf("Could not write %s.\n", studentIndex.filename); break; }
+        for (int i = 0; i < accounts; i++) fprintf(file, "S%08d pw%d\n", i, i * 7919);
+        fclose(file);
+        remove(studentIndex.bloomFilename);
+
+        double start = MonoClockNow();
+        GetCredentialIndex(studentIndex.filename);
+        double indexMs = (MonoClockNow() - start) * 1000.0;
+        start = MonoClockNow();
+        GetBloomFilter(&studentIndex);
+        double bloomMs = (MonoClockNow() - start) * 1000.0;
+
+        int errors = 0;
+        unsigned int seed = 12345;
+        start = MonoClockNow();
+        for (int i = 0; i < LOGIN_BENCH_LOOKUPS; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            int n = (int)((seed >> 8) % (unsigned int)accounts);
+            snprintf(id, sizeof(id), "S%08d", n);
+            snprintf(pass, sizeof(pass), "pw%d", n * 7919);
+            if (!AuthenticateUser(studentIndex.filename, id, pass)) errors++;
+        }
+        double loginUs = (MonoClockNow() - start) * 1e6 / LOGIN_BENCH_LOOKUPS;
+
+        start = MonoClockNow();
+        for (int i = 0; i < LOGIN_BENCH_LOOKUPS; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            snprintf(id, sizeof(id), "S%08d", (int)((seed >> 8) % (unsigned int)accounts));
+            if (!UserExists(studentIndex.filename, id)) errors++;
+        }
+        double knownUs = (MonoClockNow() - start) * 1e6 / LOGIN_BENCH_LOOKUPS;
+
+        // Registration: ids past the last account, mostly rejected by the filter alone
+        start = MonoClockNow();
+        for (int i = 0; i < LOGIN_BENCH_LOOKUPS; i++) {
+            snprintf(id, sizeof(id), "S%08d", accounts + i);
+            if (UserExists(studentIndex.filename, id)) errors++;
+        }
+        double newUs = (MonoClockNow() - start) * 1e6 / LOGIN_BENCH_LOOKUPS;
+
+        start = MonoClockNow();
+        for (int i = 0; i < LOGIN_BENCH_SCANS; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            int n = (int)((seed >> 8) % (unsigned int)accounts);
+            snprintf(id, sizeof(id), "S%08d", n);
+            snprintf(pass, sizeof(pass), "pw%d", n * 7919);
+            if (!ScanCredentialFile(studentIndex.filename, id, pass)) errors++;
+        }
+        double scanUs = (MonoClockNow() - start) * 1e6 / LOGIN_BENCH_SCANS;
+
+        printf("%-10d %-10.1f %-10.1f %-10.3f %-10.3f %-10.3f %-12.1f %d\n",
+               accounts, indexMs, bloomMs, loginUs, knownUs, newUs, scanUs, errors);
+        FreeCredentialIndex(&studentIndex);
+    }
+
+    remove(studentIndex.filename);
+    remove(studentIndex.bloomFilename);
+    studentIndex.filename = savedFilename;
+    studentIndex.bloomFilename = savedBloomFilename;
+    return 0;
+}
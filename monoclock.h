@@ -0,0 +1,26 @@
+/*******************************************************************************************
+*
+* University Portal System - Monotonic Clock
+*
+* The one timer behind the benches and solver deadlines (acadfac.c, adminstu.c,
+* program_structure.c, analytics.h, gradebook.h). Unlike raylib's GetTime() it also
+* works without a window, so the CLI modes can use it.
+*
+* clock_gettime() comes from winpthreads on MinGW-w64: every program that includes
+* this header links with -lpthread, even one that starts no threads (adminstu.c).
+*
+********************************************************************************************/
+
+#ifndef MONOCLOCK_H
+#define MONOCLOCK_H
+
+#include <time.h>
+
+// Seconds since an arbitrary start, only meaningful as a difference
+static inline double MonoClockNow(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+#endif // MONOCLOCK_H
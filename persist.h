@@ -0,0 +1,167 @@
+/*******************************************************************************************
+*
+* University Portal System - Background File Writer
+*
+* Takes file rewrites off the render thread. A module formats a table into a
+* PersistBuffer (in memory, cheap) and hands it to PersistQueue(); a writer thread
+* puts it on disk.
+*
+* - Each file is written to "<path>.tmp" and renamed over the old one, so a crash
+*   mid-write leaves the previous version rather than a torn file.
+* - A newer buffer for a path that is still queued replaces the older one: only the
+*   latest contents of a file are ever written.
+* - PersistStop() writes everything still queued before it returns.
+*
+* Uses pthreads (winpthreads on MinGW), like the timetable generator.
+*
+********************************************************************************************/
+
+#ifndef PERSIST_H
+#define PERSIST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#if defined(_WIN32)
+    // Same hand-declared Win32 style as datacache.h, so <windows.h> does not clash with raylib.h
+    __declspec(dllimport) int __stdcall MoveFileExA(const char *existing, const char *replacement, unsigned long flags);
+    #define PERSIST_MOVEFILE_FLAGS 0x9  // MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH
+#endif
+
+#define PERSIST_MAX_PATH 256
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct {
+    char *data;
+    long length, capacity;
+} PersistBuffer;
+
+typedef struct PersistJob {
+    char path[PERSIST_MAX_PATH];
+    PersistBuffer buffer;
+    struct PersistJob *next;
+} PersistJob;
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    PersistJob *queue;                  // FIFO, at most one job per path
+    bool running, stopping;
+    int written, failed;                // Files put on disk / failed writes, for the log
+} PersistWriter;
+
+//----------------------------------------------------------------------------------
+// Buffers
+//----------------------------------------------------------------------------------
+static inline void PersistAppend(PersistBuffer *buffer, const char *format, ...) {
+    for (;;) {
+        long room = buffer->capacity - buffer->length;
+        va_list args;
+        va_start(args, format);
+        int length = (room > 0) ? vsnprintf(buffer->data + buffer->length, room, format, args) : vsnprintf(NULL, 0, format, args);
+        va_end(args);
+        if (length < 0) return;
+        if (length < room) { buffer->length += length; return; }
+
+        long capacity = buffer->capacity ? buffer->capacity : 4096;
+        while (capacity - buffer->length <= length) capacity *= 2;
+        buffer->data = (char *)realloc(buffer->data, capacity);
+        buffer->capacity = capacity;
+    }
+}
+
+static inline void PersistBufferFree(PersistBuffer *buffer) {
+    free(buffer->data);
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+// Writes a whole file through "<path>.tmp" and a rename
+static inline bool PersistWriteFile(const char *path, const char *data, long length) {
+    char tempPath[PERSIST_MAX_PATH + 8];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE *file = fopen(tempPath, "wb");
+    bool written = (file != NULL) && (fwrite(data, 1, length, file) == (size_t)length);
+    if (file) written = (fclose(file) == 0) && written;
+    if (!written) { remove(tempPath); return false; }
+
+#if defined(_WIN32)
+    return MoveFileExA(tempPath, path, PERSIST_MOVEFILE_FLAGS) != 0;
+#else
+    return rename(tempPath, path) == 0;
+#endif
+}
+
+//----------------------------------------------------------------------------------
+// Writer Thread
+//----------------------------------------------------------------------------------
+static inline void *PersistWriterMain(void *arg) {
+    PersistWriter *writer = (PersistWriter *)arg;
+    pthread_mutex_lock(&writer->lock);
+    for (;;) {
+        while (writer->queue == NULL && !writer->stopping) pthread_cond_wait(&writer->wake, &writer->lock);
+        PersistJob *job = writer->queue;
+        if (job == NULL) break;         // Stopping and drained
+        writer->queue = job->next;
+        pthread_mutex_unlock(&writer->lock);
+
+        bool ok = PersistWriteFile(job->path, job->buffer.data ? job->buffer.data : "", job->buffer.length);
+        PersistBufferFree(&job->buffer);
+        free(job);
+
+        pthread_mutex_lock(&writer->lock);
+        if (ok) writer->written++; else writer->failed++;
+    }
+    pthread_mutex_unlock(&writer->lock);
+    return NULL;
+}
+
+static inline void PersistStart(PersistWriter *writer) {
+    memset(writer, 0, sizeof(*writer));
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->wake, NULL);
+    writer->running = (pthread_create(&writer->thread, NULL, PersistWriterMain, writer) == 0);
+}
+
+// Takes ownership of the buffer's memory and leaves it empty
+static inline void PersistQueue(PersistWriter *writer, const char *path, PersistBuffer *buffer) {
+    if (!writer->running) {             // No thread: write on the caller's thread instead
+        if (PersistWriteFile(path, buffer->data ? buffer->data : "", buffer->length)) writer->written++; else writer->failed++;
+        PersistBufferFree(buffer);
+        return;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+    PersistJob **link = &writer->queue;
+    while (*link && strcmp((*link)->path, path) != 0) link = &(*link)->next;
+    if (*link) PersistBufferFree(&(*link)->buffer);      // Superseded before it was written
+    else {
+        *link = (PersistJob *)calloc(1, sizeof(PersistJob));
+        strncpy((*link)->path, path, PERSIST_MAX_PATH - 1);
+    }
+    (*link)->buffer = *buffer;
+    memset(buffer, 0, sizeof(*buffer));
+    pthread_cond_signal(&writer->wake);
+    pthread_mutex_unlock(&writer->lock);
+}
+
+// Writes whatever is still queued, then ends the thread
+static inline void PersistStop(PersistWriter *writer) {
+    if (!writer->running) return;
+    pthread_mutex_lock(&writer->lock);
+    writer->stopping = true;
+    pthread_cond_signal(&writer->wake);
+    pthread_mutex_unlock(&writer->lock);
+    pthread_join(writer->thread, NULL);
+    pthread_mutex_destroy(&writer->lock);
+    pthread_cond_destroy(&writer->wake);
+    writer->running = false;
+}
+
+#endif // PERSIST_H
@@ -0,0 +1,271 @@
+/*******************************************************************************************
+*
+* University Portal System - Single-Process Shell
+*
+* Hosts every portal screen in one process and one window. Each program file is
+* compiled with -DPORTAL_SHELL, which turns its main() into a module entry point
+* (see portal.h), and its system("start X.exe ...") hand-offs come back here.
+*
+* - No process spawn, no new InitWindow and no GL context per screen switch.
+* - One loaded data model: a module keeps the tables it read (credential index, admin
+*   user tables, academics tables, fees, complaints, announcements) for its next visit.
+*   The shell counts writes to each data file (PortalFileWritten()); a module reads
+*   its files again only when one of them was written by another screen since.
+*   Opening a screen a second time reads nothing from disk.
+* - Closing a module's screen (Esc or the window close button) returns to the
+*   screen that launched it, like closing its window did before.
+* - Every in-process launch logs how long the module took to reach its first frame.
+*   "portal --startup-bench [student-id] [runs]" times every screen spawned as its own
+*   process (spawn, InitWindow, load) against opening it in-process, first and again.
+*
+* How to Compile (Windows with MinGW-w64):
+* gcc -DPORTAL_SHELL portal.c main.c afterlog.c afterreg.c adminad.c adminstu.c acadfac.c
+*     acadstu.c ann_admin.c ann_student.c program_structure.c -o portal
+*     -lraylib -lgdi32 -lwinmm -lpthread
+*
+********************************************************************************************/
+
+#define PORTAL_IMPLEMENTATION     // Keep the real WindowShouldClose() in this file
+#include "portal.h"
+#include <stdio.h>
+#include <string.h>
+#include "monoclock.h"
+
+#define PORTAL_MAX_ARGS 16
+#define PORTAL_COMMAND_LENGTH 256
+#define PORTAL_MAX_FILES 64
+#define PORTAL_BENCH_STUDENT "202501001"
+#define PORTAL_BENCH_RUNS 5
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef int (*PortalEntry)(int argc, char *argv[]);
+
+// The executables the programs launch each other as, and the module behind each
+typedef struct {
+    const char *exeName;
+    PortalEntry entry;
+} PortalModule;
+
+// Writes to one data file by screens in this process
+typedef struct {
+    char path[PORTAL_COMMAND_LENGTH];
+    unsigned int version;
+} PortalFile;
+
+//----------------------------------------------------------------------------------
+// Global Variables
+//----------------------------------------------------------------------------------
+static const PortalModule modules[] = {
+    { "main.exe",           LoginMain },
+    { "afterlog.exe",       DashboardMain },
+    { "afterreg.exe",       ProfileSetupMain },
+    { "admin_portal.exe",   AdminPortalMain },
+    { "student_portal.exe", StudentPortalMain },
+    { "acadfac.exe",        AcademicsFacultyMain },
+    { "acadstu.exe",        AcademicsStudentMain },
+    { "anadm.exe",          AnnouncementsAdminMain },
+    { "anstu.exe",          AnnouncementsStudentMain },
+    { "prostr.exe",         ProgramStructureMain },
+};
+
+static char currentTitle[PORTAL_COMMAND_LENGTH] = "University Portal";
+static double launchStart = 0.0;        // When the module being opened was launched
+static const char *launchName = NULL;
+static double lastReadyMs = 0.0;        // Launch to first frame of the last module opened
+static bool closeAtFirstFrame = false;  // --startup-bench: close each module once it is ready
+
+static PortalFile files[PORTAL_MAX_FILES];
+static int fileCount = 0;
+static unsigned int untrackedVersion = 0;   // Shared by the files past PORTAL_MAX_FILES
+
+// The screens --startup-bench opens, as the others launch them (%s is the student ID)
+static const char *const benchCommands[] = {
+    "main.exe", "afterlog.exe %s student", "admin_portal.exe 28 10", "student_portal.exe %s",
+    "acadfac.exe 28 10", "acadstu.exe %s", "anadm.exe 28 10", "anstu.exe %s Student", "prostr.exe 28 10",
+};
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+static const PortalModule *FindModule(const char *exeName);
+static PortalFile *FindFile(const char *path, bool add);
+static int StartupChild(int argc, char *argv[]);
+static int StartupBench(const char *self, const char *studentId, int runs);
+
+//----------------------------------------------------------------------------------
+// Main Entry Point
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "--startup-child") == 0) return StartupChild(argc - 2, argv + 2);
+    if (argc >= 2 && strcmp(argv[1], "--startup-bench") == 0) {
+        return StartupBench(argv[0], argc >= 3 ? argv[2] : PORTAL_BENCH_STUDENT, argc >= 4 ? atoi(argv[3]) : PORTAL_BENCH_RUNS);
+    }
+
+    InitWindow(1920, 1080, currentTitle);
+
+    // Same first screen as before: the login portal
+    char *loginArgv[] = { "main.exe", NULL };
+    int result = LoginMain(1, loginArgv);
+
+    CloseWindow();
+    return result;
+}
+
+//----------------------------------------------------------------------------------
+// Shell Functions
+//----------------------------------------------------------------------------------
+static const PortalModule *FindModule(const char *exeName) {
+    for (int i = 0; i < (int)(sizeof(modules) / sizeof(modules[0])); i++) {
+        if (strcmp(modules[i].exeName, exeName) == 0) return &modules[i];
+    }
+    return NULL;
+}
+
+// Splits "start X.exe arg1 arg2" into argv and runs X's module until it closes
+void PortalLaunch(const char *command) {
+    char buffer[PORTAL_COMMAND_LENGTH];
+    strncpy(buffer, command, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    char *args[PORTAL_MAX_ARGS + 1];
+    int argCount = 0;
+    for (char *token = strtok(buffer, " "); token != NULL && argCount < PORTAL_MAX_ARGS; token = strtok(NULL, " ")) {
+        if (argCount == 0 && strcmp(token, "start") == 0) continue;
+        args[argCount++] = token;
+    }
+    args[argCount] = NULL;
+
+    const PortalModule *module = (argCount > 0) ? FindModule(args[0]) : NULL;
+    if (module == NULL) {
+        TraceLog(LOG_WARNING, "PORTAL: No module for \"%s\", spawning it instead.", command);
+        system(command);
+        return;
+    }
+
+    // The module sets its own title; put ours back once it closes
+    char parentTitle[PORTAL_COMMAND_LENGTH];
+    strcpy(parentTitle, currentTitle);
+
+    launchStart = GetTime();
+    launchName = module->exeName;
+    lastReadyMs = 0.0;
+    module->entry(argCount, args);
+
+    strcpy(currentTitle, parentTitle);
+    SetWindowTitle(currentTitle);
+    TraceLog(LOG_INFO, "PORTAL: %s closed, back to \"%s\".", module->exeName, currentTitle);
+}
+
+// Called by each module where it used to call InitWindow()
+void PortalInitWindow(int width, int height, const char *title) {
+    if (!IsWindowReady()) InitWindow(width, height, title);
+    else if (GetScreenWidth() != width || GetScreenHeight() != height) SetWindowSize(width, height);
+
+    strncpy(currentTitle, title, sizeof(currentTitle) - 1);
+    SetWindowTitle(currentTitle);
+}
+
+// Modules call this once per frame; the first call after a launch means the
+// module has loaded its data and is about to draw
+bool PortalWindowShouldClose(void) {
+    if (launchName != NULL) {
+        lastReadyMs = (GetTime() - launchStart) * 1000.0;
+        TraceLog(LOG_INFO, "PORTAL: %s ready in-process in %.2f ms.", launchName, lastReadyMs);
+        launchName = NULL;
+        if (closeAtFirstFrame) return true;
+    }
+    return WindowShouldClose();
+}
+
+//----------------------------------------------------------------------------------
+// Shared Data Model
+//----------------------------------------------------------------------------------
+static PortalFile *FindFile(const char *path, bool add) {
+    for (int i = 0; i < fileCount; i++) {
+        if (strcmp(files[i].path, path) == 0) return &files[i];
+    }
+    if (!add || fileCount == PORTAL_MAX_FILES) return NULL;
+    PortalFile *file = &files[fileCount++];
+    snprintf(file->path, sizeof(file->path), "%s", path);
+    file->version = 0;
+    return file;
+}
+
+// 0 until a screen writes the file. Past PORTAL_MAX_FILES, a write to any untracked
+// file counts for all of them, so a module may reload for nothing but never misses one.
+unsigned int PortalFileVersion(const char *path) {
+    const PortalFile *file = FindFile(path, false);
+    if (file != NULL) return file->version;
+    return (fileCount == PORTAL_MAX_FILES) ? untrackedVersion : 0;
+}
+
+// Called by a screen after it wrote a data file, so others drop what they loaded from it
+void PortalFileWritten(const char *path) {
+    PortalFile *file = FindFile(path, true);
+    if (file != NULL) file->version++;
+    else untrackedVersion++;
+}
+
+//----------------------------------------------------------------------------------
+// Startup Bench
+//----------------------------------------------------------------------------------
+
+// "portal --startup-child X.exe args": what a standalone X.exe costs, from process start
+// through InitWindow and its loads to the first frame, then exit
+static int StartupChild(int argc, char *argv[]) {
+    char command[PORTAL_COMMAND_LENGTH] = "start";
+    for (int i = 0; i < argc; i++) {
+        size_t length = strlen(command);
+        snprintf(command + length, sizeof(command) - length, " %s", argv[i]);
+    }
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    closeAtFirstFrame = true;
+    PortalLaunch(command);          // The module's PortalInitWindow() creates the window
+    if (IsWindowReady()) CloseWindow();
+    return 0;
+}
+
+// Opens every screen with the data files in the current directory: `runs` times as a
+// child process (the old system("start X.exe") chain, waited for here), then once and
+// `runs` more times in this process. Each in-process visit closes at its first frame.
+static int StartupBench(const char *self, const char *studentId, int runs) {
+    if (runs < 1) runs = 1;
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(1920, 1080, currentTitle);
+    closeAtFirstFrame = true;
+
+    printf("%-30s %-12s %-14s %s\n", "screen", "spawn ms", "shell first", "shell again");
+    char command[PORTAL_COMMAND_LENGTH], child[PORTAL_COMMAND_LENGTH * 2];
+    double spawnTotal = 0.0, firstTotal = 0.0, againTotal = 0.0;
+    int count = (int)(sizeof(benchCommands) / sizeof(benchCommands[0]));
+    for (int i = 0; i < count; i++) {
+        char args[PORTAL_COMMAND_LENGTH - 8];   // Room for "start "
+        snprintf(args, sizeof(args), benchCommands[i], studentId);
+
+        double start = MonoClockNow();
+        for (int r = 0; r < runs; r++) {
+            snprintf(child, sizeof(child), "\"%s\" --startup-child %s", self, args);
+            if (system(child) != 0) TraceLog(LOG_WARNING, "PORTAL: \"%s\" failed.", child);
+        }
+        double spawnMs = (MonoClockNow() - start) * 1000.0 / runs;
+
+        snprintf(command, sizeof(command), "start %s", args);
+        PortalLaunch(command);
+        double firstMs = lastReadyMs, againMs = 0.0;
+        for (int r = 0; r < runs; r++) {
+            PortalLaunch(command);
+            againMs += lastReadyMs / runs;
+        }
+
+        printf("%-30s %-12.2f %-14.2f %.2f\n", args, spawnMs, firstMs, againMs);
+        spawnTotal += spawnMs; firstTotal += firstMs; againTotal += againMs;
+    }
+    printf("%-30s %-12.2f %-14.2f %.2f\n", "total", spawnTotal, firstTotal, againTotal);
+
+    CloseWindow();
+    return 0;
+}
@@ -0,0 +1,68 @@
+/*******************************************************************************************
+*
+* University Portal System - Shell Hooks
+*
+* Every screen of the portal is still its own program (main.c, afterlog.c, ...),
+* launched with system("start X.exe ..."). Built normally, nothing here changes that.
+*
+* Built with -DPORTAL_SHELL and linked together with portal.c, each program's main()
+* becomes a module entry point instead, and "start X.exe" runs that module inside
+* the one already open window. Closing a module returns to the screen that opened it.
+*
+* Screens that used to exit(0) after handing off to the next program check
+* PORTAL_HANDOFF_EXITS instead: standalone they still close (returning from their entry
+* point); in the shell the launched module has already closed, so they carry on.
+*
+* In the shell, loaded data outlives a screen: a module keeps what it read for its next
+* visit, and reads its files again only if PortalFileVersion() says a screen in this
+* process has written one of them since (writers call PortalFileWritten()). Standalone,
+* every visit is a fresh process, so the versions are always 0 and nothing is kept.
+*
+********************************************************************************************/
+
+#ifndef PORTAL_H
+#define PORTAL_H
+
+#include "raylib.h"
+#include <stdlib.h>
+
+#if defined(PORTAL_SHELL)
+    // Entry points of the hosted programs, named after the file they live in
+    int LoginMain(int argc, char *argv[]);          // main.c
+    int DashboardMain(int argc, char *argv[]);      // afterlog.c
+    int ProfileSetupMain(int argc, char *argv[]);   // afterreg.c
+    int AdminPortalMain(int argc, char *argv[]);    // adminad.c
+    int StudentPortalMain(int argc, char *argv[]);  // adminstu.c
+    int AcademicsFacultyMain(int argc, char *argv[]);   // acadfac.c
+    int AcademicsStudentMain(int argc, char *argv[]);   // acadstu.c
+    int AnnouncementsAdminMain(int argc, char *argv[]); // ann_admin.c
+    int AnnouncementsStudentMain(int argc, char *argv[]); // ann_student.c
+    int ProgramStructureMain(int argc, char *argv[]);   // program_structure.c
+
+    // portal.c: runs "start X.exe args" in this process, or falls back to system()
+    void PortalLaunch(const char *command);
+    // portal.c: reuses the shell's window, only the title changes
+    void PortalInitWindow(int width, int height, const char *title);
+    // portal.c: WindowShouldClose() that also times a module's first frame
+    bool PortalWindowShouldClose(void);
+    // portal.c: how many times screens in this process have written a data file
+    unsigned int PortalFileVersion(const char *path);
+    void PortalFileWritten(const char *path);
+
+    #define PORTAL_ENTRY(name) int name(int argc, char *argv[])
+    #define PortalCloseWindow() ((void)0)   // The shell owns the window
+    #define PORTAL_HANDOFF_EXITS 0          // PortalLaunch() returns once X has closed
+    #if !defined(PORTAL_IMPLEMENTATION)
+        #define WindowShouldClose() PortalWindowShouldClose()
+    #endif
+#else
+    #define PORTAL_ENTRY(name) int main(int argc, char *argv[])
+    #define PortalLaunch(command) system(command)
+    #define PortalInitWindow(width, height, title) InitWindow(width, height, title)
+    #define PortalCloseWindow() CloseWindow()
+    #define PortalFileVersion(path) ((void)(path), 0u)
+    #define PortalFileWritten(path) ((void)(path))
+    #define PORTAL_HANDOFF_EXITS 1          // X runs on in its own process, this one ends
+#endif
+
+#endif // PORTAL_H
@@ -0,0 +1,150 @@
+/*******************************************************************************************
+*
+* University Portal System - Profile Index
+*
+* Shared by the login (afterlog.c), registration (afterreg.c) and admin (adminad.c)
+* screens to find one record in student_info.txt / faculty_info.txt without a scan.
+*
+* - "<file>.idx" is a header, then `sortedCount` entries sorted by id (then offset, so
+*   the first record of a duplicated id wins), then an unsorted tail of entries
+*   appended by registration since the last full rewrite.
+* - The header records the size of the .txt file the offsets point into; an index whose
+*   size does not match is stale and rebuilt by the reader.
+* - Lookups binary search the sorted part straight from the file and scan the tail.
+*   Once the tail holds PROFILE_INDEX_MAX_TAIL entries, the next append sorts it into
+*   the rest, so lookups never scan more than that.
+*
+********************************************************************************************/
+
+#ifndef PROFILEINDEX_H
+#define PROFILEINDEX_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define PROFILE_INDEX_MAGIC 0x31585049  // "IPX1"
+#define PROFILE_INDEX_ID_LENGTH 51      // MAX_INPUT_CHARS + 1 in the modules
+#define PROFILE_INDEX_MAX_TAIL 64
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct {
+    unsigned int magic;
+    long sourceSize;        // Size of the .txt file the offsets point into
+    int sortedCount;
+    int totalCount;
+} ProfileIndexHeader;
+
+typedef struct {
+    char id[PROFILE_INDEX_ID_LENGTH];
+    long offset;            // Byte offset of the record's id line
+} ProfileIndexEntry;
+
+//----------------------------------------------------------------------------------
+// Index File
+//----------------------------------------------------------------------------------
+
+// Orders entries by id, then by offset so the first record of a duplicated id wins
+static inline int ProfileIndexCompare(const void *a, const void *b) {
+    const ProfileIndexEntry *ea = (const ProfileIndexEntry *)a;
+    const ProfileIndexEntry *eb = (const ProfileIndexEntry *)b;
+    int cmp = strcmp(ea->id, eb->id);
+    if (cmp != 0) return cmp;
+    return (ea->offset > eb->offset) - (ea->offset < eb->offset);
+}
+
+// Sorts the entries and replaces the index with them, all in the sorted part
+static inline bool ProfileIndexWrite(const char *indexFile, ProfileIndexEntry *entries, int count, long sourceSize) {
+    qsort(entries, count, sizeof(ProfileIndexEntry), ProfileIndexCompare);
+    FILE *file = fopen(indexFile, "wb");
+    if (file == NULL) return false;
+    ProfileIndexHeader header = { PROFILE_INDEX_MAGIC, sourceSize, count, count };
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(entries, sizeof(ProfileIndexEntry), count, file) == (size_t)count;
+    return (fclose(file) == 0) && written;
+}
+
+// Looks the id up in an index that describes a data file of sourceSize bytes.
+// Returns 1 if found, 0 if absent, -1 if the index is missing or stale.
+static inline int ProfileIndexLookup(const char *indexFile, long sourceSize, const char *id, long *offset) {
+    FILE *file = fopen(indexFile, "rb");
+    if (file == NULL) return -1;
+
+    ProfileIndexHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != PROFILE_INDEX_MAGIC || header.sourceSize != sourceSize) {
+        fclose(file);
+        return -1;
+    }
+
+    // Binary search the sorted region for the leftmost match
+    ProfileIndexEntry entry;
+    int lo = 0, hi = header.sortedCount, found = 0;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        fseek(file, (long)(sizeof(header) + mid * sizeof(entry)), SEEK_SET);
+        if (fread(&entry, sizeof(entry), 1, file) != 1) { fclose(file); return -1; }
+        int cmp = strcmp(entry.id, id);
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            if (cmp == 0) { *offset = entry.offset; found = 1; }
+            hi = mid;
+        }
+    }
+
+    // Entries appended since the last rewrite are few, scan them in order
+    if (!found) {
+        fseek(file, (long)(sizeof(header) + header.sortedCount * sizeof(entry)), SEEK_SET);
+        for (int i = header.sortedCount; i < header.totalCount; i++) {
+            if (fread(&entry, sizeof(entry), 1, file) != 1) break;
+            if (strcmp(entry.id, id) == 0) { *offset = entry.offset; found = 1; break; }
+        }
+    }
+
+    fclose(file);
+    return found;
+}
+
+// Adds a record appended at `offset` (the data file is now newSize bytes) to the tail.
+// A full tail is sorted into the rest instead. If the index did not describe the file
+// before this append it is left alone; the next lookup sees the size mismatch and rebuilds it.
+static inline void ProfileIndexAppend(const char *indexFile, const char *id, long offset, long newSize) {
+    FILE *file = fopen(indexFile, "r+b");
+    if (file == NULL) return;
+
+    ProfileIndexHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != PROFILE_INDEX_MAGIC || header.sourceSize != offset) {
+        fclose(file);
+        return;
+    }
+
+    ProfileIndexEntry entry = { 0 };
+    snprintf(entry.id, sizeof(entry.id), "%s", id);
+    entry.offset = offset;
+
+    if (header.totalCount - header.sortedCount >= PROFILE_INDEX_MAX_TAIL) {
+        ProfileIndexEntry *entries = (ProfileIndexEntry *)malloc((header.totalCount + 1) * sizeof(ProfileIndexEntry));
+        bool read = entries != NULL && fread(entries, sizeof(ProfileIndexEntry), header.totalCount, file) == (size_t)header.totalCount;
+        fclose(file);
+        if (read) {
+            entries[header.totalCount] = entry;
+            if (!ProfileIndexWrite(indexFile, entries, header.totalCount + 1, newSize)) remove(indexFile);   // Rebuilt on the next lookup
+        }
+        free(entries);
+        return;
+    }
+
+    fseek(file, (long)(sizeof(header) + header.totalCount * sizeof(entry)), SEEK_SET);
+    fwrite(&entry, sizeof(entry), 1, file);
+
+    header.totalCount++;
+    header.sourceSize = newSize;
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+    fclose(file);
+}
+
+#endif // PROFILEINDEX_H
@@ -7,12 +7,28 @@
 * - All text rendering reverted to default Raylib font.
 * - Retains all features: animations, scrollbar, themes, etc.
 *
+* TIMETABLE GENERATOR
+* - Builds a clash-free tt_entries.txt for the faculty Academics window from the
+*   courses below, solved in parallel on TT_SOLVER_THREADS worker threads.
+* - "Generate Timetable" on a semester tab solves that semester's term (odd/even).
+* - Without a window: prostr.exe --timetable [odd|even] [seconds]
+*                     prostr.exe --timetable-bench [seconds]
+* - The solver threads and clock are pthreads/clock_gettime(); link with -lpthread:
+*     gcc program_structure.c -o prostr.exe -lraylib -lgdi32 -lwinmm -lpthread
+*
 ********************************************************************************************/
 
 #include "raylib.h"
+#include "portal.h"
 #include "raymath.h" // For Lerp(), Clamp(), fabsf()
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "timetable.h" // MAX_TT_ENTRIES, the rows acadfac.c loads
+#include "persist.h"
+#include "monoclock.h" // Solver deadlines; also why this needs -lpthread on MinGW
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
@@ -27,6 +43,30 @@
 #define MAX_TABS 10 // Overview(1) + Semesters(8) + Descriptions(1)
 #define PROGRAM_COUNT 2 // Number of programs (ICT, MnC)
 
+// --- Timetable generator ---
+#define TT_FILE "tt_entries.txt"                // Read by the faculty Academics window
+#define TT_CONFIG_FILE "timetable_config.txt"   // Optional rooms and professors
+#define TT_DAYS 5
+#define TT_LECTURE_SLOTS 20                     // 5 days x hourly 08:00-12:00
+#define TT_LAB_SLOTS 10                         // 5 days x two-hour 14:00-18:00
+#define TT_SLOTS (TT_LECTURE_SLOTS + TT_LAB_SLOTS)
+#define TT_MAX_SESSIONS 4096
+#define TT_MAX_COURSES 1024
+#define TT_MAX_COHORTS 128
+#define TT_MAX_PROFS 1024
+#define TT_MAX_ROOMS 128
+#define TT_ROOM_LOAD 75                         // Percent, when no rooms are configured
+#define TT_DEFAULT_WEEKLY_HOURS 3               // Lectures per week, unless credits are fewer
+#define TT_SOLVER_THREADS 4
+#define TT_MAX_THREADS 16
+#define TT_HARD_WEIGHT 1000                     // One clash outweighs any number of soft violations
+#define TT_NOISE_ODDS 20                        // 1 in 20 moves is random
+#define TT_STALL_FACTOR 20                      // Restart after 20 x sessions moves without progress
+#define TT_UI_BUDGET 1.0                        // Seconds
+#define TT_CLI_BUDGET 5.0
+#define TT_BENCH_MAX_COPIES 8
+#define TT_BENCH_TIGHT_LOAD 100
+
 // --- High-contrast text colors ---
 #define TEXT_DARK (Color){ 40, 40, 40, 255 }
 #define TEXT_LIGHT (Color){ 100, 100, 100, 255 }
@@ -79,14 +119,73 @@ typedef struct {
     Color themeColor; // Program-specific theme color
 } Program;
 
+// --- Timetable generator ---
+typedef struct {
+    const Course *course;
+    int cohort;             // Program semester; its courses must not overlap
+    int prof;
+    int sessions;           // Hourly lectures or two-hour lab blocks per week
+    int maxPerDay;          // More in one day is a soft violation
+    bool lab;
+} TTCourse;
+
+typedef struct {
+    char name[32];
+    bool lab;
+} TTRoom;
+
+typedef struct {
+    TTCourse courses[TT_MAX_COURSES]; int courseCount;
+    int sessionCourse[TT_MAX_SESSIONS]; int sessionCount;   // Course of each weekly session
+    TTRoom rooms[TT_MAX_ROOMS]; int roomCount;
+    int lectureRooms[TT_MAX_ROOMS], lectureRoomCount;
+    int labRooms[TT_MAX_ROOMS], labRoomCount;
+    char profs[TT_MAX_PROFS][64]; int profCount;
+    char cohorts[TT_MAX_COHORTS][32]; int cohortCount;
+    char assignedCodes[TT_MAX_COURSES][16];                 // PROF lines of TT_CONFIG_FILE
+    char assignedProfs[TT_MAX_COURSES][64];
+    int assignmentCount;
+    char hourCodes[TT_MAX_COURSES][16];                     // HOURS lines of TT_CONFIG_FILE
+    int hours[TT_MAX_COURSES];
+    int hourCount;
+} TTProblem;
+
+typedef struct {
+    short slot, room;
+} TTPlacement;
+
+// One solver thread's state; bookings are counted per slot
+typedef struct {
+    const TTProblem *problem;
+    unsigned int seed;
+    double deadline;
+    TTPlacement place[TT_MAX_SESSIONS];
+    unsigned short roomUse[TT_SLOTS][TT_MAX_ROOMS];
+    unsigned short profUse[TT_SLOTS][TT_MAX_PROFS];
+    unsigned short cohortUse[TT_SLOTS][TT_MAX_COHORTS];
+    unsigned char courseDay[TT_MAX_COURSES][TT_DAYS];
+    int hard, soft;
+    long iterations;
+    int restarts;
+} TTWorker;
+
+typedef struct {
+    int courses, sessions, threads;
+    int hard, soft;         // Clashes left, and courses bunched on one day
+    int score;              // 0-100, 0 while any clash is left
+    double solveMs;
+    long iterations;
+    int restarts;
+} TTReport;
+
 
 //----------------------------------------------------------------------------------
 // Global Variables
 //----------------------------------------------------------------------------------
-const int screenWidth = 1920;
-const int screenHeight = 1080;
+static const int screenWidth = 1920;
+static const int screenHeight = 1080;
 
-GameScreen currentScreen = SCREEN_SELECTION;
+static GameScreen currentScreen = SCREEN_SELECTION;
 
 // --- Unified Data Storage ---
 Program programs[PROGRAM_COUNT]; // 0 = ICT, 1 = MnC
@@ -104,6 +203,27 @@ static float hoverAlphas[MAX_COURSES_PER_SEM] = {0}; // For smooth row hover
 static float scrollVelocity = 0.0f; // For scroll momentum
 static float titleAlpha = 0.0f; 
 
+// --- Timetable generator ---
+static struct {
+    pthread_mutex_t lock;
+    TTPlacement best[TT_MAX_SESSIONS];  // Best timetable any worker has found
+    int bestHard, bestSoft;
+    bool done;                          // A perfect timetable was found
+} ttShared;
+static char ttStatus[160] = "";         // Result of the last "Generate Timetable"
+// "Generate Timetable" solves on this thread so the window keeps drawing meanwhile
+static struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    bool running;                       // Started and not yet reported
+    bool threaded;                      // False if it had to run on the UI thread
+    bool finished;                      // Result below is ready
+    int term;
+    bool solved;
+    TTReport report;
+} ttJob = { .lock = PTHREAD_MUTEX_INITIALIZER };
+static int ttRoomLoad = TT_ROOM_LOAD;   // Percent of the week default rooms are booked
+
 // --- NO FONT GLOBALS NEEDED ---
 
 
@@ -117,6 +237,12 @@ static void UpdateDrawSelectionScreen(void);
 static void UpdateDrawProgramStructureScreen(void);
 static void UpdateDrawFrame(void); // Main update and drawing loop function
 
+// Timetable generator
+static bool GenerateTimetable(int term, double budget, int copies, int threads, bool write, TTReport *report);
+static void StartTimetableJob(int term);
+static void PollTimetableJob(void);
+static int RunTimetableCli(int argc, char *argv[]);
+
 //----------------------------------------------------------------------------------
 // Main Entry Point
 //----------------------------------------------------------------------------------
@@ -125,13 +251,18 @@ static void UpdateDrawFrame(void); // Main update and drawing loop function
  * @brief Main entry point of the application.
  * Initializes the window, loads all program data, and runs the main loop.
  */
-int main(int argc, char *argv[]) 
+PORTAL_ENTRY(ProgramStructureMain) 
 {   
+    // Timetable generation from the command line needs no window
+    if (argc >= 2 && strncmp(argv[1], "--timetable", 11) == 0) {
+        return RunTimetableCli(argc, argv);
+    }
+
     if(argc<3){
         return 0;
     }
 
-    InitWindow(screenWidth, screenHeight, "University Portal - Program Structures");
+    PortalInitWindow(screenWidth, screenHeight, "University Portal - Program Structures");
     
     // --- Fonts are no longer loaded ---
 
@@ -150,7 +281,10 @@ int main(int argc, char *argv[])
 
     // --- Fonts are no longer unloaded ---
 
-    CloseWindow();
+    if (ttJob.running && ttJob.threaded) pthread_join(ttJob.thread, NULL); // At most TT_UI_BUDGET
+    if (ttJob.running && ttJob.solved) PortalFileWritten(TT_FILE);
+    ttJob.running = false;
+    PortalCloseWindow();
     return 0;
 }
 
@@ -163,7 +297,7 @@ int main(int argc, char *argv[])
  * Checks the 'currentScreen' global variable and calls the appropriate
  * update/draw function for that screen.
  */
-void UpdateDrawFrame(void) {
+static void UpdateDrawFrame(void) {
     // This function acts as a router
     switch (currentScreen) {
         case SCREEN_SELECTION:
@@ -462,6 +596,14 @@ void UpdateDrawProgramStructureScreen(void) {
         return; // --- CRITICAL: Stop execution to prevent crash
     }
 
+    // Generate a timetable for the term of the semester being viewed
+    Rectangle generateButton = { screenWidth - 350, 50, 300, 40 };
+    bool generateHover = (activeTab >= 1 && activeTab <= 8) && CheckCollisionPointRec(mousePos, generateButton);
+    if (generateHover && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && !ttJob.running) {
+        StartTimetableJob(activeTab % 2); // Sem 1, 3, 5, 7 run together, and so do 2, 4, 6, 8
+    }
+    PollTimetableJob();
+
     // Tab button logic
     Rectangle semesterTabs[MAX_TABS];
     int tabWidth = Clamp((screenWidth - 100) / MAX_TABS - 5, 100, 180);
@@ -569,6 +711,14 @@ void UpdateDrawProgramStructureScreen(void) {
     DrawText("< Back", backButton.x + (backButtonHover ? 35 : 40), backButton.y + (backButtonHover ? 9 : 10), backTextSize, TEXT_DARK);
 
 
+    // --- Timetable Generator Button ---
+    if (activeTab >= 1 && activeTab <= 8) {
+        const char *generateLabel = ttJob.running ? "Generating..." : "Generate Timetable";
+        DrawRectangleRec(generateButton, (generateHover && !ttJob.running) ? SKYBLUE : LIGHTGRAY);
+        DrawText(generateLabel, generateButton.x + (generateButton.width - MeasureText(generateLabel, 20)) / 2, generateButton.y + 10, 20, TEXT_DARK);
+        if (ttStatus[0]) DrawText(ttStatus, generateButton.x + generateButton.width - MeasureText(ttStatus, 18), generateButton.y + 50, 18, TEXT_LIGHT);
+    }
+
     // --- Draw Fading Title ---
     DrawText(activeProgramPtr->title, screenWidth/2 - MeasureText(activeProgramPtr->title, 40)/2, 80, 40, Fade(TEXT_DARK, titleAlpha));
     
@@ -716,4 +866,453 @@ void UpdateDrawProgramStructureScreen(void) {
     // --- End Scissor Mode ---
 
     EndDrawing();
-}
\ No newline at end of file
+}
+
+//----------------------------------------------------------------------------------
+// Timetable Generator
+//----------------------------------------------------------------------------------
+
+/**
+ * @brief Small xorshift generator; each worker owns one, rand() is not thread-safe.
+ */
+static unsigned int TTRandom(unsigned int *state) {
+    unsigned int x = *state;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return *state = x;
+}
+
+static int TTSlotDay(int slot) {
+    return (slot < TT_LECTURE_SLOTS) ? slot / 4 : (slot - TT_LECTURE_SLOTS) / 2;
+}
+
+/**
+ * @brief Index of a professor by name, added on first use. -1 when the table is full.
+ */
+static int TTProfessorIndex(TTProblem *problem, const char *name) {
+    for (int i = 0; i < problem->profCount; i++) {
+        if (strcmp(problem->profs[i], name) == 0) return i;
+    }
+    if (problem->profCount >= TT_MAX_PROFS) return -1;
+    snprintf(problem->profs[problem->profCount], sizeof(problem->profs[0]), "%s", name);
+    return problem->profCount++;
+}
+
+/**
+ * @brief Reads the optional TT_CONFIG_FILE into the problem:
+ *   ROOM|<name>|<1 for a lab, 0 for a lecture room>
+ *   PROF|<course code>|<professor name>
+ *   HOURS|<course code>|<sessions per week>
+ * Courses without a PROF line get "Faculty <code>", so a course code that appears
+ * in both programs is taught by the same person. Without an HOURS line a course meets
+ * once per credit, at most TT_DEFAULT_WEEKLY_HOURS times (labs: one block per credit).
+ * Without ROOM lines, rooms are sized from the load (see TTBuildProblem).
+ */
+static void TTLoadConfig(TTProblem *problem) {
+    FILE *file = fopen(TT_CONFIG_FILE, "r");
+    if (file == NULL) return;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char *kind = strtok(line, "|");
+        char *first = strtok(NULL, "|");
+        char *second = strtok(NULL, "|");
+        if (kind == NULL || first == NULL || second == NULL) continue;
+
+        if (strcmp(kind, "ROOM") == 0 && problem->roomCount < TT_MAX_ROOMS) {
+            TTRoom *room = &problem->rooms[problem->roomCount++];
+            snprintf(room->name, sizeof(room->name), "%s", first);
+            room->lab = (atoi(second) != 0);
+        } else if (strcmp(kind, "PROF") == 0 && problem->assignmentCount < TT_MAX_COURSES) {
+            snprintf(problem->assignedCodes[problem->assignmentCount], sizeof(problem->assignedCodes[0]), "%s", first);
+            snprintf(problem->assignedProfs[problem->assignmentCount], sizeof(problem->assignedProfs[0]), "%s", second);
+            problem->assignmentCount++;
+        } else if (strcmp(kind, "HOURS") == 0 && problem->hourCount < TT_MAX_COURSES) {
+            snprintf(problem->hourCodes[problem->hourCount], sizeof(problem->hourCodes[0]), "%s", first);
+            problem->hours[problem->hourCount++] = atoi(second);
+        }
+    }
+    fclose(file);
+}
+
+/**
+ * @brief Collects every course of the given term (1 = odd semesters, 0 = even) from
+ * all programs. Each semester of each program is one cohort: its courses must never
+ * run at the same time. 'copies' replicates the programs as extra departments with
+ * their own cohorts and faculty, for the benchmark. Returns false if a limit is hit.
+ */
+static bool TTBuildProblem(TTProblem *problem, int term, int copies, bool useConfig) {
+    memset(problem, 0, sizeof(*problem));
+    if (useConfig) TTLoadConfig(problem);
+
+    static const char *programTags[PROGRAM_COUNT] = { "ICT", "MnC" };
+    int lectureSessions = 0, labSessions = 0;
+
+    for (int copy = 0; copy < copies; copy++) {
+        for (int p = 0; p < PROGRAM_COUNT; p++) {
+            for (int s = 0; s < MAX_SEMESTERS; s++) {
+                if ((s + 1) % 2 != term % 2 || programs[p].semesters[s].courseCount == 0) continue;
+                if (problem->cohortCount >= TT_MAX_COHORTS) return false;
+
+                int cohort = problem->cohortCount++;
+                if (copy == 0) sprintf(problem->cohorts[cohort], "%s S%d", programTags[p], s + 1);
+                else sprintf(problem->cohorts[cohort], "%s S%d #%d", programTags[p], s + 1, copy + 1);
+
+                for (int c = 0; c < programs[p].semesters[s].courseCount; c++) {
+                    const Course *course = &programs[p].semesters[s].courses[c];
+                    if (problem->courseCount >= TT_MAX_COURSES) return false;
+
+                    char profName[64];
+                    snprintf(profName, sizeof(profName), "Faculty %s", course->code);
+                    for (int a = 0; a < problem->assignmentCount; a++) {
+                        if (strcmp(problem->assignedCodes[a], course->code) == 0) snprintf(profName, sizeof(profName), "%s", problem->assignedProfs[a]);
+                    }
+                    if (copy > 0) snprintf(profName + strlen(profName), sizeof(profName) - strlen(profName), " #%d", copy + 1);
+
+                    TTCourse *entry = &problem->courses[problem->courseCount];
+                    entry->course = course;
+                    entry->cohort = cohort;
+                    entry->prof = TTProfessorIndex(problem, profName);
+                    entry->lab = (strcmp(course->type, "Lab") == 0);
+                    entry->sessions = course->credits;    // Hourly lectures, or two-hour lab blocks
+                    if (!entry->lab && entry->sessions > TT_DEFAULT_WEEKLY_HOURS) entry->sessions = TT_DEFAULT_WEEKLY_HOURS;
+                    for (int h = 0; h < problem->hourCount; h++) {
+                        if (strcmp(problem->hourCodes[h], course->code) == 0 && problem->hours[h] >= 0) entry->sessions = problem->hours[h];
+                    }
+                    entry->maxPerDay = (entry->sessions + TT_DAYS - 1) / TT_DAYS;
+                    if (entry->prof < 0 || problem->sessionCount + entry->sessions > TT_MAX_SESSIONS) return false;
+
+                    for (int k = 0; k < entry->sessions; k++) problem->sessionCourse[problem->sessionCount++] = problem->courseCount;
+                    if (entry->lab) labSessions += entry->sessions;
+                    else lectureSessions += entry->sessions;
+                    problem->courseCount++;
+                }
+            }
+        }
+    }
+
+    // No rooms configured: enough that each room is booked about ttRoomLoad% of the week
+    if (problem->roomCount == 0) {
+        int lectureRooms = (lectureSessions * 100 + TT_LECTURE_SLOTS * ttRoomLoad - 1) / (TT_LECTURE_SLOTS * ttRoomLoad);
+        int labRooms = (labSessions * 100 + TT_LAB_SLOTS * ttRoomLoad - 1) / (TT_LAB_SLOTS * ttRoomLoad);
+        if (lectureRooms < 1) lectureRooms = 1;
+        if (labRooms < 1) labRooms = 1;
+        if (lectureRooms + labRooms > TT_MAX_ROOMS) return false;
+        for (int i = 0; i < lectureRooms; i++) problem->rooms[problem->roomCount++] = (TTRoom){ .lab = false };
+        for (int i = 0; i < labRooms; i++) problem->rooms[problem->roomCount++] = (TTRoom){ .lab = true };
+        for (int i = 0, lt = 0, lab = 0; i < problem->roomCount; i++) {
+            if (problem->rooms[i].lab) sprintf(problem->rooms[i].name, "LAB-%d", ++lab);
+            else sprintf(problem->rooms[i].name, "LT-%d", ++lt);
+        }
+    }
+
+    for (int i = 0; i < problem->roomCount; i++) {
+        if (problem->rooms[i].lab) problem->labRooms[problem->labRoomCount++] = i;
+        else problem->lectureRooms[problem->lectureRoomCount++] = i;
+    }
+    return (problem->lectureRoomCount > 0 || lectureSessions == 0) && (problem->labRoomCount > 0 || labSessions == 0);
+}
+
+/**
+ * @brief Adds (sign = 1) or removes (sign = -1) one session's booking, keeping the
+ * worker's hard and soft violation totals up to date.
+ *  hard: two bookings of one room, professor or cohort in the same slot
+ *  soft: a course meeting more often in one day than its hours need
+ */
+static void TTBook(TTWorker *w, int session, int slot, int room, int sign) {
+    const TTCourse *course = &w->problem->courses[w->problem->sessionCourse[session]];
+    int courseIndex = w->problem->sessionCourse[session];
+    int day = TTSlotDay(slot);
+
+    if (sign > 0) {
+        w->hard += (w->roomUse[slot][room]++ > 0) + (w->profUse[slot][course->prof]++ > 0) + (w->cohortUse[slot][course->cohort]++ > 0);
+        w->soft += (w->courseDay[courseIndex][day]++ >= course->maxPerDay);
+        w->place[session] = (TTPlacement){ (short)slot, (short)room };
+    } else {
+        w->hard -= (--w->roomUse[slot][room] > 0) + (--w->profUse[slot][course->prof] > 0) + (--w->cohortUse[slot][course->cohort] > 0);
+        w->soft -= (w->courseDay[courseIndex][day]-- > course->maxPerDay);
+    }
+}
+
+static bool TTInConflict(const TTWorker *w, int session) {
+    const TTCourse *course = &w->problem->courses[w->problem->sessionCourse[session]];
+    TTPlacement at = w->place[session];
+    return w->roomUse[at.slot][at.room] > 1 || w->profUse[at.slot][course->prof] > 1 || w->cohortUse[at.slot][course->cohort] > 1 ||
+           w->courseDay[w->problem->sessionCourse[session]][TTSlotDay(at.slot)] > course->maxPerDay;
+}
+
+/**
+ * @brief Books an unbooked session into the cheapest slot and room, ties broken at
+ * random. With a small probability it takes a random one instead, to leave local minima.
+ */
+static void TTBookBest(TTWorker *w, int session) {
+    const TTProblem *problem = w->problem;
+    const TTCourse *course = &problem->courses[problem->sessionCourse[session]];
+    int firstSlot = course->lab ? TT_LECTURE_SLOTS : 0;
+    int slotCount = course->lab ? TT_LAB_SLOTS : TT_LECTURE_SLOTS;
+    const int *rooms = course->lab ? problem->labRooms : problem->lectureRooms;
+    int roomCount = course->lab ? problem->labRoomCount : problem->lectureRoomCount;
+
+    if (TTRandom(&w->seed) % TT_NOISE_ODDS == 0) {
+        TTBook(w, session, firstSlot + TTRandom(&w->seed) % slotCount, rooms[TTRandom(&w->seed) % roomCount], 1);
+        return;
+    }
+
+    int bestCost = -1, bestSlot = firstSlot, bestRoom = rooms[0], ties = 0;
+    for (int slot = firstSlot; slot < firstSlot + slotCount; slot++) {
+        int fixedCost = (w->profUse[slot][course->prof] > 0) * TT_HARD_WEIGHT + (w->cohortUse[slot][course->cohort] > 0) * TT_HARD_WEIGHT +
+                        (w->courseDay[problem->sessionCourse[session]][TTSlotDay(slot)] >= course->maxPerDay);
+        if (bestCost >= 0 && fixedCost > bestCost) continue;
+        for (int r = 0; r < roomCount; r++) {
+            int cost = fixedCost + (w->roomUse[slot][rooms[r]] > 0) * TT_HARD_WEIGHT;
+            if (bestCost < 0 || cost < bestCost) { bestCost = cost; bestSlot = slot; bestRoom = rooms[r]; ties = 1; }
+            else if (cost == bestCost && TTRandom(&w->seed) % ++ties == 0) { bestSlot = slot; bestRoom = rooms[r]; }
+        }
+    }
+    TTBook(w, session, bestSlot, bestRoom, 1);
+}
+
+/**
+ * @brief Hands a worker's current timetable to the shared best if it scores better.
+ */
+static void TTOfferBest(TTWorker *w) {
+    pthread_mutex_lock(&ttShared.lock);
+    long cost = (long)w->hard * TT_HARD_WEIGHT + w->soft;
+    if (cost < (long)ttShared.bestHard * TT_HARD_WEIGHT + ttShared.bestSoft) {
+        memcpy(ttShared.best, w->place, sizeof(TTPlacement) * w->problem->sessionCount);
+        ttShared.bestHard = w->hard;
+        ttShared.bestSoft = w->soft;
+        if (cost == 0) ttShared.done = true;
+    }
+    pthread_mutex_unlock(&ttShared.lock);
+}
+
+static bool TTShouldStop(const TTWorker *w) {
+    pthread_mutex_lock(&ttShared.lock);
+    bool done = ttShared.done;
+    pthread_mutex_unlock(&ttShared.lock);
+    return done || MonoClockNow() >= w->deadline;
+}
+
+/**
+ * @brief One solver thread: min-conflicts local search with random restarts. Workers
+ * differ only by seed, so they explore different timetables; the first to reach zero
+ * violations stops the rest.
+ */
+static void *TTWorkerMain(void *arg) {
+    TTWorker *w = (TTWorker *)arg;
+    const TTProblem *problem = w->problem;
+    int n = problem->sessionCount;
+    int *order = (int *)malloc(sizeof(int) * (n > 0 ? n : 1));
+
+    while (n > 0 && !TTShouldStop(w)) {
+        // Fresh greedy start in random order
+        memset(w->roomUse, 0, sizeof(w->roomUse));
+        memset(w->profUse, 0, sizeof(w->profUse));
+        memset(w->cohortUse, 0, sizeof(w->cohortUse));
+        memset(w->courseDay, 0, sizeof(w->courseDay));
+        w->hard = w->soft = 0;
+        for (int i = 0; i < n; i++) order[i] = i;
+        for (int i = n - 1; i > 0; i--) { int j = TTRandom(&w->seed) % (i + 1); int t = order[i]; order[i] = order[j]; order[j] = t; }
+        for (int i = 0; i < n; i++) TTBookBest(w, order[i]);
+        w->restarts++;
+
+        long runBest = (long)w->hard * TT_HARD_WEIGHT + w->soft;
+        long stall = 0;
+        TTOfferBest(w);
+
+        while (w->hard > 0 || w->soft > 0) {
+            if ((++w->iterations & 255) == 0 && TTShouldStop(w)) break;
+
+            int session = -1;
+            for (int k = 0, start = TTRandom(&w->seed) % n; k < n; k++) {
+                int candidate = (start + k) % n;
+                if (TTInConflict(w, candidate)) { session = candidate; break; }
+            }
+            if (session < 0) break;
+
+            TTBook(w, session, w->place[session].slot, w->place[session].room, -1);
+            TTBookBest(w, session);
+
+            long cost = (long)w->hard * TT_HARD_WEIGHT + w->soft;
+            if (cost < runBest) { runBest = cost; stall = 0; }
+            else if (++stall > (long)TT_STALL_FACTOR * n) break; // Stuck: restart
+        }
+        TTOfferBest(w);
+    }
+
+    free(order);
+    return NULL;
+}
+
+static TTWorker *TTNewWorker(const TTProblem *problem, int index, double deadline) {
+    TTWorker *w = (TTWorker *)calloc(1, sizeof(TTWorker));
+    w->problem = problem;
+    w->seed = 0x9E3779B9u * (unsigned int)(index + 1) ^ (unsigned int)(MonoClockNow() * 1000.0);
+    if (w->seed == 0) w->seed = 1;
+    w->deadline = deadline;
+    return w;
+}
+
+/**
+ * @brief Solves the timetable for one term on 'threads' workers within 'budget'
+ * seconds and, if 'write' is set and it has no clashes, saves it to TT_FILE in the
+ * format acadfac.c reads. A timetable with clashes leaves TT_FILE as it was.
+ * Lectures go in hourly slots 08:00-12:00 and labs in two-hour blocks 14:00-18:00,
+ * which are the rows acadfac.c's grids show.
+ */
+static bool GenerateTimetable(int term, double budget, int copies, int threads, bool write, TTReport *report) {
+    static TTProblem problem;
+    memset(report, 0, sizeof(*report));
+    double start = MonoClockNow();
+
+    if (!TTBuildProblem(&problem, term, copies, copies == 1)) {
+        TraceLog(LOG_WARNING, "TIMETABLE: Too many courses, rooms or professors for the generator limits.");
+        return false;
+    }
+    if (threads < 1) threads = 1;
+    if (threads > TT_MAX_THREADS) threads = TT_MAX_THREADS;
+
+    pthread_mutex_init(&ttShared.lock, NULL);
+    ttShared.bestHard = problem.sessionCount + 1;
+    ttShared.bestSoft = 0;
+    ttShared.done = (problem.sessionCount == 0);
+
+    TTWorker *workers[TT_MAX_THREADS];
+    pthread_t ids[TT_MAX_THREADS];
+    int started = 0;
+    for (int i = 0; i < threads; i++) {
+        workers[i] = TTNewWorker(&problem, i, start + budget);
+        if (pthread_create(&ids[i], NULL, TTWorkerMain, workers[i]) != 0) { free(workers[i]); break; }
+        started++;
+    }
+    if (started < threads) TraceLog(LOG_WARNING, "TIMETABLE: Only %d of %d solver threads started.", started, threads);
+    if (started == 0) {                 // Solve on this thread instead
+        workers[0] = TTNewWorker(&problem, 0, start + budget);
+        TTWorkerMain(workers[0]);
+    }
+    threads = (started > 0) ? started : 1;
+    for (int i = 0; i < threads; i++) {
+        if (started > 0) pthread_join(ids[i], NULL);
+        report->iterations += workers[i]->iterations;
+        report->restarts += workers[i]->restarts;
+        free(workers[i]);
+    }
+    pthread_mutex_destroy(&ttShared.lock);
+
+    report->solveMs = (MonoClockNow() - start) * 1000.0;
+    report->hard = (problem.sessionCount == 0) ? 0 : ttShared.bestHard;
+    report->soft = ttShared.bestSoft;
+    report->courses = problem.courseCount;
+    report->sessions = problem.sessionCount;
+    report->threads = threads;
+    // 100 = no clashes and every course spread over the week
+    report->score = (report->hard > 0) ? 0 : 100 - (problem.sessionCount ? 100 * report->soft / problem.sessionCount : 0);
+
+    // Runs off the UI thread, so no TextFormat() (its buffers are shared with drawing)
+    TraceLog(LOG_INFO, "TIMETABLE: %d courses, %d sessions on %d threads: %d clashes, %d soft, score %d in %.1f ms.",
+        report->courses, report->sessions, threads, report->hard, report->soft, report->score, report->solveMs);
+    if (!write || report->hard > 0) return report->hard == 0;   // Never replace a timetable with one that clashes
+
+    if (problem.sessionCount > MAX_TT_ENTRIES) {
+        TraceLog(LOG_WARNING, "TIMETABLE: %d sessions, the faculty window only loads the first %d.", problem.sessionCount, MAX_TT_ENTRIES);
+    }
+    PersistBuffer file = { 0 };
+    for (int s = 0; s < problem.sessionCount; s++) {
+        const TTCourse *course = &problem.courses[problem.sessionCourse[s]];
+        TTPlacement at = ttShared.best[s];
+        int day = TTSlotDay(at.slot);
+        int startHour = course->lab ? 14 + 2 * ((at.slot - TT_LECTURE_SLOTS) % 2) : 8 + at.slot % 4;
+        PersistAppend(&file, "%d|%02d:00|%02d:00|%d|%s %s|%s|%s|%d\n", day, startHour, startHour + (course->lab ? 2 : 1), course->lab ? 1 : 0,
+            course->course->code, problem.cohorts[course->cohort], problem.rooms[at.room].name, problem.profs[course->prof], s + 1);
+    }
+    bool written = PersistWriteFile(TT_FILE, file.data ? file.data : "", file.length);   // Temp file + rename
+    PersistBufferFree(&file);
+    if (!written) TraceLog(LOG_WARNING, "TIMETABLE: Could not write %s.", TT_FILE);
+    return written;
+}
+
+static void *TTJobMain(void *arg) {
+    (void)arg;
+    TTReport report;
+    bool solved = GenerateTimetable(ttJob.term, TT_UI_BUDGET, 1, TT_SOLVER_THREADS, true, &report);
+    pthread_mutex_lock(&ttJob.lock);
+    ttJob.report = report;
+    ttJob.solved = solved;
+    ttJob.finished = true;
+    pthread_mutex_unlock(&ttJob.lock);
+    return NULL;
+}
+
+/**
+ * @brief Starts "Generate Timetable" for one term on its own thread. If no thread can be
+ * made it runs here, which blocks the window for up to TT_UI_BUDGET as it used to.
+ */
+static void StartTimetableJob(int term) {
+    ttJob.term = term;
+    ttJob.finished = false;
+    ttJob.running = true;
+    sprintf(ttStatus, "%s term: generating...", term ? "Odd" : "Even");
+    ttJob.threaded = (pthread_create(&ttJob.thread, NULL, TTJobMain, NULL) == 0);
+    if (!ttJob.threaded) TTJobMain(NULL);
+}
+
+/**
+ * @brief Called every frame: reports the job once it has finished.
+ */
+static void PollTimetableJob(void) {
+    if (!ttJob.running) return;
+    pthread_mutex_lock(&ttJob.lock);
+    bool finished = ttJob.finished;
+    pthread_mutex_unlock(&ttJob.lock);
+    if (!finished) return;
+    if (ttJob.threaded) pthread_join(ttJob.thread, NULL);
+    ttJob.running = false;
+
+    const TTReport *report = &ttJob.report;
+    const char *term = ttJob.term ? "Odd" : "Even";
+    if (ttJob.solved) {
+        PortalFileWritten(TT_FILE); // The Academics windows read the new timetable on their next visit
+        sprintf(ttStatus, "%s term: %d sessions, score %d, %.0f ms", term, report->sessions, report->score, report->solveMs);
+    } else if (report->hard > 0) {
+        sprintf(ttStatus, "%s term: %d clashes left after %.0f ms, %s kept", term, report->hard, report->solveMs, TT_FILE);
+    } else {
+        sprintf(ttStatus, "%s term: could not write %s", term, TT_FILE);
+    }
+}
+
+/**
+ * @brief Command-line use, without opening a window:
+ *   prostr.exe --timetable [odd|even] [seconds]   writes tt_entries.txt
+ *   prostr.exe --timetable-bench [seconds]        solve time against course count
+ */
+static int RunTimetableCli(int argc, char *argv[]) {
+    SetTraceLogLevel(LOG_WARNING);
+    InitProgramData();
+    TTReport report;
+
+    if (strcmp(argv[1], "--timetable-bench") == 0) {
+        double budget = (argc >= 3) ? atof(argv[2]) : TT_CLI_BUDGET;
+        int loads[] = { TT_ROOM_LOAD, TT_BENCH_TIGHT_LOAD };  // Spare rooms, then barely enough
+        printf("%-6s %-8s %-8s %-9s %-8s %-10s %-7s %-6s %s\n", "load", "copies", "courses", "sessions", "threads", "solve ms", "clashes", "soft", "score");
+        for (int l = 0; l < 2; l++) {
+            ttRoomLoad = loads[l];
+            for (int copies = 1; copies <= TT_BENCH_MAX_COPIES; copies *= 2) {
+                int threadCounts[2] = { 1, TT_SOLVER_THREADS };
+                for (int t = 0; t < 2; t++) {
+                    GenerateTimetable(1, budget, copies, threadCounts[t], false, &report);
+                    printf("%-6d %-8d %-8d %-9d %-8d %-10.1f %-7d %-6d %d\n", loads[l], copies, report.courses, report.sessions, report.threads,
+                        report.solveMs, report.hard, report.soft, report.score);
+                }
+            }
+        }
+        return 0;
+    }
+
+    int term = (argc >= 3 && strcmp(argv[2], "even") == 0) ? 0 : 1;
+    double budget = (argc >= 4) ? atof(argv[3]) : TT_CLI_BUDGET;
+    bool solved = GenerateTimetable(term, budget, 1, TT_SOLVER_THREADS, true, &report);
+    printf("%s term: %d courses, %d sessions, %d clashes, %d soft violations, score %d, %.1f ms on %d threads -> %s\n",
+        term ? "Odd" : "Even", report.courses, report.sessions, report.hard, report.soft, report.score, report.solveMs, report.threads, solved ? TT_FILE : TT_FILE " unchanged");
+    return solved ? 0 : 1;
+}
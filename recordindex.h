@@ -0,0 +1,165 @@
+/*******************************************************************************************
+*
+* University Portal System - Keyed Line Index
+*
+* Lets the student window (acadstu.c) read one student's lines out of the shared record
+* files (results.txt, attendance.txt, ...) without parsing the rest.
+*
+* - "<file>.idx" lists (key hash, offset, length) for every line of the file, sorted by
+*   hash. It records the file's size and mtime and is rebuilt by whoever opens it after
+*   the file changed; that one scan is shared by every window opened later.
+* - A lookup is a binary search read straight from the index file, then one read per
+*   matching line. Neither depends on how large the files are.
+* - Each line read back is checked against the key, so hash collisions cost one extra
+*   read and nothing else.
+* - The key of a line comes from a RecordKeyFunc. Lines that return an empty key are
+*   kept under "" (e.g. attendance SUBJECT lines, which every student needs).
+*
+********************************************************************************************/
+
+#ifndef RECORDINDEX_H
+#define RECORDINDEX_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+#include "records.h"
+#include "persist.h"
+
+#define RECORD_INDEX_MAGIC 0x31584952u      // "RIX1"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Sets *key to the line's key; false leaves the line out of the index
+typedef bool (*RecordKeyFunc)(const RecordLine *line, RecordField *key);
+
+typedef struct {
+    uint32_t magic;
+    int32_t count;
+    int64_t sourceSize, sourceMtime;
+} RecordIndexHeader;
+
+typedef struct {
+    uint32_t hash;
+    uint32_t length;                    // Including the '\n'
+    int64_t offset;
+} RecordIndexEntry;
+
+typedef struct {
+    FILE *index, *source;
+    int count;
+    RecordKeyFunc key;
+} RecordIndex;
+
+//----------------------------------------------------------------------------------
+// Helpers
+//----------------------------------------------------------------------------------
+static inline uint32_t RecordIndexHash(const char *text, int length) {
+    uint32_t hash = 2166136261u;        // FNV-1a
+    for (int i = 0; i < length; i++) hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+    return hash;
+}
+
+static inline int RecordIndexCompare(const void *a, const void *b) {
+    const RecordIndexEntry *x = (const RecordIndexEntry *)a, *y = (const RecordIndexEntry *)b;
+    if (x->hash != y->hash) return (x->hash > y->hash) - (x->hash < y->hash);
+    return (x->offset > y->offset) - (x->offset < y->offset);
+}
+
+// Writes "<path>.idx" for the file as it is now; false if the file cannot be read
+static inline bool RecordIndexBuild(const char *path, const char *indexPath, RecordKeyFunc key) {
+    RecordFile file;
+    if (!RecordFileOpen(&file, path)) return false;
+    RecordIndexHeader header = { RECORD_INDEX_MAGIC, 0, (int64_t)file.size, (int64_t)file.mtime };  // Stamp of the bytes indexed
+    int capacity = 1024;
+    RecordIndexEntry *entries = (RecordIndexEntry *)malloc(sizeof(RecordIndexEntry) * capacity);
+    RecordLine line;
+    RecordField field;
+    while (RecordNextLine(&file, &line)) {
+        if (!key(&line, &field)) continue;
+        if (header.count == capacity) { capacity *= 2; entries = (RecordIndexEntry *)realloc(entries, sizeof(RecordIndexEntry) * capacity); }
+        long start = (long)(line.fields[0].text - file.data);
+        entries[header.count++] = (RecordIndexEntry){ RecordIndexHash(field.text, field.length), (uint32_t)(file.pos - start), start };
+    }
+    RecordFileClose(&file);
+    qsort(entries, header.count, sizeof(RecordIndexEntry), RecordIndexCompare);
+
+    long bytes = (long)sizeof(header) + (long)sizeof(RecordIndexEntry) * header.count;
+    char *image = (char *)malloc(bytes);
+    memcpy(image, &header, sizeof(header));
+    if (header.count) memcpy(image + sizeof(header), entries, sizeof(RecordIndexEntry) * header.count);
+    bool written = PersistWriteFile(indexPath, image, bytes);
+    free(image); free(entries);
+    return written;
+}
+
+static inline void RecordIndexClose(RecordIndex *index) {
+    if (index->index) fclose(index->index);
+    if (index->source) fclose(index->source);
+    memset(index, 0, sizeof(*index));
+}
+
+// Opens the index of 'path', rebuilding it first if it is missing or older than the file
+static inline bool RecordIndexOpen(RecordIndex *index, const char *path, RecordKeyFunc key) {
+    memset(index, 0, sizeof(*index));
+    char indexPath[PERSIST_MAX_PATH];
+    snprintf(indexPath, sizeof(indexPath), "%s.idx", path);
+    for (int attempt = 0; attempt < 2; attempt++) {
+        // The stamp is checked on the open source, so the offsets are used on the file they describe
+        struct stat st;
+        RecordIndexHeader header;
+        index->source = fopen(path, "rb");
+        if (index->source == NULL || fstat(fileno(index->source), &st) != 0) { RecordIndexClose(index); return false; }
+        index->index = fopen(indexPath, "rb");
+        if (index->index && fread(&header, sizeof(header), 1, index->index) == 1 && header.magic == RECORD_INDEX_MAGIC &&
+            header.sourceSize == (int64_t)st.st_size && header.sourceMtime == (int64_t)st.st_mtime) {
+            index->count = header.count;
+            index->key = key;
+            return true;
+        }
+        RecordIndexClose(index);
+        if (attempt == 0 && !RecordIndexBuild(path, indexPath, key)) return false;
+    }
+    return false;
+}
+
+static inline bool RecordIndexEntryAt(RecordIndex *index, int i, RecordIndexEntry *entry) {
+    return fseek(index->index, (long)(sizeof(RecordIndexHeader) + sizeof(RecordIndexEntry) * (size_t)i), SEEK_SET) == 0 &&
+           fread(entry, sizeof(*entry), 1, index->index) == 1;
+}
+
+// Appends every line whose key is 'key' to 'out', in file order; returns how many
+static inline int RecordIndexRead(RecordIndex *index, const char *key, PersistBuffer *out) {
+    int keyLength = (int)strlen(key), found = 0;
+    uint32_t hash = RecordIndexHash(key, keyLength);
+    int lo = 0, hi = index->count;
+    RecordIndexEntry entry;
+    while (lo < hi) {                   // First entry with this hash
+        int mid = lo + (hi - lo) / 2;
+        if (!RecordIndexEntryAt(index, mid, &entry)) return 0;
+        if (entry.hash < hash) lo = mid + 1; else hi = mid;
+    }
+    for (int i = lo; i < index->count && RecordIndexEntryAt(index, i, &entry) && entry.hash == hash; i++) {
+        long start = out->length;
+        PersistAppend(out, "%*s", (int)entry.length, "");   // Room for the line
+        RecordFile file;
+        RecordLine line;
+        RecordField field;
+        RecordFileBorrow(&file, out->data + start, entry.length);
+        bool match = fseek(index->source, (long)entry.offset, SEEK_SET) == 0 &&
+                     fread(out->data + start, 1, entry.length, index->source) == entry.length &&
+                     RecordNextLine(&file, &line) && index->key(&line, &field) &&
+                     field.length == keyLength && memcmp(field.text, key, keyLength) == 0;
+        if (!match) { out->length = start; continue; }
+        if (out->data[out->length - 1] != '\n') PersistAppend(out, "\n");  // Last line of a file
+        found++;
+    }
+    return found;
+}
+
+#endif // RECORDINDEX_H
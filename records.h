@@ -0,0 +1,239 @@
+/*******************************************************************************************
+*
+* University Portal System - Pipe-Delimited Record Reader
+*
+* Shared by the load_* functions of acadfac.c and acadstu.c, which read lines like
+* "1|08:00|09:00|0|Maths|R101|Dr. Rao|7".
+*
+* - The whole file is mapped (read into memory on Windows), and fields are returned
+*   as pointer + length into it; nothing is copied until a loader stores a string.
+* - One pass over the bytes. '|' and '\n' are found 32 (AVX2) or 16 (SSE2) bytes at a
+*   time, and the bit mask of a block is kept, so each byte is compared once. Other
+*   targets and the last partial block use a plain loop.
+* - Numbers are parsed by hand: no locale lookups and no NUL terminator needed.
+* - Unlike strtok(), empty fields are kept, so "a||b" has three fields.
+*
+********************************************************************************************/
+
+#ifndef RECORDS_H
+#define RECORDS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+
+#if !defined(RECORD_BLOCK)             // -DRECORD_BLOCK=0 forces the scalar loop
+    #if defined(__AVX2__)
+        #define RECORD_BLOCK 32
+    #elif defined(__SSE2__) || defined(_M_X64)
+        #define RECORD_BLOCK 16
+    #else
+        #define RECORD_BLOCK 0
+    #endif
+#endif
+#if RECORD_BLOCK == 32
+    #include <immintrin.h>
+#elif RECORD_BLOCK == 16
+    #include <emmintrin.h>
+#endif
+
+#if !defined(_WIN32)
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#define RECORD_MAX_FIELDS 16
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct {
+    const char *data;
+    long size;
+    long mtime;                         // Of the file that was opened, for index stamps
+    long pos;                           // Start of the next line
+    long blockBase;                     // Bytes [blockBase, blockBase + RECORD_BLOCK) ...
+    uint32_t blockMask;                 // ... have their delimiters set in this mask
+    bool blockValid;
+    bool borrowed;                      // data belongs to the caller (RecordFileBorrow)
+} RecordFile;
+
+typedef struct {
+    const char *text;                   // Not NUL-terminated
+    int length;
+} RecordField;
+
+typedef struct {
+    RecordField fields[RECORD_MAX_FIELDS];
+    int count;
+} RecordLine;
+
+//----------------------------------------------------------------------------------
+// Files
+//----------------------------------------------------------------------------------
+
+// False if the file cannot be read; an empty file opens with no lines. The size comes
+// from the open file itself, so a writer renaming a new version over the path between
+// the size check and the open cannot leave a mapping sized for the other version.
+static inline bool RecordFileOpen(RecordFile *file, const char *path) {
+    memset(file, 0, sizeof(*file));
+    struct stat st;
+#if defined(_WIN32)
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return false;
+    if (fstat(fileno(f), &st) != 0) { fclose(f); return false; }
+    long size = (long)st.st_size;
+    char *data = (size > 0) ? (char *)malloc(size) : NULL;
+    bool ok = (size == 0) || ((data != NULL) && (fread(data, 1, size, f) == (size_t)size));
+    fclose(f);
+    if (!ok) { free(data); return false; }
+    file->data = data;
+    file->size = size; file->mtime = (long)st.st_mtime;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    if (fstat(fd, &st) != 0) { close(fd); return false; }
+    long size = (long)st.st_size;
+    void *data = (size > 0) ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    file->data = (const char *)data;
+    file->size = size; file->mtime = (long)st.st_mtime;
+#endif
+    return true;
+}
+
+// Reads lines out of memory the caller owns, e.g. lines gathered by recordindex.h
+static inline void RecordFileBorrow(RecordFile *file, const char *data, long size) {
+    memset(file, 0, sizeof(*file));
+    file->data = data; file->size = size;
+    file->borrowed = true;
+}
+
+static inline void RecordFileClose(RecordFile *file) {
+    if (file->data == NULL || file->borrowed) return;
+#if defined(_WIN32)
+    free((void *)file->data);
+#else
+    munmap((void *)file->data, file->size);
+#endif
+    file->data = NULL;
+}
+
+//----------------------------------------------------------------------------------
+// Tokenizer
+//----------------------------------------------------------------------------------
+#if RECORD_BLOCK == 32
+static inline uint32_t RecordBlockMask(const char *p) {
+    __m256i bytes = _mm256_loadu_si256((const __m256i *)p);
+    __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('|')), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n')));
+    return (uint32_t)_mm256_movemask_epi8(hits);
+}
+#elif RECORD_BLOCK == 16
+static inline uint32_t RecordBlockMask(const char *p) {
+    __m128i bytes = _mm_loadu_si128((const __m128i *)p);
+    __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('|')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')));
+    return (uint32_t)_mm_movemask_epi8(hits);
+}
+#endif
+
+// Offset of the first '|' or '\n' at or after 'from'; file->size if there is none
+static inline long RecordFindDelimiter(RecordFile *file, long from) {
+#if RECORD_BLOCK > 0
+    for (;;) {
+        if (file->blockValid && from >= file->blockBase && from < file->blockBase + RECORD_BLOCK) {
+            uint32_t mask = file->blockMask & (0xFFFFFFFFu << (from - file->blockBase));
+            if (mask) return file->blockBase + __builtin_ctz(mask);
+            from = file->blockBase + RECORD_BLOCK;
+        }
+        if (from + RECORD_BLOCK > file->size) break;
+        file->blockBase = from;
+        file->blockMask = RecordBlockMask(file->data + from);
+        file->blockValid = true;
+    }
+#endif
+    for (; from < file->size; from++) {
+        if (file->data[from] == '|' || file->data[from] == '\n') return from;
+    }
+    return file->size;
+}
+
+// Splits the next non-empty line into fields; false at the end of the file. A trailing
+// '\r' is dropped and fields past RECORD_MAX_FIELDS are ignored.
+static inline bool RecordNextLine(RecordFile *file, RecordLine *line) {
+    while (file->pos < file->size) {
+        line->count = 0;
+        long start = file->pos;
+        for (;;) {
+            long end = RecordFindDelimiter(file, start);
+            if (line->count < RECORD_MAX_FIELDS) {
+                line->fields[line->count].text = file->data + start;
+                line->fields[line->count].length = (int)(end - start);
+                line->count++;
+            }
+            if (end >= file->size || file->data[end] == '\n') { file->pos = end + 1; break; }
+            start = end + 1;
+        }
+        RecordField *last = &line->fields[line->count - 1];
+        if (last->length > 0 && last->text[last->length - 1] == '\r') last->length--;
+        if (line->count > 1 || line->fields[0].length > 0) return true;
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------------
+// Fields
+//----------------------------------------------------------------------------------
+
+// Leading integer of a field, like atoi(); 0 if the field is missing
+static inline int RecordInt(const RecordLine *line, int index) {
+    if (index >= line->count) return 0;
+    const char *p = line->fields[index].text, *end = p + line->fields[index].length;
+    while (p < end && *p == ' ') p++;
+    bool negative = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    int value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++) value = value*10 + (*p - '0');
+    return negative ? -value : value;
+}
+
+// Plain decimal like "8.75" (what the save_* functions write); no exponents
+static inline double RecordFloat(const RecordLine *line, int index) {
+    if (index >= line->count) return 0.0;
+    const char *p = line->fields[index].text, *end = p + line->fields[index].length;
+    while (p < end && *p == ' ') p++;
+    bool negative = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    double value = 0.0, scale = 1.0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++) value = value*10.0 + (*p - '0');
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++) { value = value*10.0 + (*p - '0'); scale *= 10.0; }
+    }
+    return (negative ? -value : value) / scale;
+}
+
+// "HH:MM" as minutes since midnight
+static inline int RecordMinutes(const RecordLine *line, int index) {
+    if (index >= line->count) return 0;
+    const RecordField *field = &line->fields[index];
+    const char *colon = (const char *)memchr(field->text, ':', field->length);
+    int hours = RecordInt(line, index), minutes = 0;
+    for (const char *p = colon ? colon + 1 : field->text + field->length; p < field->text + field->length && *p >= '0' && *p <= '9'; p++) {
+        minutes = minutes*10 + (*p - '0');
+    }
+    return hours*60 + minutes;
+}
+
+// Copies a field as a NUL-terminated string, truncated to fit; "" if it is missing
+static inline void RecordCopy(const RecordLine *line, int index, char *dest, int size) {
+    int length = (index < line->count) ? line->fields[index].length : 0;
+    if (length > size - 1) length = size - 1;
+    if (length > 0) memcpy(dest, line->fields[index].text, length);
+    dest[length] = '\0';
+}
+
+#endif // RECORDS_H
@@ -0,0 +1,215 @@
+/*******************************************************************************************
+*
+* University Portal System - Compact Timetable Storage
+*
+* Shared by the faculty (acadfac.c) and student (acadstu.c) Academics windows.
+*
+* - Titles, rooms and professors repeat across thousands of rows, so each distinct
+*   string is stored once in a TimetableStrings table and rows hold 32-bit symbols.
+*   Interned strings never move, so a symbol's text pointer stays valid.
+* - A TimetableEntry packs its times into minutes since midnight: 24 bytes per row
+*   instead of three MAX_STR buffers.
+* - TimetableView is a struct-of-arrays copy of the rows grouped by (type, day), so a
+*   grid only walks the rows it draws.
+* - TimetableStringsPack() flattens the table for datacache.h snapshots, and
+*   TimetableStringsLoad() reads such an image back, in place or as copies.
+*
+********************************************************************************************/
+
+#ifndef TIMETABLE_H
+#define TIMETABLE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MAX_TT_ENTRIES 65536
+#define TIMETABLE_VIEW_DAYS 7
+#define TIMETABLE_MAX_STRING 256        // Same as MAX_STR in the modules
+#define TIMETABLE_STRING_BLOCK 16384
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum { TT_LECTURE = 0, TT_LAB = 1 } TTType;
+
+typedef uint32_t TimetableSymbol;       // Index into a TimetableStrings table, 0 is ""
+
+typedef struct {
+    TimetableSymbol title, room, professor;
+    int32_t id;
+    uint16_t start, end;                // Minutes since midnight, [start, end)
+    uint8_t day;                        // 0 = Mon
+    uint8_t type;                       // TTType
+    uint16_t reserved;
+} TimetableEntry;
+
+typedef struct TimetableStringBlock {
+    struct TimetableStringBlock *next;
+    int used;
+    char bytes[TIMETABLE_STRING_BLOCK];
+} TimetableStringBlock;
+
+typedef struct {
+    const char **text;                  // Symbol -> string
+    int count, capacity;
+    TimetableSymbol *slots;             // Open addressing, symbol + 1 (0 = empty)
+    int slotCapacity;
+    TimetableStringBlock *blocks;       // Copies of interned strings
+    char *packed;                       // Last TimetableStringsPack() image
+    long packedBytes;
+} TimetableStrings;
+
+// Rows grouped by (type, day); run (t, d) is [first[t*DAYS + d], first[t*DAYS + d + 1])
+typedef struct {
+    int count;
+    int first[2 * TIMETABLE_VIEW_DAYS + 1];
+    uint16_t start[MAX_TT_ENTRIES], end[MAX_TT_ENTRIES];
+    TimetableSymbol title[MAX_TT_ENTRIES], room[MAX_TT_ENTRIES];
+    int entry[MAX_TT_ENTRIES];          // Row in the entry table
+} TimetableView;
+
+//----------------------------------------------------------------------------------
+// String Table
+//----------------------------------------------------------------------------------
+static inline uint32_t TimetableHash(const char *str) {
+    uint32_t hash = 2166136261u;        // FNV-1a
+    while (*str) hash = (hash ^ (unsigned char)*str++) * 16777619u;
+    return hash;
+}
+
+// Adds a string the table does not hold yet; 'text' must outlive the table
+static inline TimetableSymbol TimetableStringsAdd(TimetableStrings *s, const char *text) {
+    if (s->count == s->capacity) {
+        s->capacity = s->capacity ? s->capacity * 2 : 256;
+        s->text = (const char **)realloc((void *)s->text, sizeof(const char *) * s->capacity);
+    }
+    if ((s->count + 1) * 2 > s->slotCapacity) {
+        free(s->slots);
+        s->slotCapacity = s->slotCapacity ? s->slotCapacity * 2 : 1024;
+        s->slots = (TimetableSymbol *)calloc(s->slotCapacity, sizeof(TimetableSymbol));
+        for (int i = 0; i < s->count; i++) {
+            uint32_t slot = TimetableHash(s->text[i]) & (s->slotCapacity - 1);
+            while (s->slots[slot]) slot = (slot + 1) & (s->slotCapacity - 1);
+            s->slots[slot] = (TimetableSymbol)i + 1;
+        }
+    }
+
+    TimetableSymbol symbol = (TimetableSymbol)s->count++;
+    s->text[symbol] = text;
+    uint32_t slot = TimetableHash(text) & (s->slotCapacity - 1);
+    while (s->slots[slot]) slot = (slot + 1) & (s->slotCapacity - 1);
+    s->slots[slot] = symbol + 1;
+    return symbol;
+}
+
+static inline void TimetableStringsFree(TimetableStrings *s) {
+    while (s->blocks) { TimetableStringBlock *next = s->blocks->next; free(s->blocks); s->blocks = next; }
+    free((void *)s->text); free(s->slots); free(s->packed);
+    memset(s, 0, sizeof(*s));
+}
+
+// Empties the table; symbol 0 is always ""
+static inline void TimetableStringsReset(TimetableStrings *s) {
+    TimetableStringsFree(s);
+    TimetableStringsAdd(s, "");
+}
+
+static inline TimetableSymbol TimetableIntern(TimetableStrings *s, const char *str) {
+    if (s->count == 0) TimetableStringsReset(s);
+    if (str == NULL) return 0;
+
+    char truncated[TIMETABLE_MAX_STRING];
+    int length = (int)strnlen(str, TIMETABLE_MAX_STRING);
+    if (length == TIMETABLE_MAX_STRING) {
+        length = TIMETABLE_MAX_STRING - 1;
+        memcpy(truncated, str, length);
+        truncated[length] = '\0';
+        str = truncated;
+    }
+
+    uint32_t slot = TimetableHash(str) & (s->slotCapacity - 1);
+    for (; s->slots[slot]; slot = (slot + 1) & (s->slotCapacity - 1)) {
+        if (strcmp(s->text[s->slots[slot] - 1], str) == 0) return s->slots[slot] - 1;
+    }
+
+    if (s->blocks == NULL || s->blocks->used + length + 1 > TIMETABLE_STRING_BLOCK) {
+        TimetableStringBlock *block = (TimetableStringBlock *)malloc(sizeof(TimetableStringBlock));
+        block->next = s->blocks; block->used = 0;
+        s->blocks = block;
+    }
+    char *copy = s->blocks->bytes + s->blocks->used;
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    s->blocks->used += length + 1;
+    return TimetableStringsAdd(s, copy);
+}
+
+static inline const char *TimetableString(const TimetableStrings *s, TimetableSymbol symbol) {
+    return (symbol < (TimetableSymbol)s->count) ? s->text[symbol] : "";
+}
+
+// Flattens the strings in symbol order into s->packed, for a snapshot section
+static inline const char *TimetableStringsPack(TimetableStrings *s, long *bytes) {
+    if (s->count == 0) TimetableStringsReset(s);
+    long total = 0;
+    for (int i = 0; i < s->count; i++) total += (long)strlen(s->text[i]) + 1;
+    free(s->packed);
+    s->packed = (char *)malloc(total);
+    long offset = 0;
+    for (int i = 0; i < s->count; i++) {
+        long length = (long)strlen(s->text[i]) + 1;
+        memcpy(s->packed + offset, s->text[i], length);
+        offset += length;
+    }
+    s->packedBytes = total;
+    *bytes = total;
+    return s->packed;
+}
+
+// Rebuilds the table from a packed image, so every symbol means the same string again.
+// With inPlace the strings are used where they are (the image must outlive the table);
+// otherwise they are copied. False if the image is malformed.
+static inline bool TimetableStringsLoad(TimetableStrings *s, const char *image, long bytes, bool inPlace) {
+    TimetableStringsFree(s);
+    if (bytes <= 0 || image[bytes - 1] != '\0' || image[0] != '\0') return false;
+    for (long offset = 0; offset < bytes; offset += (long)strlen(image + offset) + 1) {
+        TimetableSymbol symbol = inPlace ? TimetableStringsAdd(s, image + offset) : TimetableIntern(s, image + offset);
+        if (symbol != (TimetableSymbol)(s->count - 1)) return false;  // Duplicate: not a packed table
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Grid View
+//----------------------------------------------------------------------------------
+
+// Counting sort of the rows by (type, day); rows keep their relative order in each run
+static inline void TimetableBuildView(TimetableView *view, const TimetableEntry *entries, int count) {
+    int runs = 2 * TIMETABLE_VIEW_DAYS;
+    memset(view->first, 0, sizeof(view->first));
+    for (int i = 0; i < count; i++) {
+        if (entries[i].day >= TIMETABLE_VIEW_DAYS || entries[i].type > TT_LAB) continue;
+        view->first[entries[i].type * TIMETABLE_VIEW_DAYS + entries[i].day + 1]++;
+    }
+    for (int r = 0; r < runs; r++) view->first[r + 1] += view->first[r];
+
+    int next[2 * TIMETABLE_VIEW_DAYS];
+    memcpy(next, view->first, sizeof(next));
+    for (int i = 0; i < count; i++) {
+        const TimetableEntry *e = &entries[i];
+        if (e->day >= TIMETABLE_VIEW_DAYS || e->type > TT_LAB) continue;
+        int k = next[e->type * TIMETABLE_VIEW_DAYS + e->day]++;
+        view->start[k] = e->start; view->end[k] = e->end;
+        view->title[k] = e->title; view->room[k] = e->room;
+        view->entry[k] = i;
+    }
+    view->count = view->first[runs];
+}
+
+static inline int TimetableRunBegin(const TimetableView *view, TTType type, int day) { return view->first[type * TIMETABLE_VIEW_DAYS + day]; }
+static inline int TimetableRunEnd(const TimetableView *view, TTType type, int day) { return view->first[type * TIMETABLE_VIEW_DAYS + day + 1]; }
+
+#endif // TIMETABLE_H